@@ -19,6 +19,7 @@
 #include "ecs/Systems/GameObjectSystem.h"
 #include "ecs/Systems/LODSystem.h"
 #include "ecs/Systems/LightSystem.h"
+#include "core/JobSystem.h"
 #include "utils/Logger.h"
 
 Engine::Engine()
@@ -41,6 +42,9 @@ bool Engine::Initialize() {
         InitializeEventManager();
         InitializeStateManager();
 
+        // Worker pool for BSP compilation and other parallel jobs
+        JobSystem::GetInstance().Initialize();
+
         // Create core systems
         auto assetSystem = AddSystem<AssetSystem>();
         auto materialSystem = AddSystem<MaterialSystem>(); // Flyweight material management
@@ -95,8 +99,8 @@ bool Engine::Initialize() {
         }
 
         // Connect BSPTreeSystem to CollisionSystem
-        if (renderSystem && collisionSystem) {
-            // TODO: Set up world system integration for collision system
+        if (bspTreeSystem && collisionSystem) {
+            collisionSystem->SetBSPTreeSystem(bspTreeSystem);
         }
 
         if (inputSystem && playerSystem) {
@@ -131,6 +135,8 @@ void Engine::Shutdown() {
         (*it)->Shutdown();
     }
 
+    JobSystem::GetInstance().Shutdown();
+
     // Clean up managers
     if (stateManager_) {
         delete stateManager_;
@@ -0,0 +1,133 @@
+#include "JobSystem.h"
+#include "../utils/Logger.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+    thread_local unsigned int tlsThreadIndex = 0;
+}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+void JobSystem::Initialize(unsigned int threadCount) {
+    if (initialized_) {
+        Shutdown();
+    }
+
+    if (threadCount == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 0;
+    }
+
+    running_ = true;
+    initialized_ = true;
+    workers_.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+
+    LOG_INFO("JobSystem initialized with " + std::to_string(threadCount) + " worker threads");
+}
+
+void JobSystem::Shutdown() {
+    if (!initialized_) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+    workers_.clear();
+    initialized_ = false;
+
+    // Anything still queued runs inline so counters never stay stuck
+    while (TryRunOne()) {}
+}
+
+void JobSystem::Submit(JobCounter& counter, std::function<void()> job) {
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (workers_.empty()) {
+        // No pool (single core or not initialized): run inline
+        job();
+        counter.pending.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(Job{std::move(job), &counter});
+    }
+    wake_.notify_one();
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        if (!TryRunOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grain,
+                            const std::function<void(size_t begin, size_t end)>& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+
+    if (workers_.empty() || count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = 0; begin < count; begin += grain) {
+        size_t end = std::min(begin + grain, count);
+        Submit(counter, [&body, begin, end]() { body(begin, end); });
+    }
+    Wait(counter);
+}
+
+unsigned int JobSystem::GetThreadIndex() {
+    return tlsThreadIndex;
+}
+
+bool JobSystem::TryRunOne() {
+    Job job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) return false;
+        // LIFO: the most recent job is usually a child of the waiting job,
+        // which keeps recursive fork/join depth-first and cache friendly
+        job = std::move(queue_.back());
+        queue_.pop_back();
+    }
+
+    job.fn();
+    job.counter->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void JobSystem::WorkerLoop(unsigned int index) {
+    tlsThreadIndex = index;
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return !running_ || !queue_.empty(); });
+            if (!running_ && queue_.empty()) return;
+            // Workers steal the oldest job: that's the biggest chunk of work
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        job.fn();
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+}
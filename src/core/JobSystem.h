@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counter used to join a group of jobs. Every Submit() increments it, every
+// finished job decrements it; Wait() returns once it drops back to zero.
+struct JobCounter {
+    std::atomic<int> pending{0};
+};
+
+// Small fork/join thread pool shared by world compilation, lighting and physics.
+// Waiting threads help drain the queue instead of blocking, so jobs may submit
+// and wait on child jobs (recursive BSP builds) without starving the pool.
+class JobSystem {
+public:
+    static JobSystem& GetInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // threadCount == 0 picks hardware_concurrency() - 1 workers (the caller is
+    // the extra thread). Calling Initialize again resizes the pool.
+    void Initialize(unsigned int threadCount = 0);
+    void Shutdown();
+
+    // Queue a job and tie it to a counter
+    void Submit(JobCounter& counter, std::function<void()> job);
+
+    // Block until the counter reaches zero, running queued jobs meanwhile
+    void Wait(JobCounter& counter);
+
+    // Split [0, count) into chunks of at least `grain` and run them on the pool.
+    // Chunk boundaries depend only on count/grain, never on the thread count.
+    void ParallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t begin, size_t end)>& body);
+
+    // Number of threads that can run jobs (workers + the calling thread)
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(workers_.size()) + 1; }
+
+    // 0 for the main/external thread, 1..N for pool workers. Used to pick
+    // per-thread scratch memory (arenas) without locking.
+    static unsigned int GetThreadIndex();
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    void WorkerLoop(unsigned int index);
+    bool TryRunOne();
+
+    struct Job {
+        std::function<void()> fn;
+        JobCounter* counter;
+    };
+
+    std::vector<std::thread> workers_;
+    std::deque<Job> queue_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_ = false;
+    bool initialized_ = false;
+};
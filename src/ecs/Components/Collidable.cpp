@@ -6,6 +6,7 @@ Collidable::Collidable()
     , collisionMask_(LAYER_ALL)
     , isStatic_(false)
     , isTrigger_(false)
+    , isBullet_(false)
 {
 }
 
@@ -16,6 +17,7 @@ Collidable::Collidable(const Vector3& size)
     , collisionMask_(LAYER_ALL)
     , isStatic_(false)
     , isTrigger_(false)
+    , isBullet_(false)
 {
 }
 
@@ -25,6 +27,7 @@ Collidable::Collidable(const AABB& bounds)
     , collisionMask_(LAYER_ALL)
     , isStatic_(false)
     , isTrigger_(false)
+    , isBullet_(false)
 {
 }
 
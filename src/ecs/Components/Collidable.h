@@ -33,6 +33,7 @@ public:
     uint32_t GetCollisionMask() const { return collisionMask_; }
     bool IsStatic() const { return isStatic_; }
     bool IsTrigger() const { return isTrigger_; }
+    bool IsBullet() const { return isBullet_; }
 
     // Setters
     void SetBounds(const AABB& bounds) { bounds_ = bounds; }
@@ -42,6 +43,7 @@ public:
     void SetCollisionMask(uint32_t mask) { collisionMask_ = mask; }
     void SetStatic(bool isStatic) { isStatic_ = isStatic; }
     void SetTrigger(bool isTrigger) { isTrigger_ = isTrigger; }
+    void SetBullet(bool isBullet) { isBullet_ = isBullet; }
 
     // Collision layer convenience methods
     void AddToLayer(CollisionLayer layer) { collisionLayer_ |= layer; }
@@ -67,4 +69,5 @@ private:
     uint32_t collisionMask_;   // Which layers this entity can collide with
     bool isStatic_;            // Whether this collider is static (doesn't move)
     bool isTrigger_;           // Whether this is a trigger (no physical response)
+    bool isBullet_;            // Fast projectile: swept each tick (continuous collision) instead of tested at its end position
 };
@@ -1,15 +1,49 @@
 #include "CollisionSystem.h"
 #include "../Entity.h"
 #include "../Components/Player.h"
+#include "../../core/JobSystem.h"
 #include <algorithm>
+#include <cfloat>
+#include <initializer_list>
 #include "raylib.h"
 
 CollisionSystem::CollisionSystem()
     : world_(nullptr)  // Will be set by WorldSystem
+    , bspTreeSystem_(nullptr)
     , debugBoundsVisible_(false)
 {
 }
 
+void CollisionSystem::SetWorld(const World* world) {
+    world_ = world;
+    if (!world_) {
+        worldBVH_.Clear();
+        return;
+    }
+
+    worldBVH_.Build(*world_);
+    const TriangleBVH::Stats& stats = worldBVH_.GetStats();
+    LOG_INFO("Collision BVH: " + std::to_string(stats.triangles) + " triangles from " +
+             std::to_string(stats.surfaces) + " surfaces, " + std::to_string(stats.nodes) + " nodes, depth " +
+             std::to_string(stats.depth) + " (" + std::to_string(static_cast<int>(stats.buildMs)) + " ms)");
+}
+
+void CollisionSystem::QueryWorldSurfaces(const AABB& bounds, std::vector<uint32_t>& outSurfaces) const {
+    worldBVH_.QuerySurfaces(bounds, outSurfaces);
+}
+
+void CollisionSystem::GetWorldContacts(const AABB& bounds, std::vector<TriangleBVH::Contact>& outContacts) const {
+    worldBVH_.CollectContacts(bounds, outContacts);
+    std::sort(outContacts.begin(), outContacts.end(), [](const TriangleBVH::Contact& a, const TriangleBVH::Contact& b) {
+        return a.surface != b.surface ? a.surface < b.surface : a.depth > b.depth;
+    });
+    outContacts.erase(std::unique(outContacts.begin(), outContacts.end(),
+                                  [](const TriangleBVH::Contact& a, const TriangleBVH::Contact& b) {
+                                      return a.surface == b.surface;
+                                  }),
+                      outContacts.end());
+}
+
 void CollisionSystem::Initialize() {
     // Register with archetype bitmask for entities with Collidable component
     // This would be set up in the ECS system
@@ -18,17 +52,19 @@ void CollisionSystem::Initialize() {
 void CollisionSystem::Shutdown() {
     collidableEntities_.clear();
     collisionPairs_.clear();
+    colliderProxies_.clear();
+    worldBVH_.Clear();
+    dynamicTree_.Clear();
+    staticTree_.Clear();
 }
 
 void CollisionSystem::Update(float deltaTime) {
     if (!IsEnabled()) return;
 
-    // Update list of collidable entities
+    // Keep the collider trees current for queries between physics ticks;
+    // contacts are resolved by PhysicsSystem (ResolveEntityContacts)
     UpdateCollidableEntities();
 
-    // Check for entity-to-entity collisions
-    CheckEntityCollisions();
-
     // Render debug collision bounds if enabled
     if (debugBoundsVisible_) {
         RenderDebugBounds();
@@ -37,6 +73,13 @@ void CollisionSystem::Update(float deltaTime) {
     // Process collision events (this would integrate with the event system)
 }
 
+void CollisionSystem::ResolveEntityContacts() {
+    if (!IsEnabled()) return;
+
+    UpdateCollidableEntities();
+    CheckEntityCollisions();
+}
+
 void CollisionSystem::UpdateCollidableEntities() {
     collidableEntities_.clear();
 
@@ -47,43 +90,144 @@ void CollisionSystem::UpdateCollidableEntities() {
             collidableEntities_.push_back(entity);
         }
     }
+    // Pair order decides resolution order; keep it stable across runs
+    std::sort(collidableEntities_.begin(), collidableEntities_.end(),
+              [](const Entity* a, const Entity* b) { return a->GetId() < b->GetId(); });
+
+    SyncColliderProxies();
 }
 
-void CollisionSystem::CheckEntityCollisions() {
-    // Clear previous collision pairs
-    collisionPairs_.clear();
+void CollisionSystem::SyncColliderProxies() {
+    syncStamp_++;
 
-    // Broad phase: check all pairs for potential collisions
-    for (size_t i = 0; i < collidableEntities_.size(); ++i) {
-        Entity* entityA = collidableEntities_[i];
-        auto* collidableA = entityA->GetComponent<Collidable>();
+    for (Entity* entity : collidableEntities_) {
+        const auto* collidable = entity->GetComponent<Collidable>();
+        const AABB& bounds = collidable->GetBounds();
+        const Vector3 center = bounds.GetCenter();
+        const bool isStatic = collidable->IsStatic();
+
+        auto it = colliderProxies_.find(entity);
+        if (it != colliderProxies_.end() && it->second.isStatic != isStatic) {
+            (it->second.isStatic ? staticTree_ : dynamicTree_).DestroyProxy(it->second.proxyId);
+            colliderProxies_.erase(it);
+            it = colliderProxies_.end();
+        }
 
-        for (size_t j = i + 1; j < collidableEntities_.size(); ++j) {
-            Entity* entityB = collidableEntities_[j];
-            auto* collidableB = entityB->GetComponent<Collidable>();
+        if (it == colliderProxies_.end()) {
+            DynamicAABBTree& tree = isStatic ? staticTree_ : dynamicTree_;
+            colliderProxies_[entity] = {tree.CreateProxy(bounds, entity), isStatic, center, syncStamp_};
+            continue;
+        }
 
-            // Check layer/mask filtering
-            if (!collidableA->ShouldCollideWith(*collidableB)) {
-                continue;
-            }
+        ColliderProxy& proxy = it->second;
+        DynamicAABBTree& tree = isStatic ? staticTree_ : dynamicTree_;
+        tree.MoveProxy(proxy.proxyId, bounds, Vector3Subtract(center, proxy.lastCenter));
+        proxy.lastCenter = center;
+        proxy.lastSeen = syncStamp_;
+    }
 
-            // Narrow phase: check actual collision
-            if (CheckCollision(*collidableA, *collidableB)) {
-                // Record collision pair
-                collisionPairs_[entityA].push_back(entityB);
-                collisionPairs_[entityB].push_back(entityA);
+    // Entities destroyed or stripped of their Collidable since the last update
+    for (auto it = colliderProxies_.begin(); it != colliderProxies_.end();) {
+        if (it->second.lastSeen != syncStamp_) {
+            (it->second.isStatic ? staticTree_ : dynamicTree_).DestroyProxy(it->second.proxyId);
+            it = colliderProxies_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
 
-                // Resolve collision
-                ResolveEntityCollision(entityA, entityB);
+void CollisionSystem::CheckEntityCollisions() {
+    // Clear previous collision pairs
+    collisionPairs_.clear();
+
+    // Broad phase: spatial hash pairs, already filtered by layer/mask and
+    // bounds overlap
+    BuildSpatialGrid();
+    broadphase_.FindPairs(candidatePairs_);
+
+    // Islands: colliders linked by pairs that can push both of them apart.
+    // Pushes never leave an island, so islands resolve in parallel, each one
+    // in broadphase pair order - the same result as a single serial pass
+    const uint32_t colliderCount = static_cast<uint32_t>(collidableEntities_.size());
+    islandParent_.resize(colliderCount);
+    islandPushable_.resize(colliderCount);
+    for (uint32_t i = 0; i < colliderCount; ++i) {
+        const auto* collidable = collidableEntities_[i]->GetComponent<Collidable>();
+        islandParent_[i] = i;
+        islandPushable_[i] = !collidable->IsStatic() && !collidable->IsTrigger();
+    }
+    for (const SpatialHash::Pair& pair : candidatePairs_) {
+        if (!islandPushable_[pair.first] || !islandPushable_[pair.second]) continue;
+        uint32_t rootA = FindIsland(pair.first);
+        uint32_t rootB = FindIsland(pair.second);
+        if (rootA != rootB) islandParent_[std::max(rootA, rootB)] = std::min(rootA, rootB);
+    }
+
+    // A pair belongs to the island of a collider it can move, so everything
+    // that reads that collider's bounds stays on one thread. Pairs that move
+    // nothing just take the first collider's.
+    const size_t pairCount = candidatePairs_.size();
+    pairIslands_.resize(pairCount);
+    islandStart_.assign(colliderCount + 1, 0);
+    for (size_t p = 0; p < pairCount; ++p) {
+        const SpatialHash::Pair& pair = candidatePairs_[p];
+        uint32_t owner = islandPushable_[pair.first] || !islandPushable_[pair.second] ? pair.first : pair.second;
+        pairIslands_[p] = FindIsland(owner);
+        islandStart_[pairIslands_[p] + 1]++;
+    }
+    islands_.clear();
+    for (uint32_t i = 0; i < colliderCount; ++i) {
+        if (islandStart_[i + 1] > 0) islands_.push_back(i);
+        islandStart_[i + 1] += islandStart_[i];
+    }
+    // Counting sort keeps the pairs of each island in broadphase order
+    islandPairs_.resize(pairCount);
+    islandCursor_.assign(islandStart_.begin(), islandStart_.end() - 1);
+    for (size_t p = 0; p < pairCount; ++p) {
+        islandPairs_[islandCursor_[pairIslands_[p]]++] = static_cast<uint32_t>(p);
+    }
 
-                // Fire collision event
-                CollisionEvent event(entityA, entityB);
-                OnCollisionEnter(event);
+    pairHits_.assign(pairCount, 0);
+    JobSystem::GetInstance().ParallelFor(islands_.size(), ISLAND_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t island = begin; island < end; ++island) {
+            const uint32_t root = islands_[island];
+            for (uint32_t k = islandStart_[root]; k < islandStart_[root + 1]; ++k) {
+                const uint32_t p = islandPairs_[k];
+                Entity* entityA = collidableEntities_[candidatePairs_[p].first];
+                Entity* entityB = collidableEntities_[candidatePairs_[p].second];
+
+                // Narrow phase: check actual collision (bounds may have moved
+                // while resolving earlier pairs of this island)
+                if (CheckCollision(*entityA->GetComponent<Collidable>(), *entityB->GetComponent<Collidable>())) {
+                    ResolveEntityCollision(entityA, entityB);
+                    pairHits_[p] = 1;
+                }
             }
         }
+    });
+
+    // Record pairs and fire events on this thread, in pair order
+    for (size_t p = 0; p < pairCount; ++p) {
+        if (!pairHits_[p]) continue;
+        Entity* entityA = collidableEntities_[candidatePairs_[p].first];
+        Entity* entityB = collidableEntities_[candidatePairs_[p].second];
+        collisionPairs_[entityA].push_back(entityB);
+        collisionPairs_[entityB].push_back(entityA);
+
+        CollisionEvent event(entityA, entityB);
+        OnCollisionEnter(event);
     }
 }
 
+uint32_t CollisionSystem::FindIsland(uint32_t collider) {
+    while (islandParent_[collider] != collider) {
+        islandParent_[collider] = islandParent_[islandParent_[collider]];  // Path halving
+        collider = islandParent_[collider];
+    }
+    return collider;
+}
+
 bool CollisionSystem::CheckCollision(const Collidable& a, const Collidable& b) const {
     // Skip collision if either is a trigger
     if (a.IsTrigger() || b.IsTrigger()) {
@@ -125,25 +269,19 @@ CollisionEvent CollisionSystem::GetDetailedCollisionWithWorld(const Collidable&
     playerBounds.max.y = position.y + size.y / 2.0f;
     playerBounds.max.z = position.z + size.z / 2.0f;
 
-    // Check collision against all faces in the BSP tree
-    const auto& faces = world_->surfaces;
-    LOG_INFO("COLLISION CHECK: Checking " + std::to_string(faces.size()) + " faces at position (" + 
+    // Faces overlapping the box, from the BVH's batched triangle test
+    GetWorldContacts(playerBounds, worldContactScratch_);
+    LOG_INFO("COLLISION CHECK: " + std::to_string(worldContactScratch_.size()) + " faces hit at position (" + 
              std::to_string(position.x) + "," + std::to_string(position.y) + "," + std::to_string(position.z) + ")");
-    
-    for (const auto& face : faces) {
-        // Skip non-collidable faces
-        if (!HasFlag(face.flags, FaceFlags::Collidable)) continue;
-
-        // Simple AABB vs triangle intersection check
-        if (AABBIntersectsTriangle(playerBounds, face.vertices)) {
-            // Calculate penetration depth
-            float penetrationDepth = CalculatePenetrationDepth(playerBounds, face.vertices, face.normal);
-            LOG_INFO("COLLISION HIT: Found collision with face normal (" + std::to_string(face.normal.x) + "," + 
-                     std::to_string(face.normal.y) + "," + std::to_string(face.normal.z) + ") penetration: " + 
-                     std::to_string(penetrationDepth));
-            // Return detailed collision info
-            return CollisionEvent(nullptr, nullptr, position, face.normal, penetrationDepth);
-        }
+
+    if (!worldContactScratch_.empty()) {
+        const TriangleBVH::Contact& contact = worldContactScratch_.front();
+        const Face& face = world_->surfaces[contact.surface];
+        LOG_INFO("COLLISION HIT: Found collision with face normal (" + std::to_string(face.normal.x) + "," + 
+                 std::to_string(face.normal.y) + "," + std::to_string(face.normal.z) + ") penetration: " + 
+                 std::to_string(contact.depth));
+        // Return detailed collision info
+        return CollisionEvent(nullptr, nullptr, position, face.normal, contact.depth);
     }
 
     return CollisionEvent(nullptr, nullptr, position, {0,0,0}, 0.0f);
@@ -177,18 +315,20 @@ bool CollisionSystem::CastRay(const Vector3& origin, const Vector3& direction, f
         }
     }
 
-    // Cast ray against entities
+    // Cast ray against entities: the trees hand out fat boxes, the exact
+    // bounds are tested here and each hit clips the rest of the traversal
     Vector3 normalizedDir = Vector3Normalize(direction);
-    for (Entity* entity : collidableEntities_) {
+    Vector3 invDir = {1.0f/normalizedDir.x, 1.0f/normalizedDir.y, 1.0f/normalizedDir.z};
+    auto testProxy = [&](const DynamicAABBTree& tree, int32_t proxyId) {
+        Entity* entity = static_cast<Entity*>(tree.GetUserData(proxyId));
         auto* collidable = entity->GetComponent<Collidable>();
-        if (!collidable) continue;
+        if (!collidable) return closestDistance;
 
         // Ray-AABB intersection test
         AABB bounds = collidable->GetBounds();
-        Vector3 invDir = {1.0f/normalizedDir.x, 1.0f/normalizedDir.y, 1.0f/normalizedDir.z};
 
         float tmin = 0.0f;
-        float tmax = maxDistance;
+        float tmax = closestDistance;
 
         for (int i = 0; i < 3; ++i) {
             float originVal = (i == 0) ? origin.x : (i == 1) ? origin.y : origin.z;
@@ -204,24 +344,167 @@ bool CollisionSystem::CastRay(const Vector3& origin, const Vector3& direction, f
         }
 
         if (tmax >= tmin && tmin < closestDistance) {
-            Vector3 entityHitPoint = Vector3Add(origin, Vector3Scale(normalizedDir, tmin));
-            if (tmin < closestDistance) {
-                closestDistance = tmin;
-                hitPoint = entityHitPoint;
-                hitNormal = GetAABBNormal(bounds, AABB({origin.x, origin.y, origin.z}, {origin.x, origin.y, origin.z}));
-                hitEntity = entity;
-            }
+            closestDistance = tmin;
+            hitPoint = Vector3Add(origin, Vector3Scale(normalizedDir, tmin));
+            hitNormal = GetAABBNormal(bounds, AABB({origin.x, origin.y, origin.z}, {origin.x, origin.y, origin.z}));
+            hitEntity = entity;
         }
-    }
+        // Returning 0 would end the cast; a hit at the origin is final anyway
+        return closestDistance;
+    };
+    dynamicTree_.RayCast(origin, normalizedDir, closestDistance,
+                         [&](int32_t proxyId) { return testProxy(dynamicTree_, proxyId); });
+    staticTree_.RayCast(origin, normalizedDir, closestDistance,
+                        [&](int32_t proxyId) { return testProxy(staticTree_, proxyId); });
 
     return closestDistance < maxDistance;
 }
 
+void CollisionSystem::QueryAABB(const AABB& bounds, std::vector<Entity*>& outEntities, uint32_t layerMask) const {
+    outEntities.clear();
+    for (const DynamicAABBTree* tree : {&dynamicTree_, &staticTree_}) {
+        tree->Query(bounds, [&](int32_t proxyId) {
+            Entity* entity = static_cast<Entity*>(tree->GetUserData(proxyId));
+            const auto* collidable = entity->GetComponent<Collidable>();
+            if (collidable && (collidable->GetCollisionLayer() & layerMask) != 0 &&
+                collidable->GetBounds().Intersects(bounds)) {
+                outEntities.push_back(entity);
+            }
+            return true;
+        });
+    }
+}
+
+void CollisionSystem::QuerySphere(const Vector3& center, float radius, std::vector<Entity*>& outEntities,
+                                  uint32_t layerMask) const {
+    outEntities.clear();
+    for (const DynamicAABBTree* tree : {&dynamicTree_, &staticTree_}) {
+        tree->QuerySphere(center, radius, [&](int32_t proxyId) {
+            Entity* entity = static_cast<Entity*>(tree->GetUserData(proxyId));
+            const auto* collidable = entity->GetComponent<Collidable>();
+            if (!collidable || (collidable->GetCollisionLayer() & layerMask) == 0) return true;
+
+            // Closest point on the exact bounds within radius
+            Vector3 closest = ClampToAABB(center, collidable->GetBounds());
+            if (Vector3DistanceSqr(closest, center) <= radius * radius) outEntities.push_back(entity);
+            return true;
+        });
+    }
+}
+
 bool CollisionSystem::CastRayWorldOnly(const Vector3& origin, const Vector3& direction, float maxDistance,
                                       Vector3& hitPoint, Vector3& hitNormal) const {
-    // TODO: Implement ray casting for new World system
-    // For now, return false (no hit)
-    return false;
+    if (!world_) return false;
+
+    TriangleBVH::RayHit hit;
+    if (!worldBVH_.RayCast(origin, Vector3Normalize(direction), maxDistance, hit)) return false;
+
+    hitPoint = hit.point;
+    hitNormal = hit.normal;
+    return true;
+}
+
+bool CollisionSystem::SweepSphere(const Vector3& start, const Vector3& end, float radius, uint32_t layerMask,
+                                  const Entity* ignore, SweepHit& outHit) const {
+    outHit = SweepHit{};
+    outHit.position = end;
+    radius = std::max(radius, 0.0f);
+
+    const Vector3 movement = Vector3Subtract(end, start);
+    const float length = Vector3Length(movement);
+    if (length < 1e-6f) return false;
+    const Vector3 direction = Vector3Scale(movement, 1.0f / length);
+    float closest = length;
+    bool found = false;
+
+    // World: swept sphere against the collision triangles
+    TriangleBVH::RayHit worldHit;
+    if (world_ && worldBVH_.SphereCast(start, direction, radius, closest, worldHit)) {
+        closest = worldHit.distance;
+        found = true;
+        const Face& face = world_->surfaces[worldHit.surface];
+        outHit.point = worldHit.point;
+        outHit.normal = worldHit.normal;
+        outHit.surface = static_cast<int32_t>(worldHit.surface);
+        outHit.materialId = face.materialId;
+        outHit.materialEntityId = face.materialEntityId;
+    }
+
+    // Entities: candidates from the trees over the swept bounds, then the ray
+    // against each box grown by the radius
+    AABB swept(Vector3Min(start, end), Vector3Max(start, end));
+    swept.Expand({radius, radius, radius});
+    const float starts[3] = {start.x, start.y, start.z};
+    const float directions[3] = {direction.x, direction.y, direction.z};
+    for (const DynamicAABBTree* tree : {&dynamicTree_, &staticTree_}) {
+        tree->Query(swept, [&](int32_t proxyId) {
+            Entity* entity = static_cast<Entity*>(tree->GetUserData(proxyId));
+            const auto* collidable = entity->GetComponent<Collidable>();
+            if (entity == ignore || !collidable || collidable->IsTrigger() ||
+                (collidable->GetCollisionLayer() & layerMask) == 0) {
+                return true;
+            }
+
+            AABB bounds = collidable->GetBounds();
+            bounds.Expand({radius, radius, radius});
+            const float mins[3] = {bounds.min.x, bounds.min.y, bounds.min.z};
+            const float maxs[3] = {bounds.max.x, bounds.max.y, bounds.max.z};
+            float tmin = 0.0f, tmax = closest;
+            int entryAxis = -1;
+            for (int i = 0; i < 3 && tmin <= tmax; ++i) {
+                if (std::fabs(directions[i]) < 1e-8f) {
+                    if (starts[i] < mins[i] || starts[i] > maxs[i]) tmin = FLT_MAX;
+                    continue;
+                }
+                float t1 = (mins[i] - starts[i]) / directions[i];
+                float t2 = (maxs[i] - starts[i]) / directions[i];
+                if (t1 > t2) std::swap(t1, t2);
+                if (t1 > tmin) {
+                    tmin = t1;
+                    entryAxis = i;
+                }
+                tmax = std::min(tmax, t2);
+            }
+            // entryAxis < 0: started inside
+            if (entryAxis < 0 || tmin > tmax || (found && tmin >= closest)) return true;
+
+            closest = tmin;
+            found = true;
+            Vector3 normal = {0, 0, 0};
+            (entryAxis == 0 ? normal.x : entryAxis == 1 ? normal.y : normal.z) = directions[entryAxis] > 0.0f ? -1.0f : 1.0f;
+            Vector3 center = Vector3Add(start, Vector3Scale(direction, tmin));
+            outHit.point = Vector3Subtract(center, Vector3Scale(normal, radius));
+            outHit.normal = normal;
+            outHit.entity = entity;
+            outHit.surface = -1;
+            outHit.materialId = 0;
+            outHit.materialEntityId = 0;
+            return true;
+        });
+    }
+
+    if (!found) return false;
+    outHit.fraction = closest / length;
+    outHit.position = Vector3Add(start, Vector3Scale(direction, closest));
+    return true;
+}
+
+bool CollisionSystem::TraceBoxWorld(const Vector3& start, const Vector3& end, const Vector3& halfExtents,
+                                    BSPTraceResult& result, const CollisionNeighborhood* nearby) const {
+    if (!world_ || !bspTreeSystem_) {
+        result = BSPTraceResult{};
+        result.point = end;
+        return false;
+    }
+
+    if (nearby) {
+        AABB swept(Vector3Subtract(Vector3Min(start, end), halfExtents), Vector3Add(Vector3Max(start, end), halfExtents));
+        if (nearby->Covers(swept)) {
+            return bspTreeSystem_->TraceBoxSurfaces(*world_, nearby->GetSurfaces(), start, end, halfExtents, result,
+                                                    FaceFlags::Collidable);
+        }
+    }
+    return bspTreeSystem_->TraceBox(*world_, start, end, halfExtents, result, FaceFlags::Collidable);
 }
 
 bool CollisionSystem::AABBIntersect(const AABB& a, const AABB& b) const {
@@ -259,51 +542,14 @@ Vector3 CollisionSystem::GetAABBNormal(const AABB& a, const AABB& b) const {
 
 bool CollisionSystem::CheckBSPCollision(const Vector3& position, const Vector3& size) const {
     if (!world_) {
-        LOG_INFO("CheckBSPCollision: No BSP tree available");
+        LOG_INFO("CheckBSPCollision: No world geometry available");
         return false;
     }
 
-    // Create AABB from position and size
-    AABB playerBounds;
-    playerBounds.min.x = position.x - size.x / 2.0f;
-    playerBounds.min.y = position.y - size.y / 2.0f;
-    playerBounds.min.z = position.z - size.z / 2.0f;
-    playerBounds.max.x = position.x + size.x / 2.0f;
-    playerBounds.max.y = position.y + size.y / 2.0f;
-    playerBounds.max.z = position.z + size.z / 2.0f;
-
-    // Check collision against all faces in the BSP tree
-    const auto& faces = world_->surfaces;
-    int collidableFaces = 0;
-    int totalFaces = faces.size();
-
-    static int callCount = 0;
-    callCount++;
-    if (callCount % 10 == 0) { // Log every 10th call to avoid spam
-        LOG_INFO("CheckBSPCollision: Total faces: " + std::to_string(totalFaces) +
-                 ", player bounds: (" + std::to_string(playerBounds.min.x) + "," + std::to_string(playerBounds.min.y) + "," + std::to_string(playerBounds.min.z) +
-                 ") to (" + std::to_string(playerBounds.max.x) + "," + std::to_string(playerBounds.max.y) + "," + std::to_string(playerBounds.max.z) + ")");
-    }
-
-    for (const auto& face : faces) {
-        // Skip non-collidable faces
-        if (!HasFlag(face.flags, FaceFlags::Collidable)) continue;
-        collidableFaces++;
-
-        // Simple AABB vs triangle intersection check
-        if (AABBIntersectsTriangle(playerBounds, face.vertices)) {
-            LOG_INFO("COLLISION FOUND with face normal (" +
-                     std::to_string(face.normal.x) + ", " + std::to_string(face.normal.y) + ", " + std::to_string(face.normal.z) + ")");
-            return true;
-        }
-    }
-
-    if (callCount % 10 == 0) { // Log every 10th call to avoid spam
-        LOG_INFO("CheckBSPCollision: Checked " + std::to_string(collidableFaces) + "/" + std::to_string(totalFaces) +
-                 " collidable faces, no collision at (" +
-                 std::to_string(position.x) + ", " + std::to_string(position.y) + ", " + std::to_string(position.z) + ")");
-    }
-    return false;
+    // Box overlap against the collision triangles near it; touching a
+    // surface doesn't count
+    Vector3 half = Vector3Scale(size, 0.5f);
+    return worldBVH_.OverlapsBox(AABB(Vector3Subtract(position, half), Vector3Add(position, half)));
 }
 
 CollisionResponse CollisionSystem::ResolveBSPCollision(const Vector3& position, const Vector3& size) const {
@@ -354,6 +600,12 @@ void CollisionSystem::ResolveEntityCollision(Entity* entityA, Entity* entityB) {
     }
 }
 
+Vector3 CollisionSystem::ClampToAABB(const Vector3& point, const AABB& aabb) const {
+    return {std::clamp(point.x, aabb.min.x, aabb.max.x),
+            std::clamp(point.y, aabb.min.y, aabb.max.y),
+            std::clamp(point.z, aabb.min.z, aabb.max.z)};
+}
+
 float CollisionSystem::GetAABBPenetration(const AABB& a, const AABB& b, Vector3& normal) const {
     // Find overlap on each axis
     float overlapX = std::min(a.max.x - b.min.x, b.max.x - a.min.x);
@@ -374,13 +626,23 @@ float CollisionSystem::GetAABBPenetration(const AABB& a, const AABB& b, Vector3&
 }
 
 void CollisionSystem::BuildSpatialGrid() {
-    // Spatial partitioning for broad phase optimization
-    // This would be implemented for performance with many entities
+    broadphase_.Clear();
+    for (size_t i = 0; i < collidableEntities_.size(); ++i) {
+        const auto* collidable = collidableEntities_[i]->GetComponent<Collidable>();
+        broadphase_.Insert(static_cast<uint32_t>(i), collidable->GetBounds(),
+                           collidable->GetCollisionLayer(), collidable->GetCollisionMask());
+    }
+    broadphase_.Build();
 }
 
 std::vector<Entity*> CollisionSystem::QuerySpatialGrid(const AABB& bounds) const {
-    // Query entities in spatial grid cells
-    return collidableEntities_; // Simplified implementation
+    std::vector<Entity*> result;
+    broadphase_.Query(bounds, queryIds_);
+    result.reserve(queryIds_.size());
+    for (uint32_t id : queryIds_) {
+        if (id < collidableEntities_.size()) result.push_back(collidableEntities_[id]);
+    }
+    return result;
 }
 
 // Helper function to check if AABB intersects with a triangle
@@ -5,6 +5,11 @@
 #include "../Components/Position.h"
 #include "../Components/Velocity.h"
 #include "../../world/WorldGeometry.h"
+#include "../../world/BSPTreeSystem.h"
+#include "../../physics/SpatialHash.h"
+#include "../../physics/DynamicAABBTree.h"
+#include "../../physics/TriangleBVH.h"
+#include "../../physics/CollisionNeighborhood.h"
 #include "../../utils/Logger.h"
 #include <vector>
 #include <unordered_map>
@@ -33,6 +38,18 @@ struct CollisionResponse {
     CollisionResponse() : correction{0,0,0}, reflection{0,0,0}, shouldSlide(true) {}
 };
 
+// First thing a swept sphere touches (SweepSphere)
+struct SweepHit {
+    float fraction = 1.0f;          // Time of impact along start -> end, 0..1
+    Vector3 position{0, 0, 0};      // Sphere center at impact
+    Vector3 point{0, 0, 0};         // Contact point
+    Vector3 normal{0, 0, 0};        // Facing the sweep start
+    Entity* entity = nullptr;       // Entity hit, null for the world
+    int32_t surface = -1;           // world->surfaces index for world hits
+    int materialId = 0;             // Hit surface's material (world hits)
+    uint64_t materialEntityId = 0;
+};
+
 /**
  * Hybrid collision system that handles both BSP geometry and entity-to-entity collisions
  */
@@ -46,11 +63,21 @@ public:
     void Initialize() override;
     void Shutdown() override;
 
-    // World geometry integration (replaces old BSP integration)
-    void SetWorld(const World* world) { world_ = world; }
+    // Entity-entity contacts: re-sync the colliders, then push overlapping
+    // pairs apart island by island. PhysicsSystem runs this once per tick
+    // (after moving bodies against the world), so contacts follow the sim
+    // clock rather than the frame rate.
+    void ResolveEntityContacts();
+
+    // World geometry integration (replaces old BSP integration). Setting a
+    // world builds the collision triangle BVH.
+    void SetWorld(const World* world);
     bool HasWorldGeometry() const { return world_ != nullptr; }
     const World* GetWorld() const { return world_; }
 
+    // World traces walk the BSP through this system (set up by Engine)
+    void SetBSPTreeSystem(const BSPTreeSystem* bspTreeSystem) { bspTreeSystem_ = bspTreeSystem; }
+
     // Collision queries
     bool CheckCollision(const Collidable& a, const Collidable& b) const;
     bool CheckCollisionWithWorld(const Collidable& entity, const Vector3& position) const;
@@ -66,6 +93,36 @@ public:
     bool CastRayWorldOnly(const Vector3& origin, const Vector3& direction, float maxDistance,
                          Vector3& hitPoint, Vector3& hitNormal) const;
 
+    // Continuous collision: sphere (radius 0 for a point) moving start -> end
+    // against the world triangles and the entity colliders on layerMask.
+    // Reports the earliest impact. Entities the sphere starts inside are
+    // skipped, so a projectile leaving its shooter doesn't hit it.
+    bool SweepSphere(const Vector3& start, const Vector3& end, float radius, uint32_t layerMask,
+                     const Entity* ignore, SweepHit& outHit) const;
+
+    // Region queries against entity colliders (exact bounds, layer filtered);
+    // explosions, trigger volumes, AI perception
+    void QueryAABB(const AABB& bounds, std::vector<Entity*>& outEntities, uint32_t layerMask = LAYER_ALL) const;
+    void QuerySphere(const Vector3& center, float radius, std::vector<Entity*>& outEntities,
+                     uint32_t layerMask = LAYER_ALL) const;
+
+    // Collidable world surfaces near bounds (sorted indices into world->surfaces)
+    void QueryWorldSurfaces(const AABB& bounds, std::vector<uint32_t>& outSurfaces) const;
+    // World surfaces overlapping bounds (exact, batched SAT), one contact per
+    // surface with its deepest triangle, sorted by surface
+    void GetWorldContacts(const AABB& bounds, std::vector<TriangleBVH::Contact>& outContacts) const;
+    const TriangleBVH& GetWorldBVH() const { return worldBVH_; }
+
+    // World candidates around region for a run of probes in the same spot
+    void GatherNeighborhood(const AABB& region, CollisionNeighborhood& outNeighborhood) const {
+        outNeighborhood.Gather(worldBVH_, region);
+    }
+
+    // Swept box against the world's collidable surfaces (box center start -> end).
+    // With a neighborhood covering the swept box only its surfaces are traced.
+    bool TraceBoxWorld(const Vector3& start, const Vector3& end, const Vector3& halfExtents,
+                       BSPTraceResult& result, const CollisionNeighborhood* nearby = nullptr) const;
+
     // Collision detection helpers (public access for physics system)
     bool CheckAABBIntersectsTriangle(const AABB& aabb, const std::vector<Vector3>& triangle) const {
         return AABBIntersectsTriangle(aabb, triangle);
@@ -74,6 +131,11 @@ public:
         return CalculatePenetrationDepth(aabb, triangle, normal);
     }
 
+    // Entity broadphase: spatial hash rebuilt every update; cells should be
+    // about the size of a typical collider
+    void SetBroadphaseCellSize(float cellSize) { broadphase_.SetCellSize(cellSize); }
+    const SpatialHash::Stats& GetBroadphaseStats() const { return broadphase_.GetStats(); }
+
     // Debug visualization
     void SetDebugBoundsVisible(bool visible) { debugBoundsVisible_ = visible; }
     bool IsDebugBoundsVisible() const { return debugBoundsVisible_; }
@@ -87,8 +149,13 @@ public:
 
 private:
     const World* world_;  // New World structure instead of old BSPTree
+    const BSPTreeSystem* bspTreeSystem_;
     bool debugBoundsVisible_;
 
+    // Overlap and ray queries against the world's collidable triangles
+    TriangleBVH worldBVH_;
+    mutable std::vector<TriangleBVH::Contact> worldContactScratch_;
+
     // Cached collision data for optimization
     std::vector<Entity*> collidableEntities_;
 
@@ -119,4 +186,36 @@ private:
     // Broad phase optimization
     void BuildSpatialGrid();
     std::vector<Entity*> QuerySpatialGrid(const AABB& bounds) const;
+
+    SpatialHash broadphase_;                            // ids index collidableEntities_
+    std::vector<SpatialHash::Pair> candidatePairs_;
+    mutable std::vector<uint32_t> queryIds_;
+
+    // Contact islands for CheckEntityCollisions (union-find over
+    // collidableEntities_ indices; an island is named by its root)
+    static constexpr size_t ISLAND_GRAIN = 8;  // Islands per job
+    uint32_t FindIsland(uint32_t collider);
+    std::vector<uint32_t> islandParent_;
+    std::vector<uint8_t> islandPushable_;   // Non-static, non-trigger
+    std::vector<uint32_t> pairIslands_;     // Per candidate pair
+    std::vector<uint32_t> islandStart_;     // Per root: first slot in islandPairs_
+    std::vector<uint32_t> islandCursor_;
+    std::vector<uint32_t> islandPairs_;     // Pair indices grouped by island
+    std::vector<uint32_t> islands_;         // Roots with at least one pair
+    std::vector<uint8_t> pairHits_;
+
+    // Query trees: moving colliders get fat boxes refit incrementally, static
+    // ones sit in their own tight tree. Synced in UpdateCollidableEntities.
+    struct ColliderProxy {
+        int32_t proxyId;
+        bool isStatic;
+        Vector3 lastCenter;
+        uint32_t lastSeen;
+    };
+    void SyncColliderProxies();
+
+    DynamicAABBTree dynamicTree_;
+    DynamicAABBTree staticTree_{0.0f};
+    std::unordered_map<Entity*, ColliderProxy> colliderProxies_;
+    uint32_t syncStamp_ = 0;
 };
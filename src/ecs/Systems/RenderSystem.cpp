@@ -3,6 +3,7 @@
 #include "../../ecs/Components/Position.h"
 #include "../../ecs/Components/Sprite.h"
 #include "../../ecs/Components/MeshComponent.h"
+#include "../../ecs/Components/Collidable.h"
 #include "../../ecs/Systems/MeshSystem.h"  // Include before Engine.h for template instantiation
 #include "../../ecs/Systems/WorldSystem.h"
 #include "../../ecs/Systems/LightSystem.h"
@@ -10,6 +11,8 @@
 #include "../../shaders/ShaderSystem.h"
 #include "../../core/Engine.h"
 #include "../../utils/Logger.h"
+#include <algorithm>
+#include <cmath>
 
 RenderSystem::RenderSystem()
     : meshSystem_(nullptr), assetSystem_(nullptr), bspTree_(nullptr),
@@ -153,6 +156,10 @@ void RenderSystem::CollectRenderCommands()
     cullingCamera_.fovy = renderer_.GetCameraZoom();
     cullingCamera_.projection = CAMERA_PERSPECTIVE;
 
+    // One frustum per frame, shared by entity culling and the BSP traversal
+    renderer_.UpdateViewFrustum();
+    renderer_.UpdateOcclusion();
+
     // Collect world geometry commands first (static geometry)
     CollectWorldGeometryCommands();
 
@@ -276,6 +283,8 @@ void RenderSystem::CollectRenderCommands()
         processedCount++;
     }
 
+    culledCount += CullOccludedCommands();
+
     LOG_DEBUG("RenderSystem summary:");
     LOG_DEBUG("  - Total entities: " + std::to_string(entities.size()));
     LOG_DEBUG("  - Processed: " + std::to_string(processedCount));
@@ -284,6 +293,91 @@ void RenderSystem::CollectRenderCommands()
     LOG_DEBUG("  - Final render commands: " + std::to_string(renderCommands_.size()));
 }
 
+// Entities behind pillars and walls in the same room pass both the PVS and the
+// frustum; drop the ones the CPU occlusion buffer says are hidden
+int RenderSystem::CullOccludedCommands()
+{
+    if (!renderer_.IsOcclusionCullingEnabled()) return 0;
+
+    occlusionBounds_.clear();
+    occlusionCommands_.clear();
+    for (size_t i = 0; i < renderCommands_.size(); ++i) {
+        const RenderCommand& command = renderCommands_[i];
+        if (command.type != RenderType::MESH_3D && command.type != RenderType::PRIMITIVE_3D &&
+            command.type != RenderType::SPRITE_2D) continue;
+        if (!command.transform) continue;
+
+        // A box smaller than what gets drawn could hide it while part of it
+        // shows, so commands without known bounds are never tested
+        AABB bounds;
+        if (!GetCommandWorldBounds(command, bounds)) continue;
+        occlusionBounds_.push_back(bounds);
+        occlusionCommands_.push_back(i);
+    }
+    if (occlusionBounds_.empty()) return 0;
+
+    occlusionVisible_.assign(occlusionBounds_.size(), 1);
+    size_t visible = renderer_.CullOccludedAABBs(occlusionBounds_.data(), occlusionBounds_.size(),
+                                                 occlusionVisible_.data());
+    if (visible == occlusionBounds_.size()) return 0;
+
+    // Compact in place, keeping command order
+    size_t write = 0, next = 0;
+    for (size_t read = 0; read < renderCommands_.size(); ++read) {
+        bool occluded = next < occlusionCommands_.size() && occlusionCommands_[next] == read &&
+                        !occlusionVisible_[next];
+        if (next < occlusionCommands_.size() && occlusionCommands_[next] == read) next++;
+        if (occluded) continue;
+        if (write != read) renderCommands_[write] = renderCommands_[read];
+        write++;
+    }
+    int culled = static_cast<int>(renderCommands_.size() - write);
+    renderCommands_.erase(renderCommands_.begin() + write, renderCommands_.end());
+    return culled;
+}
+
+bool RenderSystem::GetCommandWorldBounds(const RenderCommand& command, AABB& outBounds) const
+{
+    const TransformComponent& transform = *command.transform;
+
+    // Mesh vertices, through the same scale, rotation and translation DrawMesh3D uses
+    if (command.mesh && command.mesh->meshType != MeshComponent::MeshType::COMPOSITE &&
+        !command.mesh->vertices.empty()) {
+        AABB local = AABB::Infinite();
+        for (const MeshVertex& vertex : command.mesh->vertices) local.Encapsulate(vertex.position);
+
+        outBounds = AABB::Infinite();
+        for (int corner = 0; corner < 8; ++corner) {
+            Vector3 point = {(corner & 1) ? local.max.x : local.min.x, (corner & 2) ? local.max.y : local.min.y,
+                             (corner & 4) ? local.max.z : local.min.z};
+            point = Vector3Multiply(point, transform.scale);
+            point = Vector3RotateByQuaternion(point, transform.rotation);
+            outBounds.Encapsulate(Vector3Add(point, transform.position));
+        }
+        return true;
+    }
+
+    // Billboards turn to face the camera: cover the sprite's diagonal in every direction
+    if (command.type == RenderType::SPRITE_2D && command.sprite && command.sprite->IsTextureLoaded()) {
+        Texture2D texture = command.sprite->GetTexture();
+        float scale = fabsf(command.sprite->GetScale());
+        float radius = 0.5f * scale * sqrtf(static_cast<float>(texture.width) * texture.width +
+                                            static_cast<float>(texture.height) * texture.height);
+        Vector3 half = {radius, radius, radius};
+        outBounds = AABB(Vector3Subtract(transform.position, half), Vector3Add(transform.position, half));
+        return true;
+    }
+
+    // Composite meshes and the like: the collider, when the entity has one
+    if (command.entity) {
+        if (const auto* collidable = command.entity->GetComponent<Collidable>()) {
+            outBounds = collidable->GetBounds();
+            return true;
+        }
+    }
+    return false;
+}
+
 void RenderSystem::SortRenderCommands()
 {
     // Enhanced sorting for material batching:
@@ -89,8 +89,15 @@ private:
 
     std::vector<RenderCommand> renderCommands_;
 
+    // Occlusion test scratch, reused every frame
+    std::vector<AABB> occlusionBounds_;
+    std::vector<uint8_t> occlusionVisible_;
+    std::vector<size_t> occlusionCommands_;
+
     void CollectRenderCommands();
     void CollectWorldGeometryCommands();
+    int CullOccludedCommands();
+    bool GetCommandWorldBounds(const RenderCommand& command, AABB& outBounds) const;
     void RenderWorldGeometryDirect();
     void SortRenderCommands();
     void ExecuteRenderCommands();
@@ -16,6 +16,7 @@
 #include "../../utils/Logger.h"
 #include "../../utils/PathUtils.h"
 #include "../../world/EntityFactory.h"
+#include "../../world/WorldCache.h"
 #include "../Systems/GameObjectSystem.h"
 #include "../Systems/LightSystem.h"
 #include <unordered_map>
@@ -100,19 +101,21 @@ bool WorldSystem::LoadDefaultMap() {
     // Load the YAML test map file
     std::string exeDir = Utils::GetExecutableDir();
     std::string testMapPath = exeDir + "/assets/maps/test_level_yaml.map";
-    MapData mapData = mapLoader_.LoadMap(testMapPath);
+    MapData mapData = LoadMapFile(testMapPath);
 
     // If that fails, try CWD-relative
     if (mapData.entities.empty()) {
         LOG_WARNING("Failed to load YAML map from exe-relative path, trying CWD-relative");
         testMapPath = "assets/maps/test_level_yaml.map";
-        mapData = mapLoader_.LoadMap(testMapPath);
+        mapData = LoadMapFile(testMapPath);
     }
 
     // Try to load YAML map first
     if (!mapData.entities.empty()) {
         // YAML entities loaded successfully
-        if (mapData.faces.empty()) {
+        if (mapData.worldFromCache) {
+            LOG_INFO("YAML map loaded with geometry from the compiled world cache");
+        } else if (mapData.faces.empty()) {
             LOG_ERROR("YAML has entities but no geometry - this shouldn't happen with the new map");
             return false;
         } else {
@@ -201,17 +204,17 @@ bool WorldSystem::LoadMap(const std::string& mapPath) {
     UnloadMap();
 
     // Load and parse map file into raw MapData with path resolution
-    MapData mapData = mapLoader_.LoadMap(mapPath);
+    MapData mapData = LoadMapFile(mapPath);
 
     // If direct path fails, try executable-relative
-    if (mapData.faces.empty()) {
+    if (mapData.faces.empty() && !mapData.worldFromCache) {
         std::string exeDir = Utils::GetExecutableDir();
         std::string exeRelativePath = exeDir + "/" + mapPath;
         LOG_WARNING("Direct map path failed, trying exe-relative: " + exeRelativePath);
-        mapData = mapLoader_.LoadMap(exeRelativePath);
+        mapData = LoadMapFile(exeRelativePath);
     }
 
-    if (mapData.faces.empty()) {
+    if (mapData.faces.empty() && !mapData.worldFromCache) {
         LOG_WARNING("Failed to load map from file: " + mapPath + " - falling back to programmatic creation");
         // TEMPORARY: Fall back to programmatic creation for testing
         mapData = CreateTestMap();
@@ -292,6 +295,40 @@ void WorldSystem::UnloadMap() {
     }
 }
 
+// Parse a map file, reusing its compiled world cache when the file hasn't changed.
+// On a hit the YAML world block is skipped entirely and BuildBSPTreeAfterMaterials
+// takes the cached world instead of compiling one.
+MapData WorldSystem::LoadMapFile(const std::string& mapPath) {
+    cachedWorld_.reset();
+    cachedBatches_.clear();
+
+    // The mapc cache first; the game's own unlit compile only stands in while
+    // that one is missing or stale
+    uint64_t key = WorldCache::ComputeKey(mapPath);
+    if (key != 0) {
+        cachedWorld_ = WorldCache::Load(WorldCache::GetCachePath(mapPath), key, cachedBatches_);
+        if (!cachedWorld_) {
+            cachedWorld_ = WorldCache::Load(WorldCache::GetRuntimeCachePath(mapPath), key, cachedBatches_);
+        }
+    }
+
+    mapLoader_.SetSkipWorldGeometry(cachedWorld_ != nullptr);
+    MapData mapData = mapLoader_.LoadMap(mapPath);
+    mapLoader_.SetSkipWorldGeometry(false);
+
+    // An empty name means the loader failed and returned a blank MapData
+    if (mapData.name.empty()) {
+        cachedWorld_.reset();
+        cachedBatches_.clear();
+        return mapData;
+    }
+
+    mapData.sourcePath = mapPath;
+    mapData.sourceKey = key;
+    mapData.worldFromCache = cachedWorld_ != nullptr;
+    return mapData;
+}
+
 // NEW ARCHITECTURE: Main processing pipeline
 void WorldSystem::ProcessMapData(MapData& mapData) {
     LOG_INFO("Processing MapData through UNIFIED pipeline...");
@@ -328,12 +365,23 @@ void WorldSystem::ProcessMapData(MapData& mapData) {
 
     // Step 3: Build BSP tree now that materials are loaded and faces have materialEntityId
     LOG_INFO("ProcessMapData: Calling BuildBSPTreeAfterMaterials");
-    BuildBSPTreeAfterMaterials();
+    BuildBSPTreeAfterMaterials(mapData);
 
     // Step 4: Create render batches
     LOG_INFO("ProcessMapData: Calling CreateRenderBatches");
     CreateRenderBatches(mapData);
 
+    // Step 4b: Store the compiled world so the next load of this map skips the build.
+    // Lightmaps are too slow to bake at load time; paintsplash_mapc bakes them.
+    // The unlit result goes beside the mapc cache, never over it.
+    if (!mapData.worldFromCache && mapData.sourceKey != 0 && worldGeometry_->GetWorld()) {
+        LOG_INFO("World compiled at load time has no baked lightmaps (run paintsplash_mapc to bake them)");
+        WorldCacheBuild build;
+        build.mergedFaces = bspTreeSystem_ && bspTreeSystem_->IsFaceMerging() ? 1 : 0;
+        WorldCache::Save(WorldCache::GetRuntimeCachePath(mapData.sourcePath), mapData.sourceKey, build,
+                         *worldGeometry_->GetWorld(), worldGeometry_->batches);
+    }
+
     // Step 4: Setup skybox
     LOG_INFO("ProcessMapData: Calling SetupSkybox");
     SetupSkybox(mapData);
@@ -355,6 +403,7 @@ void WorldSystem::BuildWorldGeometry(MapData& mapData) {
     // Set basic level info
     worldGeometry_->SetLevelName(mapData.name);
     worldGeometry_->SetSkyColor(mapData.skyColor);
+    worldGeometry_->areaPortalBrushes = mapData.areaPortals;
 
     // Initialize materials map with default WorldMaterial objects for each material ID used in faces
     usedMaterialIds_.clear(); // Clear previous material IDs
@@ -452,21 +501,25 @@ void WorldSystem::BuildWorldGeometry(MapData& mapData) {
 
         // BSP tree will be built later in the pipeline after materials are loaded
         LOG_INFO("BuildWorldGeometry: BSP tree building deferred until after material loading");
+    } else if (mapData.worldFromCache) {
+        LOG_INFO("BuildWorldGeometry: geometry comes from the compiled world cache");
     } else {
         LOG_WARNING("No brushes or faces in MapData; WorldGeometry will be empty");
     }
 }
 
-// NEW: Create render batches (placeholder for now)
+// Build the static world batches from the compiled surfaces, ranged by vis cluster
 void WorldSystem::CreateRenderBatches(const MapData& mapData) {
-    LOG_INFO("Creating render batches");
-
-    // Placeholder: batching for faces (future)
-    std::unordered_map<int, int> faceCounts;
-    for (const auto& f : mapData.faces) {
-        faceCounts[f.materialId]++;
+    if (!worldGeometry_ || !worldGeometry_->GetWorld()) {
+        LOG_WARNING("CreateRenderBatches: no compiled world");
+        return;
     }
-    LOG_INFO("Counted faces across materials: " + std::to_string(faceCounts.size()) + " groups");
+    if (mapData.worldFromCache) {
+        LOG_INFO("Render batches taken from the compiled world cache (" +
+                 std::to_string(worldGeometry_->batches.size()) + " batches)");
+        return;
+    }
+    worldGeometry_->BuildBatchesFromWorld(*worldGeometry_->GetWorld());
 }
 
 // Load textures and create materials using AssetSystem
@@ -617,7 +670,7 @@ void WorldSystem::LoadTexturesAndMaterials(const MapData& mapData) {
     // BSP tree will be built later in the pipeline with properly material-assigned faces
 }
 
-void WorldSystem::BuildBSPTreeAfterMaterials() {
+void WorldSystem::BuildBSPTreeAfterMaterials(const MapData& mapData) {
     LOG_INFO("=== BuildBSPTreeAfterMaterials STARTED ===");
     LOG_INFO("Building BSP tree with material-assigned faces");
 
@@ -633,6 +686,18 @@ void WorldSystem::BuildBSPTreeAfterMaterials() {
         return;
     }
 
+    // Compiled world cache hit: nodes, PVS and batches are already built
+    if (mapData.worldFromCache && cachedWorld_) {
+        worldGeometry_->SetWorld(std::move(cachedWorld_));
+        worldGeometry_->batches = std::move(cachedBatches_);
+        cachedBatches_.clear();
+        LOG_INFO("Quake-style world taken from the compiled world cache with " +
+                 std::to_string(worldGeometry_->GetWorld()->surfaces.size()) + " surfaces, " +
+                 std::to_string(worldGeometry_->GetWorld()->lightmaps.size()) + " lightmap pages, " +
+                 std::to_string(worldGeometry_->GetWorld()->probes.size()) + " irradiance probes");
+        return;
+    }
+
     LOG_DEBUG("worldGeometry_->faces.size(): " + std::to_string(worldGeometry_->faces.size()));
     if (worldGeometry_->faces.empty()) {
         LOG_WARNING("No faces available for BSP tree building");
@@ -640,7 +705,7 @@ void WorldSystem::BuildBSPTreeAfterMaterials() {
     }
     
     // Build Quake-style world using the material-assigned faces from worldGeometry
-    auto world = bspTreeSystem_->LoadWorld(worldGeometry_->faces);
+    auto world = bspTreeSystem_->LoadWorld(worldGeometry_->faces, worldGeometry_->areaPortalBrushes);
 
     if (!world) {
         LOG_ERROR("Failed to build Quake-style world");
@@ -893,9 +958,13 @@ bool WorldSystem::ContainsPoint(const Vector3& point) const {
 
 // DELEGATED: Ray casting
 float WorldSystem::CastRay(const Vector3& origin, const Vector3& direction, float maxDistance) const {
-    // TODO: Implement ray casting using new World system
-    // For now, return maxDistance (no hit)
-    return maxDistance;
+    const World* world = GetWorld();
+    if (!world || !bspTreeSystem_) return maxDistance;
+
+    Vector3 end = Vector3Add(origin, Vector3Scale(Vector3Normalize(direction), maxDistance));
+    BSPTraceResult trace;
+    if (!bspTreeSystem_->TraceLine(*world, origin, end, trace, FaceFlags::Collidable)) return maxDistance;
+    return trace.fraction * maxDistance;
 }
 
 bool WorldSystem::FindSpawnPoint(Vector3& spawnPoint) const {
@@ -89,10 +89,15 @@ private:
     // Persistent material ID tracking
     std::unordered_set<int> usedMaterialIds_; // Set of material IDs used in the current map
 
+    // Compiled world cache hit for the map being loaded, consumed by BuildBSPTreeAfterMaterials
+    std::unique_ptr<World> cachedWorld_;
+    std::vector<WorldGeometry::StaticBatch> cachedBatches_;
+
     // Map building pipeline
+    MapData LoadMapFile(const std::string& mapPath);
     void ProcessMapData(MapData& mapData);
     void BuildWorldGeometry(MapData& mapData);
-    void BuildBSPTreeAfterMaterials();
+    void BuildBSPTreeAfterMaterials(const MapData& mapData);
     void CreateRenderBatches(const MapData& mapData);
     void LoadTexturesAndMaterials(const MapData& mapData);
     void LoadTexturesLegacy(const MapData& mapData); // Fallback when AssetSystem unavailable
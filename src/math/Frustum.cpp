@@ -0,0 +1,213 @@
+#include "Frustum.h"
+#include "SIMD.h"
+#include "raymath.h"
+#include <cmath>
+
+void Frustum::Extract(const Camera3D& camera, float aspect, float nearDistance, float farDistance) {
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+    const Vector3& eye = camera.position;
+
+    if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+        // fovy is the view height in world units for orthographic cameras
+        float halfHeight = camera.fovy * 0.5f;
+        float halfWidth = halfHeight * aspect;
+        planes[0].normal = right;
+        planes[0].dist = -Vector3DotProduct(right, eye) + halfWidth;
+        planes[1].normal = Vector3Negate(right);
+        planes[1].dist = Vector3DotProduct(right, eye) + halfWidth;
+        planes[2].normal = up;
+        planes[2].dist = -Vector3DotProduct(up, eye) + halfHeight;
+        planes[3].normal = Vector3Negate(up);
+        planes[3].dist = Vector3DotProduct(up, eye) + halfHeight;
+    } else {
+        // Side planes pass through the eye; each normal points inward, tilted
+        // towards forward by the tangent of the half field of view
+        float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+        float tanX = tanY * aspect;
+        planes[0].normal = Vector3Normalize(Vector3Add(right, Vector3Scale(forward, tanX)));                // left
+        planes[1].normal = Vector3Normalize(Vector3Add(Vector3Negate(right), Vector3Scale(forward, tanX))); // right
+        planes[2].normal = Vector3Normalize(Vector3Add(up, Vector3Scale(forward, tanY)));                   // bottom
+        planes[3].normal = Vector3Normalize(Vector3Add(Vector3Negate(up), Vector3Scale(forward, tanY)));    // top
+        for (int i = 0; i < 4; ++i) {
+            planes[i].dist = -Vector3DotProduct(planes[i].normal, eye);
+        }
+    }
+
+    // Near plane
+    planes[4].normal = forward;
+    planes[4].dist = -Vector3DotProduct(forward, Vector3Add(eye, Vector3Scale(forward, nearDistance)));
+
+    // Far plane
+    planes[5].normal = Vector3Negate(forward);
+    planes[5].dist = Vector3DotProduct(forward, Vector3Add(eye, Vector3Scale(forward, farDistance)));
+
+    numPlanes = 6;
+    FinalizePlanes();
+}
+
+void Frustum::FinalizePlanes() {
+    for (int i = 0; i < 8; ++i) {
+        if (i < numPlanes) {
+            const FrustumPlane& plane = planes[i];
+            planeX[i] = plane.normal.x;
+            planeY[i] = plane.normal.y;
+            planeZ[i] = plane.normal.z;
+            planeD[i] = plane.dist;
+        } else {
+            // Padding lane: distance is always +1, so it never rejects anything
+            planeX[i] = planeY[i] = planeZ[i] = 0.0f;
+            planeD[i] = 1.0f;
+        }
+        absX[i] = fabsf(planeX[i]);
+        absY[i] = fabsf(planeY[i]);
+        absZ[i] = fabsf(planeZ[i]);
+    }
+}
+
+bool Frustum::TestAABB(const Vector3& mins, const Vector3& maxs, uint32_t& planeMask) const {
+    if (planeMask == 0) return true; // Parent was fully inside every plane
+
+    // Center/extents form: signed distance of the center +/- projected radius
+    // gives the farthest and nearest corners without picking vertices per plane
+    float cx = (mins.x + maxs.x) * 0.5f, cy = (mins.y + maxs.y) * 0.5f, cz = (mins.z + maxs.z) * 0.5f;
+    float ex = (maxs.x - mins.x) * 0.5f, ey = (maxs.y - mins.y) * 0.5f, ez = (maxs.z - mins.z) * 0.5f;
+
+    uint32_t outside = 0, inside = 0;
+
+#if defined(PAINTSPLASH_AVX)
+    __m256 dist = _mm256_add_ps(_mm256_add_ps(
+        _mm256_mul_ps(_mm256_load_ps(planeX), _mm256_set1_ps(cx)),
+        _mm256_mul_ps(_mm256_load_ps(planeY), _mm256_set1_ps(cy))),
+        _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(planeZ), _mm256_set1_ps(cz)), _mm256_load_ps(planeD)));
+    __m256 radius = _mm256_add_ps(_mm256_add_ps(
+        _mm256_mul_ps(_mm256_load_ps(absX), _mm256_set1_ps(ex)),
+        _mm256_mul_ps(_mm256_load_ps(absY), _mm256_set1_ps(ey))),
+        _mm256_mul_ps(_mm256_load_ps(absZ), _mm256_set1_ps(ez)));
+    outside = static_cast<uint32_t>(_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_LT_OQ)));
+    inside = static_cast<uint32_t>(_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_sub_ps(dist, radius), _mm256_setzero_ps(), _CMP_GE_OQ)));
+#elif defined(PAINTSPLASH_SSE)
+    const __m128 vcx = _mm_set1_ps(cx), vcy = _mm_set1_ps(cy), vcz = _mm_set1_ps(cz);
+    const __m128 vex = _mm_set1_ps(ex), vey = _mm_set1_ps(ey), vez = _mm_set1_ps(ez);
+    const __m128 zero = _mm_setzero_ps();
+    for (int block = 0; block < 8; block += 4) {
+        __m128 dist = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_load_ps(planeX + block), vcx),
+            _mm_mul_ps(_mm_load_ps(planeY + block), vcy)),
+            _mm_add_ps(_mm_mul_ps(_mm_load_ps(planeZ + block), vcz), _mm_load_ps(planeD + block)));
+        __m128 radius = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(_mm_load_ps(absX + block), vex),
+            _mm_mul_ps(_mm_load_ps(absY + block), vey)),
+            _mm_mul_ps(_mm_load_ps(absZ + block), vez));
+        outside |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), zero))) << block;
+        inside |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_sub_ps(dist, radius), zero))) << block;
+    }
+#else
+    for (int i = 0; i < numPlanes; ++i) {
+        if (!(planeMask & (1u << i))) continue;
+        float dist = planeX[i] * cx + planeY[i] * cy + planeZ[i] * cz + planeD[i];
+        float radius = absX[i] * ex + absY[i] * ey + absZ[i] * ez;
+        if (dist + radius < 0.0f) outside |= 1u << i;
+        if (dist - radius >= 0.0f) inside |= 1u << i;
+    }
+#endif
+
+    if (outside & planeMask) return false;
+    planeMask &= ~inside;
+    return true;
+}
+
+bool Frustum::ContainsPoint(const Vector3& point) const {
+    return IntersectsSphere(point, 0.0f);
+}
+
+bool Frustum::IntersectsSphere(const Vector3& center, float radius) const {
+    for (int i = 0; i < numPlanes; ++i) {
+        if (Vector3DotProduct(planes[i].normal, center) + planes[i].dist < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t Frustum::CullAABBs(const AABB* boxes, size_t count, uint8_t* outVisible) const {
+    size_t visible = 0;
+    size_t i = 0;
+
+#if defined(PAINTSPLASH_AVX) || defined(PAINTSPLASH_SSE)
+    #if defined(PAINTSPLASH_AVX)
+    constexpr size_t LANES = 8;
+    #else
+    constexpr size_t LANES = 4;
+    #endif
+
+    // Boxes are transposed into SoA blocks so each instruction tests one plane
+    // against LANES boxes at once
+    alignas(32) float cx[LANES], cy[LANES], cz[LANES], ex[LANES], ey[LANES], ez[LANES];
+
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t k = 0; k < LANES; ++k) {
+            const AABB& box = boxes[i + k];
+            cx[k] = (box.min.x + box.max.x) * 0.5f;
+            cy[k] = (box.min.y + box.max.y) * 0.5f;
+            cz[k] = (box.min.z + box.max.z) * 0.5f;
+            ex[k] = (box.max.x - box.min.x) * 0.5f;
+            ey[k] = (box.max.y - box.min.y) * 0.5f;
+            ez[k] = (box.max.z - box.min.z) * 0.5f;
+        }
+
+    #if defined(PAINTSPLASH_AVX)
+        const __m256 vcx = _mm256_load_ps(cx), vcy = _mm256_load_ps(cy), vcz = _mm256_load_ps(cz);
+        const __m256 vex = _mm256_load_ps(ex), vey = _mm256_load_ps(ey), vez = _mm256_load_ps(ez);
+        __m256 outside = _mm256_setzero_ps();
+        for (int p = 0; p < numPlanes; ++p) {
+            __m256 dist = _mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(planeX[p]), vcx),
+                _mm256_mul_ps(_mm256_set1_ps(planeY[p]), vcy)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planeZ[p]), vcz), _mm256_set1_ps(planeD[p])));
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(_mm256_set1_ps(absX[p]), vex),
+                _mm256_mul_ps(_mm256_set1_ps(absY[p]), vey)),
+                _mm256_mul_ps(_mm256_set1_ps(absZ[p]), vez));
+            outside = _mm256_or_ps(outside,
+                _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+        }
+        int outsideBits = _mm256_movemask_ps(outside);
+    #else
+        const __m128 vcx = _mm_load_ps(cx), vcy = _mm_load_ps(cy), vcz = _mm_load_ps(cz);
+        const __m128 vex = _mm_load_ps(ex), vey = _mm_load_ps(ey), vez = _mm_load_ps(ez);
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < numPlanes; ++p) {
+            __m128 dist = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(planeX[p]), vcx),
+                _mm_mul_ps(_mm_set1_ps(planeY[p]), vcy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planeZ[p]), vcz), _mm_set1_ps(planeD[p])));
+            __m128 radius = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(_mm_set1_ps(absX[p]), vex),
+                _mm_mul_ps(_mm_set1_ps(absY[p]), vey)),
+                _mm_mul_ps(_mm_set1_ps(absZ[p]), vez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+        }
+        int outsideBits = _mm_movemask_ps(outside);
+    #endif
+
+        for (size_t k = 0; k < LANES; ++k) {
+            uint8_t isVisible = (outsideBits & (1 << k)) ? 0 : 1;
+            outVisible[i + k] = isVisible;
+            visible += isVisible;
+        }
+    }
+#endif
+
+    // Remainder (or everything, without SIMD)
+    for (; i < count; ++i) {
+        uint8_t isVisible = IntersectsAABB(boxes[i]) ? 1 : 0;
+        outVisible[i] = isVisible;
+        visible += isVisible;
+    }
+
+    return visible;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "raylib.h"
+#include "AABB.h"
+#include <cstddef>
+#include <cstdint>
+
+// Frustum plane for culling (like Quake 3's cplane_s)
+// A point p is inside when Dot(normal, p) + dist >= 0
+struct FrustumPlane {
+    Vector3 normal;
+    float dist;
+};
+
+// Plane mask with every frustum plane still to be tested
+constexpr uint32_t FRUSTUM_ALL_PLANES = 0x3F;
+
+// View frustum with 6 inward-facing planes. Extracted once per view per frame
+// and shared by BSP traversal and entity culling. Planes are also kept in SoA
+// form (one plane per SIMD lane) for the vectorized tests.
+struct Frustum {
+    FrustumPlane planes[6]; // left, right, bottom, top, near, far
+    int numPlanes = 6;
+
+    // SoA copy; lanes 6/7 hold padding planes that accept everything
+    alignas(32) float planeX[8];
+    alignas(32) float planeY[8];
+    alignas(32) float planeZ[8];
+    alignas(32) float planeD[8];
+    alignas(32) float absX[8];
+    alignas(32) float absY[8];
+    alignas(32) float absZ[8];
+
+    // Build the planes from a camera (perspective or orthographic)
+    void Extract(const Camera3D& camera, float aspect, float nearDistance, float farDistance);
+
+    // Hierarchical AABB test. planeMask holds the planes still to be tested
+    // (start with FRUSTUM_ALL_PLANES). Planes the box is fully inside are
+    // cleared, so children of a node can inherit the mask and skip them.
+    // Returns false when the box is completely outside.
+    bool TestAABB(const Vector3& mins, const Vector3& maxs, uint32_t& planeMask) const;
+    bool IntersectsAABB(const AABB& box) const {
+        uint32_t mask = FRUSTUM_ALL_PLANES;
+        return TestAABB(box.min, box.max, mask);
+    }
+
+    bool ContainsPoint(const Vector3& point) const;
+    bool IntersectsSphere(const Vector3& center, float radius) const;
+
+    // Batch test: outVisible[i] = 1 if boxes[i] touches the frustum.
+    // Processes 8 boxes per step with AVX, 4 with SSE. Returns the visible count.
+    size_t CullAABBs(const AABB* boxes, size_t count, uint8_t* outVisible) const;
+
+private:
+    void FinalizePlanes();
+};
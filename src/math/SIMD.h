@@ -0,0 +1,20 @@
+#pragma once
+
+// SIMD feature selection shared by the culling and collision kernels.
+// SSE2 is baseline on x86-64; AVX kernels are only compiled in when the
+// compiler targets AVX (PAINTSPLASH_ENABLE_AVX in CMake). Everything has a
+// scalar fallback so ARM builds keep working.
+
+#if defined(__AVX__)
+    #define PAINTSPLASH_AVX 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PAINTSPLASH_SSE 1
+#endif
+
+#if defined(PAINTSPLASH_AVX)
+    #include <immintrin.h>
+#elif defined(PAINTSPLASH_SSE)
+    #include <emmintrin.h>
+#endif
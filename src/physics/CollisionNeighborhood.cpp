@@ -0,0 +1,65 @@
+#include "CollisionNeighborhood.h"
+#include "raymath.h"
+#include <algorithm>
+
+void CollisionNeighborhood::Gather(const TriangleBVH& bvh, const AABB& region) {
+    bvh_ = &bvh;
+    region_ = region;
+    bvh.QueryTriangles(region, triangles_);
+
+    surfaces_.clear();
+    soa_.Resize(triangles_.size());
+    for (size_t i = 0; i < triangles_.size(); ++i) {
+        const TriangleBVH::Triangle& triangle = bvh.GetTriangle(triangles_[i]);
+        soa_.Set(i, triangle.v0, triangle.v1, triangle.v2);
+        surfaces_.push_back(triangle.surface);
+    }
+    std::sort(surfaces_.begin(), surfaces_.end());
+    surfaces_.erase(std::unique(surfaces_.begin(), surfaces_.end()), surfaces_.end());
+}
+
+void CollisionNeighborhood::Clear() {
+    bvh_ = nullptr;
+    triangles_.clear();
+    surfaces_.clear();
+    soa_.Clear();
+}
+
+bool CollisionNeighborhood::Covers(const AABB& box) const {
+    return bvh_ && region_.min.x <= box.min.x && region_.min.y <= box.min.y && region_.min.z <= box.min.z &&
+           region_.max.x >= box.max.x && region_.max.y >= box.max.y && region_.max.z >= box.max.z;
+}
+
+bool CollisionNeighborhood::OverlapsBox(const AABB& box) const {
+    const Vector3 center = box.GetCenter();
+    const Vector3 halfExtents = Vector3Scale(box.GetSize(), 0.5f);
+    float depths[TriangleSAT::LANES];
+    for (size_t first = 0; first < soa_.Size(); first += TriangleSAT::LANES) {
+        size_t count = std::min(TriangleSAT::LANES, soa_.Size() - first);
+        if (TriangleSAT::TestBox(soa_, first, count, center, halfExtents, depths)) return true;
+    }
+    return false;
+}
+
+bool CollisionNeighborhood::RayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+                                    TriangleBVH::RayHit& outHit) const {
+    if (!bvh_) return false;
+    float closest = maxDistance;
+    bool found = false;
+    for (uint32_t index : triangles_) {
+        const TriangleBVH::Triangle& t = bvh_->GetTriangle(index);
+        float distance;
+        if (!TriangleBVH::RayTriangle(t, origin, direction, closest, distance)) continue;
+
+        closest = distance;
+        found = true;
+        outHit.distance = distance;
+        outHit.triangle = index;
+        outHit.surface = t.surface;
+        Vector3 normal = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(t.v1, t.v0), Vector3Subtract(t.v2, t.v0)));
+        outHit.normal = Vector3DotProduct(normal, direction) > 0.0f ? Vector3Negate(normal) : normal;
+    }
+
+    if (found) outHit.point = Vector3Add(origin, Vector3Scale(direction, outHit.distance));
+    return found;
+}
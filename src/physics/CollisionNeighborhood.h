@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../math/AABB.h"
+#include "TriangleBVH.h"
+#include "TriangleSAT.h"
+#include <cstdint>
+#include <vector>
+
+// World collision candidates around one spot, gathered once and probed many
+// times. Character movement asks the world the same questions a dozen times a
+// tick from nearly the same place (ground checks, slide and step traces,
+// stuck tests, ground rays); gathering the triangles near the move once turns
+// every later probe into a scan of a few dozen candidates, whatever the map
+// size.
+//
+// Probes must fit inside the gathered region (Covers) to be answered here;
+// callers fall back to the full world queries otherwise.
+class CollisionNeighborhood {
+public:
+    // Triangles of bvh whose bounds overlap region, plus their surfaces
+    void Gather(const TriangleBVH& bvh, const AABB& region);
+    void Clear();
+
+    bool IsActive() const { return bvh_ != nullptr; }
+    bool Covers(const AABB& box) const;
+
+    // Same answers as TriangleBVH::OverlapsBox / RayCast for probes inside the region
+    bool OverlapsBox(const AABB& box) const;
+    bool RayCast(const Vector3& origin, const Vector3& direction, float maxDistance, TriangleBVH::RayHit& outHit) const;
+
+    // Candidate surfaces (sorted indices into world->surfaces), for box traces
+    const std::vector<uint32_t>& GetSurfaces() const { return surfaces_; }
+    size_t GetTriangleCount() const { return triangles_.size(); }
+
+private:
+    const TriangleBVH* bvh_ = nullptr;
+    AABB region_;
+    std::vector<uint32_t> triangles_;   // Indices into the BVH's triangles
+    std::vector<uint32_t> surfaces_;
+    TriangleSoA soa_;                   // triangles_ laid out for TriangleSAT
+};
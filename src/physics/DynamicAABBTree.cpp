@@ -0,0 +1,279 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+
+DynamicAABBTree::DynamicAABBTree(float margin)
+    : margin_(std::max(margin, 0.0f))
+{
+}
+
+// ============================================================================
+// Node pool
+// ============================================================================
+
+int32_t DynamicAABBTree::AllocateNode() {
+    if (freeList_ == NULL_NODE) {
+        nodes_.push_back(Node());
+        freeList_ = static_cast<int32_t>(nodes_.size()) - 1;
+        nodes_[freeList_].parent = NULL_NODE;
+    }
+    int32_t node = freeList_;
+    freeList_ = nodes_[node].parent;
+    nodes_[node].userData = nullptr;
+    nodes_[node].parent = NULL_NODE;
+    nodes_[node].child1 = NULL_NODE;
+    nodes_[node].child2 = NULL_NODE;
+    nodes_[node].height = 0;
+    return node;
+}
+
+void DynamicAABBTree::FreeNode(int32_t node) {
+    nodes_[node].parent = freeList_;
+    nodes_[node].height = -1;
+    freeList_ = node;
+}
+
+void DynamicAABBTree::Clear() {
+    nodes_.clear();
+    root_ = NULL_NODE;
+    freeList_ = NULL_NODE;
+    proxyCount_ = 0;
+}
+
+// ============================================================================
+// Proxies
+// ============================================================================
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& bounds, void* userData) {
+    int32_t proxy = AllocateNode();
+    nodes_[proxy].aabb = bounds;
+    nodes_[proxy].aabb.Expand({margin_, margin_, margin_});
+    nodes_[proxy].userData = userData;
+    InsertLeaf(proxy);
+    proxyCount_++;
+    return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId) {
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    proxyCount_--;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& bounds, const Vector3& displacement) {
+    if (Contains(nodes_[proxyId].aabb, bounds)) {
+        // Still inside, but shrink back if the fat box has grown far too loose
+        // (e.g. after a teleport or a burst of speed)
+        AABB huge = bounds;
+        huge.Expand({4.0f * margin_ + std::fabs(displacement.x) * 4.0f * DISPLACEMENT_MULTIPLIER,
+                     4.0f * margin_ + std::fabs(displacement.y) * 4.0f * DISPLACEMENT_MULTIPLIER,
+                     4.0f * margin_ + std::fabs(displacement.z) * 4.0f * DISPLACEMENT_MULTIPLIER});
+        if (Contains(huge, nodes_[proxyId].aabb)) return false;
+    }
+
+    RemoveLeaf(proxyId);
+
+    // Grow by the margin, then stretch toward where the box is heading
+    AABB fat = bounds;
+    fat.Expand({margin_, margin_, margin_});
+    const Vector3 ahead = {displacement.x * DISPLACEMENT_MULTIPLIER, displacement.y * DISPLACEMENT_MULTIPLIER,
+                           displacement.z * DISPLACEMENT_MULTIPLIER};
+    (ahead.x < 0.0f ? fat.min.x : fat.max.x) += ahead.x;
+    (ahead.y < 0.0f ? fat.min.y : fat.max.y) += ahead.y;
+    (ahead.z < 0.0f ? fat.min.z : fat.max.z) += ahead.z;
+    nodes_[proxyId].aabb = fat;
+
+    InsertLeaf(proxyId);
+    return true;
+}
+
+// ============================================================================
+// Insertion / removal
+// ============================================================================
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+    if (root_ == NULL_NODE) {
+        root_ = leaf;
+        nodes_[root_].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend toward the cheapest sibling: creating a parent for a node costs
+    // the combined area, and every ancestor pays for its growth
+    const AABB leafBox = nodes_[leaf].aabb;
+    int32_t index = root_;
+    while (!nodes_[index].IsLeaf()) {
+        const Node& node = nodes_[index];
+        float area = SurfaceArea(node.aabb);
+        float combinedArea = SurfaceArea(Union(node.aabb, leafBox));
+        float cost = 2.0f * combinedArea;                       // New parent here
+        float inheritanceCost = 2.0f * (combinedArea - area);   // Growth pushed down to a child
+
+        float childCosts[2];
+        const int32_t children[2] = {node.child1, node.child2};
+        for (int c = 0; c < 2; ++c) {
+            const Node& child = nodes_[children[c]];
+            float grown = SurfaceArea(Union(leafBox, child.aabb));
+            childCosts[c] = (child.IsLeaf() ? grown : grown - SurfaceArea(child.aabb)) + inheritanceCost;
+        }
+
+        if (cost < childCosts[0] && cost < childCosts[1]) break;
+        index = childCosts[0] < childCosts[1] ? node.child1 : node.child2;
+    }
+    const int32_t sibling = index;
+
+    // New parent joins sibling and leaf
+    const int32_t oldParent = nodes_[sibling].parent;
+    const int32_t newParent = AllocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].aabb = Union(leafBox, nodes_[sibling].aabb);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        root_ = newParent;
+    } else if (nodes_[oldParent].child1 == sibling) {
+        nodes_[oldParent].child1 = newParent;
+    } else {
+        nodes_[oldParent].child2 = newParent;
+    }
+
+    Refit(nodes_[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+    if (leaf == root_) {
+        root_ = NULL_NODE;
+        return;
+    }
+
+    // The parent goes away and the sibling takes its place
+    const int32_t parent = nodes_[leaf].parent;
+    const int32_t grandParent = nodes_[parent].parent;
+    const int32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root_ = sibling;
+        nodes_[sibling].parent = NULL_NODE;
+        FreeNode(parent);
+        return;
+    }
+
+    if (nodes_[grandParent].child1 == parent) {
+        nodes_[grandParent].child1 = sibling;
+    } else {
+        nodes_[grandParent].child2 = sibling;
+    }
+    nodes_[sibling].parent = grandParent;
+    FreeNode(parent);
+
+    Refit(grandParent);
+}
+
+void DynamicAABBTree::Refit(int32_t index) {
+    while (index != NULL_NODE) {
+        index = Balance(index);
+        Node& node = nodes_[index];
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.aabb = Union(child1.aabb, child2.aabb);
+        index = node.parent;
+    }
+}
+
+// ============================================================================
+// Balancing
+// ============================================================================
+
+/*
+ * Rotates node A's taller child up when the children's heights differ by more
+ * than one. Returns the index now at A's place in the tree.
+ *
+ *        A                C
+ *       / \              / \
+ *      B   C     ->     A   F        (F the taller of C's children)
+ *         / \          / \
+ *        F   G        B   G
+ */
+int32_t DynamicAABBTree::Balance(int32_t iA) {
+    Node& A = nodes_[iA];
+    if (A.IsLeaf() || A.height < 2) return iA;
+
+    const int32_t iB = A.child1;
+    const int32_t iC = A.child2;
+    const int balance = nodes_[iC].height - nodes_[iB].height;
+    if (balance >= -1 && balance <= 1) return iA;
+
+    // Rotate the taller child (up) with A (down)
+    const bool rotateC = balance > 1;
+    const int32_t iUp = rotateC ? iC : iB;
+    const int32_t iStay = rotateC ? iB : iC;
+    Node& up = nodes_[iUp];
+    const int32_t iF = up.child1;
+    const int32_t iG = up.child2;
+
+    up.child1 = iA;
+    up.parent = A.parent;
+    A.parent = iUp;
+
+    if (up.parent == NULL_NODE) {
+        root_ = iUp;
+    } else if (nodes_[up.parent].child1 == iA) {
+        nodes_[up.parent].child1 = iUp;
+    } else {
+        nodes_[up.parent].child2 = iUp;
+    }
+
+    // Keep the taller grandchild up, hand the other one to A
+    const bool fTaller = nodes_[iF].height > nodes_[iG].height;
+    const int32_t iKeep = fTaller ? iF : iG;
+    const int32_t iGive = fTaller ? iG : iF;
+    up.child2 = iKeep;
+    if (rotateC) {
+        A.child2 = iGive;
+    } else {
+        A.child1 = iGive;
+    }
+    nodes_[iGive].parent = iA;
+
+    A.aabb = Union(nodes_[iStay].aabb, nodes_[iGive].aabb);
+    A.height = 1 + std::max(nodes_[iStay].height, nodes_[iGive].height);
+    up.aabb = Union(A.aabb, nodes_[iKeep].aabb);
+    up.height = 1 + std::max(A.height, nodes_[iKeep].height);
+    return iUp;
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+float DynamicAABBTree::GetAreaRatio() const {
+    if (root_ == NULL_NODE) return 0.0f;
+    const float rootArea = SurfaceArea(nodes_[root_].aabb);
+    if (rootArea <= 0.0f) return 0.0f;
+    float totalArea = 0.0f;
+    for (const Node& node : nodes_) {
+        if (node.height > 0) totalArea += SurfaceArea(node.aabb);
+    }
+    return totalArea / rootArea;
+}
+
+AABB DynamicAABBTree::Union(const AABB& a, const AABB& b) {
+    return AABB({std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+                {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)});
+}
+
+float DynamicAABBTree::SurfaceArea(const AABB& box) {
+    const float dx = box.max.x - box.min.x;
+    const float dy = box.max.y - box.min.y;
+    const float dz = box.max.z - box.min.z;
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+bool DynamicAABBTree::Contains(const AABB& outer, const AABB& inner) {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+           outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "../math/AABB.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Incrementally updated bounding volume hierarchy for moving boxes. Leaves
+// store a "fat" box (the real box grown by a margin and stretched along the
+// last displacement), so a collider that jitters or keeps moving the same way
+// only gets reinserted once it leaves its fat box. Inserts pick the sibling
+// with the cheapest surface area increase, and every insert/remove walks back
+// up the tree rotating unbalanced nodes, keeping queries logarithmic.
+//
+// Proxy ids are stable until destroyed; nodes are recycled through a free list.
+// Queries report fat boxes, callers test their exact bounds themselves.
+class DynamicAABBTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+    static constexpr float DEFAULT_MARGIN = 0.1f;
+    static constexpr float DISPLACEMENT_MULTIPLIER = 2.0f;    // How far ahead fat boxes stretch
+
+    explicit DynamicAABBTree(float margin = DEFAULT_MARGIN);
+
+    int32_t CreateProxy(const AABB& bounds, void* userData);
+    void DestroyProxy(int32_t proxyId);
+    // Returns true when the proxy had to be reinserted (bounds left the fat box)
+    bool MoveProxy(int32_t proxyId, const AABB& bounds, const Vector3& displacement);
+    void Clear();
+
+    void* GetUserData(int32_t proxyId) const { return nodes_[proxyId].userData; }
+    const AABB& GetFatAABB(int32_t proxyId) const { return nodes_[proxyId].aabb; }
+
+    // callback(proxyId) returns false to stop the query
+    template<typename Callback> void Query(const AABB& bounds, Callback&& callback) const;
+    template<typename Callback> void QuerySphere(const Vector3& center, float radius, Callback&& callback) const;
+    // Ray origin + t * direction (direction normalized), t in [0, maxDistance].
+    // callback(proxyId) returns the new max distance: a hit distance clips the
+    // ray, maxDistance continues unchanged, 0 stops.
+    template<typename Callback> void RayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+                                             Callback&& callback) const;
+
+    int32_t GetProxyCount() const { return proxyCount_; }
+    int32_t GetHeight() const { return root_ == NULL_NODE ? 0 : nodes_[root_].height; }
+    // Sum of internal node areas over root area; lower is a tighter tree
+    float GetAreaRatio() const;
+
+private:
+    struct Node {
+        AABB aabb;
+        void* userData;
+        int32_t parent;         // Next free node while on the free list
+        int32_t child1;
+        int32_t child2;
+        int32_t height;         // Leaf 0, free -1
+
+        bool IsLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    static constexpr int QUERY_STACK_SIZE = 256;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    int32_t Balance(int32_t node);
+    void Refit(int32_t node);   // Recompute bounds/height from there to the root
+
+    static AABB Union(const AABB& a, const AABB& b);
+    static float SurfaceArea(const AABB& box);
+    static bool Contains(const AABB& outer, const AABB& inner);
+    static bool RayHitsBox(const Vector3& origin, const Vector3& invDirection, float maxDistance, const AABB& box);
+
+    std::vector<Node> nodes_;
+    int32_t root_ = NULL_NODE;
+    int32_t freeList_ = NULL_NODE;
+    int32_t proxyCount_ = 0;
+    float margin_;
+};
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+template<typename Callback>
+void DynamicAABBTree::Query(const AABB& bounds, Callback&& callback) const {
+    if (root_ == NULL_NODE) return;
+    int32_t stack[QUERY_STACK_SIZE];
+    int count = 0;
+    stack[count++] = root_;
+
+    while (count > 0) {
+        const Node& node = nodes_[stack[--count]];
+        if (!node.aabb.Intersects(bounds)) continue;
+        if (node.IsLeaf()) {
+            if (!callback(static_cast<int32_t>(&node - nodes_.data()))) return;
+        } else if (count + 2 <= QUERY_STACK_SIZE) {
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::QuerySphere(const Vector3& center, float radius, Callback&& callback) const {
+    if (root_ == NULL_NODE) return;
+    const float radiusSq = radius * radius;
+    int32_t stack[QUERY_STACK_SIZE];
+    int count = 0;
+    stack[count++] = root_;
+
+    while (count > 0) {
+        const Node& node = nodes_[stack[--count]];
+        // Squared distance from the center to the box
+        float dx = std::max(std::max(node.aabb.min.x - center.x, center.x - node.aabb.max.x), 0.0f);
+        float dy = std::max(std::max(node.aabb.min.y - center.y, center.y - node.aabb.max.y), 0.0f);
+        float dz = std::max(std::max(node.aabb.min.z - center.z, center.z - node.aabb.max.z), 0.0f);
+        if (dx * dx + dy * dy + dz * dz > radiusSq) continue;
+        if (node.IsLeaf()) {
+            if (!callback(static_cast<int32_t>(&node - nodes_.data()))) return;
+        } else if (count + 2 <= QUERY_STACK_SIZE) {
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::RayCast(const Vector3& origin, const Vector3& direction, float maxDistance,
+                              Callback&& callback) const {
+    if (root_ == NULL_NODE) return;
+    const Vector3 invDirection = {1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z};
+    int32_t stack[QUERY_STACK_SIZE];
+    int count = 0;
+    stack[count++] = root_;
+
+    while (count > 0) {
+        const Node& node = nodes_[stack[--count]];
+        if (!RayHitsBox(origin, invDirection, maxDistance, node.aabb)) continue;
+        if (node.IsLeaf()) {
+            float distance = callback(static_cast<int32_t>(&node - nodes_.data()));
+            if (distance <= 0.0f) return;
+            maxDistance = std::min(maxDistance, distance);
+        } else if (count + 2 <= QUERY_STACK_SIZE) {
+            stack[count++] = node.child1;
+            stack[count++] = node.child2;
+        }
+    }
+}
+
+inline bool DynamicAABBTree::RayHitsBox(const Vector3& origin, const Vector3& invDirection, float maxDistance,
+                                        const AABB& box) {
+    float t1 = (box.min.x - origin.x) * invDirection.x;
+    float t2 = (box.max.x - origin.x) * invDirection.x;
+    float tmin = std::min(t1, t2), tmax = std::max(t1, t2);
+    t1 = (box.min.y - origin.y) * invDirection.y;
+    t2 = (box.max.y - origin.y) * invDirection.y;
+    tmin = std::max(tmin, std::min(t1, t2));
+    tmax = std::min(tmax, std::max(t1, t2));
+    t1 = (box.min.z - origin.z) * invDirection.z;
+    t2 = (box.max.z - origin.z) * invDirection.z;
+    tmin = std::max(tmin, std::min(t1, t2));
+    tmax = std::min(tmax, std::max(t1, t2));
+    return tmax >= std::max(tmin, 0.0f) && tmin <= maxDistance;
+}
@@ -2,6 +2,7 @@
 #include "../ecs/Entity.h"
 #include "../ecs/Components/Player.h"
 #include "../utils/Logger.h"
+#include "../core/JobSystem.h"
 #include <algorithm>
 #include <cfloat>
 #include "raylib.h"
@@ -16,6 +17,15 @@ PhysicsSystem::PhysicsSystem()
     , worldSystem_(nullptr)
     , mapLoadTime_(0.0f)
     , physicsStartupDelay_(0.3f)  // 300ms delay after map loads
+    , simTime_(0.0f)
+    , tick_(0)
+    , deterministic_(false)
+    , fixedDeltaTime_(1.0f / DEFAULT_TICK_RATE)
+    , accumulator_(0.0f)
+    , sleepEnabled_(true)
+    , restStamp_(0)
+    , restWorld_(nullptr)
+    , slidePlanes_(1)
 {
 }
 
@@ -30,50 +40,261 @@ void PhysicsSystem::Shutdown() {
 void PhysicsSystem::Update(float deltaTime) {
     if (!IsEnabled()) return;
 
-    // Track when the map becomes loaded for physics startup delay
-    if (worldSystem_ && worldSystem_->IsMapLoaded() && mapLoadTime_ == 0.0f) {
-        mapLoadTime_ = GetTime();  // Record when map was loaded
-        LOG_INFO("Map loaded, physics will start in " + std::to_string(physicsStartupDelay_) + " seconds");
+    projectileImpacts_.clear();
+
+    if (!deterministic_) {
+        Step(deltaTime);
+        return;
+    }
+
+    // Whole ticks only; the remainder carries over to the next frame. A long
+    // stall drops the backlog rather than spiralling.
+    accumulator_ += deltaTime;
+    int steps = 0;
+    while (accumulator_ >= fixedDeltaTime_ && steps < MAX_FIXED_STEPS) {
+        Step(fixedDeltaTime_);
+        accumulator_ -= fixedDeltaTime_;
+        ++steps;
+    }
+    if (steps == MAX_FIXED_STEPS) accumulator_ = 0.0f;
+}
+
+void PhysicsSystem::SetDeterministic(bool enabled, float tickRate) {
+    deterministic_ = enabled;
+    fixedDeltaTime_ = 1.0f / std::max(tickRate, 1.0f);
+    accumulator_ = 0.0f;
+    LOG_INFO(std::string("Deterministic physics ") + (enabled ? "on" : "off") + " at " +
+             std::to_string(1.0f / fixedDeltaTime_) + " Hz");
+}
+
+void PhysicsSystem::StepFixed() {
+    projectileImpacts_.clear();
+    Step(fixedDeltaTime_);
+}
+
+void PhysicsSystem::CollectBodies() {
+    players_.clear();
+    bodies_.clear();
+    sleepStats_ = SleepStats{};
+    restStamp_++;
+
+    // New or reloaded geometry: nothing is resting on what it settled on
+    const World* world = collisionSystem_ ? static_cast<CollisionSystem*>(collisionSystem_)->GetWorld() : nullptr;
+    if (world != restWorld_) {
+        WakeAllBodies();
+        restWorld_ = world;
     }
 
-    // Update physics for all entities
     for (Entity* entity : GetEntities()) {
-        UpdateEntityPhysics(entity, deltaTime);
+        auto* transform = entity->GetComponent<TransformComponent>();
+        auto* velocity = entity->GetComponent<Velocity>();
+        if (!transform || !velocity) continue;
+        if (entity->GetComponent<Player>()) {
+            players_.push_back(entity);
+            continue;
+        }
+        const auto* collidable = entity->GetComponent<Collidable>();
+        RestState& rest = restStates_[entity];
+        rest.lastSeen = restStamp_;
+
+        if (rest.asleep) {
+            // Stays asleep until something gives it velocity or moves it
+            // (contact pushes, teleports, gameplay code)
+            const float tolerance = CONTACT_TOLERANCE * CONTACT_TOLERANCE;
+            bool disturbed = Vector3Length(velocity->GetVelocity()) >= VELOCITY_EPSILON ||
+                             Vector3DistanceSqr(transform->position, rest.restPosition) > tolerance ||
+                             (collidable && Vector3DistanceSqr(collidable->GetBounds().min, rest.restBounds.min) > tolerance);
+            if (!disturbed) {
+                sleepStats_.asleep++;
+                continue;
+            }
+            rest.asleep = false;
+            rest.quietTicks = 0;
+            sleepStats_.woke++;
+        }
+
+        PhysicsBody body;
+        body.entity = entity;
+        body.rest = &rest;
+        body.bullet = collidable && collidable->IsBullet();
+        bodies_.push_back(body);
+    }
+    sleepStats_.awake = players_.size() + bodies_.size();
+
+    // Entities destroyed or stripped of their components since the last tick
+    for (auto it = restStates_.begin(); it != restStates_.end();) {
+        if (it->second.lastSeen != restStamp_) {
+            it = restStates_.erase(it);
+        } else {
+            ++it;
+        }
     }
+
+    // GetEntities is ordered by pointer, which changes from run to run
+    std::sort(players_.begin(), players_.end(),
+              [](const Entity* a, const Entity* b) { return a->GetId() < b->GetId(); });
+    std::sort(bodies_.begin(), bodies_.end(),
+              [](const PhysicsBody& a, const PhysicsBody& b) { return a.entity->GetId() < b.entity->GetId(); });
 }
 
-void PhysicsSystem::UpdateEntityPhysics(Entity* entity, float deltaTime) {
-    auto* transform = entity->GetComponent<TransformComponent>();
-    auto* velocity = entity->GetComponent<Velocity>();
-    auto* player = entity->GetComponent<Player>();
+void PhysicsSystem::Step(float deltaTime) {
+    simTime_ += deltaTime;
+    tick_++;
+
+    // Track when the map becomes loaded for physics startup delay
+    if (worldSystem_ && worldSystem_->IsMapLoaded() && mapLoadTime_ == 0.0f) {
+        mapLoadTime_ = simTime_;  // Record when map was loaded
+        LOG_INFO("Map loaded, physics will start in " + std::to_string(physicsStartupDelay_) + " seconds");
+    }
 
-    if (!transform || !velocity) return;
+    // Players take their own path (input, state, step-ups) one at a time;
+    // everything else goes through the parallel phases below
+    CollectBodies();
 
-    // Special handling for player entities
-    if (player) {
+    for (Entity* player : players_) {
         LOG_INFO("Updating player physics");
-        UpdatePlayerPhysics(entity, deltaTime);
-        return;
+        UpdatePlayerPhysics(player, deltaTime);
+    }
+
+    // Each body only writes its own components and slot, and the world is
+    // read-only, so the results don't depend on how the bodies are split
+    // between threads
+    JobSystem& jobs = JobSystem::GetInstance();
+    if (slidePlanes_.size() < jobs.GetThreadCount()) slidePlanes_.resize(jobs.GetThreadCount());
+
+    // Phase 1: forces
+    jobs.ParallelFor(bodies_.size(), BODY_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) IntegrateBody(bodies_[i], deltaTime);
+    });
+
+    // Phase 2: move against the world. Bullets sweep afterwards, against the
+    // settled positions of everything else, and only record where they stop.
+    jobs.ParallelFor(bodies_.size(), BODY_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!bodies_[i].bullet) ResolveBodyWorld(bodies_[i], deltaTime);
+        }
+    });
+
+    // Phase 3: push overlapping entities apart, island by island, against
+    // this tick's positions. Also re-syncs the collider trees the sweep reads.
+    if (collisionSystem_) static_cast<CollisionSystem*>(collisionSystem_)->ResolveEntityContacts();
+
+    // Phase 4: bullets
+    jobs.ParallelFor(bodies_.size(), BODY_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (bodies_[i].bullet) SweepBullet(bodies_[i]);
+        }
+    });
+
+    // Bullets land in body order
+    for (PhysicsBody& body : bodies_) {
+        if (body.fellAsleep) sleepStats_.fellAsleep++;
+        if (!body.bullet) continue;
+        auto* transform = body.entity->GetComponent<TransformComponent>();
+        transform->position = body.sweptPosition;
+        body.entity->GetComponent<Collidable>()->UpdateBoundsFromPosition(body.sweptPosition);
+        if (body.impacted) {
+            projectileImpacts_.push_back({body.entity, body.impact});
+            if (body.impact.entity) WakeBody(body.impact.entity);
+        }
     }
+    sleepStats_.awake -= sleepStats_.fellAsleep;
+    sleepStats_.asleep += sleepStats_.fellAsleep;
+}
 
-    // Apply basic physics forces
+void PhysicsSystem::IntegrateBody(PhysicsBody& body, float deltaTime) {
+    auto* velocity = body.entity->GetComponent<Velocity>();
     ApplyGravity(*velocity, deltaTime);
     ApplyAirResistance(*velocity, deltaTime);
+    body.movement = Vector3Scale(velocity->GetVelocity(), deltaTime);
+}
 
-    // Calculate intended movement
-    Vector3 currentVel = velocity->GetVelocity();
-    LOG_INFO("Physics input velocity=(" + std::to_string(currentVel.x) + ", " +
-             std::to_string(currentVel.y) + ", " + std::to_string(currentVel.z) + ")");
-    Vector3 movement = Vector3Scale(currentVel, deltaTime);
-    LOG_INFO("Physics movement=(" + std::to_string(movement.x) + ", " +
-             std::to_string(movement.y) + ", " + std::to_string(movement.z) + ")");
+void PhysicsSystem::ResolveBodyWorld(PhysicsBody& body, float deltaTime) {
+    auto* transform = body.entity->GetComponent<TransformComponent>();
+    auto* velocity = body.entity->GetComponent<Velocity>();
 
     // Resolve movement with collision detection
-    ResolveMovement(entity, movement, deltaTime);
+    ResolveMovement(body.entity, body.movement, deltaTime);
 
     // Apply friction based on ground contact
     bool onGround = IsOnGround(transform->position, {1.0f, 1.0f, 1.0f});
     ApplyFriction(*velocity, deltaTime, onGround);
+
+    UpdateRest(body, onGround);
+}
+
+void PhysicsSystem::UpdateRest(PhysicsBody& body, bool onGround) {
+    RestState& rest = *body.rest;
+    auto* velocity = body.entity->GetComponent<Velocity>();
+    if (!sleepEnabled_ || !onGround || Vector3Length(velocity->GetVelocity()) >= VELOCITY_EPSILON) {
+        rest.quietTicks = 0;
+        return;
+    }
+    if (++rest.quietTicks < SLEEP_TICKS) return;
+
+    velocity->Stop();
+    const auto* collidable = body.entity->GetComponent<Collidable>();
+    rest.asleep = true;
+    rest.restPosition = body.entity->GetComponent<TransformComponent>()->position;
+    rest.restBounds = collidable ? collidable->GetBounds() : AABB();
+    body.fellAsleep = true;
+}
+
+void PhysicsSystem::SetSleepEnabled(bool enabled) {
+    sleepEnabled_ = enabled;
+    if (!enabled) WakeAllBodies();
+}
+
+void PhysicsSystem::WakeBody(Entity* entity) {
+    auto it = restStates_.find(entity);
+    if (it == restStates_.end()) return;
+    it->second.asleep = false;
+    it->second.quietTicks = 0;
+}
+
+void PhysicsSystem::WakeBodiesIn(const AABB& region) {
+    for (auto& [entity, rest] : restStates_) {
+        if (!rest.asleep) continue;
+        const auto* collidable = entity->GetComponent<Collidable>();
+        bool touches = collidable ? collidable->GetBounds().Intersects(region)
+                                  : region.Contains(entity->GetComponent<TransformComponent>()->position);
+        if (touches) {
+            rest.asleep = false;
+            rest.quietTicks = 0;
+        }
+    }
+}
+
+void PhysicsSystem::WakeAllBodies() {
+    for (auto& entry : restStates_) {
+        entry.second.asleep = false;
+        entry.second.quietTicks = 0;
+    }
+}
+
+void PhysicsSystem::SweepBullet(PhysicsBody& body) {
+    auto* transform = body.entity->GetComponent<TransformComponent>();
+    auto* velocity = body.entity->GetComponent<Velocity>();
+    auto* collidable = body.entity->GetComponent<Collidable>();
+
+    Vector3 start = transform->position;
+    Vector3 end = Vector3Add(start, body.movement);
+    body.impacted = false;
+
+    // Swept sphere inscribed in the collider, however far it goes this tick
+    auto collisionSys = static_cast<CollisionSystem*>(collisionSystem_);
+    Vector3 size = collidable->GetBounds().GetSize();
+    float radius = 0.5f * std::min({size.x, size.y, size.z});
+    if (collisionSys &&
+        collisionSys->SweepSphere(start, end, radius, collidable->GetCollisionMask(), body.entity, body.impact)) {
+        // Stop just short of the contact
+        Vector3 direction = Vector3Normalize(body.movement);
+        float travelled = Vector3Distance(start, body.impact.position);
+        end = Vector3Add(start, Vector3Scale(direction, std::max(travelled - CONTACT_TOLERANCE, 0.0f)));
+        velocity->Stop();
+        body.impacted = true;
+    }
+    body.sweptPosition = end;
 }
 
 void PhysicsSystem::UpdatePlayerPhysics(Entity* playerEntity, float deltaTime) {
@@ -84,6 +305,19 @@ void PhysicsSystem::UpdatePlayerPhysics(Entity* playerEntity, float deltaTime) {
 
     if (!transform || !velocity || !player) return;
 
+    // Every world probe below happens around here: gather the candidates once,
+    // from the box where it is and where its velocity takes it, grown by a step
+    auto collisionSys = static_cast<CollisionSystem*>(collisionSystem_);
+    if (collisionSys && collidable && !player->HasNoClip()) {
+        Vector3 half = Vector3Scale(collidable->GetBounds().GetSize(), 0.5f);
+        Vector3 end = Vector3Add(transform->position, Vector3Scale(velocity->GetVelocity(), deltaTime));
+        AABB region(Vector3Subtract(Vector3Min(transform->position, end), half),
+                    Vector3Add(Vector3Max(transform->position, end), half));
+        const float reach = STEP_HEIGHT + GROUND_PROBE_DISTANCE;
+        region.Expand({reach, reach, reach});
+        collisionSys->GatherNeighborhood(region, neighborhood_);
+    }
+
     // Debug: Player physics - Position and Velocity tracking
 
     PlayerState currentState = player->GetState();
@@ -145,7 +379,8 @@ void PhysicsSystem::UpdatePlayerPhysics(Entity* playerEntity, float deltaTime) {
         Vector3 bottom = { transform->position.x, transform->position.y - halfHeight, transform->position.z };
         Vector3 down = {0.0f, -1.0f, 0.0f};
         const float maxSnap = 0.1f;   // 10cm snap range
-        float d = worldSystem_->CastRay(bottom, down, maxSnap);
+        TriangleBVH::RayHit hit;
+        float d = CastRayWorld(bottom, down, maxSnap, hit) ? hit.distance : maxSnap;
         if (d < maxSnap) {
             // Move player up by the penetration distance plus small epsilon
             float epsilon = 0.01f;
@@ -156,6 +391,8 @@ void PhysicsSystem::UpdatePlayerPhysics(Entity* playerEntity, float deltaTime) {
             if (velocity->GetY() < 0.0f) velocity->SetY(0.0f);
         }
     }
+
+    neighborhood_.Clear();
 }
 
 void PhysicsSystem::ApplyGravity(Velocity& velocity, float deltaTime) {
@@ -167,7 +404,7 @@ void PhysicsSystem::ApplyGravity(Velocity& velocity, float deltaTime) {
 
     // Check physics startup delay after map loads
     if (mapLoadTime_ > 0.0f) {
-        float timeSinceMapLoad = GetTime() - mapLoadTime_;
+        float timeSinceMapLoad = simTime_ - mapLoadTime_;
         if (timeSinceMapLoad < physicsStartupDelay_) {
             LOG_DEBUG("Physics startup delay active: " + std::to_string(timeSinceMapLoad) +
                      "/" + std::to_string(physicsStartupDelay_) + " seconds");
@@ -193,11 +430,6 @@ void PhysicsSystem::ApplyGravity(Velocity& velocity, float deltaTime) {
 void PhysicsSystem::ApplyFriction(Velocity& velocity, float deltaTime, bool onGround) {
     Vector3 currentVel = velocity.GetVelocity();
 
-    // Debug: Friction application
-    LOG_INFO("Friction before - vel: (" + std::to_string(currentVel.x) + ", " +
-             std::to_string(currentVel.y) + ", " + std::to_string(currentVel.z) +
-             ") onGround: " + (onGround ? "true" : "false"));
-
     if (onGround) {
         // Ground friction (softer for smoother feel)
         const float frictionCoeffPerFrame = 0.98f; // ~2% speed loss per 60fps frame
@@ -224,10 +456,6 @@ void PhysicsSystem::ApplyFriction(Velocity& velocity, float deltaTime, bool onGr
         if (fabsf(currentVel.z) < 0.001f) currentVel.z = 0.0f;
     }
 
-    // Debug: After friction application
-    LOG_INFO("Friction after - vel: (" + std::to_string(currentVel.x) + ", " +
-             std::to_string(currentVel.y) + ", " + std::to_string(currentVel.z) + ")");
-
     velocity.SetVelocity(currentVel);
 }
 
@@ -244,130 +472,207 @@ void PhysicsSystem::ApplyAirResistance(Velocity& velocity, float deltaTime) {
     velocity.SetVelocity(currentVel);
 }
 
-void PhysicsSystem::ResolveMovement(Entity* entity, const Vector3& intendedMovement, float deltaTime) {
-    auto* transform = entity->GetComponent<TransformComponent>();
-    auto* velocity = entity->GetComponent<Velocity>();
-    auto* collidable = entity->GetComponent<Collidable>();
+// === DETERMINISTIC STATE ===
 
-    if (!transform || !velocity || !collidable) return;
+void PhysicsSystem::SaveState(Snapshot& out) const {
+    out.tick = tick_;
+    out.simTime = simTime_;
+    out.mapLoadTime = mapLoadTime_;
+    out.bodies.clear();
+    for (Entity* entity : GetEntities()) {
+        auto* transform = entity->GetComponent<TransformComponent>();
+        auto* velocity = entity->GetComponent<Velocity>();
+        if (!transform || !velocity) continue;
+        auto* collidable = entity->GetComponent<Collidable>();
+        auto* player = entity->GetComponent<Player>();
+
+        BodyState state;
+        state.entity = entity;
+        state.position = transform->position;
+        state.velocity = velocity->GetVelocity();
+        state.bounds = collidable ? collidable->GetBounds() : AABB();
+        state.playerState = player ? player->GetState() : PlayerState::ON_GROUND;
+        state.jumping = player && player->IsJumping();
+        auto rest = restStates_.find(entity);
+        state.asleep = rest != restStates_.end() && rest->second.asleep;
+        state.quietTicks = rest != restStates_.end() ? rest->second.quietTicks : 0;
+        out.bodies.push_back(state);
+    }
+    std::sort(out.bodies.begin(), out.bodies.end(),
+              [](const BodyState& a, const BodyState& b) { return a.entity->GetId() < b.entity->GetId(); });
+}
 
-    Vector3 currentPos = transform->position;
-    Vector3 targetPos = Vector3Add(currentPos, intendedMovement);
+void PhysicsSystem::RestoreState(const Snapshot& snapshot) {
+    tick_ = snapshot.tick;
+    simTime_ = snapshot.simTime;
+    mapLoadTime_ = snapshot.mapLoadTime;
+    accumulator_ = 0.0f;
+
+    for (const BodyState& state : snapshot.bodies) {
+        if (GetEntities().count(state.entity) == 0) continue;
+        state.entity->GetComponent<TransformComponent>()->position = state.position;
+        state.entity->GetComponent<Velocity>()->SetVelocity(state.velocity);
+        if (auto* collidable = state.entity->GetComponent<Collidable>()) collidable->SetBounds(state.bounds);
+        if (auto* player = state.entity->GetComponent<Player>()) {
+            // Through ON_GROUND: every state can be reached from there
+            player->SetState(PlayerState::ON_GROUND);
+            player->SetState(state.playerState);
+            player->SetJumping(state.jumping);
+        } else {
+            RestState& rest = restStates_[state.entity];
+            rest.asleep = state.asleep;
+            rest.quietTicks = state.quietTicks;
+            rest.restPosition = state.position;
+            rest.restBounds = state.bounds;
+            rest.lastSeen = restStamp_;
+        }
+    }
+}
 
-    // Only log when near stairs area (X=40-50, Z=-10 to 10) or when moving significantly
-    bool nearStairs = (currentPos.x >= 40.0f && currentPos.x <= 50.0f && currentPos.z >= -10.0f && currentPos.z <= 10.0f);
-    bool significantMovement = Vector3Length(intendedMovement) > 0.01f;
+uint64_t PhysicsSystem::ComputeStateChecksum() const {
+    Snapshot state;
+    SaveState(state);
 
-    if (nearStairs || significantMovement) {
-        LOG_INFO("PHYSICS: Player at (" + std::to_string(currentPos.x) + "," + std::to_string(currentPos.y) + "," + std::to_string(currentPos.z) +
-                 ") moving by (" + std::to_string(intendedMovement.x) + "," + std::to_string(intendedMovement.y) + "," + std::to_string(intendedMovement.z) + ")");
-    }
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    auto mixVector = [&mix](const Vector3& v) {
+        mix(&v.x, sizeof(float));
+        mix(&v.y, sizeof(float));
+        mix(&v.z, sizeof(float));
+    };
 
-    // Store horizontal movement for later use
-    Vector3 horizontalMovement = {intendedMovement.x, 0, intendedMovement.z};
-    float horizontalSpeed = Vector3Length(horizontalMovement);
+    mix(&tick_, sizeof(tick_));
+    for (const BodyState& body : state.bodies) {
+        const uint64_t id = body.entity->GetId();
+        const uint8_t playerState = static_cast<uint8_t>(body.playerState);
+        const uint8_t asleep = body.asleep ? 1 : 0;
+        const int32_t quietTicks = body.quietTicks;
+        mix(&id, sizeof(id));
+        mix(&asleep, sizeof(asleep));
+        mix(&quietTicks, sizeof(quietTicks));
+        mixVector(body.position);
+        mixVector(body.velocity);
+        mixVector(body.bounds.min);
+        mixVector(body.bounds.max);
+        mix(&playerState, sizeof(playerState));
+    }
+    return hash;
+}
 
-    // For stair climbing, we need to detect when horizontal movement is blocked by a higher surface
-    // Only trigger step-up when there's significant horizontal movement AND we're not falling fast
+// === SWEPT BOX MOVEMENT ===
 
-    // Check for collisions at target position
-    if (!CheckCollisionAtPosition(entity, targetPos)) {
-        // No collisions, apply full movement
-        transform->position = targetPos;
-        collidable->UpdateBoundsFromPosition(targetPos);
-        LOG_INFO("MOVEMENT: No collision, applied full movement to (" +
-                 std::to_string(targetPos.x) + "," + std::to_string(targetPos.y) + "," + std::to_string(targetPos.z) + ")");
-        return;
+bool PhysicsSystem::TraceBox(const Vector3& start, const Vector3& end, const Vector3& halfExtents,
+                             BSPTraceResult& result) const {
+    auto collisionSys = static_cast<CollisionSystem*>(collisionSystem_);
+    if (!collisionSys) {
+        result = BSPTraceResult{};
+        result.point = end;
+        return false;
     }
+    return collisionSys->TraceBoxWorld(start, end, halfExtents, result,
+                                       neighborhood_.IsActive() ? &neighborhood_ : nullptr);
+}
 
-    // Collision detected - but check if PlayerSystem already handled slope movement
-    LOG_INFO("COLLISION: Collision detected at target pos (" + std::to_string(targetPos.x) + "," + std::to_string(targetPos.y) + "," + std::to_string(targetPos.z) +
-             ") - horizontalSpeed: " + std::to_string(horizontalSpeed) + ", vertical: " + std::to_string(intendedMovement.y));
+bool PhysicsSystem::CastRayWorld(const Vector3& origin, const Vector3& direction, float maxDistance,
+                                 TriangleBVH::RayHit& outHit) const {
+    auto collisionSys = static_cast<CollisionSystem*>(collisionSystem_);
+    if (!collisionSys || !collisionSys->GetWorld()) return false;
 
-    // PRIORITY 1: Check if the collision surface is a slope - if so, project movement onto slope
-    collisionEventsCache_.clear();
-    GetAllCollisions(entity, targetPos, collisionEventsCache_);
-    
-    if (!collisionEventsCache_.empty()) {
-        const CollisionEvent& firstCollision = collisionEventsCache_[0];
-        Vector3 surfaceNormal = firstCollision.normal;
-        
-        // Check if this is a slope surface (not vertical, not flat)
-        float normalY = surfaceNormal.y;
-        if (normalY > 0.1f && normalY < 0.99f && horizontalSpeed > 0.001f) {
-            LOG_INFO("SLOPE COLLISION: Detected slope normal=(" +
-                     std::to_string(surfaceNormal.x) + "," + std::to_string(surfaceNormal.y) + "," +
-                     std::to_string(surfaceNormal.z) + ") - projecting movement");
-            
-            // Project the horizontal movement onto the slope plane
-            Vector3 horizontalMovement = {intendedMovement.x, 0.0f, intendedMovement.z};
-            
-            // Project movement onto slope plane (remove component perpendicular to slope)
-            float dot = Vector3DotProduct(horizontalMovement, surfaceNormal);
-            Vector3 projectedMovement = Vector3Subtract(horizontalMovement, Vector3Scale(surfaceNormal, dot));
-            
-            // Calculate Y movement to follow the slope
-            float slopeMovementY = 0.0f;
-            if (Vector3Length(horizontalMovement) > 0.001f) {
-                // Use slope angle to calculate Y component
-                Vector3 slopeDirection = Vector3Normalize({surfaceNormal.x, 0.0f, surfaceNormal.z});
-                Vector3 movementDirection = Vector3Normalize(horizontalMovement);
-                float slopeAngle = acosf(surfaceNormal.y);
-                float horizontalDistance = Vector3Length(projectedMovement);
-                slopeMovementY = horizontalDistance * tanf(slopeAngle);
-                
-                // Determine if moving up or down slope
-                float slopeDot = Vector3DotProduct(movementDirection, slopeDirection);
-                if (slopeDot > 0) slopeMovementY = -slopeMovementY; // Moving up slope
-            }
-            
-            // Combine projected horizontal movement with slope Y and preserve vertical movement
-            Vector3 finalMovement = {projectedMovement.x, slopeMovementY + intendedMovement.y, projectedMovement.z};
-            Vector3 finalPos = Vector3Add(currentPos, finalMovement);
-            
-            transform->position = finalPos;
-            collidable->UpdateBoundsFromPosition(finalPos);
-            
-            // Update velocity to reflect slope movement
-            Vector3 slopeVelocity = Vector3Scale(finalMovement, 1.0f / deltaTime);
-            velocity->SetVelocity(slopeVelocity);
-            
-            LOG_INFO("SLOPE MOVEMENT: Applied projected movement (" + std::to_string(finalMovement.x) + "," + 
-                     std::to_string(finalMovement.y) + "," + std::to_string(finalMovement.z) + ")");
-            return;
-        }
+    Vector3 end = Vector3Add(origin, Vector3Scale(direction, maxDistance));
+    if (neighborhood_.Covers(AABB(Vector3Min(origin, end), Vector3Max(origin, end)))) {
+        return neighborhood_.RayCast(origin, direction, maxDistance, outHit);
     }
+    return collisionSys->GetWorldBVH().RayCast(origin, direction, maxDistance, outHit);
+}
 
-    // PRIORITY 2: Try step-up for stairs/obstacles (only if surface normal indicates upward-facing surface)
-    if (horizontalSpeed > 0.001f && intendedMovement.y >= -0.1f) { // Only try step-up if not falling fast
-        LOG_INFO("COLLISION: Attempting step-up at pos (" +
-                 std::to_string(currentPos.x) + "," + std::to_string(currentPos.y) + "," + std::to_string(currentPos.z) +
-                 ") with horizontal speed " + std::to_string(horizontalSpeed));
+// Slide move (PM_SlideMove): trace the box along what's left of the move, stop
+// at the contact, clip the rest against every plane touched so far and go again
+SlideMoveResult PhysicsSystem::SlideMove(const Vector3& start, const Vector3& halfExtents, const Vector3& movement) {
+    SlideMoveResult result{start, movement, false, false};
+    std::vector<CollisionPlane>& planes = slidePlanes_[JobSystem::GetThreadIndex()];
+    planes.clear();
+
+    Vector3 remaining = movement;
+    for (int bump = 0; bump < MAX_SLIDE_BUMPS && Vector3Length(remaining) > CONTACT_TOLERANCE; ++bump) {
+        BSPTraceResult trace;
+        TraceBox(result.position, Vector3Add(result.position, remaining), halfExtents, trace);
+        if (trace.allSolid) {
+            // Stuck in geometry: stay put, ApplyUnstuckCorrection pushes the box out
+            result.blocked = true;
+            result.movement = {0.0f, 0.0f, 0.0f};
+            break;
+        }
 
-        // Try to step up over the obstacle
-        if (TryStepUp(entity, horizontalMovement)) {
-            LOG_INFO("STEP-UP: Successfully stepped up over obstacle!");
-            return; // Successfully stepped up
-        } else {
-            LOG_INFO("STEP-UP: Failed to step up - obstacle too high or no valid step surface");
+        result.position = trace.point;
+        if (!trace.hit) break;
+
+        result.blocked = true;
+        if (!IsWalkableSlope(trace.normal)) result.hitWall = true;
+
+        planes.push_back({trace.normal, 0.0f, trace.point, true});
+        remaining = ClipToPlanes(Vector3Scale(remaining, 1.0f - trace.fraction), planes);
+        result.movement = ClipToPlanes(result.movement, planes);
+    }
+    return result;
+}
+
+// Remove the movement into any of the planes: slide along one plane if that
+// doesn't push into the others, otherwise along the crease of two
+Vector3 PhysicsSystem::ClipToPlanes(const Vector3& movement, const std::vector<CollisionPlane>& planes) {
+    for (size_t i = 0; i < planes.size(); ++i) {
+        Vector3 clipped = SlideVelocity(movement, planes[i].normal);
+        bool intoOther = false;
+        for (size_t j = 0; j < planes.size() && !intoOther; ++j) {
+            intoOther = j != i && Vector3DotProduct(clipped, planes[j].normal) < -CONTACT_TOLERANCE;
         }
+        if (!intoOther) return clipped;
     }
+    if (planes.size() == 2) return ResolveCornerCollision(movement, planes);
+    return {0.0f, 0.0f, 0.0f};
+}
+
+void PhysicsSystem::ResolveMovement(Entity* entity, const Vector3& intendedMovement, float deltaTime) {
+    auto* transform = entity->GetComponent<TransformComponent>();
+    auto* velocity = entity->GetComponent<Velocity>();
+    auto* collidable = entity->GetComponent<Collidable>();
+
+    if (!transform || !velocity || !collidable) return;
+
+    Vector3 currentPos = transform->position;
+    Vector3 halfExtents = Vector3Scale(collidable->GetBounds().GetSize(), 0.5f);
 
-    // PRIORITY 3: Fallback to constraint-based collision resolution
-    LOG_INFO("COLLISION: Using constraint-based collision resolution");
-    Vector3 finalMovement = ResolveConstrainedMovement(entity, currentPos, intendedMovement);
+    // Slide along whatever the box runs into
+    SlideMoveResult move = SlideMove(currentPos, halfExtents, intendedMovement);
 
-    // Apply constraint-resolved movement
-    Vector3 finalPos = Vector3Add(currentPos, finalMovement);
-    transform->position = finalPos;
-    collidable->UpdateBoundsFromPosition(finalPos);
+    // Walked into something steep: see if the same move from a step higher gets further (stairs, ledges)
+    Vector3 horizontalMovement = {intendedMovement.x, 0.0f, intendedMovement.z};
+    if (move.hitWall && Vector3Length(horizontalMovement) > 0.001f && intendedMovement.y >= -0.1f) {
+        SlideMoveResult stepped;
+        if (TryStepUp(currentPos, halfExtents, intendedMovement, stepped)) {
+            Vector3 plainDelta = Vector3Subtract(move.position, currentPos);
+            Vector3 stepDelta = Vector3Subtract(stepped.position, currentPos);
+            float plainDistance = plainDelta.x * plainDelta.x + plainDelta.z * plainDelta.z;
+            float stepDistance = stepDelta.x * stepDelta.x + stepDelta.z * stepDelta.z;
+            if (stepDistance > plainDistance + CONTACT_TOLERANCE * CONTACT_TOLERANCE) {
+                LOG_INFO("STEP-UP: Stepped up " + std::to_string(stepDelta.y) + " units");
+                move = stepped;
+            }
+        }
+    }
 
-    // Update velocity based on movement constraints
-    Vector3 actualMovement = Vector3Scale(finalMovement, 1.0f / deltaTime);
-    velocity->SetVelocity(actualMovement);
+    transform->position = move.position;
+    collidable->UpdateBoundsFromPosition(move.position);
 
-    LOG_INFO("COLLISION: Applied constraint movement to (" +
-             std::to_string(finalPos.x) + "," + std::to_string(finalPos.y) + "," + std::to_string(finalPos.z) + ")");
+    // Drop the velocity that went into surfaces
+    if (move.blocked && deltaTime > 0.0f) {
+        velocity->SetVelocity(Vector3Scale(move.movement, 1.0f / deltaTime));
+    }
 }
 
 void PhysicsSystem::HandleCollision(Entity* entity, const Vector3& movement, const Vector3& surfaceNormal) {
@@ -497,22 +802,13 @@ void PhysicsSystem::GetAllCollisions(Entity* entity, const Vector3& position, st
     playerBounds.max.y = position.y + size.y / 2.0f;
     playerBounds.max.z = position.z + size.z / 2.0f;
 
-    // Check collision against all faces in the BSP tree
-    const auto& faces = collisionSys->GetWorld()->surfaces;
-    for (const auto& face : faces) {
-        // Skip non-collidable faces
-        if (!HasFlag(face.flags, FaceFlags::Collidable)) continue;
-
-        // Simple AABB vs triangle intersection check
-        if (collisionSys->CheckAABBIntersectsTriangle(playerBounds, face.vertices)) {
-            // Calculate penetration depth
-            float penetrationDepth = collisionSys->GetPenetrationDepth(playerBounds, face.vertices, face.normal);
-            
-
-            
-            // Add to collision list
-            outCollisions.emplace_back(nullptr, nullptr, position, face.normal, penetrationDepth);
-        }
+    // Faces overlapping the box, from the BVH's batched triangle test
+    const World* world = collisionSys->GetWorld();
+    if (!world) return;
+    collisionSys->GetWorldContacts(playerBounds, worldContacts_);
+    for (const TriangleBVH::Contact& contact : worldContacts_) {
+        const Face& face = world->surfaces[contact.surface];
+        outCollisions.emplace_back(nullptr, nullptr, position, face.normal, contact.depth);
     }
 }
 
@@ -625,36 +921,6 @@ bool PhysicsSystem::WouldCollideWithAny(Entity* entity, const Vector3& position,
     return false;
 }
 
-void PhysicsSystem::TryHorizontalMovement(Entity* entity, const Vector3& intendedMovement) {
-    auto* transform = entity->GetComponent<TransformComponent>();
-
-    if (!transform) return;
-
-    // Try to move horizontally, allowing sliding along surfaces
-    Vector3 horizontalMovement = {intendedMovement.x, 0.0f, intendedMovement.z};
-
-    if (Vector3Length(horizontalMovement) > 0.001f) {
-        Vector3 testPos = Vector3Add(transform->position, horizontalMovement);
-        if (!CheckCollisionAtPosition(entity, testPos)) {
-            transform->position = Vector3Add(transform->position, horizontalMovement);
-        } else {
-            // Try sliding - move only in X direction
-            Vector3 slideX = {intendedMovement.x, 0.0f, 0.0f};
-            Vector3 testPosX = Vector3Add(transform->position, slideX);
-            if (!CheckCollisionAtPosition(entity, testPosX)) {
-                transform->position = Vector3Add(transform->position, slideX);
-            }
-
-            // Try sliding - move only in Z direction
-            Vector3 slideZ = {0.0f, 0.0f, intendedMovement.z};
-            Vector3 testPosZ = Vector3Add(transform->position, slideZ);
-            if (!CheckCollisionAtPosition(entity, testPosZ)) {
-                transform->position = Vector3Add(transform->position, slideZ);
-            }
-        }
-    }
-}
-
 float PhysicsSystem::GetSurfaceHeightAtPosition(const Vector3& position) const {
     // Cast ray down from high above to find surface height
     const float RAY_START_HEIGHT = 10.0f; // Start ray 10 units above
@@ -689,7 +955,10 @@ bool PhysicsSystem::CheckCollisionAtPosition(Entity* entity, const Vector3& posi
         return false;
     }
 
-    bool result = collisionSys->CheckCollisionWithWorld(*collidable, position);
+    Vector3 half = Vector3Scale(collidable->GetBounds().GetSize(), 0.5f);
+    AABB box(Vector3Subtract(position, half), Vector3Add(position, half));
+    bool result = neighborhood_.Covers(box) ? neighborhood_.OverlapsBox(box)
+                                            : collisionSys->CheckCollisionWithWorld(*collidable, position);
     LOG_INFO("CheckCollisionAtPosition: Position (" + std::to_string(position.x) + "," +
              std::to_string(position.y) + "," + std::to_string(position.z) + ") collision: " +
              std::string(result ? "YES" : "NO"));
@@ -830,82 +1099,12 @@ bool PhysicsSystem::IsOnGround(const Vector3& position, const Vector3& size) con
         return onGround;
     }
 
-    // Enhanced ground check: Check for collision slightly below the player's feet
-    Vector3 bottomCenter = {position.x, position.y - size.y/2.0f, position.z};
-    Vector3 testPosition = {bottomCenter.x, bottomCenter.y - 0.05f, bottomCenter.z}; // 5cm below feet
-
-    // Create a small AABB to test for collision below the player
-    AABB testBounds;
-    float halfWidth = size.x * 0.4f; // Slightly smaller than player for edge detection
-    float halfDepth = size.z * 0.4f;
-    testBounds.min = {testPosition.x - halfWidth, testPosition.y - 0.02f, testPosition.z - halfDepth};
-    testBounds.max = {testPosition.x + halfWidth, testPosition.y + 0.02f, testPosition.z + halfDepth};
-
-    // Check collision using existing BSP collision system
-    bool hasGroundBelow = false;
-    if (collisionSystem_) {
-        Collidable testCollidable({halfWidth*2, 0.04f, halfDepth*2});
-        hasGroundBelow = dynamic_cast<CollisionSystem*>(collisionSystem_)->CheckCollisionWithWorld(testCollidable, testPosition);
-    }
-
-    // Additional check: If no ground below but player has downward velocity very close to zero,
-    // check if player is penetrating any surface from above (standing on top of something)
-    if (!hasGroundBelow) {
-        // Create player AABB at current position
-        AABB playerBounds;
-        playerBounds.min.x = position.x - size.x/2.0f;
-        playerBounds.min.y = position.y - size.y/2.0f;
-        playerBounds.min.z = position.z - size.z/2.0f;
-        playerBounds.max.x = position.x + size.x/2.0f;
-        playerBounds.max.y = position.y + size.y/2.0f;
-        playerBounds.max.z = position.z + size.z/2.0f;
-
-        // Check if player is currently colliding with any surface and find the highest surface
-        float highestSurfaceY = -FLT_MAX;
-        bool foundSurface = false;
-
-        if (!collisionSystem_) {
-            return 0.0f; // No collision system available
-        }
-
-        const auto& faces = dynamic_cast<CollisionSystem*>(collisionSystem_)->GetWorld()->surfaces;
-
-        for (const auto& face : faces) {
-            if (!HasFlag(face.flags, FaceFlags::Collidable)) continue;
-
-            // Check if player AABB intersects this face
-            if (dynamic_cast<CollisionSystem*>(collisionSystem_)->CheckAABBIntersectsTriangle(playerBounds, face.vertices)) {
-                // Calculate triangle normal and check if it's a floor-like surface
-                Vector3 edge1 = Vector3Subtract(face.vertices[1], face.vertices[0]);
-                Vector3 edge2 = Vector3Subtract(face.vertices[2], face.vertices[0]);
-                Vector3 normal = Vector3Normalize(Vector3CrossProduct(edge1, edge2));
-
-                // If normal points mostly upward (Y-dominant), it's a potential ground surface
-                if (fabsf(normal.y) > fabsf(normal.x) && fabsf(normal.y) > fabsf(normal.z) && normal.y > 0.0f) {
-                    // Find the highest Y coordinate of the triangle
-                    float maxY = std::max({face.vertices[0].y, face.vertices[1].y, face.vertices[2].y});
-                    if (maxY > highestSurfaceY) {
-                        highestSurfaceY = maxY;
-                        foundSurface = true;
-                    }
-                }
-            }
-        }
-
-        // If we found a surface and the player is very close to it (within epsilon), consider grounded
-        if (foundSurface) {
-            float surfaceEpsilon = 0.1f; // 10cm tolerance for standing on surfaces
-            float playerBottomY = position.y - size.y/2.0f;
-            if (playerBottomY >= highestSurfaceY - surfaceEpsilon && playerBottomY <= highestSurfaceY + surfaceEpsilon) {
-                hasGroundBelow = true;
-                LOG_INFO("Platform ground check: Player bottom Y=" + std::to_string(playerBottomY) +
-                         " Surface Y=" + std::to_string(highestSurfaceY) + " - GROUNDED on platform!");
-            }
-        }
-    }
-
-    LOG_INFO("Enhanced ground check: PosY=" + std::to_string(position.y) +
-             " TestY=" + std::to_string(testPosition.y) + " hasGroundBelow=" + (hasGroundBelow ? "true" : "false"));
+    // Trace the box a little way down: grounded if it lands on something walkable.
+    // A box already sunk into the floor can't move down at all (allSolid).
+    BSPTraceResult trace;
+    Vector3 below = {position.x, position.y - GROUND_PROBE_DISTANCE, position.z};
+    TraceBox(position, below, Vector3Scale(size, 0.5f), trace);
+    bool hasGroundBelow = trace.allSolid || (trace.hit && IsWalkableSlope(trace.normal));
 
     return hasGroundBelow;
 }
@@ -940,9 +1139,13 @@ Vector3 PhysicsSystem::GetGroundNormal(const Vector3& position) const {
     LOG_INFO("GROUND NORMAL: Casting ray from (" + std::to_string(rayStart.x) + "," + std::to_string(rayStart.y) + "," + std::to_string(rayStart.z) +
              ") downward " + std::to_string(RAY_LENGTH) + " units");
 
-    // TODO: Use CollisionSystem for ray casting instead of direct BSPTree access
-    float hitDistance = RAY_LENGTH; // Placeholder
+    float hitDistance = RAY_LENGTH;
     hitNormal = {0, 1, 0}; // Default up normal
+    TriangleBVH::RayHit hit;
+    if (CastRayWorld(rayStart, rayDirection, RAY_LENGTH, hit)) {
+        hitDistance = hit.distance;
+        hitNormal = hit.normal;
+    }
 
     LOG_INFO("GROUND NORMAL: Raycast result - distance: " + std::to_string(hitDistance) +
              ", max distance: " + std::to_string(RAY_LENGTH) +
@@ -1010,59 +1213,6 @@ Vector3 PhysicsSystem::SlideVelocity(const Vector3& velocity, const Vector3& nor
 }
 
 
-Vector3 PhysicsSystem::ResolveConstrainedMovement(Entity* entity, const Vector3& currentPos, const Vector3& intendedMovement) {
-    // Constraint-based collision: prevent movement into collision zones, allow sliding
-
-    // Try movement components separately for smooth sliding
-    Vector3 remainingMovement = intendedMovement;
-    Vector3 finalMovement = {0, 0, 0};
-
-    // Try X movement first
-    if (fabsf(remainingMovement.x) > 0.001f) {
-        Vector3 xMovement = {remainingMovement.x, 0, 0};
-        Vector3 testPos = Vector3Add(Vector3Add(currentPos, finalMovement), xMovement);
-
-        if (!CheckCollisionAtPosition(entity, testPos)) {
-            finalMovement.x += remainingMovement.x;
-        }
-    }
-
-    // Try Z movement
-    if (fabsf(remainingMovement.z) > 0.001f) {
-        Vector3 zMovement = {0, 0, remainingMovement.z};
-        Vector3 testPos = Vector3Add(Vector3Add(currentPos, finalMovement), zMovement);
-
-        if (!CheckCollisionAtPosition(entity, testPos)) {
-            finalMovement.z += remainingMovement.z;
-        }
-    }
-
-    // Try Y movement (gravity/jumping)
-    if (fabsf(remainingMovement.y) > 0.001f) {
-        Vector3 yMovement = {0, remainingMovement.y, 0};
-        Vector3 testPos = Vector3Add(Vector3Add(currentPos, finalMovement), yMovement);
-
-        if (!CheckCollisionAtPosition(entity, testPos)) {
-            finalMovement.y += remainingMovement.y;
-        }
-    }
-
-    // If we couldn't move in individual axes, try diagonal combinations
-    if (Vector3Length(finalMovement) < 0.001f && Vector3Length(intendedMovement) > 0.001f) {
-        // Try XZ diagonal movement (common for corner sliding)
-        Vector3 xzMovement = {intendedMovement.x, 0, intendedMovement.z};
-        if (Vector3Length(xzMovement) > 0.001f) {
-            Vector3 testPos = Vector3Add(currentPos, xzMovement);
-            if (!CheckCollisionAtPosition(entity, testPos)) {
-                finalMovement.x = intendedMovement.x;
-                finalMovement.z = intendedMovement.z;
-            }
-        }
-    }
-
-    return finalMovement;
-}
-
 void PhysicsSystem::ApplyUnstuckCorrection(Entity* entity, float deltaTime) {
     auto* transform = entity->GetComponent<TransformComponent>();
     auto* collidable = entity->GetComponent<Collidable>();
@@ -1134,82 +1284,27 @@ void PhysicsSystem::ApplyUnstuckCorrection(Entity* entity, float deltaTime) {
 
 
 
-bool PhysicsSystem::TryStepUp(Entity* entity, const Vector3& intendedMovement) {
-    auto* transform = entity->GetComponent<TransformComponent>();
-    auto* collidable = entity->GetComponent<Collidable>();
-    auto* velocity = entity->GetComponent<Velocity>();
-
-    if (!transform || !collidable || !velocity) return false;
-
-    Vector3 currentPos = transform->position;
-
-    // Only attempt step-up for horizontal movement
-    Vector3 horizontalMovement = {intendedMovement.x, 0, intendedMovement.z};
-    if (Vector3Length(horizontalMovement) < 0.001f) {
-        LOG_INFO("STEP-UP: Skipping - no horizontal movement");
-        return false;
-    }
+// Step move (PM_StepSlideMove): trace up a step, slide the horizontal part of
+// the move, trace back down and only keep it when landing on walkable ground
+bool PhysicsSystem::TryStepUp(const Vector3& start, const Vector3& halfExtents, const Vector3& intendedMovement,
+                              SlideMoveResult& outMove) {
+    BSPTraceResult trace;
+    TraceBox(start, Vector3Add(start, {0.0f, STEP_HEIGHT, 0.0f}), halfExtents, trace);
+    if (trace.allSolid) return false;
 
-    LOG_INFO("STEP-UP: Attempting step-up with horizontal movement: (" + 
-             std::to_string(horizontalMovement.x) + "," + std::to_string(horizontalMovement.z) + ")");
+    Vector3 raised = trace.point;
+    float stepUp = raised.y - start.y;
+    if (stepUp < CONTACT_TOLERANCE) return false; // Ceiling right above
 
-    // Industry standard approach: Simple step offset
-    const float STEP_OFFSET = STEP_HEIGHT; // Use the defined constant (0.6 units)
-    const float STEP_EPSILON = 0.02f; // Small buffer for precision
+    outMove = SlideMove(raised, halfExtents, {intendedMovement.x, 0.0f, intendedMovement.z});
 
-    // Try to move up by step offset + intended horizontal movement
-    Vector3 liftedPos = Vector3Add(currentPos, {horizontalMovement.x, STEP_OFFSET, horizontalMovement.z});
+    TraceBox(outMove.position, Vector3Add(outMove.position, {0.0f, -stepUp, 0.0f}), halfExtents, trace);
+    if (trace.allSolid || !trace.hit || !IsWalkableSlope(trace.normal)) return false;
 
-    LOG_INFO("STEP-UP: Testing lifted position: (" + 
-             std::to_string(liftedPos.x) + "," + std::to_string(liftedPos.y) + "," + std::to_string(liftedPos.z) + ")");
-
-    // Check if we can stand at the lifted position (no collision above)
-    if (CheckCollisionAtPosition(entity, liftedPos)) {
-        LOG_INFO("STEP-UP: Collision at lifted position - cannot step up");
-        return false;
-    }
-
-    // Check if there's solid ground below the lifted position
-    // This uses the existing ground detection logic
-    bool hasGroundBelow = IsOnGround(liftedPos, collidable->GetBounds().GetSize());
-    
-    if (hasGroundBelow) {
-        LOG_INFO("STEP-UP: Found ground below lifted position - successful step up");
-        
-        // Move to lifted position
-        transform->position = liftedPos;
-        collidable->UpdateBoundsFromPosition(liftedPos);
-        
-        // Reset vertical velocity to prevent bouncing
-        velocity->SetY(0.0f);
-        
-        return true;
-    } else {
-        // Alternative approach: Try to find the actual step surface height
-        // Check for ground at various heights below the lifted position
-        for (float dropHeight = STEP_EPSILON; dropHeight <= STEP_OFFSET + STEP_EPSILON; dropHeight += 0.1f) {
-            Vector3 testPos = Vector3Add(liftedPos, {0, -dropHeight, 0});
-            
-            // Ensure we don't step down below original position
-            if (testPos.y < currentPos.y - STEP_EPSILON) {
-                continue;
-            }
-            
-            if (IsOnGround(testPos, collidable->GetBounds().GetSize())) {
-                LOG_INFO("STEP-UP: Found step surface at height " + std::to_string(testPos.y) + 
-                         " (drop: " + std::to_string(dropHeight) + ")");
-                
-                transform->position = testPos;
-                collidable->UpdateBoundsFromPosition(testPos);
-                velocity->SetY(0.0f);
-                
-                return true;
-            }
-        }
-    }
-
-    LOG_INFO("STEP-UP: No valid step surface found - step up failed");
-    return false;
+    outMove.position = trace.point;
+    outMove.blocked = true;
+    outMove.movement.y = 0.0f;
+    return true;
 }
 
 std::vector<CollisionPlane> PhysicsSystem::GatherCollisionPlanes(Entity* entity, const Vector3& position) {
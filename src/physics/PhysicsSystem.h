@@ -8,6 +8,8 @@
 #include "../world/BSPTree.h"
 #include "../ecs/Systems/CollisionSystem.h"
 #include "../ecs/Systems/WorldSystem.h"
+#include <cstdint>
+#include <unordered_map>
 
 // Physics constants
 const float GRAVITY = -30.0f;          // Gravity acceleration (units/s²)
@@ -23,6 +25,11 @@ const float PENETRATION_SLOP = 0.005f;   // Allowed penetration before hard corr
 const float STEP_HEIGHT = 0.6f;          // Maximum step height for stair climbing (increased for larger stairs)
 const float SLOPE_THRESHOLD = 0.7f;      // Surface normal Y component threshold for slopes (cos(45°) ≈ 0.707)
 const float MAX_SLOPE_ANGLE = 45.0f;     // Maximum walkable slope angle in degrees
+const int MAX_SLIDE_BUMPS = 4;           // Box traces per slide move before giving up on the rest
+const float GROUND_PROBE_DISTANCE = 0.05f; // How far below the feet IsOnGround traces
+const float DEFAULT_TICK_RATE = 60.0f;     // Deterministic mode ticks per second
+const int MAX_FIXED_STEPS = 8;            // Deterministic ticks per Update before the backlog is dropped
+const int SLEEP_TICKS = 30;               // Grounded ticks under VELOCITY_EPSILON before a body sleeps
 
 /**
  * Physics system that handles movement, gravity, collision response, and player state management
@@ -35,6 +42,20 @@ struct CollisionPlane {
     bool isContact;  // True for resting contact, false for collision
 };
 
+// Outcome of a slide move (a few box traces, clipping against each contact)
+struct SlideMoveResult {
+    Vector3 position;
+    Vector3 movement;   // Intended movement clipped against every contact plane
+    bool blocked;       // Touched anything
+    bool hitWall;       // Touched a plane too steep to walk on
+};
+
+// A bullet's first hit this tick, for paint splats and damage
+struct ProjectileImpact {
+    Entity* projectile;
+    SweepHit hit;           // fraction is the time of impact within the tick
+};
+
 struct StabilizedMovement {
     Vector3 position;
     Vector3 velocity;
@@ -62,6 +83,62 @@ public:
     void SetCollisionSystem(System* collisionSystem) { collisionSystem_ = collisionSystem; }
     void SetWorldSystem(System* worldSystem) { worldSystem_ = static_cast<WorldSystem*>(worldSystem); }
 
+    // Bullets (Collidable::IsBullet) that hit something during the last Update
+    const std::vector<ProjectileImpact>& GetProjectileImpacts() const { return projectileImpacts_; }
+
+    // Sleeping: a non-player body that stays grounded and under
+    // VELOCITY_EPSILON for SLEEP_TICKS ticks is skipped until it is pushed,
+    // moved or given velocity, hit by a bullet, or woken below
+    struct SleepStats {
+        size_t awake = 0;
+        size_t asleep = 0;
+        size_t fellAsleep = 0;  // This tick
+        size_t woke = 0;        // This tick
+    };
+    void SetSleepEnabled(bool enabled);
+    bool IsSleepEnabled() const { return sleepEnabled_; }
+    const SleepStats& GetSleepStats() const { return sleepStats_; }
+    void WakeBody(Entity* entity);
+    // Geometry changed (door, moving brush): wake every body whose bounds touch region
+    void WakeBodiesIn(const AABB& region);
+    void WakeAllBodies();
+
+    // Deterministic mode (lockstep, rollback, reproducible perf runs): Update
+    // runs whole ticks of 1/tickRate out of an accumulator instead of one
+    // step of the frame time. Bodies always go in entity ID order and the sim
+    // never reads the wall clock, so the same start state and inputs give
+    // bit-identical ticks on any thread count.
+    void SetDeterministic(bool enabled, float tickRate = DEFAULT_TICK_RATE);
+    bool IsDeterministic() const { return deterministic_; }
+    float GetFixedDeltaTime() const { return fixedDeltaTime_; }
+    uint64_t GetTick() const { return tick_; }
+    // One fixed tick, for callers that drive the simulation themselves
+    void StepFixed();
+
+    // Physics state of every entity, for rollback and replay checks
+    struct BodyState {
+        Entity* entity;
+        Vector3 position;
+        Vector3 velocity;
+        AABB bounds;
+        PlayerState playerState;
+        bool jumping;
+        bool asleep;
+        int quietTicks;
+    };
+    struct Snapshot {
+        uint64_t tick = 0;
+        float simTime = 0.0f;
+        float mapLoadTime = 0.0f;
+        std::vector<BodyState> bodies;  // Entity ID order
+    };
+    void SaveState(Snapshot& out) const;
+    // Entities missing from the snapshot are left alone
+    void RestoreState(const Snapshot& snapshot);
+    // FNV-1a over the tick and the bit patterns of every body's state, in
+    // entity ID order
+    uint64_t ComputeStateChecksum() const;
+
 private:
     float gravity_;
     float terminalVelocity_;
@@ -72,23 +149,82 @@ private:
     WorldSystem* worldSystem_;
 
     // Physics startup delay to ensure collision system is ready
-    float mapLoadTime_;
+    float mapLoadTime_;          // simTime_ when the map finished loading
     float physicsStartupDelay_;  // Delay in seconds after map loads before physics starts
 
+    // Simulated clock and fixed tick state
+    float simTime_;
+    uint64_t tick_;
+    bool deterministic_;
+    float fixedDeltaTime_;
+    float accumulator_;
+
+    void Step(float deltaTime);
+    void CollectBodies();
+
     // Pre-allocated containers to avoid per-frame allocations (performance optimization)
     std::vector<CollisionEvent> collisionEventsCache_;
     std::vector<CollisionEvent> collisionsCache_;
     std::vector<CollisionPlane> collisionPlanesCache_;
+    mutable std::vector<TriangleBVH::Contact> worldContacts_;
+    std::vector<ProjectileImpact> projectileImpacts_;
+
+    // World candidates around the player being moved, gathered once per
+    // UpdatePlayerPhysics; the probes below use it when they fit inside
+    CollisionNeighborhood neighborhood_;
+
+    // Sleep bookkeeping per non-player body, kept across ticks
+    struct RestState {
+        int quietTicks = 0;             // Consecutive grounded ticks under VELOCITY_EPSILON
+        bool asleep = false;
+        Vector3 restPosition{0, 0, 0};  // Where it fell asleep; moving it wakes it
+        AABB restBounds;                // Entity pushes move Position and the bounds, not the transform
+        uint32_t lastSeen = 0;
+    };
+    bool sleepEnabled_;
+    SleepStats sleepStats_;
+    std::unordered_map<Entity*, RestState> restStates_;
+    uint32_t restStamp_;
+    const World* restWorld_;    // Geometry the sleepers settled on; a new world wakes them
+
+    // Non-player entity moving through the tick's phases
+    struct PhysicsBody {
+        Entity* entity = nullptr;
+        RestState* rest = nullptr;
+        bool bullet = false;
+        Vector3 movement{0, 0, 0};          // This tick's move, from phase 1
+        Vector3 sweptPosition{0, 0, 0};     // Bullets: where the sweep stopped
+        bool impacted = false;
+        bool fellAsleep = false;
+        SweepHit impact;
+    };
+    static constexpr size_t BODY_GRAIN = 16;    // Bodies per job
+
+    std::vector<Entity*> players_;
+    std::vector<PhysicsBody> bodies_;
+    std::vector<std::vector<CollisionPlane>> slidePlanes_;  // SlideMove scratch, one per job thread
 
     // Physics update methods
-    void UpdateEntityPhysics(Entity* entity, float deltaTime);
     void UpdatePlayerPhysics(Entity* playerEntity, float deltaTime);
+    void IntegrateBody(PhysicsBody& body, float deltaTime);
+    void ResolveBodyWorld(PhysicsBody& body, float deltaTime);
+    void SweepBullet(PhysicsBody& body);
+    void UpdateRest(PhysicsBody& body, bool onGround);
 
     // Force and movement calculations
     void ApplyGravity(Velocity& velocity, float deltaTime);
     void ApplyFriction(Velocity& velocity, float deltaTime, bool onGround);
     void ApplyAirResistance(Velocity& velocity, float deltaTime);
 
+    // World ray (collision triangles), answered from the neighborhood when it covers the ray
+    bool CastRayWorld(const Vector3& origin, const Vector3& direction, float maxDistance,
+                      TriangleBVH::RayHit& outHit) const;
+
+    // Swept box movement (BSP box traces)
+    bool TraceBox(const Vector3& start, const Vector3& end, const Vector3& halfExtents, BSPTraceResult& result) const;
+    SlideMoveResult SlideMove(const Vector3& start, const Vector3& halfExtents, const Vector3& movement);
+    Vector3 ClipToPlanes(const Vector3& movement, const std::vector<CollisionPlane>& planes);
+
     // Collision and movement resolution
     void ResolveMovement(Entity* entity, const Vector3& intendedMovement, float deltaTime);
     bool CheckGroundCollision(const Vector3& position, const Vector3& size) const;
@@ -99,7 +235,6 @@ private:
     void HandleMultipleCollisions(Entity* entity, const Vector3& intendedMovement, const std::vector<CollisionEvent>& collisions);
     bool WouldCollideWithAny(Entity* entity, const Vector3& position, const std::vector<CollisionEvent>& collisions, size_t excludeIndex) const;
     CollisionEvent GetDetailedCollision(Entity* entity, const Vector3& position, const Vector3& movement) const;
-    void TryHorizontalMovement(Entity* entity, const Vector3& intendedMovement);
 
     // Player-specific physics
     void UpdatePlayerState(Entity* playerEntity);
@@ -110,8 +245,8 @@ private:
     // Enhanced collision handling methods
     Vector3 ResolveCornerCollision(const Vector3& velocity, const std::vector<CollisionPlane>& planes);
     Vector3 SlideVelocity(const Vector3& velocity, const Vector3& normal);
-    Vector3 ResolveConstrainedMovement(Entity* entity, const Vector3& currentPos, const Vector3& intendedMovement);
-    bool TryStepUp(Entity* entity, const Vector3& intendedMovement);
+    bool TryStepUp(const Vector3& start, const Vector3& halfExtents, const Vector3& intendedMovement,
+                   SlideMoveResult& outMove);
     std::vector<CollisionPlane> GatherCollisionPlanes(Entity* entity, const Vector3& position);
     
     // Slope detection and handling
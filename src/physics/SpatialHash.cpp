@@ -0,0 +1,226 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int32_t CELL_COORD_LIMIT = (1 << 20) - 1;    // 21 signed bits per axis in a key
+    constexpr uint64_t CELL_KEY_MASK = (1ull << 21) - 1;
+
+    size_t NextPowerOfTwo(size_t value) {
+        size_t result = 16;
+        while (result < value) result <<= 1;
+        return result;
+    }
+
+    uint64_t HashKey(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDull;
+        key ^= key >> 33;
+        return key;
+    }
+}
+
+SpatialHash::SpatialHash(float cellSize) {
+    SetCellSize(cellSize);
+}
+
+void SpatialHash::SetCellSize(float cellSize) {
+    cellSize_ = cellSize > 0.0f ? cellSize : DEFAULT_CELL_SIZE;
+    invCellSize_ = 1.0f / cellSize_;
+}
+
+int32_t SpatialHash::CellCoord(float value) const {
+    float cell = std::floor(value * invCellSize_);
+    if (!(cell > -CELL_COORD_LIMIT)) return -CELL_COORD_LIMIT;    // Also catches NaN
+    if (cell > CELL_COORD_LIMIT) return CELL_COORD_LIMIT;
+    return static_cast<int32_t>(cell);
+}
+
+uint64_t SpatialHash::PackKey(int32_t x, int32_t y, int32_t z) {
+    return (static_cast<uint64_t>(x) & CELL_KEY_MASK) << 42 |
+           (static_cast<uint64_t>(y) & CELL_KEY_MASK) << 21 |
+           (static_cast<uint64_t>(z) & CELL_KEY_MASK);
+}
+
+void SpatialHash::Clear() {
+    objects_.clear();
+    oversized_.clear();
+    cells_.clear();
+    cellObjects_.clear();
+    stats_ = Stats();
+}
+
+void SpatialHash::Insert(uint32_t id, const AABB& bounds, uint32_t layer, uint32_t mask) {
+    Object object;
+    object.bounds = bounds;
+    object.id = id;
+    object.layer = layer;
+    object.mask = mask;
+    object.minCell[0] = CellCoord(bounds.min.x);
+    object.minCell[1] = CellCoord(bounds.min.y);
+    object.minCell[2] = CellCoord(bounds.min.z);
+    object.maxCell[0] = CellCoord(bounds.max.x);
+    object.maxCell[1] = CellCoord(bounds.max.y);
+    object.maxCell[2] = CellCoord(bounds.max.z);
+
+    uint64_t cellCount = 1;
+    for (int axis = 0; axis < 3; ++axis) {
+        object.maxCell[axis] = std::max(object.maxCell[axis], object.minCell[axis]);   // Inverted boxes
+        cellCount *= static_cast<uint64_t>(object.maxCell[axis] - object.minCell[axis] + 1);
+    }
+    object.oversized = cellCount > MAX_CELLS_PER_OBJECT;
+    objects_.push_back(object);
+}
+
+uint32_t SpatialHash::FindOrAddCell(int32_t x, int32_t y, int32_t z) {
+    const uint64_t key = PackKey(x, y, z);
+    for (size_t slot = HashKey(key) & slotMask_;; slot = (slot + 1) & slotMask_) {
+        if (slotCells_[slot] == 0) {
+            slotKeys_[slot] = key;
+            slotCells_[slot] = static_cast<uint32_t>(cells_.size()) + 1;
+            cells_.push_back({x, y, z, 0, 0});
+            return static_cast<uint32_t>(cells_.size() - 1);
+        }
+        if (slotKeys_[slot] == key) return slotCells_[slot] - 1;
+    }
+}
+
+int64_t SpatialHash::FindCell(int32_t x, int32_t y, int32_t z) const {
+    if (slotCells_.empty()) return -1;
+    const uint64_t key = PackKey(x, y, z);
+    for (size_t slot = HashKey(key) & slotMask_;; slot = (slot + 1) & slotMask_) {
+        if (slotCells_[slot] == 0) return -1;
+        if (slotKeys_[slot] == key) return static_cast<int64_t>(slotCells_[slot]) - 1;
+    }
+}
+
+void SpatialHash::Build() {
+    cells_.clear();
+    oversized_.clear();
+
+    size_t entries = 0;
+    for (uint32_t i = 0; i < objects_.size(); ++i) {
+        const Object& object = objects_[i];
+        if (object.oversized) {
+            oversized_.push_back(i);
+            continue;
+        }
+        entries += static_cast<size_t>(object.maxCell[0] - object.minCell[0] + 1) *
+                   (object.maxCell[1] - object.minCell[1] + 1) * (object.maxCell[2] - object.minCell[2] + 1);
+    }
+
+    // At most one cell per entry; keep the table under half full
+    size_t slotCount = NextPowerOfTwo(entries * 2);
+    slotKeys_.resize(slotCount);
+    slotCells_.assign(slotCount, 0);
+    slotMask_ = slotCount - 1;
+
+    // Count per cell, then place: cell contents end up contiguous
+    for (const Object& object : objects_) {
+        if (object.oversized) continue;
+        for (int32_t z = object.minCell[2]; z <= object.maxCell[2]; ++z)
+            for (int32_t y = object.minCell[1]; y <= object.maxCell[1]; ++y)
+                for (int32_t x = object.minCell[0]; x <= object.maxCell[0]; ++x)
+                    cells_[FindOrAddCell(x, y, z)].count++;
+    }
+    uint32_t first = 0;
+    cellCursor_.resize(cells_.size());
+    for (size_t c = 0; c < cells_.size(); ++c) {
+        cells_[c].first = first;
+        cellCursor_[c] = first;
+        first += cells_[c].count;
+    }
+    cellObjects_.resize(first);
+    for (uint32_t i = 0; i < objects_.size(); ++i) {
+        const Object& object = objects_[i];
+        if (object.oversized) continue;
+        for (int32_t z = object.minCell[2]; z <= object.maxCell[2]; ++z)
+            for (int32_t y = object.minCell[1]; y <= object.maxCell[1]; ++y)
+                for (int32_t x = object.minCell[0]; x <= object.maxCell[0]; ++x)
+                    cellObjects_[cellCursor_[FindCell(x, y, z)]++] = i;
+    }
+
+    stats_ = Stats();
+    stats_.objects = objects_.size();
+    stats_.oversized = oversized_.size();
+    stats_.cells = cells_.size();
+    stats_.entries = entries;
+}
+
+void SpatialHash::FindPairs(std::vector<Pair>& outPairs) {
+    outPairs.clear();
+    size_t candidates = 0;
+
+    for (const Cell& cell : cells_) {
+        const uint32_t* members = cellObjects_.data() + cell.first;
+        for (uint32_t i = 0; i < cell.count; ++i) {
+            const Object& a = objects_[members[i]];
+            for (uint32_t j = i + 1; j < cell.count; ++j) {
+                const Object& b = objects_[members[j]];
+                candidates++;
+                if (!Accepts(a, b) || !a.bounds.Intersects(b.bounds)) continue;
+
+                // Report from the cell holding the overlap's min corner only
+                if (CellCoord(std::max(a.bounds.min.x, b.bounds.min.x)) != cell.x ||
+                    CellCoord(std::max(a.bounds.min.y, b.bounds.min.y)) != cell.y ||
+                    CellCoord(std::max(a.bounds.min.z, b.bounds.min.z)) != cell.z) continue;
+
+                outPairs.push_back(a.id < b.id ? Pair(a.id, b.id) : Pair(b.id, a.id));
+            }
+        }
+    }
+
+    // Oversized boxes against everything (each oversized pair once)
+    for (size_t o = 0; o < oversized_.size(); ++o) {
+        const Object& big = objects_[oversized_[o]];
+        for (uint32_t i = 0; i < objects_.size(); ++i) {
+            const Object& other = objects_[i];
+            if (i == oversized_[o] || (other.oversized && i < oversized_[o])) continue;
+            candidates++;
+            if (!Accepts(big, other) || !big.bounds.Intersects(other.bounds)) continue;
+            outPairs.push_back(big.id < other.id ? Pair(big.id, other.id) : Pair(other.id, big.id));
+        }
+    }
+
+    // Same order an all-pairs loop over ids would give
+    std::sort(outPairs.begin(), outPairs.end());
+    stats_.candidates = candidates;
+    stats_.pairs = outPairs.size();
+}
+
+void SpatialHash::Query(const AABB& bounds, std::vector<uint32_t>& outIds) const {
+    outIds.clear();
+    const int32_t minCell[3] = {CellCoord(bounds.min.x), CellCoord(bounds.min.y), CellCoord(bounds.min.z)};
+    const int32_t maxCell[3] = {CellCoord(bounds.max.x), CellCoord(bounds.max.y), CellCoord(bounds.max.z)};
+    uint64_t cellCount = 1;
+    for (int axis = 0; axis < 3; ++axis) {
+        cellCount *= static_cast<uint64_t>(maxCell[axis] - minCell[axis] + 1);
+    }
+
+    if (cellCount > cells_.size()) {
+        // Bigger than the occupied grid: a plain scan is cheaper
+        for (const Object& object : objects_) {
+            if (object.bounds.Intersects(bounds)) outIds.push_back(object.id);
+        }
+    } else {
+        for (int32_t z = minCell[2]; z <= maxCell[2]; ++z) {
+            for (int32_t y = minCell[1]; y <= maxCell[1]; ++y) {
+                for (int32_t x = minCell[0]; x <= maxCell[0]; ++x) {
+                    int64_t c = FindCell(x, y, z);
+                    if (c < 0) continue;
+                    const Cell& cell = cells_[c];
+                    for (uint32_t i = 0; i < cell.count; ++i) {
+                        const Object& object = objects_[cellObjects_[cell.first + i]];
+                        if (object.bounds.Intersects(bounds)) outIds.push_back(object.id);
+                    }
+                }
+            }
+        }
+        for (uint32_t index : oversized_) {
+            if (objects_[index].bounds.Intersects(bounds)) outIds.push_back(objects_[index].id);
+        }
+    }
+
+    std::sort(outIds.begin(), outIds.end());
+    outIds.erase(std::unique(outIds.begin(), outIds.end()), outIds.end());
+}
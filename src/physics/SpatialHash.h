@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../math/AABB.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Uniform spatial hash broadphase. Every box is inserted into each grid cell
+// it overlaps (cells live in an open addressing table keyed by their integer
+// coordinates), and only boxes sharing a cell become candidate pairs. With
+// boxes around the cell size that is linear in the object count instead of
+// all pairs.
+//
+// A pair sharing several cells is reported once: only by the cell holding
+// the min corner of the two boxes' overlap. Boxes covering more than
+// MAX_CELLS_PER_OBJECT cells stay out of the grid and are tested against
+// everything instead.
+//
+// Rebuilt every tick (Clear, Insert, Build); storage is kept between ticks so
+// a steady scene doesn't allocate.
+class SpatialHash {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 4.0f;
+    static constexpr uint32_t MAX_CELLS_PER_OBJECT = 64;
+
+    using Pair = std::pair<uint32_t, uint32_t>;
+
+    struct Stats {
+        size_t objects = 0;
+        size_t oversized = 0;       // Objects kept out of the grid
+        size_t cells = 0;           // Occupied cells
+        size_t entries = 0;         // Object/cell memberships
+        size_t candidates = 0;      // Same-cell pairs looked at
+        size_t pairs = 0;           // Pairs reported
+    };
+
+    explicit SpatialHash(float cellSize = DEFAULT_CELL_SIZE);
+
+    void SetCellSize(float cellSize);
+    float GetCellSize() const { return cellSize_; }
+
+    void Clear();
+    // ids are the caller's (e.g. an index into its entity list) and must be
+    // unique. Pairs are only reported when each side's mask accepts the other's
+    // layer, the same rule as Collidable::ShouldCollideWith.
+    void Insert(uint32_t id, const AABB& bounds, uint32_t layer = 0xFFFFFFFFu, uint32_t mask = 0xFFFFFFFFu);
+    void Build();
+
+    // Unique overlapping, layer-compatible pairs with first < second, sorted
+    void FindPairs(std::vector<Pair>& outPairs);
+    // ids of the boxes overlapping bounds, sorted, no layer filtering
+    void Query(const AABB& bounds, std::vector<uint32_t>& outIds) const;
+
+    size_t GetObjectCount() const { return objects_.size(); }
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    struct Object {
+        AABB bounds;
+        uint32_t id;
+        uint32_t layer, mask;
+        int32_t minCell[3], maxCell[3];
+        bool oversized;
+    };
+
+    struct Cell {
+        int32_t x, y, z;
+        uint32_t first;     // Into cellObjects_
+        uint32_t count;
+    };
+
+    int32_t CellCoord(float value) const;
+    static uint64_t PackKey(int32_t x, int32_t y, int32_t z);
+    uint32_t FindOrAddCell(int32_t x, int32_t y, int32_t z);
+    int64_t FindCell(int32_t x, int32_t y, int32_t z) const;
+    static bool Accepts(const Object& a, const Object& b) {
+        return (a.mask & b.layer) != 0 && (b.mask & a.layer) != 0;
+    }
+
+    float cellSize_;
+    float invCellSize_;
+
+    std::vector<Object> objects_;
+    std::vector<uint32_t> oversized_;       // Object indices
+    std::vector<Cell> cells_;
+    std::vector<uint32_t> cellObjects_;     // Object indices grouped by cell
+    std::vector<uint32_t> cellCursor_;      // Build scratch
+
+    // Open addressing table: slotKeys_ / slotCells_ (cell index + 1, 0 = empty)
+    std::vector<uint64_t> slotKeys_;
+    std::vector<uint32_t> slotCells_;
+    size_t slotMask_ = 0;
+
+    Stats stats_;
+};
@@ -0,0 +1,535 @@
+#include "TriangleBVH.h"
+#include "../world/WorldGeometry.h"
+#include "../world/WorldMesh.h"
+#include "raymath.h"
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    constexpr float TRAVERSAL_COST = 1.0f;      // Relative to one triangle test
+    constexpr float BARYCENTRIC_EPSILON = 1e-5f;  // So rays can't slip between triangles sharing an edge
+
+    float SurfaceArea(const AABB& box) {
+        Vector3 d = Vector3Subtract(box.max, box.min);
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    float Axis(const Vector3& v, int axis) {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    bool NodeOverlaps(const TriangleBVH::Node& node, const AABB& box) {
+        return node.min.x <= box.max.x && node.max.x >= box.min.x &&
+               node.min.y <= box.max.y && node.max.y >= box.min.y &&
+               node.min.z <= box.max.z && node.max.z >= box.min.z;
+    }
+
+    // Entry distance of the ray into the node (grown by inflate on every
+    // side), FLT_MAX on a miss
+    float NodeEntry(const TriangleBVH::Node& node, const Vector3& origin, const Vector3& invDirection, float maxDistance,
+                    float inflate = 0.0f) {
+        float t1 = (node.min.x - inflate - origin.x) * invDirection.x;
+        float t2 = (node.max.x + inflate - origin.x) * invDirection.x;
+        float tmin = std::min(t1, t2), tmax = std::max(t1, t2);
+        t1 = (node.min.y - inflate - origin.y) * invDirection.y;
+        t2 = (node.max.y + inflate - origin.y) * invDirection.y;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+        t1 = (node.min.z - inflate - origin.z) * invDirection.z;
+        t2 = (node.max.z + inflate - origin.z) * invDirection.z;
+        tmin = std::max(tmin, std::min(t1, t2));
+        tmax = std::min(tmax, std::max(t1, t2));
+        tmin = std::max(tmin, 0.0f);
+        return (tmax >= tmin && tmin <= maxDistance) ? tmin : FLT_MAX;
+    }
+
+    // Ray against a sphere; 0 if the origin is already inside
+    bool RaySphere(const Vector3& origin, const Vector3& direction, const Vector3& center, float radius,
+                   float& outDistance) {
+        Vector3 m = Vector3Subtract(origin, center);
+        float c = Vector3DotProduct(m, m) - radius * radius;
+        if (c <= 0.0f) {
+            outDistance = 0.0f;
+            return true;
+        }
+        float b = Vector3DotProduct(m, direction);
+        float discriminant = b * b - c;
+        if (b > 0.0f || discriminant < 0.0f) return false;
+        outDistance = -b - std::sqrt(discriminant);
+        return true;
+    }
+
+    // Ray against the round side of the capsule around segment ab (the end
+    // caps are the vertex spheres); 0 if the origin is already inside
+    bool RayCylinder(const Vector3& origin, const Vector3& direction, const Vector3& a, const Vector3& b, float radius,
+                     float& outDistance, Vector3& outPoint) {
+        Vector3 axis = Vector3Subtract(b, a);
+        float axisSq = Vector3DotProduct(axis, axis);
+        if (axisSq < 1e-12f) return false;
+        Vector3 fromA = Vector3Subtract(origin, a);
+        float axisOrigin = Vector3DotProduct(axis, fromA) / axisSq;
+        float axisDirection = Vector3DotProduct(axis, direction) / axisSq;
+
+        // Origin and direction with the axis component removed
+        Vector3 o = Vector3Subtract(fromA, Vector3Scale(axis, axisOrigin));
+        Vector3 d = Vector3Subtract(direction, Vector3Scale(axis, axisDirection));
+        float qa = Vector3DotProduct(d, d);
+        float qb = Vector3DotProduct(o, d);
+        float qc = Vector3DotProduct(o, o) - radius * radius;
+
+        float t = 0.0f;
+        if (qc > 0.0f) {
+            float discriminant = qb * qb - qa * qc;
+            if (qa < 1e-12f || qb >= 0.0f || discriminant < 0.0f) return false;
+            t = (-qb - std::sqrt(discriminant)) / qa;
+        }
+        float s = axisOrigin + axisDirection * t;
+        if (s < 0.0f || s > 1.0f) return false;
+        outDistance = t;
+        outPoint = Vector3Add(a, Vector3Scale(axis, s));
+        return true;
+    }
+
+    bool PointInTriangle(const Vector3& p, const TriangleBVH::Triangle& t) {
+        Vector3 e0 = Vector3Subtract(t.v1, t.v0);
+        Vector3 e1 = Vector3Subtract(t.v2, t.v0);
+        Vector3 ep = Vector3Subtract(p, t.v0);
+        float d00 = Vector3DotProduct(e0, e0), d01 = Vector3DotProduct(e0, e1), d11 = Vector3DotProduct(e1, e1);
+        float d20 = Vector3DotProduct(ep, e0), d21 = Vector3DotProduct(ep, e1);
+        float denom = d00 * d11 - d01 * d01;
+        if (std::fabs(denom) < 1e-12f) return false;
+        float v = (d11 * d20 - d01 * d21) / denom;
+        float w = (d00 * d21 - d01 * d20) / denom;
+        return v >= -BARYCENTRIC_EPSILON && w >= -BARYCENTRIC_EPSILON && v + w <= 1.0f + BARYCENTRIC_EPSILON;
+    }
+
+    // Earliest touch of a moving sphere and a triangle. The face is tried
+    // first: when the sphere reaches the plane inside the triangle nothing
+    // else can come sooner. Otherwise the first edge or corner it meets.
+    bool SweepSphereTriangle(const TriangleBVH::Triangle& t, const Vector3& origin, const Vector3& direction,
+                             float radius, float maxDistance, float& outDistance, Vector3& outPoint) {
+        Vector3 normal = Vector3CrossProduct(Vector3Subtract(t.v1, t.v0), Vector3Subtract(t.v2, t.v0));
+        float normalLength = Vector3Length(normal);
+        if (normalLength > 1e-12f) {
+            normal = Vector3Scale(normal, 1.0f / normalLength);
+            float planeDistance = Vector3DotProduct(Vector3Subtract(origin, t.v0), normal);
+            if (planeDistance < 0.0f) {
+                normal = Vector3Negate(normal);
+                planeDistance = -planeDistance;
+            }
+            float approach = -Vector3DotProduct(direction, normal);
+            float planeTime = -1.0f;
+            if (planeDistance <= radius) {
+                planeTime = 0.0f;
+            } else if (approach > 0.0f) {
+                planeTime = (planeDistance - radius) / approach;
+            }
+            if (planeTime >= 0.0f && planeTime <= maxDistance) {
+                Vector3 center = Vector3Add(origin, Vector3Scale(direction, planeTime));
+                Vector3 contact = Vector3Subtract(center, Vector3Scale(normal, std::min(planeDistance, radius)));
+                if (PointInTriangle(contact, t)) {
+                    outDistance = planeTime;
+                    outPoint = contact;
+                    return true;
+                }
+            }
+        }
+
+        bool found = false;
+        float closest = maxDistance;
+        const Vector3 corners[3] = {t.v0, t.v1, t.v2};
+        for (int i = 0; i < 3; ++i) {
+            float distance;
+            Vector3 point;
+            if (RayCylinder(origin, direction, corners[i], corners[(i + 1) % 3], radius, distance, point) &&
+                distance <= closest) {
+                closest = distance;
+                outPoint = point;
+                found = true;
+            }
+            if (RaySphere(origin, direction, corners[i], radius, distance) && distance <= closest) {
+                closest = distance;
+                outPoint = corners[i];
+                found = true;
+            }
+        }
+        if (found) outDistance = closest;
+        return found;
+    }
+
+    AABB TriangleBounds(const TriangleBVH::Triangle& triangle) {
+        AABB box = AABB::Infinite();
+        box.Encapsulate(triangle.v0);
+        box.Encapsulate(triangle.v1);
+        box.Encapsulate(triangle.v2);
+        return box;
+    }
+}
+
+// ============================================================================
+// Build
+// ============================================================================
+
+void TriangleBVH::Clear() {
+    nodes_.clear();
+    triangles_.clear();
+    soa_.Clear();
+    stats_ = Stats();
+}
+
+void TriangleBVH::Build(const World& world, FaceFlags mask) {
+    auto startTime = std::chrono::steady_clock::now();
+    Clear();
+
+    std::vector<uint32_t> corners;
+    for (size_t s = 0; s < world.surfaces.size(); ++s) {
+        const Face& face = world.surfaces[s];
+        if (mask != FaceFlags::None && !HasFlag(face.flags, mask)) continue;
+        corners.clear();
+        if (!WorldMesh::TriangulatePolygon(face.vertices, corners)) continue;
+        for (size_t c = 0; c + 2 < corners.size(); c += 3) {
+            triangles_.push_back({face.vertices[corners[c]], face.vertices[corners[c + 1]],
+                                  face.vertices[corners[c + 2]], static_cast<uint32_t>(s)});
+        }
+        stats_.surfaces++;
+    }
+    if (triangles_.empty()) {
+        stats_.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        return;
+    }
+
+    const size_t count = triangles_.size();
+    std::vector<AABB> bounds(count);
+    std::vector<Vector3> centroids(count);
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        bounds[i] = TriangleBounds(triangles_[i]);
+        centroids[i] = bounds[i].GetCenter();
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    // A binary tree over n leaves has at most 2n - 1 nodes
+    nodes_.reserve(2 * count);
+    nodes_.push_back({{0, 0, 0}, 0, {0, 0, 0}, static_cast<uint32_t>(count)});
+    Subdivide(0, 1, bounds, centroids, order);
+    nodes_.shrink_to_fit();
+
+    // Store triangles in leaf order
+    std::vector<Triangle> sorted(count);
+    for (size_t i = 0; i < count; ++i) sorted[i] = triangles_[order[i]];
+    triangles_.swap(sorted);
+    soa_.Resize(count);
+    for (size_t i = 0; i < count; ++i) soa_.Set(i, triangles_[i].v0, triangles_[i].v1, triangles_[i].v2);
+
+    stats_.triangles = count;
+    stats_.nodes = nodes_.size();
+    stats_.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void TriangleBVH::Subdivide(uint32_t nodeIndex, int depth, std::vector<AABB>& bounds,
+                            std::vector<Vector3>& centroids, std::vector<uint32_t>& order) {
+    const uint32_t first = nodes_[nodeIndex].leftOrFirst;
+    const uint32_t count = nodes_[nodeIndex].count;
+
+    AABB nodeBounds = AABB::Infinite();
+    AABB centroidBounds = AABB::Infinite();
+    for (uint32_t i = first; i < first + count; ++i) {
+        nodeBounds.Encapsulate(bounds[order[i]]);
+        centroidBounds.Encapsulate(centroids[order[i]]);
+    }
+    nodes_[nodeIndex].min = nodeBounds.min;
+    nodes_[nodeIndex].max = nodeBounds.max;
+    stats_.depth = std::max(stats_.depth, depth);
+
+    auto makeLeaf = [&]() { stats_.leaves++; };
+    if (count <= 1 || depth >= STACK_SIZE - 1) {
+        makeLeaf();
+        return;
+    }
+
+    // Binned SAH: centroids into SAH_BINS slabs per axis, sweep both ways for
+    // the cheapest plane between bins
+    int bestAxis = -1;
+    int bestSplit = 0;
+    float bestCost = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float lo = Axis(centroidBounds.min, axis);
+        const float extent = Axis(centroidBounds.max, axis) - lo;
+        if (extent <= 0.0f) continue;
+        const float scale = SAH_BINS / extent;
+
+        AABB binBounds[SAH_BINS];
+        uint32_t binCounts[SAH_BINS] = {};
+        for (int b = 0; b < SAH_BINS; ++b) binBounds[b] = AABB::Infinite();
+        for (uint32_t i = first; i < first + count; ++i) {
+            int b = std::min(SAH_BINS - 1, static_cast<int>((Axis(centroids[order[i]], axis) - lo) * scale));
+            binCounts[b]++;
+            binBounds[b].Encapsulate(bounds[order[i]]);
+        }
+
+        float leftArea[SAH_BINS - 1];
+        uint32_t leftCount[SAH_BINS - 1];
+        AABB box = AABB::Infinite();
+        uint32_t sum = 0;
+        for (int b = 0; b < SAH_BINS - 1; ++b) {
+            sum += binCounts[b];
+            if (binCounts[b]) box.Encapsulate(binBounds[b]);
+            leftCount[b] = sum;
+            leftArea[b] = sum ? SurfaceArea(box) : 0.0f;
+        }
+        box = AABB::Infinite();
+        sum = 0;
+        for (int b = SAH_BINS - 1; b > 0; --b) {
+            sum += binCounts[b];
+            if (binCounts[b]) box.Encapsulate(binBounds[b]);
+            if (leftCount[b - 1] == 0 || sum == 0) continue;
+            float cost = leftArea[b - 1] * leftCount[b - 1] + SurfaceArea(box) * sum;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    // Split only when it beats testing every triangle here, unless the leaf
+    // would be too big
+    const float leafCost = SurfaceArea(nodeBounds) * count;
+    const float splitCost = TRAVERSAL_COST * SurfaceArea(nodeBounds) + bestCost;
+    uint32_t* begin = order.data() + first;
+    uint32_t* end = begin + count;
+    uint32_t* middle = nullptr;
+    if (bestAxis >= 0 && (splitCost < leafCost || count > MAX_LEAF_TRIANGLES)) {
+        const float lo = Axis(centroidBounds.min, bestAxis);
+        const float scale = SAH_BINS / (Axis(centroidBounds.max, bestAxis) - lo);
+        middle = std::partition(begin, end, [&](uint32_t t) {
+            return std::min(SAH_BINS - 1, static_cast<int>((Axis(centroids[t], bestAxis) - lo) * scale)) < bestSplit;
+        });
+    } else if (count > MAX_LEAF_TRIANGLES) {
+        // Every centroid in one spot: halve by index
+        middle = begin + count / 2;
+    } else {
+        makeLeaf();
+        return;
+    }
+
+    const uint32_t leftCount = static_cast<uint32_t>(middle - begin);
+    const uint32_t left = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({{0, 0, 0}, first, {0, 0, 0}, leftCount});
+    nodes_.push_back({{0, 0, 0}, first + leftCount, {0, 0, 0}, count - leftCount});
+    nodes_[nodeIndex].leftOrFirst = left;
+    nodes_[nodeIndex].count = 0;
+
+    Subdivide(left, depth + 1, bounds, centroids, order);
+    Subdivide(left + 1, depth + 1, bounds, centroids, order);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+void TriangleBVH::QueryTriangles(const AABB& box, std::vector<uint32_t>& outTriangles) const {
+    outTriangles.clear();
+    if (nodes_.empty()) return;
+
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (!NodeOverlaps(node, box)) continue;
+        if (node.count > 0) {
+            for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                const Triangle& t = triangles_[i];
+                if (std::max({t.v0.x, t.v1.x, t.v2.x}) < box.min.x || std::min({t.v0.x, t.v1.x, t.v2.x}) > box.max.x ||
+                    std::max({t.v0.y, t.v1.y, t.v2.y}) < box.min.y || std::min({t.v0.y, t.v1.y, t.v2.y}) > box.max.y ||
+                    std::max({t.v0.z, t.v1.z, t.v2.z}) < box.min.z || std::min({t.v0.z, t.v1.z, t.v2.z}) > box.max.z) {
+                    continue;
+                }
+                outTriangles.push_back(i);
+            }
+        } else if (top + 2 <= STACK_SIZE) {
+            stack[top++] = node.leftOrFirst;
+            stack[top++] = node.leftOrFirst + 1;
+        }
+    }
+}
+
+void TriangleBVH::QuerySurfaces(const AABB& box, std::vector<uint32_t>& outSurfaces) const {
+    QueryTriangles(box, outSurfaces);
+    for (uint32_t& index : outSurfaces) index = triangles_[index].surface;
+    std::sort(outSurfaces.begin(), outSurfaces.end());
+    outSurfaces.erase(std::unique(outSurfaces.begin(), outSurfaces.end()), outSurfaces.end());
+}
+
+bool TriangleBVH::OverlapsBox(const AABB& box) const {
+    if (nodes_.empty()) return false;
+    const Vector3 center = box.GetCenter();
+    const Vector3 halfExtents = Vector3Scale(box.GetSize(), 0.5f);
+    float depths[TriangleSAT::LANES];
+
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (!NodeOverlaps(node, box)) continue;
+        if (node.count > 0) {
+            for (uint32_t first = node.leftOrFirst; first < node.leftOrFirst + node.count; first += TriangleSAT::LANES) {
+                size_t count = std::min<size_t>(TriangleSAT::LANES, node.leftOrFirst + node.count - first);
+                if (TriangleSAT::TestBox(soa_, first, count, center, halfExtents, depths)) return true;
+            }
+        } else if (top + 2 <= STACK_SIZE) {
+            stack[top++] = node.leftOrFirst;
+            stack[top++] = node.leftOrFirst + 1;
+        }
+    }
+    return false;
+}
+
+void TriangleBVH::CollectContacts(const AABB& box, std::vector<Contact>& outContacts) const {
+    outContacts.clear();
+    if (nodes_.empty()) return;
+    const Vector3 center = box.GetCenter();
+    const Vector3 halfExtents = Vector3Scale(box.GetSize(), 0.5f);
+    float depths[TriangleSAT::LANES];
+
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (!NodeOverlaps(node, box)) continue;
+        if (node.count > 0) {
+            for (uint32_t first = node.leftOrFirst; first < node.leftOrFirst + node.count; first += TriangleSAT::LANES) {
+                size_t count = std::min<size_t>(TriangleSAT::LANES, node.leftOrFirst + node.count - first);
+                uint32_t hits = TriangleSAT::TestBox(soa_, first, count, center, halfExtents, depths);
+                for (uint32_t lane = 0; hits; ++lane, hits >>= 1) {
+                    if (hits & 1u) outContacts.push_back({first + lane, triangles_[first + lane].surface, depths[lane]});
+                }
+            }
+        } else if (top + 2 <= STACK_SIZE) {
+            stack[top++] = node.leftOrFirst;
+            stack[top++] = node.leftOrFirst + 1;
+        }
+    }
+}
+
+bool TriangleBVH::RayTriangle(const Triangle& t, const Vector3& origin, const Vector3& direction, float maxDistance,
+                              float& outDistance) {
+    Vector3 e1 = Vector3Subtract(t.v1, t.v0);
+    Vector3 e2 = Vector3Subtract(t.v2, t.v0);
+    Vector3 p = Vector3CrossProduct(direction, e2);
+    float det = Vector3DotProduct(e1, p);
+    if (std::fabs(det) < 1e-12f) return false;
+    float invDet = 1.0f / det;
+    Vector3 s = Vector3Subtract(origin, t.v0);
+    float u = Vector3DotProduct(s, p) * invDet;
+    if (u < -BARYCENTRIC_EPSILON || u > 1.0f + BARYCENTRIC_EPSILON) return false;
+    Vector3 q = Vector3CrossProduct(s, e1);
+    float v = Vector3DotProduct(direction, q) * invDet;
+    if (v < -BARYCENTRIC_EPSILON || u + v > 1.0f + BARYCENTRIC_EPSILON) return false;
+    float distance = Vector3DotProduct(e2, q) * invDet;
+    if (distance < 0.0f || distance > maxDistance) return false;
+    outDistance = distance;
+    return true;
+}
+
+bool TriangleBVH::RayCast(const Vector3& origin, const Vector3& direction, float maxDistance, RayHit& outHit) const {
+    if (nodes_.empty()) return false;
+    const Vector3 invDirection = {1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z};
+    float closest = maxDistance;
+    bool found = false;
+
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    if (NodeEntry(nodes_[0], origin, invDirection, closest) == FLT_MAX) return false;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (node.count > 0) {
+            for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                const Triangle& t = triangles_[i];
+                float distance;
+                if (!RayTriangle(t, origin, direction, closest, distance)) continue;
+
+                closest = distance;
+                found = true;
+                outHit.distance = distance;
+                outHit.triangle = i;
+                outHit.surface = t.surface;
+                Vector3 e1 = Vector3Subtract(t.v1, t.v0);
+                Vector3 e2 = Vector3Subtract(t.v2, t.v0);
+                Vector3 normal = Vector3Normalize(Vector3CrossProduct(e1, e2));
+                outHit.normal = Vector3DotProduct(normal, direction) > 0.0f ? Vector3Negate(normal) : normal;
+            }
+            continue;
+        }
+
+        // Nearer child popped first; children the current hit already beats are dropped
+        uint32_t near = node.leftOrFirst, far = node.leftOrFirst + 1;
+        float nearEntry = NodeEntry(nodes_[near], origin, invDirection, closest);
+        float farEntry = NodeEntry(nodes_[far], origin, invDirection, closest);
+        if (farEntry < nearEntry) {
+            std::swap(near, far);
+            std::swap(nearEntry, farEntry);
+        }
+        if (farEntry != FLT_MAX && top < STACK_SIZE) stack[top++] = far;
+        if (nearEntry != FLT_MAX && top < STACK_SIZE) stack[top++] = near;
+    }
+
+    if (found) outHit.point = Vector3Add(origin, Vector3Scale(direction, outHit.distance));
+    return found;
+}
+
+bool TriangleBVH::SphereCast(const Vector3& origin, const Vector3& direction, float radius, float maxDistance,
+                             RayHit& outHit) const {
+    if (radius <= 0.0f) return RayCast(origin, direction, maxDistance, outHit);
+    if (nodes_.empty()) return false;
+    const Vector3 invDirection = {1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z};
+    float closest = maxDistance;
+    bool found = false;
+
+    // Same walk as RayCast with every node grown by the radius
+    uint32_t stack[STACK_SIZE];
+    int top = 0;
+    if (NodeEntry(nodes_[0], origin, invDirection, closest, radius) == FLT_MAX) return false;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (node.count > 0) {
+            for (uint32_t i = node.leftOrFirst; i < node.leftOrFirst + node.count; ++i) {
+                const Triangle& t = triangles_[i];
+                float distance;
+                Vector3 point;
+                if (!SweepSphereTriangle(t, origin, direction, radius, closest, distance, point)) continue;
+                if (found && distance >= closest) continue;
+
+                closest = distance;
+                found = true;
+                outHit.distance = distance;
+                outHit.point = point;
+                outHit.triangle = i;
+                outHit.surface = t.surface;
+                Vector3 normal = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(t.v1, t.v0),
+                                                                      Vector3Subtract(t.v2, t.v0)));
+                outHit.normal = Vector3DotProduct(normal, Vector3Subtract(origin, t.v0)) < 0.0f
+                                    ? Vector3Negate(normal) : normal;
+            }
+            continue;
+        }
+
+        uint32_t near = node.leftOrFirst, far = node.leftOrFirst + 1;
+        float nearEntry = NodeEntry(nodes_[near], origin, invDirection, closest, radius);
+        float farEntry = NodeEntry(nodes_[far], origin, invDirection, closest, radius);
+        if (farEntry < nearEntry) {
+            std::swap(near, far);
+            std::swap(nearEntry, farEntry);
+        }
+        if (farEntry != FLT_MAX && top < STACK_SIZE) stack[top++] = far;
+        if (nearEntry != FLT_MAX && top < STACK_SIZE) stack[top++] = near;
+    }
+    return found;
+}
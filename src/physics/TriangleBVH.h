@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../math/AABB.h"
+#include "../world/Brush.h"
+#include "TriangleSAT.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct World;
+
+// Static bounding volume hierarchy over the world's collision triangles.
+// Built once per loaded world: every surface with the mask flags is
+// triangulated (WorldMesh::TriangulatePolygon), split top-down with the binned
+// surface area heuristic and flattened into 32-byte nodes, children next to
+// each other. Triangles are stored in leaf order, so a leaf is one contiguous
+// run; a TriangleSoA copy in the same order feeds the batched SAT kernel, one
+// call per leaf.
+//
+// Overlap and ray queries cost grows with the triangles near the query, not
+// with the map's face count.
+class TriangleBVH {
+public:
+    static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+    static constexpr int SAH_BINS = 16;
+
+    struct Triangle {
+        Vector3 v0, v1, v2;
+        uint32_t surface;       // Index into world->surfaces
+    };
+
+    struct Node {
+        Vector3 min;
+        uint32_t leftOrFirst;   // Interior: left child (right is +1). Leaf: first triangle
+        Vector3 max;
+        uint32_t count;         // Triangles in a leaf, 0 for interior nodes
+    };
+
+    struct RayHit {
+        float distance = 0.0f;
+        Vector3 point{0, 0, 0};
+        Vector3 normal{0, 0, 0};    // Facing the ray origin
+        uint32_t triangle = 0;
+        uint32_t surface = 0;
+    };
+
+    // Triangle overlapping a query box, see TriangleSAT for depth
+    struct Contact {
+        uint32_t triangle;
+        uint32_t surface;
+        float depth;
+    };
+
+    struct Stats {
+        size_t surfaces = 0;
+        size_t triangles = 0;
+        size_t nodes = 0;
+        size_t leaves = 0;
+        int depth = 0;
+        double buildMs = 0.0;
+    };
+
+    void Build(const World& world, FaceFlags mask = FaceFlags::Collidable);
+    void Clear();
+    bool IsEmpty() const { return nodes_.empty(); }
+
+    // Surfaces with a triangle whose bounds overlap box, sorted, no repeats
+    void QuerySurfaces(const AABB& box, std::vector<uint32_t>& outSurfaces) const;
+    // Triangles (indices into GetTriangle) whose bounds overlap box
+    void QueryTriangles(const AABB& box, std::vector<uint32_t>& outTriangles) const;
+    // True if any triangle overlaps the box interior (separating axis test;
+    // touching doesn't count, so a box resting on a floor is free)
+    bool OverlapsBox(const AABB& box) const;
+    // Every triangle overlapping the box interior, in leaf order
+    void CollectContacts(const AABB& box, std::vector<Contact>& outContacts) const;
+    // Closest triangle hit along origin + direction * t, t in [0, maxDistance].
+    // direction must be normalized; both triangle sides count.
+    bool RayCast(const Vector3& origin, const Vector3& direction, float maxDistance, RayHit& outHit) const;
+    // First triangle a sphere moving along origin + direction * t touches
+    // (face, edge or corner), t in [0, maxDistance]; 0 if it starts touching.
+    // point is the contact on the triangle, the sphere's center is at
+    // origin + direction * distance. radius <= 0 is a RayCast.
+    bool SphereCast(const Vector3& origin, const Vector3& direction, float radius, float maxDistance,
+                    RayHit& outHit) const;
+
+    // One triangle, either winding (Moller-Trumbore); distance in [0, maxDistance]
+    static bool RayTriangle(const Triangle& triangle, const Vector3& origin, const Vector3& direction,
+                            float maxDistance, float& outDistance);
+
+    const Triangle& GetTriangle(uint32_t index) const { return triangles_[index]; }
+    size_t GetTriangleCount() const { return triangles_.size(); }
+    const TriangleSoA& GetTriangleSoA() const { return soa_; }
+    const Stats& GetStats() const { return stats_; }
+
+private:
+    static constexpr int STACK_SIZE = 64;
+
+    void Subdivide(uint32_t nodeIndex, int depth, std::vector<AABB>& bounds, std::vector<Vector3>& centroids,
+                   std::vector<uint32_t>& order);
+
+    std::vector<Node> nodes_;
+    std::vector<Triangle> triangles_;
+    TriangleSoA soa_;
+    Stats stats_;
+};
+
+static_assert(sizeof(TriangleBVH::Node) == 32, "BVH nodes are meant to fit two per cache line");
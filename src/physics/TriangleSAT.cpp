@@ -0,0 +1,268 @@
+#include "TriangleSAT.h"
+#include "../math/SIMD.h"
+#include "raymath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace {
+    constexpr float AXIS_EPSILON = 1e-10f;    // Edge crossings shorter than this are no axis
+
+#if defined(PAINTSPLASH_AVX)
+    // Thin wrappers so the kernel body below is written once
+    using Lane = __m256;
+    inline Lane Load(const float* p) { return _mm256_loadu_ps(p); }
+    inline Lane Set1(float v) { return _mm256_set1_ps(v); }
+    inline Lane Add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+    inline Lane Sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+    inline Lane Mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+    inline Lane Min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+    inline Lane Max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+    inline Lane Abs(Lane a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    inline Lane Or(Lane a, Lane b) { return _mm256_or_ps(a, b); }
+    inline Lane And(Lane a, Lane b) { return _mm256_and_ps(a, b); }
+    inline Lane GreaterEqual(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline Lane LessEqual(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    inline uint32_t Mask(Lane a) { return static_cast<uint32_t>(_mm256_movemask_ps(a)); }
+    inline void Store(float* p, Lane a) { _mm256_storeu_ps(p, a); }
+#elif defined(PAINTSPLASH_SSE)
+    using Lane = __m128;
+    inline Lane Load(const float* p) { return _mm_loadu_ps(p); }
+    inline Lane Set1(float v) { return _mm_set1_ps(v); }
+    inline Lane Add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+    inline Lane Sub(Lane a, Lane b) { return _mm_sub_ps(a, b); }
+    inline Lane Mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+    inline Lane Min(Lane a, Lane b) { return _mm_min_ps(a, b); }
+    inline Lane Max(Lane a, Lane b) { return _mm_max_ps(a, b); }
+    inline Lane Abs(Lane a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    inline Lane Or(Lane a, Lane b) { return _mm_or_ps(a, b); }
+    inline Lane And(Lane a, Lane b) { return _mm_and_ps(a, b); }
+    inline Lane GreaterEqual(Lane a, Lane b) { return _mm_cmpge_ps(a, b); }
+    inline Lane LessEqual(Lane a, Lane b) { return _mm_cmple_ps(a, b); }
+    inline uint32_t Mask(Lane a) { return static_cast<uint32_t>(_mm_movemask_ps(a)); }
+    inline void Store(float* p, Lane a) { _mm_storeu_ps(p, a); }
+#endif
+}
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+void TriangleSoA::Resize(size_t count) {
+    count_ = count;
+    const size_t padded = count + TriangleSAT::LANES - 1;
+    for (std::vector<float>* array : {&v0x, &v0y, &v0z, &v1x, &v1y, &v1z, &v2x, &v2y, &v2z,
+                                      &e0x, &e0y, &e0z, &e1x, &e1y, &e1z, &e2x, &e2y, &e2z,
+                                      &nx, &ny, &nz}) {
+        array->assign(count ? padded : 0, 0.0f);
+    }
+}
+
+void TriangleSoA::Set(size_t i, const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+    v0x[i] = v0.x; v0y[i] = v0.y; v0z[i] = v0.z;
+    v1x[i] = v1.x; v1y[i] = v1.y; v1z[i] = v1.z;
+    v2x[i] = v2.x; v2y[i] = v2.y; v2z[i] = v2.z;
+
+    const Vector3 e0 = Vector3Subtract(v1, v0);
+    const Vector3 e1 = Vector3Subtract(v2, v1);
+    const Vector3 e2 = Vector3Subtract(v0, v2);
+    e0x[i] = e0.x; e0y[i] = e0.y; e0z[i] = e0.z;
+    e1x[i] = e1.x; e1y[i] = e1.y; e1z[i] = e1.z;
+    e2x[i] = e2.x; e2y[i] = e2.y; e2z[i] = e2.z;
+
+    const Vector3 n = Vector3Normalize(Vector3CrossProduct(e0, e1));
+    nx[i] = n.x; ny[i] = n.y; nz[i] = n.z;
+}
+
+// ============================================================================
+// Scalar
+// ============================================================================
+
+uint32_t TriangleSAT::TestBoxScalar(const TriangleSoA& t, size_t first, size_t count,
+                                    const Vector3& c, const Vector3& h, float* outDepths) {
+    uint32_t hits = 0;
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        outDepths[lane] = 0.0f;
+        if (lane >= count) continue;
+        const size_t i = first + lane;
+
+        // Vertices relative to the box center
+        const float ax = t.v0x[i] - c.x, ay = t.v0y[i] - c.y, az = t.v0z[i] - c.z;
+        const float bx = t.v1x[i] - c.x, by = t.v1y[i] - c.y, bz = t.v1z[i] - c.z;
+        const float cx = t.v2x[i] - c.x, cy = t.v2y[i] - c.y, cz = t.v2z[i] - c.z;
+
+        // Box face axes
+        if (std::min({ax, bx, cx}) >= h.x || std::max({ax, bx, cx}) <= -h.x) continue;
+        if (std::min({ay, by, cy}) >= h.y || std::max({ay, by, cy}) <= -h.y) continue;
+        if (std::min({az, bz, cz}) >= h.z || std::max({az, bz, cz}) <= -h.z) continue;
+
+        // Triangle plane
+        const float normalRadius = h.x * std::fabs(t.nx[i]) + h.y * std::fabs(t.ny[i]) + h.z * std::fabs(t.nz[i]);
+        const float planeDistance = t.nx[i] * ax + t.ny[i] * ay + t.nz[i] * az;
+        if (std::fabs(planeDistance) >= normalRadius) continue;
+
+        // Edge x box axis. The edge's own two vertices project to the same
+        // value, so only it and the opposite vertex matter.
+        const float ex[3] = {t.e0x[i], t.e1x[i], t.e2x[i]};
+        const float ey[3] = {t.e0y[i], t.e1y[i], t.e2y[i]};
+        const float ez[3] = {t.e0z[i], t.e1z[i], t.e2z[i]};
+        const float px[3] = {ax, bx, cx}, py[3] = {ay, by, cy}, pz[3] = {az, bz, cz};
+        bool separated = false;
+        for (int e = 0; e < 3 && !separated; ++e) {
+            const int on = e, off = (e + 2) % 3;
+            auto test = [&](float lengthSq, float p0, float p1, float radius) {
+                if (lengthSq < AXIS_EPSILON) return false;
+                return std::min(p0, p1) >= radius || std::max(p0, p1) <= -radius;
+            };
+            // x: (0, ez, -ey)
+            separated = test(ey[e] * ey[e] + ez[e] * ez[e],
+                             ez[e] * py[on] - ey[e] * pz[on], ez[e] * py[off] - ey[e] * pz[off],
+                             h.y * std::fabs(ez[e]) + h.z * std::fabs(ey[e])) ||
+                        // y: (-ez, 0, ex)
+                        test(ex[e] * ex[e] + ez[e] * ez[e],
+                             ex[e] * pz[on] - ez[e] * px[on], ex[e] * pz[off] - ez[e] * px[off],
+                             h.x * std::fabs(ez[e]) + h.z * std::fabs(ex[e])) ||
+                        // z: (ey, -ex, 0)
+                        test(ex[e] * ex[e] + ey[e] * ey[e],
+                             ey[e] * px[on] - ex[e] * py[on], ey[e] * px[off] - ex[e] * py[off],
+                             h.x * std::fabs(ey[e]) + h.y * std::fabs(ex[e]));
+        }
+        if (separated) continue;
+
+        hits |= 1u << lane;
+        outDepths[lane] = normalRadius - std::fabs(planeDistance);
+    }
+    return hits;
+}
+
+// ============================================================================
+// SIMD
+// ============================================================================
+
+uint32_t TriangleSAT::TestBox(const TriangleSoA& t, size_t first, size_t count,
+                              const Vector3& center, const Vector3& h, float* outDepths) {
+#if defined(PAINTSPLASH_AVX) || defined(PAINTSPLASH_SSE)
+    const size_t i = first;
+    const uint32_t laneMask = count >= LANES ? (1u << LANES) - 1u : (1u << count) - 1u;
+    auto allSeparated = [&](Lane separated) {
+        if ((Mask(separated) & laneMask) != laneMask) return false;
+        std::fill(outDepths, outDepths + LANES, 0.0f);
+        return true;
+    };
+
+    const Lane cx = Set1(center.x), cy = Set1(center.y), cz = Set1(center.z);
+    const Lane hx = Set1(h.x), hy = Set1(h.y), hz = Set1(h.z);
+    const Lane nhx = Set1(-h.x), nhy = Set1(-h.y), nhz = Set1(-h.z);
+    const Lane axisEpsilon = Set1(AXIS_EPSILON);
+
+    const Lane px[3] = {Sub(Load(&t.v0x[i]), cx), Sub(Load(&t.v1x[i]), cx), Sub(Load(&t.v2x[i]), cx)};
+    const Lane py[3] = {Sub(Load(&t.v0y[i]), cy), Sub(Load(&t.v1y[i]), cy), Sub(Load(&t.v2y[i]), cy)};
+    const Lane pz[3] = {Sub(Load(&t.v0z[i]), cz), Sub(Load(&t.v1z[i]), cz), Sub(Load(&t.v2z[i]), cz)};
+
+    // Box face axes
+    Lane separated = Or(GreaterEqual(Min(Min(px[0], px[1]), px[2]), hx), LessEqual(Max(Max(px[0], px[1]), px[2]), nhx));
+    separated = Or(separated, Or(GreaterEqual(Min(Min(py[0], py[1]), py[2]), hy), LessEqual(Max(Max(py[0], py[1]), py[2]), nhy)));
+    separated = Or(separated, Or(GreaterEqual(Min(Min(pz[0], pz[1]), pz[2]), hz), LessEqual(Max(Max(pz[0], pz[1]), pz[2]), nhz)));
+    // Most batches end here, the BVH leaf bounds are loose
+    if (allSeparated(separated)) return 0;
+
+    // Triangle plane
+    const Lane nx = Load(&t.nx[i]), ny = Load(&t.ny[i]), nz = Load(&t.nz[i]);
+    const Lane normalRadius = Add(Add(Mul(hx, Abs(nx)), Mul(hy, Abs(ny))), Mul(hz, Abs(nz)));
+    const Lane planeDistance = Abs(Add(Add(Mul(nx, px[0]), Mul(ny, py[0])), Mul(nz, pz[0])));
+    separated = Or(separated, GreaterEqual(planeDistance, normalRadius));
+    if (allSeparated(separated)) return 0;
+
+    // Edge x box axis, edge vertex and opposite vertex
+    const Lane ex[3] = {Load(&t.e0x[i]), Load(&t.e1x[i]), Load(&t.e2x[i])};
+    const Lane ey[3] = {Load(&t.e0y[i]), Load(&t.e1y[i]), Load(&t.e2y[i])};
+    const Lane ez[3] = {Load(&t.e0z[i]), Load(&t.e1z[i]), Load(&t.e2z[i])};
+    auto axisSeparates = [&](Lane lengthSq, Lane p0, Lane p1, Lane radius) {
+        Lane apart = Or(GreaterEqual(Min(p0, p1), radius), LessEqual(Max(p0, p1), Sub(Set1(0.0f), radius)));
+        return And(apart, GreaterEqual(lengthSq, axisEpsilon));
+    };
+    for (int e = 0; e < 3; ++e) {
+        const int on = e, off = (e + 2) % 3;
+        const Lane absX = Abs(ex[e]), absY = Abs(ey[e]), absZ = Abs(ez[e]);
+        separated = Or(separated, axisSeparates(Add(Mul(ey[e], ey[e]), Mul(ez[e], ez[e])),
+                                                Sub(Mul(ez[e], py[on]), Mul(ey[e], pz[on])),
+                                                Sub(Mul(ez[e], py[off]), Mul(ey[e], pz[off])),
+                                                Add(Mul(hy, absZ), Mul(hz, absY))));
+        separated = Or(separated, axisSeparates(Add(Mul(ex[e], ex[e]), Mul(ez[e], ez[e])),
+                                                Sub(Mul(ex[e], pz[on]), Mul(ez[e], px[on])),
+                                                Sub(Mul(ex[e], pz[off]), Mul(ez[e], px[off])),
+                                                Add(Mul(hx, absZ), Mul(hz, absX))));
+        separated = Or(separated, axisSeparates(Add(Mul(ex[e], ex[e]), Mul(ey[e], ey[e])),
+                                                Sub(Mul(ey[e], px[on]), Mul(ex[e], py[on])),
+                                                Sub(Mul(ey[e], px[off]), Mul(ex[e], py[off])),
+                                                Add(Mul(hx, absY), Mul(hy, absX))));
+        if (allSeparated(separated)) return 0;
+    }
+
+    const uint32_t hits = ~Mask(separated) & laneMask;
+
+    Store(outDepths, Sub(normalRadius, planeDistance));
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        if (!(hits & (1u << lane))) outDepths[lane] = 0.0f;
+    }
+    return hits;
+#else
+    return TestBoxScalar(t, first, count, center, h, outDepths);
+#endif
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+TriangleSAT::BenchmarkResult TriangleSAT::Benchmark(const TriangleSoA& triangles, size_t boxes,
+                                                    const Vector3& halfExtents) {
+    BenchmarkResult result;
+    const size_t count = triangles.Size();
+    if (count == 0 || boxes == 0) return result;
+
+    // Centers near random triangles, so a fair share of lanes overlap
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> pick(0, count - 1);
+    std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+    std::vector<Vector3> centers(boxes);
+    for (Vector3& center : centers) {
+        size_t i = pick(rng);
+        center = {triangles.v0x[i] + jitter(rng) * halfExtents.x * 2.0f,
+                  triangles.v0y[i] + jitter(rng) * halfExtents.y * 2.0f,
+                  triangles.v0z[i] + jitter(rng) * halfExtents.z * 2.0f};
+    }
+
+    std::vector<uint32_t> scalarMasks, simdMasks;
+    scalarMasks.reserve(boxes * ((count + LANES - 1) / LANES));
+    simdMasks.reserve(scalarMasks.capacity());
+    float depths[LANES];
+
+    auto start = std::chrono::steady_clock::now();
+    for (const Vector3& center : centers) {
+        for (size_t first = 0; first < count; first += LANES) {
+            scalarMasks.push_back(TestBoxScalar(triangles, first, std::min(LANES, count - first), center,
+                                                halfExtents, depths));
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (const Vector3& center : centers) {
+        for (size_t first = 0; first < count; first += LANES) {
+            simdMasks.push_back(TestBox(triangles, first, std::min(LANES, count - first), center,
+                                        halfExtents, depths));
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    result.boxes = boxes;
+    result.tests = boxes * count;
+    for (size_t k = 0; k < scalarMasks.size(); ++k) {
+        uint32_t scalar = scalarMasks[k], simd = simdMasks[k];
+        for (uint32_t diff = scalar ^ simd; diff; diff &= diff - 1) result.mismatches++;
+        for (uint32_t bits = scalar; bits; bits &= bits - 1) result.hits++;
+    }
+    result.scalarNsPerTest = std::chrono::duration<double, std::nano>(middle - start).count() / result.tests;
+    result.simdNsPerTest = std::chrono::duration<double, std::nano>(end - middle).count() / result.tests;
+    return result;
+}
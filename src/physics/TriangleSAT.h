@@ -0,0 +1,63 @@
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Collision triangles in structure-of-arrays form for the batched box test:
+// vertices, edges (e0 = v1 - v0, e1 = v2 - v1, e2 = v0 - v2) and unit normals,
+// one float array per component. Arrays carry TriangleSAT::LANES - 1 floats
+// of padding so a batch starting anywhere can load a full register.
+struct TriangleSoA {
+    std::vector<float> v0x, v0y, v0z, v1x, v1y, v1z, v2x, v2y, v2z;
+    std::vector<float> e0x, e0y, e0z, e1x, e1y, e1z, e2x, e2y, e2z;
+    std::vector<float> nx, ny, nz;
+
+    void Resize(size_t count);
+    void Set(size_t index, const Vector3& v0, const Vector3& v1, const Vector3& v2);
+    size_t Size() const { return count_; }
+    void Clear() { Resize(0); }
+
+private:
+    size_t count_ = 0;
+};
+
+// Separating axis test of one box against a batch of triangles: 3 box axes,
+// the triangle normal and the 9 edge x box axis crossings, one triangle per
+// SIMD lane (8 with AVX, 4 with SSE2, scalar elsewhere). Projections that only
+// touch count as separated, so a box resting on a floor is free.
+//
+// For each overlapping triangle the depth is how far the box reaches through
+// the triangle's plane (box radius along the normal minus the center's plane
+// distance), the same measure CollisionSystem::GetPenetrationDepth uses.
+class TriangleSAT {
+public:
+#if defined(__AVX__)
+    static constexpr size_t LANES = 8;
+#else
+    static constexpr size_t LANES = 4;
+#endif
+
+    // Triangles [first, first + count), count <= LANES. Bit i of the result is
+    // set when triangle first + i overlaps; outDepths[i] is its depth (0 for
+    // misses). outDepths needs LANES entries.
+    static uint32_t TestBox(const TriangleSoA& triangles, size_t first, size_t count,
+                            const Vector3& center, const Vector3& halfExtents, float* outDepths);
+    // One lane at a time; reference for the SIMD path
+    static uint32_t TestBoxScalar(const TriangleSoA& triangles, size_t first, size_t count,
+                                  const Vector3& center, const Vector3& halfExtents, float* outDepths);
+
+    struct BenchmarkResult {
+        size_t boxes = 0;
+        size_t tests = 0;           // Box/triangle pairs per path
+        size_t hits = 0;
+        size_t mismatches = 0;      // Lanes where the two paths disagree
+        double scalarNsPerTest = 0.0;
+        double simdNsPerTest = 0.0;
+    };
+
+    // Every box against every triangle with both paths. Boxes are sized and
+    // scattered around the triangles so some overlap.
+    static BenchmarkResult Benchmark(const TriangleSoA& triangles, size_t boxes, const Vector3& halfExtents);
+};
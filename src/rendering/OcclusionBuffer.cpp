@@ -0,0 +1,382 @@
+#include "OcclusionBuffer.h"
+#include "../math/Frustum.h"
+#include "../math/SIMD.h"
+#include "../world/WorldGeometry.h"
+#include "../core/JobSystem.h"
+#include "raymath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr int MAX_CLIPPED_VERTICES = 64;
+constexpr size_t TEST_GRAIN = 64;           // Boxes per job in CullAABBs
+constexpr uint32_t FULL_ROW = 0xFFFFFFFFu;
+
+// Bits [first, last) of a 32 pixel tile row
+uint32_t SpanMask(int first, int last) {
+    if (first >= last) return 0;
+    uint32_t upper = last >= 32 ? FULL_ROW : ((1u << last) - 1u);
+    uint32_t lower = first <= 0 ? 0u : ((1u << first) - 1u);
+    return upper & ~lower;
+}
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer() {
+    SetResolution(DEFAULT_WIDTH, DEFAULT_HEIGHT);
+}
+
+void OcclusionBuffer::SetResolution(int width, int height) {
+    tilesX_ = std::max(1, (width + TILE_WIDTH - 1) / TILE_WIDTH);
+    tilesY_ = std::max(1, (height + TILE_HEIGHT - 1) / TILE_HEIGHT);
+    width_ = tilesX_ * TILE_WIDTH;
+    height_ = tilesY_ * TILE_HEIGHT;
+
+    const size_t tileCount = static_cast<size_t>(tilesX_) * tilesY_;
+    masks_.assign(tileCount * TILE_HEIGHT, 0);
+    referenceDepth_.assign(tileCount, 0.0f);
+    workingDepth_.assign(tileCount, 0.0f);
+    rowBins_.resize(tilesY_);
+    active_ = false;
+}
+
+bool OcclusionBuffer::BeginFrame(const Camera3D& camera, float aspect, float nearDistance) {
+    triangles_.clear();
+    stats_ = Stats();
+    active_ = false;
+
+    // 1/w depth needs a perspective divide
+    if (camera.projection != CAMERA_PERSPECTIVE) return false;
+
+    Vector3 forward = Vector3Subtract(camera.target, camera.position);
+    if (Vector3Length(forward) < 1e-6f) return false;
+    forward_ = Vector3Normalize(forward);
+    right_ = Vector3Normalize(Vector3CrossProduct(forward_, camera.up));
+    up_ = Vector3CrossProduct(right_, forward_);
+    eye_ = camera.position;
+
+    float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+    float tanX = tanY * aspect;
+    if (tanY <= 0.0f || tanX <= 0.0f) return false;
+    scaleX_ = width_ * 0.5f / tanX;
+    scaleY_ = height_ * 0.5f / tanY;
+    nearDistance_ = nearDistance;
+
+    std::fill(masks_.begin(), masks_.end(), 0u);
+    std::fill(referenceDepth_.begin(), referenceDepth_.end(), 0.0f);
+    std::fill(workingDepth_.begin(), workingDepth_.end(), 0.0f);
+    active_ = true;
+    return true;
+}
+
+// === OCCLUDERS ===
+
+void OcclusionBuffer::AddOccluder(const Vector3* vertices, size_t count) {
+    if (!active_ || count < 3 || count > MAX_CLIPPED_VERTICES - 1) return;
+    if (triangles_.size() >= MAX_OCCLUDER_TRIANGLES) return;
+
+    // View space (x right, y up, w forward), clipped to the near plane
+    Vector3 view[MAX_CLIPPED_VERTICES];
+    Vector3 clipped[MAX_CLIPPED_VERTICES];
+    for (size_t i = 0; i < count; ++i) {
+        Vector3 d = Vector3Subtract(vertices[i], eye_);
+        view[i] = {Vector3DotProduct(d, right_), Vector3DotProduct(d, up_), Vector3DotProduct(d, forward_)};
+    }
+    size_t clippedCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3& a = view[i];
+        const Vector3& b = view[(i + 1) % count];
+        bool aIn = a.z >= nearDistance_, bIn = b.z >= nearDistance_;
+        if (aIn) clipped[clippedCount++] = a;
+        if (aIn != bIn) {
+            float t = (nearDistance_ - a.z) / (b.z - a.z);
+            clipped[clippedCount++] = Vector3Lerp(a, b, t);
+        }
+    }
+    if (clippedCount < 3) return;
+
+    ScreenVertex screen[MAX_CLIPPED_VERTICES];
+    for (size_t i = 0; i < clippedCount; ++i) {
+        float invW = 1.0f / clipped[i].z;
+        screen[i] = {width_ * 0.5f + clipped[i].x * scaleX_ * invW,
+                     height_ * 0.5f - clipped[i].y * scaleY_ * invW, invW};
+    }
+
+    // Convex: fan into triangles
+    bool added = false;
+    for (size_t i = 1; i + 1 < clippedCount && triangles_.size() < MAX_OCCLUDER_TRIANGLES; ++i) {
+        ScreenTriangle tri;
+        tri.v[0] = screen[0];
+        tri.v[1] = screen[i];
+        tri.v[2] = screen[i + 1];
+
+        const ScreenVertex& a = tri.v[0];
+        const ScreenVertex& b = tri.v[1];
+        const ScreenVertex& c = tri.v[2];
+        float det = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+        if (fabsf(det) < 1e-6f) continue;
+
+        float minX = std::min({a.x, b.x, c.x}), maxX = std::max({a.x, b.x, c.x});
+        float minY = std::min({a.y, b.y, c.y}), maxY = std::max({a.y, b.y, c.y});
+        if (maxX < 0.0f || minX >= width_ || maxY < 0.0f || minY >= height_) continue;
+
+        tri.depthA = ((b.invW - a.invW) * (c.y - a.y) - (c.invW - a.invW) * (b.y - a.y)) / det;
+        tri.depthB = ((b.x - a.x) * (c.invW - a.invW) - (c.x - a.x) * (b.invW - a.invW)) / det;
+        tri.depthC = a.invW - tri.depthA * a.x - tri.depthB * a.y;
+        tri.minInvW = std::min({a.invW, b.invW, c.invW});
+        tri.tileRowBegin = std::max(0, static_cast<int>(minY) / TILE_HEIGHT);
+        tri.tileRowEnd = std::min(tilesY_, static_cast<int>(maxY) / TILE_HEIGHT + 1);
+        triangles_.push_back(tri);
+        added = true;
+    }
+    if (added) stats_.occluders++;
+}
+
+void OcclusionBuffer::RenderOccluders(const World& world, const Frustum& frustum) {
+    if (!active_) return;
+
+    for (uint32_t index : world.occluders) {
+        if (triangles_.size() >= MAX_OCCLUDER_TRIANGLES) break;
+        if (index >= world.surfaces.size()) continue;
+        const Face& face = world.surfaces[index];
+        if (face.vertices.size() < 3) continue;
+
+        // Surfaces are one-sided: seen from behind they aren't drawn and hide nothing
+        if (Vector3DotProduct(face.normal, Vector3Subtract(eye_, face.vertices[0])) <= 0.0f) continue;
+
+        AABB bounds = AABB::Infinite();
+        for (const Vector3& v : face.vertices) bounds.Encapsulate(v);
+        if (!frustum.IntersectsAABB(bounds)) continue;
+
+        AddOccluder(face.vertices.data(), face.vertices.size());
+    }
+    Rasterize();
+}
+
+void OcclusionBuffer::Rasterize() {
+    if (!active_ || triangles_.empty()) return;
+    auto startTime = std::chrono::steady_clock::now();
+
+    for (auto& bin : rowBins_) bin.clear();
+    for (size_t t = 0; t < triangles_.size(); ++t) {
+        for (int row = triangles_[t].tileRowBegin; row < triangles_[t].tileRowEnd; ++row) {
+            rowBins_[row].push_back(static_cast<uint32_t>(t));
+        }
+    }
+
+    // Each job owns whole tile rows, so no two jobs ever touch the same tile
+    JobSystem::GetInstance().ParallelFor(static_cast<size_t>(tilesY_), 1, [this](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) RasterizeTileRow(static_cast<int>(row));
+    });
+
+    stats_.triangles += triangles_.size();
+    triangles_.clear();
+    stats_.rasterMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void OcclusionBuffer::RasterizeTileRow(int tileRow) {
+    const float rowTop = static_cast<float>(tileRow * TILE_HEIGHT);
+    int spanFirst[TILE_HEIGHT], spanLast[TILE_HEIGHT];
+    uint32_t rows[TILE_HEIGHT];
+
+    for (uint32_t index : rowBins_[tileRow]) {
+        const ScreenTriangle& tri = triangles_[index];
+
+        // Edge functions A*x + B*y + C, >= 0 inside whatever the winding
+        const ScreenVertex* v = tri.v;
+        float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+        float sign = area > 0.0f ? 1.0f : -1.0f;
+        float edgeA[3], edgeB[3], edgeC[3];
+        for (int e = 0; e < 3; ++e) {
+            const ScreenVertex& a = v[e];
+            const ScreenVertex& b = v[(e + 1) % 3];
+            edgeA[e] = -sign * (b.y - a.y);
+            edgeB[e] = sign * (b.x - a.x);
+            edgeC[e] = -edgeA[e] * a.x - edgeB[e] * a.y;
+        }
+
+        // Covered pixel span per row, sampled at pixel centers
+        int firstColumn = width_, lastColumn = 0;
+        for (int k = 0; k < TILE_HEIGHT; ++k) {
+            float py = rowTop + k + 0.5f;
+            float left = 0.0f, right = static_cast<float>(width_);
+            for (int e = 0; e < 3; ++e) {
+                float value = edgeB[e] * py + edgeC[e];
+                if (edgeA[e] > 0.0f) left = std::max(left, -value / edgeA[e]);
+                else if (edgeA[e] < 0.0f) right = std::min(right, -value / edgeA[e]);
+                else if (value < 0.0f) right = -1.0f;
+            }
+            spanFirst[k] = left < right ? static_cast<int>(std::ceil(left - 0.5f)) : 0;
+            spanLast[k] = left < right ? std::min(width_, static_cast<int>(std::ceil(right - 0.5f))) : 0;
+            if (spanFirst[k] < spanLast[k]) {
+                firstColumn = std::min(firstColumn, spanFirst[k]);
+                lastColumn = std::max(lastColumn, spanLast[k]);
+            }
+        }
+        if (firstColumn >= lastColumn) continue;
+
+        for (int tx = firstColumn / TILE_WIDTH; tx <= (lastColumn - 1) / TILE_WIDTH; ++tx) {
+            const int tileLeft = tx * TILE_WIDTH;
+            uint32_t any = 0;
+            for (int k = 0; k < TILE_HEIGHT; ++k) {
+                rows[k] = SpanMask(spanFirst[k] - tileLeft, spanLast[k] - tileLeft);
+                any |= rows[k];
+            }
+            if (!any) continue;
+
+            // Farthest point of the triangle inside the tile: the depth plane's
+            // minimum over the tile corners, but never beyond the farthest vertex
+            float x0 = static_cast<float>(tileLeft), x1 = x0 + TILE_WIDTH;
+            float y0 = rowTop, y1 = rowTop + TILE_HEIGHT;
+            float corner = std::min(std::min(tri.depthA * x0 + tri.depthB * y0, tri.depthA * x1 + tri.depthB * y0),
+                                    std::min(tri.depthA * x0 + tri.depthB * y1, tri.depthA * x1 + tri.depthB * y1)) +
+                           tri.depthC;
+            UpdateTile(static_cast<size_t>(tileRow) * tilesX_ + tx, rows, std::max(corner, tri.minInvW));
+        }
+    }
+}
+
+void OcclusionBuffer::UpdateTile(size_t tile, const uint32_t rows[TILE_HEIGHT], float invW) {
+    float& reference = referenceDepth_[tile];
+    float& working = workingDepth_[tile];
+    uint32_t* mask = &masks_[tile * TILE_HEIGHT];
+
+    // Behind the fully covered layer: nothing to add
+    if (invW <= reference) return;
+
+    uint32_t any = 0;
+    for (int k = 0; k < TILE_HEIGHT; ++k) any |= mask[k];
+
+    // The paper's merge heuristic: a triangle much nearer than the working
+    // layer starts a new one instead of being merged (the merge keeps the
+    // farthest depth, which would throw away most of its value)
+    if (!any || invW - working > working - reference) {
+        for (int k = 0; k < TILE_HEIGHT; ++k) mask[k] = rows[k];
+        working = invW;
+    } else {
+        for (int k = 0; k < TILE_HEIGHT; ++k) mask[k] |= rows[k];
+        working = std::min(working, invW);
+    }
+
+    // Fully covered: the working layer becomes the reference layer
+    uint32_t full = FULL_ROW;
+    for (int k = 0; k < TILE_HEIGHT; ++k) full &= mask[k];
+    if (full == FULL_ROW) {
+        reference = std::max(reference, working);
+        for (int k = 0; k < TILE_HEIGHT; ++k) mask[k] = 0;
+        working = 0.0f;
+    }
+}
+
+// === TESTS ===
+
+bool OcclusionBuffer::TestAABB(const AABB& box) const {
+    if (!active_) return true;
+
+    float minX = static_cast<float>(width_), maxX = 0.0f;
+    float minY = static_cast<float>(height_), maxY = 0.0f;
+    float nearest = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        Vector3 corner = {(i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y,
+                          (i & 4) ? box.max.z : box.min.z};
+        Vector3 d = Vector3Subtract(corner, eye_);
+        float w = Vector3DotProduct(d, forward_);
+        // Crosses the near plane: too close to say anything
+        if (w < nearDistance_) return true;
+
+        float invW = 1.0f / w;
+        float sx = width_ * 0.5f + Vector3DotProduct(d, right_) * scaleX_ * invW;
+        float sy = height_ * 0.5f - Vector3DotProduct(d, up_) * scaleY_ * invW;
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        nearest = std::max(nearest, invW);
+    }
+
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+    int x1 = std::min(width_, static_cast<int>(std::ceil(maxX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+    int y1 = std::min(height_, static_cast<int>(std::ceil(maxY)));
+    // Off screen: leave it to the frustum test
+    if (x0 >= x1 || y0 >= y1) return true;
+
+    return TestRect(x0, y0, x1, y1, nearest);
+}
+
+bool OcclusionBuffer::TestRect(int x0, int y0, int x1, int y1, float nearestInvW) const {
+    const int tx0 = x0 / TILE_WIDTH, tx1 = (x1 - 1) / TILE_WIDTH;
+    const int ty0 = y0 / TILE_HEIGHT, ty1 = (y1 - 1) / TILE_HEIGHT;
+
+#if defined(PAINTSPLASH_SSE)
+    const __m128 nearest4 = _mm_set1_ps(nearestInvW);
+#endif
+
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        const int rowLo = std::max(y0 - ty * TILE_HEIGHT, 0);
+        const int rowHi = std::min(y1 - ty * TILE_HEIGHT, TILE_HEIGHT);
+        const size_t rowBase = static_cast<size_t>(ty) * tilesX_;
+
+        int tx = tx0;
+        while (tx <= tx1) {
+#if defined(PAINTSPLASH_SSE)
+            // Four tiles at a time against the reference layer: the common
+            // case behind a wall is every tile rejecting at once
+            if (tx + 3 <= tx1) {
+                __m128 reference = _mm_loadu_ps(&referenceDepth_[rowBase + tx]);
+                if (_mm_movemask_ps(_mm_cmplt_ps(nearest4, reference)) == 0xF) {
+                    tx += 4;
+                    continue;
+                }
+            }
+#endif
+            const size_t tile = rowBase + tx;
+            if (nearestInvW < referenceDepth_[tile]) {
+                ++tx;
+                continue;
+            }
+
+            // Pixels in the working layer's mask are at least that near
+            if (nearestInvW < workingDepth_[tile]) {
+                uint32_t columns = SpanMask(x0 - tx * TILE_WIDTH, x1 - tx * TILE_WIDTH);
+                const uint32_t* mask = &masks_[tile * TILE_HEIGHT];
+                bool covered = true;
+                for (int k = rowLo; k < rowHi && covered; ++k) {
+                    covered = (mask[k] & columns) == columns;
+                }
+                if (covered) {
+                    ++tx;
+                    continue;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t OcclusionBuffer::CullAABBs(const AABB* boxes, size_t count, uint8_t* outVisible) {
+    size_t tested = 0;
+    for (size_t i = 0; i < count; ++i) tested += outVisible[i] ? 1 : 0;
+
+    if (active_) {
+        JobSystem::GetInstance().ParallelFor(count, TEST_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (outVisible[i] && !TestAABB(boxes[i])) outVisible[i] = 0;
+            }
+        });
+    }
+
+    size_t visible = 0;
+    for (size_t i = 0; i < count; ++i) visible += outVisible[i] ? 1 : 0;
+    stats_.tested += tested;
+    stats_.occluded += tested - visible;
+    return visible;
+}
+
+float OcclusionBuffer::GetTileDepth(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width_ || y >= height_) return 0.0f;
+    return referenceDepth_[static_cast<size_t>(y / TILE_HEIGHT) * tilesX_ + x / TILE_WIDTH];
+}
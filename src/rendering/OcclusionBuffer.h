@@ -0,0 +1,106 @@
+#pragma once
+
+#include "raylib.h"
+#include "../math/AABB.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct World;
+struct Frustum;
+
+// CPU masked occlusion culling (Andersson et al., "Masked Software Occlusion
+// Culling"). The largest world surfaces (World::occluders, picked at compile
+// time) are rasterized each frame into a low resolution buffer of 32x8 pixel
+// tiles. Each tile stores a coverage mask plus two conservative depths instead
+// of per-pixel depth, so rasterizing and testing stay cheap. Entity bounds are
+// then tested against it before draw commands are issued.
+//
+// Depth is stored as 1/w (larger = nearer), which interpolates linearly in
+// screen space. Everything runs on the CPU and the job system, no GPU needed.
+class OcclusionBuffer {
+public:
+    static constexpr int TILE_WIDTH = 32;
+    static constexpr int TILE_HEIGHT = 8;
+    static constexpr int DEFAULT_WIDTH = 320;
+    static constexpr int DEFAULT_HEIGHT = 192;
+    static constexpr size_t MAX_OCCLUDER_TRIANGLES = 4096;  // Per frame raster budget
+
+    struct Stats {
+        size_t occluders = 0;       // Polygons rasterized this frame
+        size_t triangles = 0;
+        size_t tested = 0;          // Boxes tested this frame
+        size_t occluded = 0;
+        double rasterMs = 0.0;
+    };
+
+    OcclusionBuffer();
+
+    // Buffer size in pixels, rounded up to whole tiles
+    void SetResolution(int width, int height);
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+
+    // Clear the buffer and set up the projection for this frame. Returns false
+    // (and every test reports visible) for cameras it can't handle.
+    bool BeginFrame(const Camera3D& camera, float aspect, float nearDistance = 0.05f);
+
+    // Queue a convex world space polygon as an occluder. Either winding is
+    // accepted; callers drop one-sided polygons seen from behind.
+    void AddOccluder(const Vector3* vertices, size_t count);
+
+    // Queue the world's occluder surfaces that face the camera and pass the
+    // frustum, then rasterize everything queued
+    void RenderOccluders(const World& world, const Frustum& frustum);
+
+    // Rasterize queued occluders. Tile rows are independent, so they are
+    // split across the job system.
+    void Rasterize();
+
+    // False when the box is completely hidden behind rasterized occluders
+    bool TestAABB(const AABB& box) const;
+
+    // Batch test on the job system: clears outVisible[i] for occluded boxes.
+    // Entries that are already 0 (frustum culled) are skipped. Returns the
+    // number still visible.
+    size_t CullAABBs(const AABB* boxes, size_t count, uint8_t* outVisible);
+
+    bool IsActive() const { return active_; }
+    const Stats& GetStats() const { return stats_; }
+
+    // Conservative depth of the tile covering pixel (x, y) for debugging:
+    // everything drawn there is at least this near (1/w, 0 = nothing)
+    float GetTileDepth(int x, int y) const;
+
+private:
+    struct ScreenVertex { float x, y, invW; };
+    struct ScreenTriangle {
+        ScreenVertex v[3];
+        float depthA, depthB, depthC;    // invW = depthA * x + depthB * y + depthC
+        float minInvW;                   // Farthest vertex
+        int tileRowBegin, tileRowEnd;
+    };
+
+    void RasterizeTileRow(int tileRow);
+    void UpdateTile(size_t tile, const uint32_t rows[TILE_HEIGHT], float invW);
+    bool TestRect(int x0, int y0, int x1, int y1, float nearestInvW) const;
+
+    int width_ = 0, height_ = 0;
+    int tilesX_ = 0, tilesY_ = 0;
+    bool active_ = false;
+
+    // View setup from BeginFrame
+    Vector3 eye_{0, 0, 0}, right_{1, 0, 0}, up_{0, 1, 0}, forward_{0, 0, -1};
+    float scaleX_ = 1.0f, scaleY_ = 1.0f;     // Half size / tan(half fov)
+    float nearDistance_ = 0.05f;
+
+    // Per tile (SoA): coverage of the working layer (one word per pixel row),
+    // depth of the fully covered reference layer and of the working layer
+    std::vector<uint32_t> masks_;
+    std::vector<float> referenceDepth_;
+    std::vector<float> workingDepth_;
+
+    std::vector<ScreenTriangle> triangles_;
+    std::vector<std::vector<uint32_t>> rowBins_;   // Triangles touching each tile row, in queue order
+    Stats stats_;
+};
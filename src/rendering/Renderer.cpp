@@ -8,8 +8,12 @@
 #include "../ecs/Components/TransformComponent.h"
 #include "../ecs/Systems/MeshSystem.h"
 #include "../ecs/Systems/AssetSystem.h"
+#include "../world/LightmapBaker.h"
+#include "../world/IrradianceVolume.h"
+#include "../world/WorldMesh.h"
 #include "utils/Logger.h"
 #include <algorithm>
+#include <climits>
 #include <string>
 
 Renderer::Renderer()
@@ -44,6 +48,7 @@ Renderer::Renderer()
     camera_.up = {0.0f, 1.0f, 0.0f};          // Up vector
     camera_.fovy = 45.0f;                      // Field of view
     camera_.projection = CAMERA_PERSPECTIVE;   // Perspective projection
+    UpdateViewFrustum();
 
     LOG_INFO("Renderer initialized with Camera3D");
 }
@@ -52,6 +57,8 @@ Renderer::~Renderer()
 {
     // Asset cache will automatically log its final statistics in its destructor
     modelCache_.reset();
+    UnloadLightmapTextures();
+    UnloadWorldBatchBuffers();
     LOG_INFO("Renderer destroyed");
 }
 
@@ -171,15 +178,15 @@ void Renderer::HandleDebugInput() {
         }
         
         // Cycle through clusters with F6/F7
-        if (bspTree_ && bspTree_->GetClusterCount() > 0) {
+        int clusterCount = (worldGeometry_ && worldGeometry_->GetWorld()) ? worldGeometry_->GetWorld()->numClusters : 0;
+        if (clusterCount > 0) {
             if (inputSystem_->IsActionPressed(static_cast<InputAction>(
                     static_cast<int>(InputAction::CUSTOM_START) + 3))) {  // F6
-                selectedCluster_ = (selectedCluster_ - 1 + bspTree_->GetClusterCount()) % 
-                                 bspTree_->GetClusterCount();
+                selectedCluster_ = (selectedCluster_ - 1 + clusterCount) % clusterCount;
                 LOG_INFO("Selected Cluster: " + std::to_string(selectedCluster_));
             } else if (inputSystem_->IsActionPressed(static_cast<InputAction>(
                     static_cast<int>(InputAction::CUSTOM_START) + 4))) {  // F7
-                selectedCluster_ = (selectedCluster_ + 1) % bspTree_->GetClusterCount();
+                selectedCluster_ = (selectedCluster_ + 1) % clusterCount;
                 LOG_INFO("Selected Cluster: " + std::to_string(selectedCluster_));
             }
         }
@@ -198,23 +205,29 @@ void Renderer::RenderBSPGeometry()
 
     if (worldGeometry_->GetWorld() && bspTreeSystem_) {
         // Phase 1: PVS Visibility Determination (like Quake's R_MarkLeaves)
-        // This MUST happen first - it marks entire subtrees as potentially visible
-        bspTreeSystem_->MarkLeaves(*worldGeometry_->GetWorld(), camera_.position);
+        // This MUST happen first - it marks whole clusters that pass the PVS and
+        // a batch frustum test of their bounds
+        bspTreeSystem_->MarkLeaves(*worldGeometry_->GetWorld(), camera_.position, &viewFrustum_);
+
+        // Static batches draw the marked clusters whole; the face walk below
+        // is for worlds that have none
+        if (UpdateWorldBatchBuffers(worldGeometry_->GetBatches())) {
+            RenderWorldBatches(*worldGeometry_->GetWorld());
+
+            rlSetTexture(0);
+            rlEnableDepthTest();
+            rlEnableDepthMask();
+            rlEnableBackfaceCulling();
+            return;
+        }
 
         // Phase 2: Recursive BSP Traversal with Frustum Culling (like R_RecursiveWorldNode)
         // Only traverses nodes marked visible by PVS, applies hierarchical frustum culling
         visibleFaces_.clear();
 
-        bspTreeSystem_->TraverseForRendering(*worldGeometry_->GetWorld(), camera_,
-            [&](const Face& face) {
-                // Final face-level checks: backface culling only
-                // Frustum culling already done at node level for efficiency
-                // For now, always render faces in the new system (backface culling removed for debugging)
-                // TODO: Add backface culling when ready
-                if (true) {
-                    visibleFaces_.push_back(&face);
-                }
-            });
+        // Final face-level checks (backface culling) are not done yet
+        // TODO: Add backface culling when ready
+        bspTreeSystem_->TraverseForRendering(*worldGeometry_->GetWorld(), viewFrustum_, visibleFaces_);
 
         LOG_DEBUG("Quake-style rendering pipeline results:");
         LOG_DEBUG("  - Total faces in world: " + std::to_string(worldGeometry_->GetWorld()->surfaces.size()));
@@ -249,6 +262,15 @@ void Renderer::RenderBSPGeometry()
     // Group faces by material for batching to reduce draw calls
     facesByMaterial_.clear();
 
+    // Lightmapped faces are grouped separately: drawn unlit, then modulated by
+    // their atlas page
+    const World* world = worldGeometry_->GetWorld();
+    const bool useLightmaps = lightmapsEnabled_ && world && UpdateLightmapTextures(*world);
+    for (auto& group : lightmappedFacesByMaterial_) group.second.clear();
+    for (auto& page : facesByLightmap_) page.clear();
+    facesByLightmap_.resize(lightmapTextures_.size());
+    size_t lightmappedFaces = 0;
+
     // First pass: group faces by material and count stats
     for (const Face* facePtr : visibleFaces_) {
         const Face& face = *facePtr;
@@ -261,61 +283,500 @@ void Renderer::RenderBSPGeometry()
 
         // Use materialId as key (0 for default material)
         unsigned int materialKey = face.materialId;
-        facesByMaterial_[materialKey].push_back(facePtr);
+        if (useLightmaps && face.lightmapIndex >= 0 && face.lightmapIndex < (int)facesByLightmap_.size()) {
+            lightmappedFacesByMaterial_[materialKey].push_back(facePtr);
+            facesByLightmap_[face.lightmapIndex].push_back(facePtr);
+            lightmappedFaces++;
+        } else {
+            facesByMaterial_[materialKey].push_back(facePtr);
+        }
 
         surfacesRendered_++;
         trianglesRendered_ += (face.vertices.size() >= 3) ? face.vertices.size() - 2 : 0;
     }
 
     // Second pass: render each material group in batch (dramatically reduces draw calls)
-    for (const auto& materialGroup : facesByMaterial_) {
+    RenderMaterialGroups(facesByMaterial_);
+
+    // Static lights are already in the lightmaps, so these faces skip the
+    // lighting shader
+    if (lightmappedFaces > 0) {
+        bool shaderWasActive = currentShader_ != nullptr;
+        if (shaderWasActive) EndShaderMode();
+        RenderMaterialGroups(lightmappedFacesByMaterial_);
+        RenderLightmapPass();
+        if (shaderWasActive && currentShader_) BeginShaderMode(*currentShader_);
+    }
+
+    // Reset render state
+    rlSetTexture(0);
+    rlEnableDepthTest();
+    rlEnableDepthMask();
+    rlEnableBackfaceCulling();
+
+    // BSP geometry rendering completed
+}
+
+// Draw faces grouped by material (one SetupMaterial per group)
+void Renderer::RenderMaterialGroups(const std::unordered_map<unsigned int, std::vector<const Face*>>& groups)
+{
+    for (const auto& materialGroup : groups) {
         unsigned int materialId = materialGroup.first;
         const auto& faces = materialGroup.second;
+        if (faces.empty()) continue;
 
-        // Set up material for this batch (once per material, not per face)
-        MaterialComponent faceMaterialComponent;
-
-        // Look up material in WorldSystem's ID mapping
-        auto worldSystem = GetEngine().GetSystem<WorldSystem>();
-        if (worldSystem) {
-            const auto& materialIdMap = worldSystem->GetMaterialIdMap();
-            auto matIt = materialIdMap.find(materialId);
-            if (matIt != materialIdMap.end()) {
-                // Found material mapping - create MaterialComponent with the MaterialSystem ID
-                faceMaterialComponent = MaterialComponent(matIt->second);
-                LOG_DEBUG("Using materialId " + std::to_string(materialId) +
-                         " -> MaterialSystem ID " + std::to_string(matIt->second));
-            } else {
-                // Material not found - use default material (ID 0)
-                faceMaterialComponent = MaterialComponent(0);
-                LOG_DEBUG("MaterialId " + std::to_string(materialId) + " not found, using default material");
-            }
+        // Set up material once per batch (not per face)
+        SetupWorldMaterial(materialId);
+
+        // Render all faces in this material batch (single draw call per face, but batched by material)
+        for (const Face* facePtr : faces) {
+            RenderFace(*facePtr);
+        }
+    }
+}
+
+// Set up a world face material id through WorldSystem's mapping to MaterialSystem
+void Renderer::SetupWorldMaterial(unsigned int materialId)
+{
+    MaterialComponent faceMaterialComponent;
+
+    // Look up material in WorldSystem's ID mapping
+    auto worldSystem = GetEngine().GetSystem<WorldSystem>();
+    if (worldSystem) {
+        const auto& materialIdMap = worldSystem->GetMaterialIdMap();
+        auto matIt = materialIdMap.find(materialId);
+        if (matIt != materialIdMap.end()) {
+            // Found material mapping - create MaterialComponent with the MaterialSystem ID
+            faceMaterialComponent = MaterialComponent(matIt->second);
+            LOG_DEBUG("Using materialId " + std::to_string(materialId) +
+                     " -> MaterialSystem ID " + std::to_string(matIt->second));
         } else {
-            // No WorldSystem - use default material
+            // Material not found - use default material (ID 0)
             faceMaterialComponent = MaterialComponent(0);
-            LOG_WARNING("WorldSystem not available for material lookup");
+            LOG_DEBUG("MaterialId " + std::to_string(materialId) + " not found, using default material");
+        }
+    } else {
+        // No WorldSystem - use default material
+        faceMaterialComponent = MaterialComponent(0);
+        LOG_WARNING("WorldSystem not available for material lookup");
+    }
+
+    SetupMaterial(faceMaterialComponent);
+}
+
+// Multiply lightmapped faces (already drawn with their material) by their
+// atlas page: dst = 2 * src * dst, which undoes the LIGHTMAP_OVERBRIGHT
+// encoding. Same vertices and depth test LEQUAL, so only those faces' pixels
+// are touched.
+void Renderer::RenderLightmapPass()
+{
+    rlSetBlendFactors(RL_DST_COLOR, RL_SRC_COLOR, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+    rlDisableDepthMask();
+    rlDisableBackfaceCulling();
+
+    for (size_t page = 0; page < facesByLightmap_.size(); ++page) {
+        const std::vector<const Face*>& faces = facesByLightmap_[page];
+        if (faces.empty()) continue;
+
+        rlBegin(RL_TRIANGLES);
+            rlSetTexture(lightmapTextures_[page].id);
+            for (const Face* face : faces) {
+                auto emit = [&](const Vector3& vertex) {
+                    Vector2 planar = LightmapBaker::SurfacePlanar(*face, vertex);
+                    rlColor4ub(255, 255, 255, 255);
+                    rlTexCoord2f(planar.x * face->lightmapUVScale.x + face->lightmapUVOffset.x,
+                                 planar.y * face->lightmapUVScale.y + face->lightmapUVOffset.y);
+                    rlVertex3f(vertex.x, vertex.y, vertex.z);
+                };
+                faceCorners_.clear();
+                if (!WorldMesh::TriangulatePolygon(face->vertices, faceCorners_)) continue;
+                for (uint32_t corner : faceCorners_) {
+                    emit(face->vertices[corner]);
+                }
+            }
+        rlEnd();
+    }
+
+    rlSetTexture(0);
+    lastBoundTexture_ = -1;
+    EndBlendMode();
+}
+
+bool Renderer::UpdateLightmapTextures(const World& world)
+{
+    if (world.lightmapTexels.data() == lightmapSource_ && world.lightmapTexels.size() == lightmapSourceTexels_) {
+        return !lightmapTextures_.empty();
+    }
+
+    UnloadLightmapTextures();
+    lightmapSource_ = world.lightmapTexels.data();
+    lightmapSourceTexels_ = world.lightmapTexels.size();
+
+    for (const BSPLightmap& lightmap : world.lightmaps) {
+        Image image = {};
+        image.data = const_cast<Color*>(world.lightmapTexels.data() + lightmap.firstTexel);
+        image.width = static_cast<int>(lightmap.width);
+        image.height = static_cast<int>(lightmap.height);
+        image.mipmaps = 1;
+        image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+        Texture2D texture = LoadTextureFromImage(image);
+        SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+        SetTextureWrap(texture, TEXTURE_WRAP_CLAMP);
+        lightmapTextures_.push_back(texture);
+    }
+
+    if (!lightmapTextures_.empty()) {
+        LOG_INFO("Uploaded " + std::to_string(lightmapTextures_.size()) + " lightmap pages (" +
+                 std::to_string(lightmapSourceTexels_ * sizeof(Color) / 1024) + " KB)");
+    }
+    return !lightmapTextures_.empty();
+}
+
+void Renderer::UnloadLightmapTextures()
+{
+    for (const Texture2D& texture : lightmapTextures_) {
+        if (texture.id != 0) UnloadTexture(texture);
+    }
+    lightmapTextures_.clear();
+    facesByLightmap_.clear();
+    lightmapSource_ = nullptr;
+    lightmapSourceTexels_ = 0;
+}
+
+// === Static World Batches ===
+
+namespace {
+
+// rlDrawVertexArrayElements reads unsigned short indices
+constexpr size_t WORLD_BATCH_CHUNK_VERTICES = 65536;
+
+// One chunk's worth of a batch before upload
+struct WorldBatchChunkData {
+    std::vector<unsigned int> sourceVertices;  // Batch vertex of each chunk vertex
+    std::vector<unsigned short> indices;
+    std::vector<WorldGeometry::BatchRange> clusterRanges;
+};
+
+unsigned int LoadWorldBatchStream(const void* data, size_t bytes, unsigned int location, int components,
+                                  int type, bool normalized) {
+    unsigned int vbo = rlLoadVertexBuffer(data, static_cast<int>(bytes), false);
+    rlSetVertexAttribute(location, components, type, normalized, 0, 0);
+    rlEnableVertexAttribute(location);
+    return vbo;
+}
+
+} // namespace
+
+// Draw the static batches' visible cluster ranges. Lightmapped batches draw
+// unlit and are then modulated by their atlas page, as in the face path.
+void Renderer::RenderWorldBatches(const World& world)
+{
+    bspTreeSystem_->GetVisibleClusters(world, visibleClusters_);
+    for (size_t c = 0; c < visibleClusters_.size() && c < world.clusters.size(); ++c) {
+        if (visibleClusters_[c]) surfacesRendered_ += static_cast<int>(world.clusters[c].surfaces.size());
+    }
+
+    if (worldBatchStretchUVs_ != useStretchUV_) {
+        BindWorldBatchUVs(useStretchUV_);
+    }
+
+    const bool useLightmaps = lightmapsEnabled_ && UpdateLightmapTextures(world);
+    auto isLightmapped = [&](const WorldBatchBuffers& batch) {
+        return useLightmaps && batch.lightmapPage >= 0 &&
+               batch.lightmapPage < static_cast<int>(lightmapTextures_.size());
+    };
+    // Material textures are bound by SetupMaterial; a material without one
+    // keeps the previous texture, as RenderFace does
+    auto materialTexture = [&]() {
+        return lastBoundTexture_ > 0 ? static_cast<unsigned int>(lastBoundTexture_) : rlGetTextureIdDefault();
+    };
+
+    bool anyLightmapped = false;
+    for (const WorldBatchBuffers& batch : worldBatchBuffers_) {
+        if (isLightmapped(batch)) {
+            anyLightmapped = true;
+            continue;
         }
+        SetupWorldMaterial(batch.materialId);
+        BeginWorldBatchShader(currentShader_);
+        for (const WorldBatchChunk& chunk : batch.chunks) {
+            DrawWorldBatchChunk(chunk, chunk.vao, materialTexture());
+        }
+        EndWorldBatchShader();
+    }
 
-        MaterialComponent* faceMaterial = &faceMaterialComponent;
+    // Static lights are already in the lightmaps, so these batches skip the
+    // lighting shader
+    if (anyLightmapped) {
+        bool shaderWasActive = currentShader_ != nullptr;
+        if (shaderWasActive) EndShaderMode();
 
-        // Set up material once per batch
-        if (faceMaterial) {
-            SetupMaterial(*faceMaterial);
+        for (const WorldBatchBuffers& batch : worldBatchBuffers_) {
+            if (!isLightmapped(batch)) continue;
+            SetupWorldMaterial(batch.materialId);
+            BeginWorldBatchShader(nullptr);
+            for (const WorldBatchChunk& chunk : batch.chunks) {
+                DrawWorldBatchChunk(chunk, chunk.vao, materialTexture());
+            }
+            EndWorldBatchShader();
         }
 
-        // Render all faces in this material batch (single draw call per face, but batched by material)
-        for (const Face* facePtr : faces) {
-            RenderFace(*facePtr);
+        // dst = 2 * src * dst, see RenderLightmapPass
+        rlSetBlendFactors(RL_DST_COLOR, RL_SRC_COLOR, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM);
+        rlDisableDepthMask();
+        rlDisableBackfaceCulling();
+        BeginWorldBatchShader(nullptr);
+        // The lightmap VAOs have no color stream
+        const float vertexColor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        rlSetVertexAttributeDefault(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, vertexColor, RL_SHADER_ATTRIB_VEC4, 4);
+        for (const WorldBatchBuffers& batch : worldBatchBuffers_) {
+            if (!isLightmapped(batch)) continue;
+            for (const WorldBatchChunk& chunk : batch.chunks) {
+                DrawWorldBatchChunk(chunk, chunk.lightmapVao, lightmapTextures_[batch.lightmapPage].id);
+            }
         }
+        EndWorldBatchShader();
+        EndBlendMode();
+
+        if (shaderWasActive && currentShader_) BeginShaderMode(*currentShader_);
     }
+    lastBoundTexture_ = -1;
+}
 
-    // Reset render state
-    rlSetTexture(0);
-    rlEnableDepthTest();
-    rlEnableDepthMask();
-    rlEnableBackfaceCulling();
+// Bind a shader for VAO draws with the uniforms rlgl sets for its own batch
+void Renderer::BeginWorldBatchShader(const Shader* shader)
+{
+    // Flush pending immediate-mode geometry so draw order holds
+    rlDrawRenderBatchActive();
+
+    const int* locs = shader ? shader->locs : rlGetShaderLocsDefault();
+    rlEnableShader(shader ? shader->id : rlGetShaderIdDefault());
+
+    Matrix model = rlGetMatrixTransform();
+    Matrix view = rlGetMatrixModelview();
+    Matrix projection = rlGetMatrixProjection();
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MVP], MatrixMultiply(MatrixMultiply(model, view), projection));
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_VIEW], view);
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_PROJECTION], projection);
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_MODEL], model);
+    rlSetUniformMatrix(locs[RL_SHADER_LOC_MATRIX_NORMAL], MatrixTranspose(MatrixInvert(model)));
+
+    const float diffuse[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const int textureSlot = 0;
+    rlSetUniform(locs[RL_SHADER_LOC_COLOR_DIFFUSE], diffuse, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(locs[RL_SHADER_LOC_MAP_DIFFUSE], &textureSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(0);
+}
 
-    // BSP geometry rendering completed
+void Renderer::EndWorldBatchShader()
+{
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+void Renderer::DrawWorldBatchChunk(const WorldBatchChunk& chunk, unsigned int vao, unsigned int textureId)
+{
+    visibleRanges_.clear();
+    WorldGeometry::CollectVisibleRanges(chunk.clusterRanges, visibleClusters_, visibleRanges_);
+    if (visibleRanges_.empty() || vao == 0) return;
+
+    rlEnableTexture(textureId);
+    rlEnableVertexArray(vao);
+    for (const WorldGeometry::BatchRange& range : visibleRanges_) {
+        rlDrawVertexArrayElements(static_cast<int>(range.firstIndex), static_cast<int>(range.indexCount), 0);
+        if (vao == chunk.vao) trianglesRendered_ += static_cast<int>(range.indexCount / 3);
+    }
+}
+
+bool Renderer::UpdateWorldBatchBuffers(const std::vector<WorldGeometry::StaticBatch>& batches)
+{
+    if (batches.data() == worldBatchSource_ && batches.size() == worldBatchSourceCount_) {
+        return !worldBatchBuffers_.empty();
+    }
+
+    UnloadWorldBatchBuffers();
+    worldBatchSource_ = batches.data();
+    worldBatchSourceCount_ = batches.size();
+    worldBatchStretchUVs_ = useStretchUV_;
+
+    size_t chunkCount = 0, vertexCount = 0;
+    std::vector<unsigned int> chunkIndex;
+    std::vector<Vector3> positions, normals;
+    std::vector<Vector2> uvs, stretchUVs, lightmapUVs;
+    std::vector<Color> colors;
+
+    for (const WorldGeometry::StaticBatch& batch : batches) {
+        WorldBatchBuffers buffers;
+        buffers.materialId = batch.materialId;
+        buffers.lightmapPage = batch.lightmapPage;
+        chunkIndex.assign(batch.positions.size(), UINT_MAX);
+
+        WorldBatchChunkData data;
+        auto upload = [&]() -> bool {
+            if (data.indices.empty()) return true;
+
+            positions.clear();
+            normals.clear();
+            uvs.clear();
+            stretchUVs.clear();
+            lightmapUVs.clear();
+            colors.clear();
+            for (unsigned int vertex : data.sourceVertices) {
+                positions.push_back(batch.positions[vertex]);
+                normals.push_back(batch.normals[vertex]);
+                // Flip V globally, as RenderFace does; lightmap uvs aren't flipped
+                uvs.push_back({batch.uvs[vertex].x, 1.0f - batch.uvs[vertex].y});
+                stretchUVs.push_back({batch.stretchUVs[vertex].x, 1.0f - batch.stretchUVs[vertex].y});
+                lightmapUVs.push_back(batch.lightmapUVs[vertex]);
+                colors.push_back(batch.colors[vertex]);
+                chunkIndex[vertex] = UINT_MAX;
+            }
+
+            WorldBatchChunk chunk;
+            chunk.vao = rlLoadVertexArray();
+            if (chunk.vao == 0) return false;
+            rlEnableVertexArray(chunk.vao);
+            chunk.positionVbo = LoadWorldBatchStream(positions.data(), positions.size() * sizeof(Vector3),
+                                                     RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false);
+            chunk.uvVbo = rlLoadVertexBuffer(uvs.data(), static_cast<int>(uvs.size() * sizeof(Vector2)), false);
+            chunk.stretchUVVbo = LoadWorldBatchStream(stretchUVs.data(), stretchUVs.size() * sizeof(Vector2),
+                                                      RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false);
+            if (!worldBatchStretchUVs_) {
+                rlEnableVertexBuffer(chunk.uvVbo);
+                rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, 0, 0);
+            }
+            chunk.normalVbo = LoadWorldBatchStream(normals.data(), normals.size() * sizeof(Vector3),
+                                                   RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 3, RL_FLOAT, false);
+            chunk.colorVbo = LoadWorldBatchStream(colors.data(), colors.size() * sizeof(Color),
+                                                  RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, RL_UNSIGNED_BYTE, true);
+            chunk.ebo = rlLoadVertexBufferElement(data.indices.data(),
+                                                  static_cast<int>(data.indices.size() * sizeof(unsigned short)), false);
+
+            // The lightmap pass reads the page uvs as its only texcoords
+            if (batch.lightmapPage >= 0) {
+                chunk.lightmapVao = rlLoadVertexArray();
+                rlEnableVertexArray(chunk.lightmapVao);
+                rlEnableVertexBuffer(chunk.positionVbo);
+                rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_FLOAT, false, 0, 0);
+                rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+                chunk.lightmapUVVbo = LoadWorldBatchStream(lightmapUVs.data(), lightmapUVs.size() * sizeof(Vector2),
+                                                           RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT,
+                                                           false);
+                rlEnableVertexBufferElement(chunk.ebo);
+            }
+            rlDisableVertexArray();
+
+            chunk.clusterRanges = std::move(data.clusterRanges);
+            vertexCount += positions.size();
+            buffers.chunks.push_back(std::move(chunk));
+            ++chunkCount;
+            data = WorldBatchChunkData();
+            return true;
+        };
+
+        // Ranges are split only where a chunk fills up, so most stay whole
+        bool uploaded = true;
+        for (size_t r = 0; r < batch.clusterRanges.size() && uploaded; ++r) {
+            const WorldGeometry::BatchRange& range = batch.clusterRanges[r];
+            WorldGeometry::BatchRange chunkRange = {range.cluster, static_cast<uint32_t>(data.indices.size()), 0};
+            for (uint32_t i = range.firstIndex; i + 2 < range.firstIndex + range.indexCount && uploaded; i += 3) {
+                if (data.sourceVertices.size() + 3 > WORLD_BATCH_CHUNK_VERTICES) {
+                    if (chunkRange.indexCount > 0) data.clusterRanges.push_back(chunkRange);
+                    uploaded = upload();
+                    chunkRange = {range.cluster, 0, 0};
+                }
+                for (uint32_t k = 0; k < 3; ++k) {
+                    unsigned int vertex = batch.indices[i + k];
+                    if (chunkIndex[vertex] == UINT_MAX) {
+                        chunkIndex[vertex] = static_cast<unsigned int>(data.sourceVertices.size());
+                        data.sourceVertices.push_back(vertex);
+                    }
+                    data.indices.push_back(static_cast<unsigned short>(chunkIndex[vertex]));
+                }
+                chunkRange.indexCount += 3;
+            }
+            if (chunkRange.indexCount > 0) data.clusterRanges.push_back(chunkRange);
+        }
+        uploaded = uploaded && upload();
+        worldBatchBuffers_.push_back(std::move(buffers));
+
+        if (!uploaded) {
+            LOG_WARNING("Vertex arrays not supported, drawing world faces one by one");
+            UnloadWorldBatchBuffers();
+            worldBatchSource_ = batches.data();
+            worldBatchSourceCount_ = batches.size();
+            return false;
+        }
+    }
+
+    if (!worldBatchBuffers_.empty()) {
+        LOG_INFO("Uploaded " + std::to_string(worldBatchBuffers_.size()) + " static world batches (" +
+                 std::to_string(chunkCount) + " chunks, " + std::to_string(vertexCount) + " vertices)");
+    }
+    return !worldBatchBuffers_.empty();
+}
+
+void Renderer::UnloadWorldBatchBuffers()
+{
+    for (const WorldBatchBuffers& batch : worldBatchBuffers_) {
+        for (const WorldBatchChunk& chunk : batch.chunks) {
+            if (chunk.vao != 0) rlUnloadVertexArray(chunk.vao);
+            if (chunk.lightmapVao != 0) rlUnloadVertexArray(chunk.lightmapVao);
+            for (unsigned int vbo : {chunk.positionVbo, chunk.uvVbo, chunk.stretchUVVbo, chunk.normalVbo,
+                                     chunk.colorVbo, chunk.lightmapUVVbo, chunk.ebo}) {
+                if (vbo != 0) rlUnloadVertexBuffer(vbo);
+            }
+        }
+    }
+    worldBatchBuffers_.clear();
+    worldBatchSource_ = nullptr;
+    worldBatchSourceCount_ = 0;
+}
+
+// Point the batch VAOs' texcoords at the stretch or authored uv stream
+void Renderer::BindWorldBatchUVs(bool stretch)
+{
+    for (const WorldBatchBuffers& batch : worldBatchBuffers_) {
+        for (const WorldBatchChunk& chunk : batch.chunks) {
+            rlEnableVertexArray(chunk.vao);
+            rlEnableVertexBuffer(stretch ? chunk.stretchUVVbo : chunk.uvVbo);
+            rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_FLOAT, false, 0, 0);
+        }
+    }
+    rlDisableVertexArray();
+    worldBatchStretchUVs_ = stretch;
+}
+
+bool Renderer::ApplyProbeLighting(const Shader& shader, const Vector3& position)
+{
+    const World* world = worldGeometry_ ? worldGeometry_->GetWorld() : nullptr;
+    if (!probeLightingEnabled_ || !world || world->probes.empty() || shader.id == 0) return false;
+
+    if (shader.id != probeShaderId_) {
+        probeShaderId_ = shader.id;
+        probeSHLoc_ = GetShaderLocation(shader, "probeSH");
+    }
+    if (probeSHLoc_ < 0) return false;
+
+    BSPIrradianceProbe probe;
+    if (!IrradianceVolume::Sample(*world, position, probe)) return false;
+    Vector3 ambient[4];
+    IrradianceVolume::ToAmbient(probe, ambient);
+
+    // Flush first, or batched geometry still pending would pick up this probe
+    rlDrawRenderBatchActive();
+    SetShaderValueV(shader, probeSHLoc_, ambient, SHADER_UNIFORM_VEC3, 4);
+    return true;
+}
+
+void Renderer::ClearProbeLighting(const Shader& shader)
+{
+    const Vector3 zero[4] = {};
+    SetShaderValueV(shader, probeSHLoc_, zero, SHADER_UNIFORM_VEC3, 4);
 }
 
 // Skybox rendering (following WorldRenderer pattern)
@@ -452,73 +913,14 @@ void Renderer::RenderFace(const Face& face)
     // Decide UV source: either provided UVs or renderer-generated stretch UVs
     const bool needStretchUVs = useStretchUV_ || (face.uvs.size() != face.vertices.size());
 
-    // Compute per-face stretch-to-fill UVs (tangent-space, normalized to 0..1)
-    std::vector<Vector2> stretchUVs;
-    if (needStretchUVs) {
-        // Build tangent space from face normal using a stable world-up reference
-        Vector3 normal = Vector3Normalize(face.normal);
-
-        const Vector3 WORLD_UP   = {0.0f, 1.0f, 0.0f};
-        const Vector3 WORLD_RIGHT= {1.0f, 0.0f, 0.0f};
-
-        // Prefer bitangent aligned with world up when possible (keeps textures upright)
-        Vector3 planeUp = WORLD_UP;
-        float upDot = Vector3DotProduct(planeUp, normal);
-        planeUp.x -= upDot * normal.x;
-        planeUp.y -= upDot * normal.y;
-        planeUp.z -= upDot * normal.z;
-        float upLenSq = planeUp.x*planeUp.x + planeUp.y*planeUp.y + planeUp.z*planeUp.z;
-        if (upLenSq < 1e-8f) {
-            // If up is degenerate (face nearly vertical), project world right instead
-            planeUp = WORLD_RIGHT;
-            float rDot = Vector3DotProduct(planeUp, normal);
-            planeUp.x -= rDot * normal.x;
-            planeUp.y -= rDot * normal.y;
-            planeUp.z -= rDot * normal.z;
-        }
-        Vector3 bitangent = Vector3Normalize(planeUp);
-        Vector3 tangent = Vector3Normalize(Vector3CrossProduct(bitangent, normal));
-
-        // If still degenerate, fallback to longest-edge method
-        float tLenSq = tangent.x*tangent.x + tangent.y*tangent.y + tangent.z*tangent.z;
-        if (tLenSq < 1e-8f) {
-            float maxLenSq = -1.0f;
-            const size_t nVerts = face.vertices.size();
-            for (size_t i = 0; i < nVerts; ++i) {
-                const Vector3& a = face.vertices[i];
-                const Vector3& b = face.vertices[(i + 1) % nVerts];
-                Vector3 edge = Vector3Subtract(b, a);
-                float d = Vector3DotProduct(edge, normal);
-                edge.x -= d * normal.x;
-                edge.y -= d * normal.y;
-                edge.z -= d * normal.z;
-                float eLenSq = edge.x*edge.x + edge.y*edge.y + edge.z*edge.z;
-                if (eLenSq > maxLenSq) { maxLenSq = eLenSq; tangent = edge; }
-            }
-            tangent = Vector3Normalize(tangent);
-            bitangent = Vector3Normalize(Vector3CrossProduct(normal, tangent));
-        }
-
-        // Find bounds in tangent space
-        float minU = FLT_MAX, maxU = -FLT_MAX;
-        float minV = FLT_MAX, maxV = -FLT_MAX;
-        for (const auto& vtx : face.vertices) {
-            float u = Vector3DotProduct(vtx, tangent);
-            float vv = Vector3DotProduct(vtx, bitangent);
-            if (u < minU) minU = u; if (u > maxU) maxU = u;
-            if (vv < minV) minV = vv; if (vv > maxV) maxV = vv;
-        }
-        const float uRange = maxU - minU;
-        const float vRange = maxV - minV;
-        stretchUVs.reserve(face.vertices.size());
-        for (const auto& vtx : face.vertices) {
-            float u = Vector3DotProduct(vtx, tangent);
-            float vv = Vector3DotProduct(vtx, bitangent);
-            if (uRange > 1e-5f) u = (u - minU) / uRange; else u = 0.5f;
-            if (vRange > 1e-5f) vv = (vv - minV) / vRange; else vv = 0.5f;
-            stretchUVs.push_back({u, vv});
-        }
+    // Stretch-to-fill UVs: baked at world build from the authored face (so BSP
+    // fragments of one face line up), computed here for faces built elsewhere
+    std::vector<Vector2> computedStretchUVs;
+    const bool bakedStretchUVs = face.stretchUVs.size() == face.vertices.size();
+    if (needStretchUVs && !bakedStretchUVs) {
+        ComputeStretchUVs(face.vertices, face.normal, computedStretchUVs);
     }
+    const std::vector<Vector2>& stretchUVs = bakedStretchUVs ? face.stretchUVs : computedStretchUVs;
 
     // Debug: warn if no texture is currently bound (likely to render white)
     unsigned int currentTexIdForCheck = lastBoundTexture_;
@@ -576,54 +978,30 @@ void Renderer::RenderFace(const Face& face)
             }
         rlEnd();
         trianglesRendered_++;
-    } else if (vcount == 4) {
-        // Quad rendering with rlgl - supports textures, normals, and shaders
-        LOG_DEBUG("QUAD RENDER: 4 vertices with shader + normal + texture support");
-        rlBegin(RL_QUADS);
-            // Set texture inside rlBegin() for proper binding
-            if (lastBoundTexture_ != 0) rlSetTexture(lastBoundTexture_);
-            rlColor4ub(face.tint.r, face.tint.g, face.tint.b, face.tint.a);
-            rlNormal3f(face.normal.x, face.normal.y, face.normal.z);
-            // Quad vertices in counter-clockwise order (like Raylib examples)
-            for (size_t i = 0; i < 4; i++) {
-                const Vector2& uvSrc = getUV(i);
-                Vector2 uv = { uvSrc.x, 1.0f - uvSrc.y }; // Flip V globally
-                rlTexCoord2f(uv.x, uv.y);
-                rlVertex3f(face.vertices[i].x, face.vertices[i].y, face.vertices[i].z);
-            }
-        rlEnd();
-        trianglesRendered_ += 2;
-    } else if (vcount > 4) {
-        // Triangle fan for polygons with more than 4 vertices using rlgl
-        LOG_DEBUG("POLYGON RENDER: " + std::to_string(vcount) + " vertices as triangle fan with shader + normal + texture support");
+    } else {
+        // Ear-clipped rather than fanned: T-junction vertices sit on straight
+        // edges, and a fan from vertex 0 turns them into zero-area slivers
+        // that leave the crack open
+        faceCorners_.clear();
+        if (!WorldMesh::TriangulatePolygon(face.vertices, faceCorners_)) {
+            LOG_WARNING("RenderFace: Face with " + std::to_string(vcount) + " vertices has no area, skipping");
+            return;
+        }
+        LOG_DEBUG("POLYGON RENDER: " + std::to_string(vcount) + " vertices as " +
+                  std::to_string(faceCorners_.size() / 3) + " triangles with shader + normal + texture support");
         rlBegin(RL_TRIANGLES);
             // Set texture inside rlBegin() for proper binding
             if (lastBoundTexture_ != 0) rlSetTexture(lastBoundTexture_);
-            for (size_t i = 1; i + 1 < vcount; ++i) {
-                size_t idx0 = 0, idx1 = i, idx2 = i + 1;
-                rlColor4ub(face.tint.r, face.tint.g, face.tint.b, face.tint.a);
-                rlNormal3f(face.normal.x, face.normal.y, face.normal.z);
-                const Vector2& uv0 = getUV(idx0);
-                Vector2 uv0_flipped = { uv0.x, 1.0f - uv0.y };
-                rlTexCoord2f(uv0_flipped.x, uv0_flipped.y);
-                rlVertex3f(face.vertices[idx0].x, face.vertices[idx0].y, face.vertices[idx0].z);
-                
+            for (uint32_t corner : faceCorners_) {
                 rlColor4ub(face.tint.r, face.tint.g, face.tint.b, face.tint.a);
                 rlNormal3f(face.normal.x, face.normal.y, face.normal.z);
-                const Vector2& uv1 = getUV(idx1);
-                Vector2 uv1_flipped = { uv1.x, 1.0f - uv1.y };
-                rlTexCoord2f(uv1_flipped.x, uv1_flipped.y);
-                rlVertex3f(face.vertices[idx1].x, face.vertices[idx1].y, face.vertices[idx1].z);
-                
-                rlColor4ub(face.tint.r, face.tint.g, face.tint.b, face.tint.a);
-                rlNormal3f(face.normal.x, face.normal.y, face.normal.z);
-                const Vector2& uv2 = getUV(idx2);
-                Vector2 uv2_flipped = { uv2.x, 1.0f - uv2.y };
-                rlTexCoord2f(uv2_flipped.x, uv2_flipped.y);
-                rlVertex3f(face.vertices[idx2].x, face.vertices[idx2].y, face.vertices[idx2].z);
-                trianglesRendered_++;
+                const Vector2& uvSrc = getUV(corner);
+                Vector2 uv = { uvSrc.x, 1.0f - uvSrc.y }; // Flip V globally
+                rlTexCoord2f(uv.x, uv.y);
+                rlVertex3f(face.vertices[corner].x, face.vertices[corner].y, face.vertices[corner].z);
             }
         rlEnd();
+        trianglesRendered_ += static_cast<int>(faceCorners_.size() / 3);
     }
 }
 
@@ -833,7 +1211,10 @@ void Renderer::DrawMesh3D(const RenderCommand& command)
         EndShaderMode();
     } else {
         // Draw the cached model with default material shader
+        const Shader& modelShader = cachedModel.materials[0].shader;
+        bool probeLit = ApplyProbeLighting(modelShader, worldPos);
         DrawModelEx(cachedModel, worldPos, rotationAxis, rotationAngle, scale, WHITE);
+        if (probeLit) ClearProbeLighting(modelShader);
     }
 
     // Re-enable backface culling
@@ -1338,9 +1719,19 @@ bool Renderer::CastRay(const Vector3& origin, const Vector3& direction, float ma
 bool Renderer::CastRayWorld(const Vector3& origin, const Vector3& direction, float maxDistance,
                            Vector3& hitPoint, Vector3& hitNormal) const
 {
-    // TODO: Implement ray casting using the new World system
-    // For now, return false (no hit)
-    return false;
+    if (!worldGeometry_ || !worldGeometry_->GetWorld() || !bspTreeSystem_) return false;
+
+    // Picking hits whatever is drawn, collidable or not
+    Vector3 end = Vector3Add(origin, Vector3Scale(Vector3Normalize(direction), maxDistance));
+    BSPTraceResult trace;
+    if (!bspTreeSystem_->TraceLine(*worldGeometry_->GetWorld(), origin, end, trace,
+                                   FaceFlags::None, FaceFlags::NoDraw | FaceFlags::Invisible)) {
+        return false;
+    }
+
+    hitPoint = trace.point;
+    hitNormal = trace.normal;
+    return true;
 }
 
 bool Renderer::CastRayEntities(const Vector3& origin, const Vector3& direction, float maxDistance,
@@ -1398,6 +1789,16 @@ bool Renderer::CastRayEntities(const Vector3& origin, const Vector3& direction,
 }
 
 // Culling methods
+void Renderer::UpdateViewFrustum() {
+    UpdateScreenSize();
+    float aspect = screenHeight_ > 0 ? (float)screenWidth_ / (float)screenHeight_ : 1.0f;
+
+    // Culling far plane matches the entity far clip; with culling disabled use
+    // a far plane that never rejects anything inside the map
+    float farDistance = enableFrustumCulling_ ? farClipDistance_ : 1.0e6f;
+    viewFrustum_.Extract(camera_, aspect, 0.01f, farDistance);
+}
+
 bool Renderer::IsEntityVisible(const Vector3& position, float boundingRadius) const {
     cullingStats_.totalEntitiesChecked++;
 
@@ -1406,94 +1807,53 @@ bool Renderer::IsEntityVisible(const Vector3& position, float boundingRadius) co
         return true;
     }
 
-    // TEMPORARILY DISABLE FRUSTUM CULLING FOR DEBUGGING
-    cullingStats_.entitiesVisible++;
-    return true;
-
     // First do distance-based culling (cheapest check)
-    Vector3 cameraPos = GetCameraPosition();
-    float distance = Vector3Distance(cameraPos, position);
-
-    // Check far clip distance
-    if (distance > farClipDistance_ + boundingRadius) {
+    Vector3 toEntity = Vector3Subtract(position, camera_.position);
+    float maxDistance = farClipDistance_ + boundingRadius;
+    if (Vector3LengthSqr(toEntity) > maxDistance * maxDistance) {
         cullingStats_.entitiesCulledByDistance++;
-        LOG_DEBUG("Entity culled: distance (" + std::to_string(distance) + ") > far clip (" + std::to_string(farClipDistance_) + ")");
         return false;
     }
 
-    // Create bounding box for the entity
-    BoundingBox entityBounds = {
-        {position.x - boundingRadius, position.y - boundingRadius, position.z - boundingRadius},
-        {position.x + boundingRadius, position.y + boundingRadius, position.z + boundingRadius}
-    };
+    // Bounding sphere against the shared frame frustum
+    if (!viewFrustum_.IntersectsSphere(position, boundingRadius)) {
+        cullingStats_.entitiesCulledByFrustum++;
+        return false;
+    }
 
-    // Get camera frustum and test intersection
-    // Note: We need to calculate frustum planes manually since Raylib doesn't expose GetCameraFrustum()
-    Vector3 forward = Vector3Normalize(Vector3Subtract(camera_.target, camera_.position));
-    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera_.up));
-    Vector3 up = Vector3CrossProduct(right, forward);
+    // Entity passed all culling tests
+    cullingStats_.entitiesVisible++;
+    return true;
+}
 
-    float halfFovY = camera_.fovy * 0.5f * DEG2RAD;
-    float aspectRatio = (float)screenWidth_ / (float)screenHeight_;
-    float halfFovX = atanf(tanf(halfFovY) * aspectRatio);
+size_t Renderer::AreAABBsVisible(const AABB* boxes, size_t count, uint8_t* outVisible) const {
+    if (!enableFrustumCulling_) {
+        std::fill(outVisible, outVisible + count, static_cast<uint8_t>(1));
+        return count;
+    }
+    return viewFrustum_.CullAABBs(boxes, count, outVisible);
+}
 
-    // Calculate frustum corner directions
-    Vector3 nearCenter = Vector3Add(camera_.position, Vector3Scale(forward, 0.1f)); // Near plane at 0.1 units
-    Vector3 farCenter = Vector3Add(camera_.position, Vector3Scale(forward, farClipDistance_));
+void Renderer::UpdateOcclusion() {
+    if (!occlusionCullingEnabled_) return;
 
-    float nearHeight = 2.0f * tanf(halfFovY) * 0.1f;
-    float nearWidth = nearHeight * aspectRatio;
-    float farHeight = 2.0f * tanf(halfFovY) * farClipDistance_;
-    float farWidth = farHeight * aspectRatio;
+    float aspect = screenHeight_ > 0 ? (float)screenWidth_ / (float)screenHeight_ : 1.0f;
+    if (!occlusionBuffer_.BeginFrame(camera_, aspect)) return;
 
-    // Simple frustum-AABB intersection test using separating axis theorem
-    // Check if entity is completely outside any frustum plane
-    
-    // For performance, we'll use a simplified check:
-    // 1. Distance culling (already done above)
-    // 2. Check if entity is roughly within the view cone
-    
-    Vector3 toEntity = Vector3Subtract(position, camera_.position);
-    float entityDistance = Vector3Length(toEntity);
-    
-    if (entityDistance > 0.001f) { // Avoid division by zero
-        Vector3 toEntityNorm = Vector3Scale(toEntity, 1.0f / entityDistance);
-        
-        // Check if entity is roughly in front of camera
-        float dotForward = Vector3DotProduct(toEntityNorm, forward);
-        if (dotForward < -0.1f) { // Allow slight tolerance for entities just behind camera
-            cullingStats_.entitiesCulledByFrustum++;
-            LOG_DEBUG("Entity culled: behind camera (dot=" + std::to_string(dotForward) + ")");
-            return false;
-        }
-        
-        // Check horizontal field of view
-        float dotRight = Vector3DotProduct(toEntityNorm, right);
-        float horizontalAngle = acosf(fmaxf(-1.0f, fminf(1.0f, dotForward))); // Clamp to avoid NaN
-        float maxHorizontalAngle = halfFovX + atanf(boundingRadius / entityDistance);
-        
-        if (fabsf(dotRight) > sinf(maxHorizontalAngle)) {
-            cullingStats_.entitiesCulledByFrustum++;
-            LOG_DEBUG("Entity culled: outside horizontal FOV");
-            return false;
-        }
-        
-        // Check vertical field of view
-        float dotUp = Vector3DotProduct(toEntityNorm, up);
-        float maxVerticalAngle = halfFovY + atanf(boundingRadius / entityDistance);
-        
-        if (fabsf(dotUp) > sinf(maxVerticalAngle)) {
-            cullingStats_.entitiesCulledByFrustum++;
-            LOG_DEBUG("Entity culled: outside vertical FOV");
-            return false;
-        }
+    const World* world = worldGeometry_ ? worldGeometry_->GetWorld() : nullptr;
+    if (world && !world->occluders.empty()) {
+        occlusionBuffer_.RenderOccluders(*world, viewFrustum_);
     }
+}
 
-    // Entity passed all culling tests
-    cullingStats_.entitiesVisible++;
-    LOG_DEBUG("Entity visible: distance=" + std::to_string(distance) + ", position=(" +
-              std::to_string(position.x) + "," + std::to_string(position.y) + "," + std::to_string(position.z) + ")");
-    return true;
+size_t Renderer::CullOccludedAABBs(const AABB* boxes, size_t count, uint8_t* outVisible) {
+    size_t candidates = 0;
+    for (size_t i = 0; i < count; ++i) candidates += outVisible[i] ? 1 : 0;
+    if (!occlusionCullingEnabled_ || !occlusionBuffer_.IsActive()) return candidates;
+
+    size_t visible = occlusionBuffer_.CullAABBs(boxes, count, outVisible);
+    cullingStats_.entitiesCulledByOcclusion += static_cast<int>(candidates - visible);
+    return visible;
 }
 
 // Face visibility check for rendering - proper culling logic
@@ -1511,11 +1871,11 @@ bool Renderer::IsFaceVisibleForRendering(const Face& face, const Camera3D& camer
     // Frustum culling: check if face intersects view frustum
     // Use face center as primary test, with vertex checks as backup
     /*
-    if (!IsPointInViewFrustum(center, camera)) {
+    if (!IsPointInViewFrustum(center)) {
         // Check individual vertices - if any vertex is visible, face might be visible
         bool anyVertexVisible = false;
         for (const auto& vertex : face.vertices) {
-            if (IsPointInViewFrustum(vertex, camera)) {
+            if (IsPointInViewFrustum(vertex)) {
                 anyVertexVisible = true;
                 break;
             }
@@ -1550,184 +1910,62 @@ bool Renderer::IsFaceVisibleForRendering(const Face& face, const Camera3D& camer
 }
 
 // Check if a point is within the camera's view frustum
-bool Renderer::IsPointInViewFrustum(const Vector3& point, const Camera3D& camera) const {
-    // Compute camera forward
-    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
-    Vector3 toPoint = Vector3Normalize(Vector3Subtract(point, camera.position));
-
-    // Vertical FOV is camera.fovy (degrees). Convert to radians/half-angle.
-    float halfVertFovRad = camera.fovy * (PI / 180.0f) * 0.5f;
-
-    // Derive horizontal FOV from aspect ratio
-    int screenW = GetScreenWidth();
-    int screenH = GetScreenHeight();
-    float aspect = (screenH > 0) ? (float)screenW / (float)screenH : 1.0f;
-    float halfHorizFovRad = atanf(tanf(halfVertFovRad) * aspect);
-
-    // Build camera basis (right, up)
-    Vector3 up = camera.up;
-    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, up));
-    up = Vector3Normalize(Vector3CrossProduct(right, forward));
-
-    // Project toPoint onto basis to get angles
-    float forwardDot = Vector3DotProduct(forward, toPoint);
-    float rightDot = Vector3DotProduct(right, toPoint);
-    float upDot = Vector3DotProduct(up, toPoint);
-
-    // Reject points behind the camera
-    if (forwardDot <= 0.0f) return false;
-
-    // Compute angles via atan2 of lateral vs forward components
-    float horizAngle = fabsf(atan2f(rightDot, forwardDot));
-    float vertAngle = fabsf(atan2f(upDot, forwardDot));
-
-    return (horizAngle <= halfHorizFovRad) && (vertAngle <= halfVertFovRad);
+bool Renderer::IsPointInViewFrustum(const Vector3& point) const {
+    return viewFrustum_.ContainsPoint(point);
 }
 
 // Check if an AABB intersects the camera's view frustum
-bool Renderer::IsAABBInViewFrustum(const AABB& box, const Camera3D& camera) const {
-    // Check all 8 corners of the AABB against the view frustum
-    Vector3 corners[8] = {
-        {box.min.x, box.min.y, box.min.z},
-        {box.max.x, box.min.y, box.min.z},
-        {box.min.x, box.max.y, box.min.z},
-        {box.max.x, box.max.y, box.min.z},
-        {box.min.x, box.min.y, box.max.z},
-        {box.max.x, box.min.y, box.max.z},
-        {box.min.x, box.max.y, box.max.z},
-        {box.max.x, box.max.y, box.max.z}
-    };
-
-    // If any corner is inside the frustum, the AABB intersects
-    for (const auto& corner : corners) {
-        if (IsPointInViewFrustum(corner, camera)) {
-            return true;
-        }
-    }
-
-    // Check if camera is inside the AABB
-    Vector3 cameraPos = camera.position;
-    if (cameraPos.x >= box.min.x && cameraPos.x <= box.max.x &&
-        cameraPos.y >= box.min.y && cameraPos.y <= box.max.y &&
-        cameraPos.z >= box.min.z && cameraPos.z <= box.max.z) {
-        return true;
-    }
-
-    // AABB is outside the frustum
-    return false;
+bool Renderer::IsAABBInViewFrustum(const AABB& box) const {
+    return viewFrustum_.IntersectsAABB(box);
 }
 
 // === PVS Debug Visualization Methods ===
 
 void Renderer::DebugDrawClusters(bool showAllClusters, bool showVisibilityLines) const {
-    // TODO: Implement cluster debug drawing for new World system
-    // For now, draw leaf nodes as clusters since we simplified the clustering
     if (!worldGeometry_ || !worldGeometry_->GetWorld()) return;
 
     const World* world = worldGeometry_->GetWorld();
 
-    // Draw all leaf nodes (each leaf is currently a cluster)
-    std::function<void(const BSPNode*)> drawNode = [&](const BSPNode* node) {
-        if (!node) return;
-
-        if (node->IsLeaf() && !node->surfaceIndices.empty()) {
-            // Choose color based on cluster ID (using node address as hash for now)
-            uintptr_t addr = reinterpret_cast<uintptr_t>(node);
-            Color clusterColor = {
-                static_cast<unsigned char>((addr * 37) % 255),
-                static_cast<unsigned char>((addr * 71) % 255),
-                static_cast<unsigned char>((addr * 113) % 255),
-                100
-            };
-
-            // Draw leaf bounds
-            Vector3 size = {
-                node->maxs.x - node->mins.x,
-                node->maxs.y - node->mins.y,
-                node->maxs.z - node->mins.z
-            };
-            Vector3 center = {
-                (node->mins.x + node->maxs.x) * 0.5f,
-                (node->mins.y + node->maxs.y) * 0.5f,
-                (node->mins.z + node->maxs.z) * 0.5f
-            };
-
-            DrawCubeWires(center, size.x, size.y, size.z, clusterColor);
-        }
+    for (const BSPCluster& cluster : world->clusters) {
+        if (cluster.surfaces.empty()) continue;
 
-        // Recurse to children
-        if (!node->IsLeaf()) {
-            drawNode(node->children[0]);
-            drawNode(node->children[1]);
-        }
-    };
+        // Choose color based on cluster id
+        Color clusterColor = {
+            static_cast<unsigned char>((cluster.id * 37) % 255),
+            static_cast<unsigned char>((cluster.id * 71) % 255),
+            static_cast<unsigned char>((cluster.id * 113) % 255),
+            100
+        };
 
-    drawNode(world->root);
+        Vector3 size = cluster.bounds.GetSize();
+        DrawCubeWires(cluster.bounds.GetCenter(), size.x, size.y, size.z, clusterColor);
+    }
 }
 
 void Renderer::DebugDrawClusterPVS(int32_t clusterId) const {
-    // Implement cluster PVS debug drawing for new World system
     if (!worldGeometry_ || !worldGeometry_->GetWorld()) return;
 
     const World* world = worldGeometry_->GetWorld();
-
-    // For now, since we simplified clustering, clusterId corresponds to leaf index
-    // Find the Nth leaf in the tree
-    std::vector<const BSPNode*> leaves;
-    std::function<void(const BSPNode*)> collectLeaves = [&](const BSPNode* node) {
-        if (!node) return;
-        if (node->IsLeaf()) {
-            leaves.push_back(node);
-        } else {
-            collectLeaves(node->children[0]);
-            collectLeaves(node->children[1]);
-        }
-    };
-    collectLeaves(world->root);
-
-    if (clusterId < 0 || clusterId >= static_cast<int32_t>(leaves.size())) {
+    if (clusterId < 0 || clusterId >= world->numClusters) {
         return;
     }
 
-    const BSPNode* selectedLeaf = leaves[clusterId];
-
-    // Highlight selected cluster/leaf in red
-    Vector3 size = {
-        selectedLeaf->maxs.x - selectedLeaf->mins.x,
-        selectedLeaf->maxs.y - selectedLeaf->mins.y,
-        selectedLeaf->maxs.z - selectedLeaf->mins.z
-    };
-    Vector3 center = {
-        (selectedLeaf->mins.x + selectedLeaf->maxs.x) * 0.5f,
-        (selectedLeaf->mins.y + selectedLeaf->maxs.y) * 0.5f,
-        (selectedLeaf->mins.z + selectedLeaf->maxs.z) * 0.5f
-    };
-
+    // Highlight selected cluster in red
+    const BSPCluster& selected = world->clusters[clusterId];
+    Vector3 center = selected.bounds.GetCenter();
+    Vector3 size = selected.bounds.GetSize();
     DrawCubeWires(center, size.x, size.y, size.z, RED);
 
-    // Since we currently make all clusters visible to all others (no PVS culling),
-    // highlight all other leaves in green
-    for (size_t i = 0; i < leaves.size(); ++i) {
-        if (static_cast<int32_t>(i) != clusterId) {
-            const BSPNode* leaf = leaves[i];
-
-            Vector3 leafSize = {
-                leaf->maxs.x - leaf->mins.x,
-                leaf->maxs.y - leaf->mins.y,
-                leaf->maxs.z - leaf->mins.z
-            };
-            Vector3 leafCenter = {
-                (leaf->mins.x + leaf->maxs.x) * 0.5f,
-                (leaf->mins.y + leaf->maxs.y) * 0.5f,
-                (leaf->mins.z + leaf->maxs.z) * 0.5f
-            };
-
-            // Draw connection line
-            DrawLine3D(center, leafCenter, YELLOW);
-
-            // Highlight visible leaf bounds
-            DrawCubeWires(leafCenter, leafSize.x, leafSize.y, leafSize.z, GREEN);
-        }
+    // Clusters in its PVS row in green, with a line to each
+    const uint8_t* row = &world->visData[clusterId * world->clusterBytes];
+    for (const BSPCluster& cluster : world->clusters) {
+        if (cluster.id == clusterId || cluster.surfaces.empty()) continue;
+        if (!(row[cluster.id >> 3] & (1 << (cluster.id & 7)))) continue;
+
+        Vector3 otherCenter = cluster.bounds.GetCenter();
+        Vector3 otherSize = cluster.bounds.GetSize();
+        DrawLine3D(center, otherCenter, YELLOW);
+        DrawCubeWires(otherCenter, otherSize.x, otherSize.y, otherSize.z, GREEN);
     }
 }
 
@@ -1736,33 +1974,13 @@ void Renderer::DebugDrawAllClusterBounds() const {
 
     const World* world = worldGeometry_->GetWorld();
 
-    // Draw all leaf bounds in white (each leaf is currently a cluster)
-    std::function<void(const BSPNode*)> drawAllLeaves = [&](const BSPNode* node) {
-        if (!node) return;
-
-        if (node->IsLeaf() && !node->surfaceIndices.empty()) {
-            Vector3 size = {
-                node->maxs.x - node->mins.x,
-                node->maxs.y - node->mins.y,
-                node->maxs.z - node->mins.z
-            };
-            Vector3 center = {
-                (node->mins.x + node->maxs.x) * 0.5f,
-                (node->mins.y + node->maxs.y) * 0.5f,
-                (node->mins.z + node->maxs.z) * 0.5f
-            };
-
-            DrawCubeWires(center, size.x, size.y, size.z, WHITE);
-        }
+    // Draw all cluster bounds in white
+    for (const BSPCluster& cluster : world->clusters) {
+        if (cluster.surfaces.empty()) continue;
 
-        // Recurse to children
-        if (!node->IsLeaf()) {
-            drawAllLeaves(node->children[0]);
-            drawAllLeaves(node->children[1]);
-        }
-    };
-
-    drawAllLeaves(world->root);
+        Vector3 size = cluster.bounds.GetSize();
+        DrawCubeWires(cluster.bounds.GetCenter(), size.x, size.y, size.z, WHITE);
+    }
 }
 
 // Shader management for BSP geometry
@@ -9,6 +9,7 @@
 #include "../world/WorldGeometry.h" // For World struct
 #include "../world/BSPTreeSystem.h"
 #include "../math/AABB.h"
+#include "../math/Frustum.h"
 #include "../ecs/Components/Collidable.h"
 #include "../ecs/Components/MeshComponent.h"
 #include "../ecs/Components/TransformComponent.h"
@@ -16,6 +17,7 @@
 #include "../ecs/Systems/AssetSystem.h"
 #include "../core/Engine.h"
 #include "Skybox.h"
+#include "OcclusionBuffer.h"
 #include "../ecs/Systems/CacheSystem.h"
 
 class Entity;
@@ -203,26 +205,55 @@ public:
     void ClearCurrentShader();
 
     // Culling methods
+    // The view frustum is extracted once per frame from the current camera and
+    // shared by entity culling and the BSP traversal
+    void UpdateViewFrustum();
+    const Frustum& GetViewFrustum() const { return viewFrustum_; }
     bool IsEntityVisible(const Vector3& position, float boundingRadius = 1.0f) const;
+    // Batch variant for many bounds at once (SIMD); returns the visible count
+    size_t AreAABBsVisible(const AABB* boxes, size_t count, uint8_t* outVisible) const;
     void SetFrustumCullingEnabled(bool enabled) { enableFrustumCulling_ = enabled; }
     bool IsFrustumCullingEnabled() const { return enableFrustumCulling_; }
     void SetFarClipDistance(float distance) { farClipDistance_ = distance; }
     float GetFarClipDistance() const { return farClipDistance_; }
+
+    // Software occlusion culling: after UpdateViewFrustum, rasterize the world's
+    // occluder surfaces on the CPU, then test entity bounds that passed the
+    // frustum against them (clears outVisible for hidden ones)
+    void UpdateOcclusion();
+    size_t CullOccludedAABBs(const AABB* boxes, size_t count, uint8_t* outVisible);
+    void SetOcclusionCullingEnabled(bool enabled) { occlusionCullingEnabled_ = enabled; }
+    bool IsOcclusionCullingEnabled() const { return occlusionCullingEnabled_; }
+    const OcclusionBuffer& GetOcclusionBuffer() const { return occlusionBuffer_; }
+
+    // Baked lightmaps: world faces with a lightmapIndex skip the runtime lighting
+    // shader and are modulated by their atlas page instead (one bind per page)
+    void SetLightmapsEnabled(bool enabled) { lightmapsEnabled_ = enabled; }
+    bool IsLightmapsEnabled() const { return lightmapsEnabled_; }
+    size_t GetLightmapPageCount() const { return lightmapTextures_.size(); }
+
+    // Baked irradiance probes: lit meshes get the world's indirect light at
+    // their position through the lighting shader's probeSH uniform
+    void SetProbeLightingEnabled(bool enabled) { probeLightingEnabled_ = enabled; }
+    bool IsProbeLightingEnabled() const { return probeLightingEnabled_; }
     
     // Culling statistics
     struct CullingStats {
         int totalEntitiesChecked = 0;
         int entitiesCulledByDistance = 0;
         int entitiesCulledByFrustum = 0;
+        int entitiesCulledByOcclusion = 0;
         int entitiesVisible = 0;
         
         void Reset() {
-            totalEntitiesChecked = entitiesCulledByDistance = entitiesCulledByFrustum = entitiesVisible = 0;
+            totalEntitiesChecked = entitiesCulledByDistance = entitiesCulledByFrustum = 0;
+            entitiesCulledByOcclusion = entitiesVisible = 0;
         }
         
         float GetCullRate() const {
             return totalEntitiesChecked > 0 ? 
-                (float)(entitiesCulledByDistance + entitiesCulledByFrustum) / totalEntitiesChecked : 0.0f;
+                (float)(entitiesCulledByDistance + entitiesCulledByFrustum + entitiesCulledByOcclusion) /
+                    totalEntitiesChecked : 0.0f;
         }
     };
     
@@ -230,14 +261,47 @@ public:
     void ResetCullingStats() { cullingStats_.Reset(); }
 
 private:
+    // A static batch on the GPU, split into chunks 16-bit indices can address
+    // (rlgl draws elements as unsigned short)
+    struct WorldBatchChunk {
+        unsigned int vao = 0;          // positions, uvs, normals, colors
+        unsigned int lightmapVao = 0;  // positions, lightmap uvs (lightmapped batches only)
+        unsigned int positionVbo = 0, uvVbo = 0, stretchUVVbo = 0, normalVbo = 0, colorVbo = 0, lightmapUVVbo = 0;
+        unsigned int ebo = 0;
+        std::vector<WorldGeometry::BatchRange> clusterRanges;  // The batch's ranges, in chunk indices
+    };
+    struct WorldBatchBuffers {
+        int materialId = 0;
+        int lightmapPage = -1;
+        std::vector<WorldBatchChunk> chunks;
+    };
+
     // World rendering helper methods
     void RenderBSPGeometry();
     void RenderSkybox();
     void SetupMaterial(const MaterialComponent& material);
     void RenderFace(const Face& face);
+    void RenderMaterialGroups(const std::unordered_map<unsigned int, std::vector<const Face*>>& groups);
+    void SetupWorldMaterial(unsigned int materialId);
+    void RenderLightmapPass();
+    // Static batches: visible cluster ranges of each batch as indexed draws
+    void RenderWorldBatches(const World& world);
+    void BeginWorldBatchShader(const Shader* shader);
+    void EndWorldBatchShader();
+    void DrawWorldBatchChunk(const WorldBatchChunk& chunk, unsigned int vao, unsigned int textureId);
+    // Upload the static batches when the loaded world changes
+    bool UpdateWorldBatchBuffers(const std::vector<WorldGeometry::StaticBatch>& batches);
+    void UnloadWorldBatchBuffers();
+    void BindWorldBatchUVs(bool stretch);
+    // Upload the world's atlas pages when the loaded world changes
+    bool UpdateLightmapTextures(const World& world);
+    void UnloadLightmapTextures();
+    // Set / zero probeSH on a mesh shader around its draw
+    bool ApplyProbeLighting(const Shader& shader, const Vector3& position);
+    void ClearProbeLighting(const Shader& shader);
     bool IsFaceVisibleForRendering(const Face& face, const Camera3D& camera) const;
-    bool IsPointInViewFrustum(const Vector3& point, const Camera3D& camera) const;
-    bool IsAABBInViewFrustum(const AABB& box, const Camera3D& camera) const;
+    bool IsPointInViewFrustum(const Vector3& point) const;
+    bool IsAABBInViewFrustum(const AABB& box) const;
     
     // PVS Debug rendering
     void RenderPVSDebug();
@@ -272,6 +336,11 @@ private:
     // Pre-allocated containers to avoid per-frame allocations (major performance optimization)
     std::vector<const Face*> visibleFaces_;
     std::unordered_map<unsigned int, std::vector<const Face*>> facesByMaterial_;
+    std::unordered_map<unsigned int, std::vector<const Face*>> lightmappedFacesByMaterial_;
+    std::vector<std::vector<const Face*>> facesByLightmap_;  // Indexed by atlas page
+    std::vector<uint32_t> faceCorners_;  // Triangulated corners of the face being drawn
+    std::vector<uint8_t> visibleClusters_;
+    std::vector<WorldGeometry::BatchRange> visibleRanges_;
 
     // Optimized mesh rendering buffers (ECS-friendly)
     std::vector<float> vertexBuffer_;
@@ -314,7 +383,27 @@ private:
     // Culling settings
     bool enableFrustumCulling_;
     float farClipDistance_;
+    Frustum viewFrustum_;
     mutable CullingStats cullingStats_;
+    OcclusionBuffer occlusionBuffer_;
+    bool occlusionCullingEnabled_ = true;
+
+    // Lightmap atlas pages of the world they were uploaded from
+    std::vector<Texture2D> lightmapTextures_;
+    const Color* lightmapSource_ = nullptr;
+    size_t lightmapSourceTexels_ = 0;
+    bool lightmapsEnabled_ = true;
+
+    // Static batches of the world they were uploaded from
+    std::vector<WorldBatchBuffers> worldBatchBuffers_;
+    const WorldGeometry::StaticBatch* worldBatchSource_ = nullptr;
+    size_t worldBatchSourceCount_ = 0;
+    bool worldBatchStretchUVs_ = true;  // uv stream the batch VAOs read
+
+    // probeSH location, cached per shader
+    unsigned int probeShaderId_ = 0;
+    int probeSHLoc_ = -1;
+    bool probeLightingEnabled_ = true;
     
     // PVS Debug visualization
     bool showPVSDebug_ = false;
@@ -31,6 +31,9 @@ struct Light {
 // Input lighting values
 uniform Light lights[MAX_LIGHTS];
 uniform vec4 ambient;
+// Baked irradiance probe for the current mesh, cosine-convolved L1 SH
+// (constant, x, y, z); all zero for world faces
+uniform vec3 probeSH[4];
 uniform vec3 viewPos;
 uniform int activeLightCount;
 
@@ -99,6 +102,10 @@ void main()
     // Lower ambient floor to allow more light variation
     finalColor = max(finalColor, texelColor * (ambient/15.0) * tint);
 
+    // Indirect light from the baked probes
+    vec3 probeLight = max(probeSH[0] + probeSH[1]*normal.x + probeSH[2]*normal.y + probeSH[3]*normal.z, vec3(0.0));
+    finalColor.rgb += texelColor.rgb*tint.rgb*probeLight;
+
     // Gamma correction
     finalColor = pow(finalColor, vec4(1.0/2.2));
 }
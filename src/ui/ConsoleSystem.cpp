@@ -1,4 +1,9 @@
 #include "ConsoleSystem.h"
+#include "../core/Engine.h"
+#include "../ecs/Systems/WorldSystem.h"
+#include "../ecs/Systems/RenderSystem.h"
+#include "../world/BSPTreeSystem.h"
+#include "../physics/PhysicsSystem.h"
 #include <algorithm>
 #include <sstream>
 #include <iostream>
@@ -282,6 +287,283 @@ void ConsoleSystem::InitializeBuiltInCommands() {
                    "Toggle collision detection for player (1/0)");
     RegisterCommand("render_bounds", [this](const std::vector<std::string>& args) { CmdRenderBounds(args); },
                    "Toggle visualization of collision bounds (1/0)");
+    RegisterCommand("bsp_compare", [this](const std::vector<std::string>& args) { CmdBSPCompare(args); },
+                   "Rebuild the world BSP with each splitter heuristic and report depth/nodes/fragments");
+    RegisterCommand("areaportal", [this](const std::vector<std::string>& args) { CmdAreaPortal(args); },
+                   "List area portals, or open/close one: areaportal <name|index> <open|close>");
+    RegisterCommand("r_occlusion", [this](const std::vector<std::string>& args) { CmdOcclusion(args); },
+                   "Toggle CPU occlusion culling of entities (1/0), or show last frame's stats");
+    RegisterCommand("r_lightmaps", [this](const std::vector<std::string>& args) { CmdLightmaps(args); },
+                   "Toggle baked lightmaps on world surfaces (1/0); off uses the runtime lighting shader");
+    RegisterCommand("r_probes", [this](const std::vector<std::string>& args) { CmdProbes(args); },
+                   "Toggle baked irradiance probe lighting on entities (1/0), or show the probe grid");
+    RegisterCommand("phys_satbench", [this](const std::vector<std::string>& args) { CmdSATBench(args); },
+                   "Time the scalar vs SIMD box/triangle test against the world triangles: phys_satbench [boxes]");
+    RegisterCommand("phys_deterministic", [this](const std::vector<std::string>& args) { CmdDeterministic(args); },
+                   "Toggle fixed-tick deterministic physics (1/0) at an optional rate: phys_deterministic [1/0] [hz]");
+    RegisterCommand("phys_replaycheck", [this](const std::vector<std::string>& args) { CmdReplayCheck(args); },
+                   "Run the same physics ticks from a snapshot at two frame rates and compare per-tick checksums: phys_replaycheck [ticks]");
+    RegisterCommand("phys_sleep", [this](const std::vector<std::string>& args) { CmdSleep(args); },
+                   "Toggle sleeping of bodies at rest (1/0), or show last tick's awake/asleep counts");
+}
+
+void ConsoleSystem::CmdBSPCompare(const std::vector<std::string>& args) {
+    auto* bspTreeSystem = engine_.GetSystem<BSPTreeSystem>();
+    auto* worldSystem = engine_.GetSystem<WorldSystem>();
+    if (!bspTreeSystem || !worldSystem || !worldSystem->GetWorldGeometry()) {
+        LogError("No world loaded");
+        return;
+    }
+
+    if (worldSystem->GetWorldGeometry()->faces.empty()) {
+        LogError("No source faces in memory (world was loaded from the compiled world cache)");
+        return;
+    }
+
+    auto results = bspTreeSystem->CompareSplitterModes(worldSystem->GetWorldGeometry()->faces);
+    for (const auto& result : results) {
+        const BSPBuildStats& stats = result.second;
+        LogInfo(std::string(BSPTreeSystem::GetSplitterModeName(result.first)) + ": depth " +
+                std::to_string(stats.maxDepth) + ", nodes " + std::to_string(stats.nodeCount) +
+                ", fragments " + std::to_string(stats.fragmentCount) +
+                ", splits " + std::to_string(stats.splitCount) +
+                ", " + std::to_string(static_cast<int>(stats.buildMs)) + " ms");
+    }
+}
+
+void ConsoleSystem::CmdAreaPortal(const std::vector<std::string>& args) {
+    auto* bspTreeSystem = engine_.GetSystem<BSPTreeSystem>();
+    auto* worldSystem = engine_.GetSystem<WorldSystem>();
+    World* world = worldSystem && worldSystem->GetWorldGeometry() ? worldSystem->GetWorldGeometry()->GetWorld() : nullptr;
+    if (!bspTreeSystem || !world) {
+        LogError("No world loaded");
+        return;
+    }
+
+    if (args.empty()) {
+        LogInfo(std::to_string(world->areas.size()) + " areas, " + std::to_string(world->areaPortals.size()) + " area portals");
+        for (size_t i = 0; i < world->areaPortals.size(); ++i) {
+            const BSPAreaPortal& portal = world->areaPortals[i];
+            std::string areas;
+            for (int32_t area : portal.areas) areas += " " + std::to_string(area);
+            LogInfo("  " + std::to_string(i) + " '" + portal.name + "' " + (portal.open ? "open" : "closed") +
+                    ", areas:" + areas);
+        }
+        return;
+    }
+
+    int32_t portal = bspTreeSystem->FindAreaPortal(*world, args[0]);
+    if (portal < 0 && !args[0].empty() && std::all_of(args[0].begin(), args[0].end(), ::isdigit)) {
+        portal = std::stoi(args[0]);
+    }
+
+    if (portal < 0 || portal >= static_cast<int32_t>(world->areaPortals.size())) {
+        LogError("Unknown area portal: " + args[0]);
+        return;
+    }
+
+    // Toggle unless a state is given
+    bool open = !world->areaPortals[portal].open;
+    if (args.size() > 1) {
+        open = args[1] == "open" || args[1] == "1";
+    }
+
+    bspTreeSystem->SetAreaPortalOpen(*world, portal, open);
+    LogInfo("Area portal '" + world->areaPortals[portal].name + "' " + (open ? "opened" : "closed"));
+}
+
+void ConsoleSystem::CmdOcclusion(const std::vector<std::string>& args) {
+    auto* renderSystem = engine_.GetSystem<RenderSystem>();
+    if (!renderSystem) {
+        LogError("No render system available");
+        return;
+    }
+    Renderer* renderer = renderSystem->GetRenderer();
+
+    if (!args.empty()) {
+        bool enabled = args[0] == "1" || args[0] == "true" || args[0] == "on";
+        renderer->SetOcclusionCullingEnabled(enabled);
+        LogInfo("Occlusion culling " + std::string(enabled ? "enabled" : "disabled"));
+        return;
+    }
+
+    const OcclusionBuffer& buffer = renderer->GetOcclusionBuffer();
+    const OcclusionBuffer::Stats& stats = buffer.GetStats();
+    LogInfo("Occlusion culling " + std::string(renderer->IsOcclusionCullingEnabled() ? "enabled" : "disabled") +
+            ", " + std::to_string(buffer.GetWidth()) + "x" + std::to_string(buffer.GetHeight()) + " buffer");
+    LogInfo("  " + std::to_string(stats.occluders) + " occluders, " + std::to_string(stats.triangles) +
+            " triangles, " + std::to_string(stats.rasterMs) + " ms");
+    LogInfo("  " + std::to_string(stats.occluded) + " of " + std::to_string(stats.tested) + " entities occluded");
+}
+
+void ConsoleSystem::CmdLightmaps(const std::vector<std::string>& args) {
+    auto* renderSystem = engine_.GetSystem<RenderSystem>();
+    if (!renderSystem) {
+        LogError("No render system available");
+        return;
+    }
+    Renderer* renderer = renderSystem->GetRenderer();
+
+    if (!args.empty()) {
+        bool enabled = args[0] == "1" || args[0] == "true" || args[0] == "on";
+        renderer->SetLightmapsEnabled(enabled);
+        LogInfo("Lightmaps " + std::string(enabled ? "enabled" : "disabled"));
+        return;
+    }
+
+    LogInfo("Lightmaps " + std::string(renderer->IsLightmapsEnabled() ? "enabled" : "disabled") + ", " +
+            std::to_string(renderer->GetLightmapPageCount()) + " atlas pages loaded");
+}
+
+void ConsoleSystem::CmdProbes(const std::vector<std::string>& args) {
+    auto* renderSystem = engine_.GetSystem<RenderSystem>();
+    if (!renderSystem) {
+        LogError("No render system available");
+        return;
+    }
+    Renderer* renderer = renderSystem->GetRenderer();
+
+    if (!args.empty()) {
+        bool enabled = args[0] == "1" || args[0] == "true" || args[0] == "on";
+        renderer->SetProbeLightingEnabled(enabled);
+        LogInfo("Probe lighting " + std::string(enabled ? "enabled" : "disabled"));
+        return;
+    }
+
+    auto* worldSystem = engine_.GetSystem<WorldSystem>();
+    const World* world = worldSystem && worldSystem->GetWorldGeometry() ? worldSystem->GetWorldGeometry()->GetWorld() : nullptr;
+    if (!world || world->probes.empty()) {
+        LogInfo("Probe lighting " + std::string(renderer->IsProbeLightingEnabled() ? "enabled" : "disabled") +
+                ", no baked probes (run paintsplash_mapc)");
+        return;
+    }
+    const BSPProbeGrid& grid = world->probeGrid;
+    LogInfo("Probe lighting " + std::string(renderer->IsProbeLightingEnabled() ? "enabled" : "disabled") + ", " +
+            std::to_string(grid.countX) + "x" + std::to_string(grid.countY) + "x" + std::to_string(grid.countZ) +
+            " probes at " + std::to_string(grid.spacing) + " units");
+}
+
+void ConsoleSystem::CmdSATBench(const std::vector<std::string>& args) {
+    auto* collisionSys = engine_.GetSystem<CollisionSystem>();
+    if (!collisionSys || collisionSys->GetWorldBVH().IsEmpty()) {
+        LogError("No world collision triangles loaded");
+        return;
+    }
+
+    size_t boxes = 1000;
+    if (!args.empty() && !args[0].empty() && std::all_of(args[0].begin(), args[0].end(), ::isdigit)) {
+        boxes = std::max<size_t>(1, std::stoul(args[0]));
+    }
+
+    // Player-sized boxes
+    const TriangleSoA& triangles = collisionSys->GetWorldBVH().GetTriangleSoA();
+    TriangleSAT::BenchmarkResult result = TriangleSAT::Benchmark(triangles, boxes, {0.4f, 0.9f, 0.4f});
+    LogInfo(std::to_string(result.boxes) + " boxes x " + std::to_string(triangles.Size()) + " triangles, " +
+            std::to_string(TriangleSAT::LANES) + " lanes");
+    LogInfo("  scalar " + std::to_string(result.scalarNsPerTest) + " ns/test, SIMD " +
+            std::to_string(result.simdNsPerTest) + " ns/test");
+    LogInfo("  " + std::to_string(result.hits) + " of " + std::to_string(result.tests) + " overlap, " +
+            std::to_string(result.mismatches) + " mismatches");
+}
+
+void ConsoleSystem::CmdDeterministic(const std::vector<std::string>& args) {
+    auto* physics = engine_.GetSystem<PhysicsSystem>();
+    if (!physics) {
+        LogError("No physics system available");
+        return;
+    }
+
+    bool enabled = !physics->IsDeterministic(); // Toggle by default
+    if (!args.empty()) {
+        if (args[0] == "1" || args[0] == "true" || args[0] == "on") {
+            enabled = true;
+        } else if (args[0] == "0" || args[0] == "false" || args[0] == "off") {
+            enabled = false;
+        }
+    }
+    float tickRate = 1.0f / physics->GetFixedDeltaTime();
+    if (args.size() > 1) {
+        try {
+            tickRate = std::stof(args[1]);
+        } catch (const std::exception&) {
+            LogError("Invalid tick rate: " + args[1]);
+            return;
+        }
+    }
+
+    physics->SetDeterministic(enabled, tickRate);
+    LogInfo("Deterministic physics " + std::string(enabled ? "enabled" : "disabled") + " (" +
+            std::to_string(1.0f / physics->GetFixedDeltaTime()) + " Hz, tick " + std::to_string(physics->GetTick()) + ")");
+}
+
+void ConsoleSystem::CmdReplayCheck(const std::vector<std::string>& args) {
+    auto* physics = engine_.GetSystem<PhysicsSystem>();
+    if (!physics || !physics->IsEnabled()) {
+        LogError("No physics system available");
+        return;
+    }
+
+    size_t ticks = 120;
+    if (!args.empty() && !args[0].empty() && std::all_of(args[0].begin(), args[0].end(), ::isdigit)) {
+        ticks = std::max<size_t>(1, std::stoul(args[0]));
+    }
+
+    // Ticks go through Update, the path the game runs; it only ticks at a
+    // fixed rate in deterministic mode
+    const bool wasDeterministic = physics->IsDeterministic();
+    if (!wasDeterministic) physics->SetDeterministic(true, 1.0f / physics->GetFixedDeltaTime());
+    const float tickTime = physics->GetFixedDeltaTime();
+
+    // Same start state, same (absent) input, once at one frame per tick and
+    // once at two frames per tick; the game resumes from the snapshot
+    // afterwards
+    PhysicsSystem::Snapshot start;
+    physics->SaveState(start);
+    const float frameTimes[2] = {tickTime, tickTime * 0.5f};
+    std::vector<uint64_t> runs[2];
+    for (int run = 0; run < 2; ++run) {
+        std::vector<uint64_t>& checksums = runs[run];
+        physics->RestoreState(start);
+        checksums.reserve(ticks);
+        while (checksums.size() < ticks) {
+            uint64_t tickBefore = physics->GetTick();
+            physics->Update(frameTimes[run]);
+            if (physics->GetTick() != tickBefore) checksums.push_back(physics->ComputeStateChecksum());
+        }
+    }
+    physics->RestoreState(start);
+    if (!wasDeterministic) physics->SetDeterministic(false, 1.0f / tickTime);
+
+    auto mismatch = std::mismatch(runs[0].begin(), runs[0].end(), runs[1].begin());
+    if (mismatch.first == runs[0].end()) {
+        std::ostringstream hash;
+        hash << std::hex << runs[0].back();
+        LogInfo(std::to_string(ticks) + " ticks x " + std::to_string(start.bodies.size()) +
+                " bodies replayed identically at both frame rates, final checksum " + hash.str());
+    } else {
+        LogError("Replay diverged at tick " + std::to_string(mismatch.first - runs[0].begin() + 1) + " of " +
+                 std::to_string(ticks));
+    }
+}
+
+void ConsoleSystem::CmdSleep(const std::vector<std::string>& args) {
+    auto* physics = engine_.GetSystem<PhysicsSystem>();
+    if (!physics) {
+        LogError("No physics system available");
+        return;
+    }
+
+    if (!args.empty()) {
+        bool enabled = args[0] == "1" || args[0] == "true" || args[0] == "on";
+        physics->SetSleepEnabled(enabled);
+        LogInfo("Body sleeping " + std::string(enabled ? "enabled" : "disabled"));
+        return;
+    }
+
+    const PhysicsSystem::SleepStats& stats = physics->GetSleepStats();
+    LogInfo("Body sleeping " + std::string(physics->IsSleepEnabled() ? "enabled" : "disabled") + ", " +
+            std::to_string(stats.awake) + " awake, " + std::to_string(stats.asleep) + " asleep");
+    LogInfo("  last tick: " + std::to_string(stats.fellAsleep) + " fell asleep, " + std::to_string(stats.woke) + " woke");
 }
 
 void ConsoleSystem::CmdNoClip(const std::vector<std::string>& args) {
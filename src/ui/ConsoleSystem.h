@@ -123,6 +123,15 @@ private:
     void CmdList(const std::vector<std::string>& args);
     void CmdNoClip(const std::vector<std::string>& args);
     void CmdRenderBounds(const std::vector<std::string>& args);
+    void CmdBSPCompare(const std::vector<std::string>& args);
+    void CmdAreaPortal(const std::vector<std::string>& args);
+    void CmdOcclusion(const std::vector<std::string>& args);
+    void CmdLightmaps(const std::vector<std::string>& args);
+    void CmdProbes(const std::vector<std::string>& args);
+    void CmdSATBench(const std::vector<std::string>& args);
+    void CmdDeterministic(const std::vector<std::string>& args);
+    void CmdReplayCheck(const std::vector<std::string>& args);
+    void CmdSleep(const std::vector<std::string>& args);
 
     // Utility
     std::string GetTimestampString() const;
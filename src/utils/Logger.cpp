@@ -4,6 +4,7 @@
 std::ofstream Logger::logFile_;
 LogLevel Logger::currentLevel_ = LogLevel::INFO;
 bool Logger::initialized_ = false;
+std::mutex Logger::mutex_;
 
 void Logger::Init(const std::string& logFile)
 {
@@ -72,6 +73,7 @@ void Logger::Log(LogLevel level, const std::string& message, const char* file, i
 
     std::string finalMessage = logMessage.str();
 
+    std::lock_guard<std::mutex> lock(mutex_);
     WriteToFile(finalMessage);
     WriteToConsole(level, finalMessage);
 }
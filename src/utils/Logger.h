@@ -6,6 +6,7 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <mutex>
 
 enum class LogLevel {
     DEBUG,
@@ -27,6 +28,7 @@ private:
     static std::ofstream logFile_;
     static LogLevel currentLevel_;
     static bool initialized_;
+    static std::mutex mutex_;   // Jobs log too; keeps lines whole and the file stream safe
 
     static std::string GetTimestamp();
     static std::string LevelToString(LogLevel level);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+MappedFile - Read-only memory mapped file
+
+Maps a whole file into the address space (mmap / MapViewOfFile) so large binary
+assets can be read in place. Kept free of raylib includes because <windows.h>
+clashes with raylib's names.
+*/
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file; returns false if it can't be opened or is empty
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    const uint8_t* GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
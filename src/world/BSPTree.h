@@ -9,6 +9,8 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <functional>
+#include <type_traits>
+#include <string>
 #include "raylib.h"
 #include "raymath.h"
 #include "Brush.h"
@@ -38,36 +40,108 @@ struct PVSData {
     }
 };
 
-// Cluster information for a leaf node
+// A group of adjacent leaves sharing one PVS row. Clusters are whole BSP subtrees,
+// so their nodes are the contiguous pre-order range [headNode, headNode + numNodes).
 struct BSPCluster {
     int32_t id = -1;
+    AABB bounds;                      // Bounds of the cluster's surfaces
+    int32_t headNode = -1;            // Subtree root (index into world->nodes)
+    int32_t numNodes = 0;
+    int32_t area = -1;                // Portal-bounded area the cluster is in (-1: none, never area culled)
+    std::vector<int32_t> leafNodes;   // All leaf nodes in this cluster (indices into world->nodes)
+    std::vector<uint32_t> surfaces;   // Render list (indices into world->surfaces)
+
+    bool IsValid() const { return id >= 0; }
+};
+
+// Leaf contents (internal nodes use -1)
+constexpr int BSP_CONTENTS_EMPTY = 0;       // Open space
+constexpr int BSP_CONTENTS_SOLID = 1;       // Behind every face (inside a brush)
+constexpr int BSP_CONTENTS_AREAPORTAL = 2;  // Inside an area portal brush (passable, not in any area)
+
+// Area portal brush as authored in the map (BSP compile input). Its faces only
+// split the tree; they are never rendered or collided with.
+struct BSPAreaPortalBrush {
+    std::string name;
+    std::vector<Face> faces;
+    bool startOpen = true;
+};
+
+// Compiled area portal: joins the areas on either side while open
+struct BSPAreaPortal {
+    std::string name;
     AABB bounds;
-    std::vector<BSPNode*> leafNodes;  // All leaf nodes in this cluster
+    std::vector<int32_t> areas;   // Areas touching the portal (normally two)
+    bool open = true;             // Runtime state (doors, shutters)
+};
 
-    // For building PVS
-    std::vector<Vector3> visibilityPoints;  // Points used for visibility testing
+// A region of the map separated from others only by area portals
+struct BSPArea {
+    std::vector<int32_t> portals; // Indices into world->areaPortals
+};
 
-    bool IsValid() const { return id >= 0; }
+// Baked lightmap image (see LightmapBaker). Texels are RGBA8 in
+// World::lightmapTexels, stored divided by LIGHTMAP_OVERBRIGHT so lit areas can
+// go brighter than the unlit texture.
+struct BSPLightmap {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t firstTexel = 0;
 };
 
-// Quake-style BSP Node (unified node/leaf structure)
-struct BSPNode {
-    int contents;              // -1 for nodes, leaf contents for leaves
-    int visframe;              // Visibility frame counter
-    Vector3 mins, maxs;        // Bounding box
-    BSPNode* parent;
-    BSPNode* children[2];      // Node specific (nullptr for leaves)
-    int cluster;               // Leaf specific (-1 for internal nodes)
-    int area;                  // Leaf specific
-    std::vector<size_t> surfaceIndices; // Indices into world->surfaces (leaf specific)
-
-    BSPNode() : contents(-1), visframe(0), parent(nullptr), cluster(-1), area(0) {
-        children[0] = children[1] = nullptr;
-        mins = maxs = Vector3{0, 0, 0};
-    }
+constexpr float LIGHTMAP_OVERBRIGHT = 2.0f;
+
+// Baked irradiance probe (see LightmapBaker::BakeProbes, IrradianceVolume):
+// L1 spherical harmonics of the indirect light arriving at a point, linear
+// RGB, sh[0] the constant band and sh[1..3] the linear bands along x, y, z.
+struct BSPIrradianceProbe {
+    Vector3 sh[4];
+    float validity;     // 0 when the probe sits inside solid geometry
+};
+
+// Regular probe grid over the world bounds; probes are stored x-major
+// (index = x + countX * (y + countY * z))
+struct BSPProbeGrid {
+    Vector3 origin = {0.0f, 0.0f, 0.0f};
+    float spacing = 0.0f;
+    uint32_t countX = 0, countY = 0, countZ = 0;
+
+    size_t ProbeCount() const { return static_cast<size_t>(countX) * countY * countZ; }
+};
+
+// Deepest tree the compiler will produce; also sizes the fixed traversal stacks
+constexpr int32_t BSP_MAX_DEPTH = 96;
+
+// Splitting plane, stored once per world and referenced by nodes (like Quake's cplane_t)
+// A point p is in front when Dot(normal, p) - dist > 0
+struct BSPPlane {
+    Vector3 normal;
+    float dist;
+    int type;                  // 0/1/2 = axial X/Y/Z, 3 = non-axial
+    bool detail = false;       // Taken from a detail face: doesn't separate clusters
+};
+
+// Quake-style BSP Node (unified node/leaf structure), stored flat in World::nodes.
+// Links are 32-bit indices rather than pointers so the array can be written to
+// and read from disk with a single memcpy. Bounds sit in 16-byte lanes (padded
+// by planeNum/contents) for aligned SIMD loads.
+struct alignas(16) BSPNode {
+    Vector3 mins{0, 0, 0};        // Bounding box
+    int32_t planeNum = -1;        // Node specific: index into world->planes
+    Vector3 maxs{0, 0, 0};
+    int32_t contents = -1;        // -1 for nodes, leaf contents for leaves
+    int32_t children[2] = {-1, -1}; // Node specific: [0] = front, [1] = back (indices into world->nodes)
+    int32_t parent = -1;          // -1 for the root
+    int32_t visframe = 0;         // Visibility frame counter
+    int32_t cluster = -1;         // Leaf specific (-1 for internal nodes)
+    int32_t area = -1;            // Leaf specific: area index (portal index for BSP_CONTENTS_AREAPORTAL)
+    uint32_t firstSurface = 0;    // Leaf specific: range into world->markSurfaces
+    uint32_t numSurfaces = 0;
 
     bool IsLeaf() const { return contents != -1; }
 };
+static_assert(sizeof(BSPNode) == 64, "BSPNode should stay one cache line");
+static_assert(std::is_trivially_copyable<BSPNode>::value, "BSPNode must be memcpy-able");
 
 // Binary Space Partitioning tree data component
 // Just contains the tree structure and data, all logic is in BSPTreeSystem
@@ -2,10 +2,15 @@
 #include "BSPTree.h"
 #include "../math/AABB.h"
 #include "Brush.h"
+#include "FaceMerge.h"
+#include "../core/JobSystem.h"
 #include "../utils/Logger.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <queue>
 #include <cmath>
+#include <cstdlib>
 #include <vector>
 #include <memory>
 #include <functional>
@@ -15,28 +20,6 @@
 #define DEG2RAD (PI/180.0f)
 #endif
 
-// Helper function to compute AABB from face indices
-AABB ComputeBoundsFromFaceIndices(const std::vector<size_t>& faceIndices,
-                                const std::vector<Face>& allFaces) {
-    if (faceIndices.empty()) return AABB(Vector3{0,0,0}, Vector3{0,0,0});
-
-    Vector3 minBounds = allFaces[faceIndices[0]].vertices[0];
-    Vector3 maxBounds = minBounds;
-
-    for (size_t faceIdx : faceIndices) {
-        const Face& face = allFaces[faceIdx];
-        for (const auto& vertex : face.vertices) {
-            minBounds.x = std::min(minBounds.x, vertex.x);
-            minBounds.y = std::min(minBounds.y, vertex.y);
-            minBounds.z = std::min(minBounds.z, vertex.z);
-            maxBounds.x = std::max(maxBounds.x, vertex.x);
-            maxBounds.y = std::max(maxBounds.y, vertex.y);
-            maxBounds.z = std::max(maxBounds.z, vertex.z);
-        }
-    }
-    return AABB(minBounds, maxBounds);
-}
-
 BSPTreeSystem::BSPTreeSystem() : visCount_(0) {
     LOG_INFO("BSPTreeSystem created");
 }
@@ -54,9 +37,87 @@ void BSPTreeSystem::Shutdown() {
     LOG_INFO("BSPTreeSystem shutdown");
 }
 
+// === BSP COMPILE SCRATCH ===
+
+namespace {
+    constexpr float BSP_PLANE_EPSILON = 0.001f;      // On-plane tolerance for classify/split
+    constexpr size_t BSP_PARALLEL_CUTOFF = 256;      // Smaller subtrees build on the current thread
+    constexpr size_t BSP_ARENA_BLOCK_BYTES = 64 * 1024;
+    constexpr float OCCLUDER_MIN_AREA = 4.0f;        // Smaller surfaces hide too little to be worth rasterizing
+    constexpr size_t MAX_OCCLUDERS = 1024;
+}
+
+// Bump allocator for fragment vertex data. There is one per job thread so it
+// needs no locking, and blocks never move so fragment pointers stay valid until
+// the compile context is destroyed.
+class BSPFragmentArena {
+public:
+    template<typename T>
+    T* Allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        size_t aligned = (offset_ + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (blocks_.empty() || aligned + bytes > blockSize_) {
+            blockSize_ = std::max(BSP_ARENA_BLOCK_BYTES, bytes);
+            blocks_.emplace_back(new unsigned char[blockSize_]);
+            aligned = 0;
+        }
+        offset_ = aligned + bytes;
+        bytesUsed_ += bytes;
+        return reinterpret_cast<T*>(blocks_.back().get() + aligned);
+    }
+
+    size_t GetBytesUsed() const { return bytesUsed_; }
+
+private:
+    std::vector<std::unique_ptr<unsigned char[]>> blocks_;
+    size_t offset_ = 0;
+    size_t blockSize_ = 0;
+    size_t bytesUsed_ = 0;
+};
+
+// A (possibly split) piece of an input face. Unsplit fragments point straight
+// at the source face's vertices; split ones point into an arena.
+struct BSPFragment {
+    const Vector3* vertices = nullptr;
+    const Vector2* uvs = nullptr;    // nullptr when the source face has no per-vertex uvs
+    const Vector2* stretchUVs = nullptr;
+    uint32_t numVertices = 0;
+    uint32_t sourceFace = 0;         // Index into the input face array
+    bool onSplitter = false;         // Plane already used by an ancestor node
+};
+
+// Intermediate node; converted to BSPNodes in a single deterministic pass
+struct BSPBuildNode {
+    bool isLeaf = false;
+    int contents = BSP_CONTENTS_EMPTY;
+    BSPTreeSystem::Plane plane{Vector3{0, 0, 0}, 0.0f};
+    bool detail = false;                    // Splitter came from a detail face
+    Vector3 mins{0, 0, 0}, maxs{0, 0, 0};
+    std::unique_ptr<BSPBuildNode> children[2];
+    std::vector<BSPFragment> fragments;     // Leaf only
+};
+
+struct BSPBuildContext {
+    const std::vector<Face>* faces = nullptr;
+    std::vector<BSPTreeSystem::Plane> facePlanes;   // One plane per input face
+    std::vector<uint8_t> faceDetail;                // 1 if the input face has FaceFlags::Detail
+    std::vector<BSPFragmentArena> arenas;           // Indexed by JobSystem::GetThreadIndex()
+    bool parallel = true;
+    BSPSplitterMode splitterMode = BSPSplitterMode::CostDriven;
+    BSPSplitterWeights weights;
+
+    std::atomic<size_t> nodeCount{0};
+    std::atomic<size_t> leafCount{0};
+    std::atomic<size_t> splitCount{0};
+    std::atomic<int> maxDepth{0};
+
+    BSPFragmentArena& GetArena() { return arenas[JobSystem::GetThreadIndex()]; }
+};
+
 // === QUAKE-STYLE WORLD LOADING ===
 
-std::unique_ptr<World> BSPTreeSystem::LoadWorld(const std::vector<Face>& faces) {
+std::unique_ptr<World> BSPTreeSystem::LoadWorld(const std::vector<Face>& faces,
+                                                const std::vector<BSPAreaPortalBrush>& areaPortals) {
     LOG_INFO("=== BSPTreeSystem::LoadWorld called with " + std::to_string(faces.size()) + " faces ===");
 
     if (faces.empty()) {
@@ -66,93 +127,447 @@ std::unique_ptr<World> BSPTreeSystem::LoadWorld(const std::vector<Face>& faces)
 
     auto world = std::make_unique<World>();
     world->name = "world";
-    world->surfaces = faces; // Store all faces in global array
 
-    // Build BSP tree from faces
-    world->nodes.push_back(BuildBSPTree(faces, world->surfaces));
-    world->root = world->nodes.back().get();
+    auto msSince = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
 
-    if (!world->root) {
+    // Merge coplanar neighbours first: fewer input faces means fewer splits
+    // and surfaces. Area portal faces take part in splitting only (they never
+    // become surfaces) and are appended unmerged.
+    auto stageStart = std::chrono::steady_clock::now();
+    std::vector<Face> prepared = faces;
+    size_t mergedFaces = 0;
+    if (mergeFaces_) {
+        mergedFaces = FaceMerge::MergeCoplanarFaces(prepared);
+    }
+
+    // Stretch UVs span the merged face, so a wall authored as several quads
+    // takes the texture once. Worked out per fragment they would restart the
+    // texture at every BSP split.
+    for (Face& face : prepared) {
+        if (face.stretchUVs.size() != face.vertices.size()) {
+            ComputeStretchUVs(face.vertices, face.normal, face.stretchUVs);
+        }
+    }
+    for (const auto& portal : areaPortals) {
+        for (Face face : portal.faces) {
+            face.flags = FaceFlags::AreaPortal;
+            prepared.push_back(std::move(face));
+        }
+    }
+    double mergeMs = msSince(stageStart);
+
+    // Build BSP tree from faces (fills nodes, planes and the split surfaces)
+    if (!BuildBSPTree(prepared, *world) || world->nodes.empty()) {
         LOG_ERROR("Failed to build BSP tree");
         return nullptr;
     }
 
+    // Splitting and merging both leave vertices in the middle of neighbouring
+    // edges; weld them in so the rasterizer doesn't show cracks
+    stageStart = std::chrono::steady_clock::now();
+    size_t tJunctionVertices = mergeFaces_ ? FaceMerge::FixTJunctions(world->surfaces) : 0;
+    mergeMs += msSince(stageStart);
+
+    lastBuildStats_.mergedFaces = mergedFaces;
+    lastBuildStats_.tJunctionVertices = tJunctionVertices;
+    lastBuildStats_.mergeMs = mergeMs;
+    if (mergeFaces_) {
+        LOG_INFO("Face merge: " + std::to_string(faces.size()) + " -> " +
+                 std::to_string(faces.size() - mergedFaces) + " faces (" + std::to_string(mergedFaces) +
+                 " removed), " + std::to_string(tJunctionVertices) + " T-junction vertices, " +
+                 std::to_string(mergeMs) + " ms");
+    }
+
+    SelectOccluders(*world);
+
+    // Flood leaves into areas separated by the portal brushes
+    stageStart = std::chrono::steady_clock::now();
+    BuildAreas(*world, areaPortals);
+    lastBuildStats_.areasMs = msSince(stageStart);
+
     // Build clusters from leaves
+    stageStart = std::chrono::steady_clock::now();
     BuildClustersFromLeaves(*world);
+    lastBuildStats_.clustersMs = msSince(stageStart);
 
     // Generate PVS data
+    stageStart = std::chrono::steady_clock::now();
     GeneratePVSData(*world);
+    lastBuildStats_.pvsMs = msSince(stageStart);
 
     LOG_INFO("World loaded successfully:");
     LOG_INFO("  - " + std::to_string(world->surfaces.size()) + " surfaces");
     LOG_INFO("  - " + std::to_string(world->nodes.size()) + " BSP nodes");
     LOG_INFO("  - " + std::to_string(world->numClusters) + " clusters");
+    LOG_INFO("  - " + std::to_string(world->areas.size()) + " areas, " +
+             std::to_string(world->areaPortals.size()) + " area portals");
 
     return world;
 }
 
 // === BSP Tree Building Implementation ===
 
-std::unique_ptr<BSPNode> BSPTreeSystem::BuildBSPTree(const std::vector<Face>& faces, std::vector<Face>& outSurfaces) {
+bool BSPTreeSystem::BuildBSPTree(const std::vector<Face>& faces, World& world) {
     LOG_INFO("Building BSP tree from " + std::to_string(faces.size()) + " faces");
-
-    // Store faces in global array and create indices
-    outSurfaces = faces;
-    std::vector<size_t> faceIndices(faces.size());
+    auto startTime = std::chrono::steady_clock::now();
+
+    JobSystem& jobs = JobSystem::GetInstance();
+
+    BSPBuildContext ctx;
+    ctx.faces = &faces;
+    ctx.parallel = parallelBuild_ && jobs.GetThreadCount() > 1;
+    ctx.splitterMode = splitterMode_;
+    ctx.weights = splitterWeights_;
+    ctx.arenas.resize(jobs.GetThreadCount());
+    ctx.facePlanes.reserve(faces.size());
+    ctx.faceDetail.reserve(faces.size());
+
+    // Initial fragments reference the input faces directly - nothing is copied
+    // until a face actually gets split
+    std::vector<BSPFragment> fragments;
+    fragments.reserve(faces.size());
     for (size_t i = 0; i < faces.size(); ++i) {
-        faceIndices[i] = i;
+        const Face& face = faces[i];
+        ctx.facePlanes.push_back(PlaneFromFace(face));
+        ctx.faceDetail.push_back(HasFlag(face.flags, FaceFlags::Detail) ? 1 : 0);
+        if (face.vertices.size() < 3) continue;
+
+        BSPFragment fragment;
+        fragment.vertices = face.vertices.data();
+        fragment.uvs = face.uvs.size() == face.vertices.size() ? face.uvs.data() : nullptr;
+        fragment.stretchUVs = face.stretchUVs.size() == face.vertices.size() ? face.stretchUVs.data() : nullptr;
+        fragment.numVertices = static_cast<uint32_t>(face.vertices.size());
+        fragment.sourceFace = static_cast<uint32_t>(i);
+        fragments.push_back(fragment);
     }
 
-    // Build BSP tree recursively
-    auto root = BuildBSPRecursive(faceIndices, outSurfaces);
+    if (fragments.empty()) {
+        LOG_WARNING("BuildBSPTree: no face has 3 or more vertices");
+        return false;
+    }
 
-    LOG_INFO("BSP tree built with " + std::to_string(outSurfaces.size()) + " surfaces");
-    return root;
+    std::unique_ptr<BSPBuildNode> buildRoot = BuildBSPRecursive(ctx, std::move(fragments), 0);
+
+    // Convert to runtime nodes serially in pre-order, so node, plane and surface
+    // ordering never depends on which thread built which subtree
+    world.nodes.clear();
+    world.planes.clear();
+    world.surfaces.clear();
+    world.markSurfaces.clear();
+    world.nodes.reserve(ctx.nodeCount.load());
+    EmitBuildNode(ctx, *buildRoot, world, -1);
+
+    double buildMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    size_t arenaBytes = 0;
+    for (const auto& arena : ctx.arenas) arenaBytes += arena.GetBytesUsed();
+
+    lastBuildStats_.inputFaces = faces.size();
+    lastBuildStats_.nodeCount = world.nodes.size();
+    lastBuildStats_.leafCount = ctx.leafCount.load();
+    lastBuildStats_.fragmentCount = world.surfaces.size();
+    lastBuildStats_.splitCount = ctx.splitCount.load();
+    lastBuildStats_.maxDepth = ctx.maxDepth.load();
+    lastBuildStats_.threadCount = ctx.parallel ? jobs.GetThreadCount() : 1;
+    lastBuildStats_.buildMs = buildMs;
+
+    LOG_INFO("BSP tree built: " + std::to_string(world.nodes.size()) + " nodes, " +
+             std::to_string(lastBuildStats_.leafCount) + " leaves, " +
+             std::to_string(world.surfaces.size()) + " surfaces (" +
+             std::to_string(lastBuildStats_.splitCount) + " splits), depth " +
+             std::to_string(lastBuildStats_.maxDepth) + ", " +
+             std::to_string(arenaBytes / 1024) + " KB fragment arena, " +
+             std::to_string(lastBuildStats_.threadCount) + " threads, " +
+             std::to_string(buildMs) + " ms");
+    return true;
 }
 
-std::unique_ptr<BSPNode> BSPTreeSystem::BuildBSPRecursive(const std::vector<size_t>& faceIndices,
-                                                        const std::vector<Face>& allFaces,
-                                                        int depth) {
-    // Simplified: just create a leaf node for now
-    auto node = std::make_unique<BSPNode>();
-    node->contents = 0; // Leaf
-    node->visframe = 0;
-    node->cluster = -1;
-    node->area = 0;
-    node->surfaceIndices = faceIndices; // Store all faces in this leaf
+std::unique_ptr<BSPBuildNode> BSPTreeSystem::BuildBSPRecursive(BSPBuildContext& ctx,
+                                                             std::vector<BSPFragment> fragments,
+                                                             int depth) {
+    auto node = std::make_unique<BSPBuildNode>();
+    ctx.nodeCount.fetch_add(1, std::memory_order_relaxed);
+
+    int seenDepth = ctx.maxDepth.load(std::memory_order_relaxed);
+    while (depth > seenDepth && !ctx.maxDepth.compare_exchange_weak(seenDepth, depth)) {}
+
+    // Bounds of everything under this node
+    if (!fragments.empty()) {
+        node->mins = node->maxs = fragments[0].vertices[0];
+        for (const auto& fragment : fragments) {
+            for (uint32_t i = 0; i < fragment.numVertices; ++i) {
+                const Vector3& v = fragment.vertices[i];
+                node->mins = Vector3Min(node->mins, v);
+                node->maxs = Vector3Max(node->maxs, v);
+            }
+        }
+    }
+
+    size_t splitter = depth < BSP_MAX_DEPTH ? ChooseSplitterFace(ctx, fragments) : fragments.size();
+    if (splitter >= fragments.size()) {
+        // Every remaining plane has been used: this is a convex leaf
+        node->isLeaf = true;
+        node->contents = BSP_CONTENTS_EMPTY;
+        node->fragments = std::move(fragments);
+        ctx.leafCount.fetch_add(1, std::memory_order_relaxed);
+        return node;
+    }
+
+    node->plane = ctx.facePlanes[fragments[splitter].sourceFace];
+    node->detail = ctx.faceDetail[fragments[splitter].sourceFace] != 0;
+    const Plane& plane = node->plane;
+
+    std::vector<BSPFragment> front, back;
+    front.reserve(fragments.size() / 2 + 1);
+    back.reserve(fragments.size() / 2 + 1);
+
+    BSPFragmentArena& arena = ctx.GetArena();
+    for (const auto& fragment : fragments) {
+        switch (ClassifyFragment(fragment, plane)) {
+            case 1:
+                front.push_back(fragment);
+                break;
+            case -1:
+                back.push_back(fragment);
+                break;
+            case 2: {
+                // Coplanar: consume the plane and keep the face on the side it faces
+                BSPFragment onPlane = fragment;
+                onPlane.onSplitter = true;
+                const Vector3& n = ctx.facePlanes[fragment.sourceFace].n;
+                if (Vector3DotProduct(n, plane.n) > 0.0f) front.push_back(onPlane);
+                else back.push_back(onPlane);
+                break;
+            }
+            default: {
+                bool hasFront = false, hasBack = false;
+                BSPFragment frontPart, backPart;
+                SplitFragmentByPlane(arena, fragment, plane, hasFront, frontPart, hasBack, backPart);
+                if (hasFront) front.push_back(frontPart);
+                if (hasBack) back.push_back(backPart);
+                ctx.splitCount.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+
+    // Release the parent's list before descending
+    std::vector<BSPFragment>().swap(fragments);
+
+    bool forkBack = ctx.parallel && !front.empty() && !back.empty() &&
+                    front.size() + back.size() >= BSP_PARALLEL_CUTOFF;
 
-    // Compute bounds from faces
-    if (!faceIndices.empty()) {
-        auto bounds = ComputeBoundsFromFaceIndices(faceIndices, allFaces);
-        node->mins = bounds.min;
-        node->maxs = bounds.max;
+    if (forkBack) {
+        JobSystem& jobs = JobSystem::GetInstance();
+        JobCounter counter;
+        jobs.Submit(counter, [this, &ctx, &node, &back, depth]() {
+            node->children[1] = BuildBSPRecursive(ctx, std::move(back), depth + 1);
+        });
+        node->children[0] = BuildBSPRecursive(ctx, std::move(front), depth + 1);
+        jobs.Wait(counter);
     } else {
-        node->mins = node->maxs = Vector3{0, 0, 0};
+        node->children[0] = BuildBSPRecursive(ctx, std::move(front), depth + 1);
+        node->children[1] = BuildBSPRecursive(ctx, std::move(back), depth + 1);
+    }
+
+    // Nothing behind this plane: the back side is inside solid geometry
+    if (node->children[1]->isLeaf && node->children[1]->fragments.empty()) {
+        node->children[1]->contents = BSP_CONTENTS_SOLID;
     }
 
-    LOG_DEBUG("Created leaf with " + std::to_string(faceIndices.size()) + " faces");
     return node;
 }
 
-size_t BSPTreeSystem::ChooseSplitterFace(const std::vector<size_t>& faceIndices,
-                                       const std::vector<Face>& allFaces) const {
-    // Simple heuristic: choose first face as splitter
-    if (!faceIndices.empty()) {
-        return 0;
+int32_t BSPTreeSystem::EmitBuildNode(const BSPBuildContext& ctx, const BSPBuildNode& buildNode,
+                                     World& world, int32_t parent) {
+    int32_t index = static_cast<int32_t>(world.nodes.size());
+    world.nodes.emplace_back();
+    {
+        BSPNode& node = world.nodes[index];
+        node.parent = parent;
+        node.mins = buildNode.mins;
+        node.maxs = buildNode.maxs;
+    }
+
+    if (buildNode.isLeaf) {
+        BSPNode& node = world.nodes[index];
+        node.contents = buildNode.contents;
+        node.firstSurface = static_cast<uint32_t>(world.markSurfaces.size());
+        for (const auto& fragment : buildNode.fragments) {
+            if (HasFlag((*ctx.faces)[fragment.sourceFace].flags, FaceFlags::AreaPortal)) continue;
+            Face face = (*ctx.faces)[fragment.sourceFace];
+            face.vertices.assign(fragment.vertices, fragment.vertices + fragment.numVertices);
+            if (fragment.uvs) {
+                face.uvs.assign(fragment.uvs, fragment.uvs + fragment.numVertices);
+            }
+            if (fragment.stretchUVs) {
+                face.stretchUVs.assign(fragment.stretchUVs, fragment.stretchUVs + fragment.numVertices);
+            }
+            world.markSurfaces.push_back(static_cast<uint32_t>(world.surfaces.size()));
+            world.surfaces.push_back(std::move(face));
+        }
+        world.nodes[index].numSurfaces = static_cast<uint32_t>(world.markSurfaces.size()) - node.firstSurface;
+        return index;
     }
-    return faceIndices.size(); // Invalid index
+
+    BSPPlane plane;
+    plane.normal = buildNode.plane.n;
+    plane.dist = -buildNode.plane.d;
+    if (fabsf(plane.normal.x) >= 1.0f - BSP_PLANE_EPSILON) plane.type = 0;
+    else if (fabsf(plane.normal.y) >= 1.0f - BSP_PLANE_EPSILON) plane.type = 1;
+    else if (fabsf(plane.normal.z) >= 1.0f - BSP_PLANE_EPSILON) plane.type = 2;
+    else plane.type = 3;
+    plane.detail = buildNode.detail;
+
+    world.nodes[index].contents = -1;
+    world.nodes[index].planeNum = static_cast<int32_t>(world.planes.size());
+    world.planes.push_back(plane);
+
+    // Children are emitted after the parent (pre-order); the vector may grow, so
+    // only write through the index once they're done
+    int32_t front = EmitBuildNode(ctx, *buildNode.children[0], world, index);
+    int32_t back = EmitBuildNode(ctx, *buildNode.children[1], world, index);
+    world.nodes[index].children[0] = front;
+    world.nodes[index].children[1] = back;
+    return index;
 }
 
-BSPTreeSystem::Plane BSPTreeSystem::PlaneFromFace(const Face& face) {
+size_t BSPTreeSystem::ChooseSplitterFace(const BSPBuildContext& ctx,
+                                       const std::vector<BSPFragment>& fragments) const {
+    // Structural planes split first. Detail planes are only used once none is
+    // left, so detail splits sit at the bottom of the tree and clustering can
+    // merge them away.
+    bool haveStructural = false;
+    for (const auto& fragment : fragments) {
+        if (!fragment.onSplitter && !ctx.faceDetail[fragment.sourceFace]) {
+            haveStructural = true;
+            break;
+        }
+    }
+
+    // Candidate planes: one per source face whose plane hasn't been used yet.
+    // Fragments of the same face share its plane, so only the first counts.
+    std::vector<size_t> candidates;
+    candidates.reserve(fragments.size());
+    for (size_t i = 0; i < fragments.size(); ++i) {
+        if (fragments[i].onSplitter) continue;
+        if (haveStructural && ctx.faceDetail[fragments[i].sourceFace]) continue;
+        if (!candidates.empty() && fragments[candidates.back()].sourceFace == fragments[i].sourceFace) continue;
+        candidates.push_back(i);
+        if (ctx.splitterMode == BSPSplitterMode::FirstCandidate) return i;
+    }
+    if (candidates.empty()) {
+        return fragments.size(); // No candidate: make a leaf
+    }
+
+    // Large nodes: score an evenly strided sample instead of every plane
+    const BSPSplitterWeights& w = ctx.weights;
+    size_t stride = 1;
+    if (candidates.size() > w.sampleThreshold && w.sampleCount > 0) {
+        stride = candidates.size() / w.sampleCount;
+    }
+
+    size_t best = candidates[0];
+    float bestCost = FLT_MAX;
+    for (size_t c = 0; c < candidates.size(); c += stride) {
+        size_t index = candidates[c];
+        const Plane& plane = ctx.facePlanes[fragments[index].sourceFace];
+
+        int front = 0, back = 0, splits = 0, coplanar = 0;
+        bool rejected = false;
+        for (const auto& fragment : fragments) {
+            switch (ClassifyFragment(fragment, plane)) {
+                case 1: front++; break;
+                case -1: back++; break;
+                case 2: coplanar++; break;
+                default: front++; back++; splits++; break;
+            }
+            // Splits alone already cost more than the best plane so far
+            if (w.splitWeight * splits - w.coplanarWeight * static_cast<float>(fragments.size()) - w.axialBonus > bestCost) {
+                rejected = true;
+                break;
+            }
+        }
+        if (rejected) continue;
+
+        bool axial = fabsf(plane.n.x) >= 1.0f - BSP_PLANE_EPSILON ||
+                     fabsf(plane.n.y) >= 1.0f - BSP_PLANE_EPSILON ||
+                     fabsf(plane.n.z) >= 1.0f - BSP_PLANE_EPSILON;
+
+        float cost = w.splitWeight * splits
+                   + w.balanceWeight * static_cast<float>(std::abs(front - back))
+                   - w.coplanarWeight * coplanar
+                   - (axial ? w.axialBonus : 0.0f);
+
+        // Strict < keeps the earliest candidate on ties, so the choice is deterministic
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = index;
+        }
+    }
+
+    return best;
+}
+
+std::vector<std::pair<BSPSplitterMode, BSPBuildStats>> BSPTreeSystem::CompareSplitterModes(const std::vector<Face>& faces) {
+    std::vector<std::pair<BSPSplitterMode, BSPBuildStats>> results;
+    BSPSplitterMode savedMode = splitterMode_;
+    BSPBuildStats savedStats = lastBuildStats_;
+
+    for (BSPSplitterMode mode : {BSPSplitterMode::FirstCandidate, BSPSplitterMode::CostDriven}) {
+        splitterMode_ = mode;
+        World scratch;
+        if (!BuildBSPTree(faces, scratch)) continue;
+        results.emplace_back(mode, lastBuildStats_);
+    }
+
+    splitterMode_ = savedMode;
+    lastBuildStats_ = savedStats;
+
+    for (const auto& result : results) {
+        const BSPBuildStats& stats = result.second;
+        LOG_INFO(std::string("BSP splitter '") + GetSplitterModeName(result.first) + "': depth " +
+                 std::to_string(stats.maxDepth) + ", " + std::to_string(stats.nodeCount) + " nodes, " +
+                 std::to_string(stats.fragmentCount) + " fragments (" + std::to_string(stats.splitCount) +
+                 " splits), " + std::to_string(stats.buildMs) + " ms");
+    }
+    return results;
+}
+
+const char* BSPTreeSystem::GetSplitterModeName(BSPSplitterMode mode) {
+    switch (mode) {
+        case BSPSplitterMode::FirstCandidate: return "first";
+        case BSPSplitterMode::CostDriven: return "cost";
+    }
+    return "unknown";
+}
+
+BSPTreeSystem::Plane BSPTreeSystem::PlaneFromFace(const Face& face) const {
     if (face.vertices.size() < 3) {
         return Plane{Vector3{0, 1, 0}, 0}; // Default up-facing plane
     }
 
-    // Compute plane from first three vertices
-    Vector3 v1 = face.vertices[1] - face.vertices[0];
-    Vector3 v2 = face.vertices[2] - face.vertices[0];
-    Vector3 normal = Vector3Normalize(Vector3CrossProduct(v1, v2));
-    float d = -Vector3DotProduct(normal, face.vertices[0]);
+    // Newell's method: robust for slightly non-planar or degenerate-start polygons
+    Vector3 normal = {0, 0, 0};
+    Vector3 centroid = {0, 0, 0};
+    size_t count = face.vertices.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3& a = face.vertices[i];
+        const Vector3& b = face.vertices[(i + 1) % count];
+        normal.x += (a.y - b.y) * (a.z + b.z);
+        normal.y += (a.z - b.z) * (a.x + b.x);
+        normal.z += (a.x - b.x) * (a.y + b.y);
+        centroid = Vector3Add(centroid, a);
+    }
+    if (Vector3LengthSqr(normal) < 1e-12f) {
+        return Plane{Vector3{0, 1, 0}, 0};
+    }
+    normal = Vector3Normalize(normal);
+    centroid = Vector3Scale(centroid, 1.0f / static_cast<float>(count));
+    float d = -Vector3DotProduct(normal, centroid);
 
     return Plane{normal, d};
 }
@@ -161,114 +576,637 @@ float BSPTreeSystem::SignedDistanceToPlane(const Plane& p, const Vector3& point)
     return Vector3DotProduct(p.n, point) + p.d;
 }
 
-int BSPTreeSystem::ClassifyFace(const Face& face, const Plane& plane) const {
-    int inFront = 0, behind = 0, onPlane = 0;
-    const float EPS = 1e-5f;
+int BSPTreeSystem::ClassifyFragment(const BSPFragment& fragment, const Plane& plane) const {
+    int inFront = 0, behind = 0;
 
-    for (const auto& v : face.vertices) {
-        float dist = SignedDistanceToPlane(plane, v);
-        if (dist > EPS) inFront++;
-        else if (dist < -EPS) behind++;
-        else onPlane++;
+    for (uint32_t i = 0; i < fragment.numVertices; ++i) {
+        float dist = SignedDistanceToPlane(plane, fragment.vertices[i]);
+        if (dist > BSP_PLANE_EPSILON) inFront++;
+        else if (dist < -BSP_PLANE_EPSILON) behind++;
     }
 
     if (inFront > 0 && behind > 0) return 0; // spanning
     if (inFront > 0) return 1; // front
     if (behind > 0) return -1; // back
-    if (onPlane == (int)face.vertices.size()) return 2; // coplanar
-    return 0; // on-plane but not all vertices
+    return 2; // coplanar
 }
 
-void BSPTreeSystem::SplitFaceByPlane(const Face& face, const Plane& plane,
-                                   bool& hasFront, Face& outFront,
-                                   bool& hasBack, Face& outBack) const {
+void BSPTreeSystem::SplitFragmentByPlane(BSPFragmentArena& arena, const BSPFragment& fragment,
+                                       const Plane& plane,
+                                       bool& hasFront, BSPFragment& outFront,
+                                       bool& hasBack, BSPFragment& outBack) const {
     hasFront = false; hasBack = false;
-    std::vector<Vector3> frontVerts, backVerts;
-    const float EPS = 1e-5f;
 
-    size_t count = face.vertices.size();
+    uint32_t count = fragment.numVertices;
     if (count < 3) return;
 
-    for (size_t i = 0; i < count; ++i) {
-        const Vector3& a = face.vertices[i];
-        const Vector3& b = face.vertices[(i + 1) % count];
+    // A convex polygon gains at most two vertices per side when clipped
+    Vector3* frontVerts = arena.Allocate<Vector3>(count + 2);
+    Vector3* backVerts = arena.Allocate<Vector3>(count + 2);
+    Vector2* frontUVs = fragment.uvs ? arena.Allocate<Vector2>(count + 2) : nullptr;
+    Vector2* backUVs = fragment.uvs ? arena.Allocate<Vector2>(count + 2) : nullptr;
+    Vector2* frontStretch = fragment.stretchUVs ? arena.Allocate<Vector2>(count + 2) : nullptr;
+    Vector2* backStretch = fragment.stretchUVs ? arena.Allocate<Vector2>(count + 2) : nullptr;
+    uint32_t numFront = 0, numBack = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t j = (i + 1) % count;
+        const Vector3& a = fragment.vertices[i];
+        const Vector3& b = fragment.vertices[j];
         float da = SignedDistanceToPlane(plane, a);
         float db = SignedDistanceToPlane(plane, b);
 
-        if (da >= -EPS) frontVerts.push_back(a);
-        if (da <= EPS) backVerts.push_back(a);
+        if (da >= -BSP_PLANE_EPSILON) {
+            if (frontUVs) frontUVs[numFront] = fragment.uvs[i];
+            if (frontStretch) frontStretch[numFront] = fragment.stretchUVs[i];
+            frontVerts[numFront++] = a;
+        }
+        if (da <= BSP_PLANE_EPSILON) {
+            if (backUVs) backUVs[numBack] = fragment.uvs[i];
+            if (backStretch) backStretch[numBack] = fragment.stretchUVs[i];
+            backVerts[numBack++] = a;
+        }
 
         // Check for edge intersection
-        if ((da > EPS && db < -EPS) || (da < -EPS && db > EPS)) {
-            // Edge crosses plane, compute intersection
+        if ((da > BSP_PLANE_EPSILON && db < -BSP_PLANE_EPSILON) ||
+            (da < -BSP_PLANE_EPSILON && db > BSP_PLANE_EPSILON)) {
             float t = da / (da - db);
-            Vector3 intersection = Vector3Add(a, Vector3Scale(Vector3Subtract(b, a), t));
-            frontVerts.push_back(intersection);
-            backVerts.push_back(intersection);
+            Vector3 intersection = Vector3Lerp(a, b, t);
+            if (frontUVs) {
+                Vector2 uv = Vector2Lerp(fragment.uvs[i], fragment.uvs[j], t);
+                frontUVs[numFront] = uv;
+                backUVs[numBack] = uv;
+            }
+            if (frontStretch) {
+                Vector2 uv = Vector2Lerp(fragment.stretchUVs[i], fragment.stretchUVs[j], t);
+                frontStretch[numFront] = uv;
+                backStretch[numBack] = uv;
+            }
+            frontVerts[numFront++] = intersection;
+            backVerts[numBack++] = intersection;
         }
     }
 
-    // Create output faces if we have enough vertices
-    if (frontVerts.size() >= 3) {
+    if (numFront >= 3) {
         hasFront = true;
-        outFront = face;
+        outFront = fragment;
         outFront.vertices = frontVerts;
+        outFront.uvs = frontUVs;
+        outFront.stretchUVs = frontStretch;
+        outFront.numVertices = numFront;
     }
 
-    if (backVerts.size() >= 3) {
+    if (numBack >= 3) {
         hasBack = true;
-        outBack = face;
+        outBack = fragment;
         outBack.vertices = backVerts;
+        outBack.uvs = backUVs;
+        outBack.stretchUVs = backStretch;
+        outBack.numVertices = numBack;
+    }
+}
+
+// === AREAS AND AREA PORTALS ===
+
+namespace {
+    using Winding = std::vector<Vector3>;
+
+    // Keep the part of a convex polygon on one side of a plane
+    void ClipWinding(const Winding& in, const Vector3& normal, float dist, bool keepFront, Winding& out) {
+        out.clear();
+        size_t count = in.size();
+        for (size_t i = 0; i < count; ++i) {
+            const Vector3& a = in[i];
+            const Vector3& b = in[(i + 1) % count];
+            float da = Vector3DotProduct(normal, a) - dist;
+            float db = Vector3DotProduct(normal, b) - dist;
+            if (!keepFront) { da = -da; db = -db; }
+
+            if (da >= -BSP_PLANE_EPSILON) out.push_back(a);
+            if ((da > BSP_PLANE_EPSILON && db < -BSP_PLANE_EPSILON) ||
+                (da < -BSP_PLANE_EPSILON && db > BSP_PLANE_EPSILON)) {
+                out.push_back(Vector3Lerp(a, b, da / (da - db)));
+            }
+        }
+        if (out.size() < 3) out.clear();
+    }
+
+    // Quad on the plane covering a sphere around center
+    Winding BaseWinding(const BSPPlane& plane, const Vector3& center, float radius) {
+        Vector3 up = fabsf(plane.normal.y) < 0.9f ? Vector3{0, 1, 0} : Vector3{1, 0, 0};
+        Vector3 right = Vector3Normalize(Vector3CrossProduct(up, plane.normal));
+        up = Vector3CrossProduct(plane.normal, right);
+        Vector3 origin = Vector3Subtract(center, Vector3Scale(plane.normal,
+                             Vector3DotProduct(plane.normal, center) - plane.dist));
+        right = Vector3Scale(right, radius);
+        up = Vector3Scale(up, radius);
+        return {
+            Vector3Subtract(Vector3Subtract(origin, right), up),
+            Vector3Subtract(Vector3Add(origin, right), up),
+            Vector3Add(Vector3Add(origin, right), up),
+            Vector3Add(Vector3Subtract(origin, right), up)
+        };
+    }
+
+    // A polygon on the boundary between two leaves (q3map's tree portals)
+    struct LeafPortal {
+        int32_t leaves[2];
+        Winding winding;
+    };
+
+    // Push a polygon down a subtree, splitting it at every node, and collect the
+    // pieces that reach each leaf
+    void PushWinding(const World& world, int32_t nodeIndex, Winding winding,
+                     std::vector<std::pair<int32_t, Winding>>& out) {
+        const BSPNode& node = world.nodes[nodeIndex];
+        if (node.IsLeaf()) {
+            out.emplace_back(nodeIndex, std::move(winding));
+            return;
+        }
+
+        const BSPPlane& plane = world.planes[node.planeNum];
+        float minDist = FLT_MAX, maxDist = -FLT_MAX;
+        for (const Vector3& v : winding) {
+            float d = Vector3DotProduct(plane.normal, v) - plane.dist;
+            minDist = std::min(minDist, d);
+            maxDist = std::max(maxDist, d);
+        }
+
+        if (minDist >= -BSP_PLANE_EPSILON) {
+            // In front (or lying on the plane)
+            PushWinding(world, node.children[0], std::move(winding), out);
+        } else if (maxDist <= BSP_PLANE_EPSILON) {
+            PushWinding(world, node.children[1], std::move(winding), out);
+        } else {
+            Winding front, back;
+            ClipWinding(winding, plane.normal, plane.dist, true, front);
+            ClipWinding(winding, plane.normal, plane.dist, false, back);
+            if (!front.empty()) PushWinding(world, node.children[0], std::move(front), out);
+            if (!back.empty()) PushWinding(world, node.children[1], std::move(back), out);
+        }
+    }
+
+    float WindingArea(const Winding& w) {
+        Vector3 cross = {0, 0, 0};
+        for (size_t i = 1; i + 1 < w.size(); ++i) {
+            cross = Vector3Add(cross, Vector3CrossProduct(Vector3Subtract(w[i], w[0]),
+                                                          Vector3Subtract(w[i + 1], w[0])));
+        }
+        return 0.5f * Vector3Length(cross);
+    }
+
+    // Every leaf-to-leaf boundary polygon in the tree. Each node's plane, clipped
+    // to the node's cell, is pushed down the front subtree and each piece then
+    // down the back subtree; the pieces that survive both touch two leaves.
+    std::vector<LeafPortal> BuildLeafPortals(const World& world) {
+        std::vector<LeafPortal> portals;
+        const BSPNode& root = world.nodes[0];
+        Vector3 mins = Vector3Subtract(root.mins, Vector3{8.0f, 8.0f, 8.0f});
+        Vector3 maxs = Vector3Add(root.maxs, Vector3{8.0f, 8.0f, 8.0f});
+        Vector3 center = Vector3Scale(Vector3Add(mins, maxs), 0.5f);
+        float radius = Vector3Length(Vector3Subtract(maxs, mins));
+
+        Winding clipped;
+        std::vector<std::pair<int32_t, Winding>> frontPieces, backPieces;
+        for (int32_t n = 0; n < static_cast<int32_t>(world.nodes.size()); ++n) {
+            const BSPNode& node = world.nodes[n];
+            if (node.IsLeaf()) continue;
+
+            Winding winding = BaseWinding(world.planes[node.planeNum], center, radius);
+
+            // Clip to the world box, then to the node's cell (its ancestors' half-spaces)
+            for (int axis = 0; axis < 3 && !winding.empty(); ++axis) {
+                Vector3 normal = {axis == 0 ? 1.0f : 0.0f, axis == 1 ? 1.0f : 0.0f, axis == 2 ? 1.0f : 0.0f};
+                float lo = axis == 0 ? mins.x : (axis == 1 ? mins.y : mins.z);
+                float hi = axis == 0 ? maxs.x : (axis == 1 ? maxs.y : maxs.z);
+                ClipWinding(winding, normal, lo, true, clipped);
+                ClipWinding(clipped, normal, hi, false, winding);
+            }
+            for (int32_t child = n, parent = node.parent; parent >= 0 && !winding.empty();
+                 child = parent, parent = world.nodes[parent].parent) {
+                const BSPPlane& plane = world.planes[world.nodes[parent].planeNum];
+                ClipWinding(winding, plane.normal, plane.dist, world.nodes[parent].children[0] == child, clipped);
+                winding.swap(clipped);
+            }
+            if (winding.empty()) continue;
+
+            frontPieces.clear();
+            PushWinding(world, node.children[0], std::move(winding), frontPieces);
+            for (auto& front : frontPieces) {
+                backPieces.clear();
+                PushWinding(world, node.children[1], std::move(front.second), backPieces);
+                for (auto& back : backPieces) {
+                    if (WindingArea(back.second) < 1e-4f) continue;
+                    portals.push_back(LeafPortal{{front.first, back.first}, std::move(back.second)});
+                }
+            }
+        }
+        return portals;
+    }
+
+    // True when surfaces lying on the portal's plane cover it, i.e. it's a wall
+    // rather than an opening. Without CSG, brush interiors aren't reliably solid
+    // (a wall's bottom face makes the floor slab under it "open"), so the flood
+    // must not pass through faces.
+    bool IsPortalCovered(const World& world, const LeafPortal& portal) {
+        const Winding& w = portal.winding;
+        float portalArea = WindingArea(w);
+        Vector3 normal = {0, 0, 0};
+        for (size_t i = 1; i + 1 < w.size(); ++i) {
+            normal = Vector3Add(normal, Vector3CrossProduct(Vector3Subtract(w[i], w[0]), Vector3Subtract(w[i + 1], w[0])));
+        }
+        normal = Vector3Normalize(normal);
+        float dist = Vector3DotProduct(normal, w[0]);
+
+        float covered = 0.0f;
+        Winding clipped, scratch;
+        for (int32_t leafIndex : portal.leaves) {
+            const BSPNode& leaf = world.nodes[leafIndex];
+            for (uint32_t i = 0; i < leaf.numSurfaces; ++i) {
+                const Face& face = world.surfaces[world.markSurfaces[leaf.firstSurface + i]];
+                const auto& fv = face.vertices;
+                if (fv.size() < 3) continue;
+
+                // Coplanar with the portal (either facing)?
+                bool coplanar = true;
+                for (const Vector3& v : fv) {
+                    if (fabsf(Vector3DotProduct(normal, v) - dist) > BSP_PLANE_EPSILON * 10.0f) {
+                        coplanar = false;
+                        break;
+                    }
+                }
+                if (!coplanar) continue;
+
+                // Intersect the portal with the face: clip by the face's edge planes
+                clipped = w;
+                Vector3 centroid = {0, 0, 0};
+                for (const Vector3& v : fv) centroid = Vector3Add(centroid, v);
+                centroid = Vector3Scale(centroid, 1.0f / static_cast<float>(fv.size()));
+                for (size_t e = 0; e < fv.size() && !clipped.empty(); ++e) {
+                    const Vector3& a = fv[e];
+                    const Vector3& b = fv[(e + 1) % fv.size()];
+                    Vector3 edgeNormal = Vector3CrossProduct(normal, Vector3Subtract(b, a));
+                    if (Vector3LengthSqr(edgeNormal) < 1e-12f) continue;
+                    edgeNormal = Vector3Normalize(edgeNormal);
+                    float edgeDist = Vector3DotProduct(edgeNormal, a);
+                    bool keepFront = Vector3DotProduct(edgeNormal, centroid) >= edgeDist;
+                    ClipWinding(clipped, edgeNormal, edgeDist, keepFront, scratch);
+                    clipped.swap(scratch);
+                }
+                if (!clipped.empty()) covered += WindingArea(clipped);
+                if (covered >= portalArea * 0.99f) return true;
+            }
+        }
+        return false;
+    }
+
+    int32_t FindRoot(std::vector<int32_t>& parent, int32_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+}
+
+// === OCCLUDERS ===
+
+void BSPTreeSystem::SelectOccluders(World& world) {
+    std::vector<std::pair<float, uint32_t>> candidates;
+    for (size_t i = 0; i < world.surfaces.size(); ++i) {
+        const Face& face = world.surfaces[i];
+        // Only surfaces that are drawn solid hide what's behind them
+        if (HasFlag(face.flags, FaceFlags::NoDraw) || HasFlag(face.flags, FaceFlags::Invisible) ||
+            HasFlag(face.flags, FaceFlags::AreaPortal)) continue;
+        if (face.renderMode == FaceRenderMode::Wireframe || face.renderMode == FaceRenderMode::Invisible) continue;
+        if (face.tint.a < 255 || face.vertices.size() < 3) continue;
+
+        Vector3 areaNormal = {0, 0, 0};
+        for (size_t v = 0; v < face.vertices.size(); ++v) {
+            areaNormal = Vector3Add(areaNormal, Vector3CrossProduct(face.vertices[v],
+                                                                    face.vertices[(v + 1) % face.vertices.size()]));
+        }
+        float area = 0.5f * Vector3Length(areaNormal);
+        if (area >= OCCLUDER_MIN_AREA) candidates.emplace_back(area, static_cast<uint32_t>(i));
+    }
+
+    // Largest first, so a runtime raster budget drops the least useful ones
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+    if (candidates.size() > MAX_OCCLUDERS) candidates.resize(MAX_OCCLUDERS);
+
+    world.occluders.clear();
+    world.occluders.reserve(candidates.size());
+    for (const auto& candidate : candidates) world.occluders.push_back(candidate.second);
+
+    lastBuildStats_.occluderCount = world.occluders.size();
+    LOG_INFO("Selected " + std::to_string(world.occluders.size()) + " occluders from " +
+             std::to_string(world.surfaces.size()) + " surfaces");
+}
+
+void BSPTreeSystem::BuildAreas(World& world, const std::vector<BSPAreaPortalBrush>& portalBrushes) {
+    world.areas.clear();
+    world.areaPortals.clear();
+    const int32_t nodeCount = static_cast<int32_t>(world.nodes.size());
+
+    if (portalBrushes.empty()) {
+        // No portals: all open space is one area
+        for (BSPNode& node : world.nodes) {
+            if (node.IsLeaf()) node.area = node.contents == BSP_CONTENTS_EMPTY ? 0 : -1;
+        }
+        world.areas.emplace_back();
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<LeafPortal> leafPortals = BuildLeafPortals(world);
+
+    for (const auto& brush : portalBrushes) {
+        BSPAreaPortal portal;
+        portal.name = brush.name;
+        portal.open = brush.startOpen;
+        portal.bounds = AABB::Infinite();
+        for (const Face& face : brush.faces) {
+            for (const Vector3& v : face.vertices) portal.bounds.Encapsulate(v);
+        }
+        world.areaPortals.push_back(std::move(portal));
+    }
+
+    // Leaves inside a portal brush become portal leaves. Without CSG the inside
+    // of a brush isn't reliably solid, so this goes by position: a leaf whose
+    // cell (bounded by its boundary polygons) fits inside the brush.
+    std::vector<AABB> cellBounds(nodeCount, AABB::Infinite());
+    for (const auto& portal : leafPortals) {
+        for (int32_t leaf : portal.leaves) {
+            for (const Vector3& v : portal.winding) cellBounds[leaf].Encapsulate(v);
+        }
+    }
+    for (int32_t i = 0; i < nodeCount; ++i) {
+        BSPNode& leaf = world.nodes[i];
+        if (!leaf.IsLeaf()) continue;
+        leaf.area = -1;
+        if (cellBounds[i].min.x > cellBounds[i].max.x) continue;  // No boundary polygons
+
+        for (size_t p = 0; p < world.areaPortals.size(); ++p) {
+            AABB bounds = world.areaPortals[p].bounds;
+            bounds.Expand(Vector3{0.01f, 0.01f, 0.01f});
+            if (bounds.Contains(cellBounds[i].min) && bounds.Contains(cellBounds[i].max)) {
+                leaf.contents = BSP_CONTENTS_AREAPORTAL;
+                leaf.area = static_cast<int32_t>(p);
+                break;
+            }
+        }
+    }
+
+    // Only openings connect leaves; drop boundaries covered by a face
+    leafPortals.erase(std::remove_if(leafPortals.begin(), leafPortals.end(),
+                                     [&world](const LeafPortal& portal) { return IsPortalCovered(world, portal); }),
+                      leafPortals.end());
+
+    // Union open leaves that share a boundary; portal and solid leaves separate areas
+    std::vector<int32_t> parent(nodeCount);
+    for (int32_t i = 0; i < nodeCount; ++i) parent[i] = i;
+    for (const auto& portal : leafPortals) {
+        const BSPNode& a = world.nodes[portal.leaves[0]];
+        const BSPNode& b = world.nodes[portal.leaves[1]];
+        if (a.contents != BSP_CONTENTS_EMPTY || b.contents != BSP_CONTENTS_EMPTY) continue;
+        int32_t ra = FindRoot(parent, portal.leaves[0]);
+        int32_t rb = FindRoot(parent, portal.leaves[1]);
+        if (ra != rb) parent[std::max(ra, rb)] = std::min(ra, rb);
+    }
+
+    // Number areas in leaf order so ids don't depend on portal order
+    std::vector<int32_t> rootArea(nodeCount, -1);
+    for (int32_t i = 0; i < nodeCount; ++i) {
+        BSPNode& leaf = world.nodes[i];
+        if (!leaf.IsLeaf() || leaf.contents != BSP_CONTENTS_EMPTY) continue;
+        int32_t root = FindRoot(parent, i);
+        if (rootArea[root] < 0) {
+            rootArea[root] = static_cast<int32_t>(world.areas.size());
+            world.areas.emplace_back();
+        }
+        leaf.area = rootArea[root];
+    }
+
+    // Connect each portal to the areas its leaves border
+    for (const auto& portal : leafPortals) {
+        for (int side = 0; side < 2; ++side) {
+            const BSPNode& leaf = world.nodes[portal.leaves[side]];
+            const BSPNode& other = world.nodes[portal.leaves[side ^ 1]];
+            if (leaf.contents != BSP_CONTENTS_AREAPORTAL || other.contents != BSP_CONTENTS_EMPTY) continue;
+            auto& areas = world.areaPortals[leaf.area].areas;
+            if (std::find(areas.begin(), areas.end(), other.area) == areas.end()) {
+                areas.push_back(other.area);
+            }
+        }
+    }
+    for (size_t p = 0; p < world.areaPortals.size(); ++p) {
+        BSPAreaPortal& portal = world.areaPortals[p];
+        std::sort(portal.areas.begin(), portal.areas.end());
+        for (int32_t area : portal.areas) {
+            world.areas[area].portals.push_back(static_cast<int32_t>(p));
+        }
+        if (portal.areas.size() < 2) {
+            LOG_WARNING("Area portal '" + portal.name + "' touches " + std::to_string(portal.areas.size()) +
+                        " area(s); the map leaks around it, so it won't cull anything");
+        }
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    LOG_INFO("Built " + std::to_string(world.areas.size()) + " areas from " +
+             std::to_string(world.areaPortals.size()) + " area portals (" +
+             std::to_string(leafPortals.size()) + " leaf portals, " + std::to_string(ms) + " ms)");
+}
+
+bool BSPTreeSystem::SetAreaPortalOpen(World& world, int32_t portal, bool open) {
+    if (portal < 0 || portal >= static_cast<int32_t>(world.areaPortals.size())) return false;
+    world.areaPortals[portal].open = open;
+    return true;
+}
+
+int32_t BSPTreeSystem::FindAreaPortal(const World& world, const std::string& name) const {
+    for (size_t i = 0; i < world.areaPortals.size(); ++i) {
+        if (world.areaPortals[i].name == name) return static_cast<int32_t>(i);
+    }
+    return -1;
+}
+
+void BSPTreeSystem::FloodAreas(const World& world, int32_t startArea, std::vector<uint8_t>& outConnected) const {
+    outConnected.assign(world.areas.size(), 0);
+    if (startArea < 0 || startArea >= static_cast<int32_t>(world.areas.size())) return;
+
+    std::vector<int32_t> stack;
+    stack.push_back(startArea);
+    outConnected[startArea] = 1;
+    while (!stack.empty()) {
+        int32_t area = stack.back();
+        stack.pop_back();
+        for (int32_t p : world.areas[area].portals) {
+            const BSPAreaPortal& portal = world.areaPortals[p];
+            if (!portal.open) continue;
+            for (int32_t next : portal.areas) {
+                if (outConnected[next]) continue;
+                outConnected[next] = 1;
+                stack.push_back(next);
+            }
+        }
     }
 }
 
 // === PVS AND CLUSTERING ===
 
+namespace {
+    // The area a leaf ties its cluster to. Only areas bounded by a portal matter:
+    // areas without one (pockets inside overlapping brushes, or a map that leaks
+    // around its portals) can never be opened or closed, so they merge freely.
+    int32_t ClusterAreaKey(const World& world, const BSPNode& leaf) {
+        if (leaf.contents == BSP_CONTENTS_AREAPORTAL) return -3;  // Only merges with other portal leaves
+        if (leaf.contents != BSP_CONTENTS_EMPTY || leaf.area < 0) return -1;
+        return world.areas[leaf.area].portals.empty() ? -1 : leaf.area;
+    }
+}
+
 void BSPTreeSystem::BuildClustersFromLeaves(World& world) {
     LOG_INFO("Building clusters from leaves");
 
-    // Collect all leaf nodes
-    std::vector<BSPNode*> leaves;
-    std::function<void(BSPNode*)> collectLeaves = [&](BSPNode* node) {
-        if (!node) return;
-        if (node->IsLeaf()) {
-            leaves.push_back(node);
-        } else {
-            collectLeaves(node->children[0]);
-            collectLeaves(node->children[1]);
+    world.clusters.clear();
+    world.clusterBounds.clear();
+    const int32_t nodeCount = static_cast<int32_t>(world.nodes.size());
+    if (nodeCount == 0) {
+        world.numClusters = 0;
+        world.clusterBytes = 0;
+        return;
+    }
+
+    // Per-subtree totals in one reverse pass (children always follow their
+    // parent in the pre-order array)
+    std::vector<int32_t> subtreeSize(nodeCount, 1);
+    std::vector<uint32_t> subtreeSurfaces(nodeCount, 0);
+    std::vector<uint8_t> structural(nodeCount, 0);   // Subtree contains a structural split
+    std::vector<int32_t> subtreeArea(nodeCount, -1); // Single area, -1 for none, -2 for several, -3 portal
+    size_t leafCount = 0;
+    for (int32_t i = nodeCount - 1; i >= 0; --i) {
+        const BSPNode& node = world.nodes[i];
+        if (node.IsLeaf()) {
+            subtreeSurfaces[i] = node.numSurfaces;
+            subtreeArea[i] = ClusterAreaKey(world, node);
+            world.nodes[i].cluster = -1;
+            leafCount++;
+            continue;
         }
-    };
-    collectLeaves(world.root);
+        int32_t front = node.children[0], back = node.children[1];
+        subtreeSize[i] = 1 + subtreeSize[front] + subtreeSize[back];
+        subtreeSurfaces[i] = subtreeSurfaces[front] + subtreeSurfaces[back];
+        structural[i] = (!world.planes[node.planeNum].detail || structural[front] || structural[back]) ? 1 : 0;
 
-    LOG_INFO("Found " + std::to_string(leaves.size()) + " leaves");
+        int32_t a = subtreeArea[front], b = subtreeArea[back];
+        subtreeArea[i] = a == -1 ? b : (b == -1 || b == a ? a : -2);
+    }
 
-    // Assign cluster IDs to leaves (simplified: each leaf is its own cluster for now)
-    world.numClusters = leaves.size();
-    for (size_t i = 0; i < leaves.size(); ++i) {
-        leaves[i]->cluster = static_cast<int>(i);
+    ClusterSubtree(world, subtreeSize, subtreeSurfaces, structural, subtreeArea, 0);
+
+    world.numClusters = static_cast<int>(world.clusters.size());
+    world.clusterBounds.reserve(world.clusters.size());
+    for (const BSPCluster& cluster : world.clusters) {
+        world.clusterBounds.push_back(cluster.bounds);
     }
 
     // Calculate cluster bytes for PVS (1 bit per cluster)
     world.clusterBytes = (world.numClusters + 7) / 8;
+
+    LOG_INFO("Merged " + std::to_string(leafCount) + " leaves into " +
+             std::to_string(world.numClusters) + " clusters");
 }
 
-void BSPTreeSystem::GeneratePVSData(World& world) {
-    LOG_INFO("Generating PVS data for " + std::to_string(world.numClusters) + " clusters");
+int32_t BSPTreeSystem::ClusterSubtree(World& world, const std::vector<int32_t>& subtreeSize,
+                                      const std::vector<uint32_t>& subtreeSurfaces,
+                                      const std::vector<uint8_t>& structural,
+                                      const std::vector<int32_t>& subtreeArea, int32_t nodeIndex) {
+    const BSPNode& node = world.nodes[nodeIndex];
+    if (node.IsLeaf()) {
+        // Solid leaves have no cluster
+        if (node.contents == BSP_CONTENTS_SOLID) return -1;
+        return MakeCluster(world, nodeIndex, 1);
+    }
+
+    // Take the whole subtree if it fits the budget. Subtrees cut only by detail
+    // planes always merge: detail geometry shouldn't fragment the vis structure.
+    // A cluster never spans two areas, or closing a portal couldn't hide it.
+    Vector3 size = Vector3Subtract(node.maxs, node.mins);
+    float volume = size.x * size.y * size.z;
+    if (subtreeArea[nodeIndex] != -2 &&
+        (!structural[nodeIndex] ||
+         (subtreeSurfaces[nodeIndex] <= clusterSettings_.maxSurfaces && volume <= clusterSettings_.maxVolume))) {
+        return MakeCluster(world, nodeIndex, subtreeSize[nodeIndex]);
+    }
 
-    // Allocate PVS data
-    size_t pvsSize = world.numClusters * world.clusterBytes;
-    world.visData.resize(pvsSize, 0);
+    // Empty leaves with no surfaces ("air" on the open side of a plane) join
+    // the cluster across that plane instead of getting a PVS row of their own
+    auto isAir = [&world](int32_t index) {
+        const BSPNode& n = world.nodes[index];
+        return n.IsLeaf() && n.contents == BSP_CONTENTS_EMPTY && n.numSurfaces == 0;
+    };
 
-    // For now, make all clusters visible to all others (no PVS culling)
-    // TODO: Implement proper portal-based PVS generation
-    for (int clusterA = 0; clusterA < world.numClusters; ++clusterA) {
-        for (int clusterB = 0; clusterB < world.numClusters; ++clusterB) {
-            // Set bit for clusterB in clusterA's PVS
-            int byteIndex = clusterA * world.clusterBytes + (clusterB / 8);
-            int bitIndex = clusterB % 8;
-            world.visData[byteIndex] |= (1 << bitIndex);
+    int32_t front = node.children[0], back = node.children[1];
+    int32_t first = -1;
+    if (!isAir(front)) first = ClusterSubtree(world, subtreeSize, subtreeSurfaces, structural, subtreeArea, front);
+    if (!isAir(back)) {
+        int32_t backFirst = ClusterSubtree(world, subtreeSize, subtreeSurfaces, structural, subtreeArea, back);
+        if (first < 0) first = backFirst;
+    }
+
+    for (int32_t child : {front, back}) {
+        if (!isAir(child)) continue;
+        int32_t key = ClusterAreaKey(world, world.nodes[child]);
+        if (first < 0 || (key != -1 && key != world.clusters[first].area)) {
+            int32_t own = MakeCluster(world, child, 1);
+            if (first < 0) first = own;
+        } else {
+            world.nodes[child].cluster = first;
+            world.clusters[first].leafNodes.push_back(child);
         }
     }
+    return first;
+}
+
+int32_t BSPTreeSystem::MakeCluster(World& world, int32_t headNode, int32_t numNodes) {
+    int32_t id = static_cast<int32_t>(world.clusters.size());
+    world.clusters.emplace_back();
+    BSPCluster& cluster = world.clusters.back();
+    cluster.id = id;
+    cluster.headNode = headNode;
+    cluster.numNodes = numNodes;
+
+    const BSPNode& head = world.nodes[headNode];
+    cluster.bounds = AABB(head.mins, head.maxs);
+
+    for (int32_t i = headNode; i < headNode + numNodes; ++i) {
+        BSPNode& leaf = world.nodes[i];
+        if (!leaf.IsLeaf() || leaf.contents == BSP_CONTENTS_SOLID) continue;
+
+        // Clusters without a portal-bounded area keep area -1: never area culled
+        leaf.cluster = id;
+        int32_t key = ClusterAreaKey(world, leaf);
+        if (key >= 0) cluster.area = key;
+        cluster.leafNodes.push_back(i);
+        if (leaf.numSurfaces == 0) continue;
+
+        const uint32_t* mark = world.markSurfaces.data() + leaf.firstSurface;
+        cluster.surfaces.insert(cluster.surfaces.end(), mark, mark + leaf.numSurfaces);
+    }
+    return id;
+}
+
+void BSPTreeSystem::GeneratePVSData(World& world) {
+    LOG_INFO("Generating PVS data for " + std::to_string(world.numClusters) + " clusters");
+
+    // Every cluster sees every other until vis is built from leaf portals.
+    // Sampled sight lines between clusters aren't conservative: a room seen
+    // through a doorway or down a corridor can miss every sample line and
+    // vanish while it is on screen. Culling falls back to areas and frustum.
+    size_t pvsSize = static_cast<size_t>(world.numClusters) * world.clusterBytes;
+    world.visData.assign(pvsSize, 0xFF);
 
     LOG_INFO("PVS data generated (" + std::to_string(pvsSize) + " bytes)");
 }
@@ -282,291 +1220,505 @@ const uint8_t* BSPTreeSystem::GetClusterPVS(const World& world, int cluster) con
 
 // === VISIBILITY MARKING ===
 
-void BSPTreeSystem::MarkLeaves(World& world, const Vector3& cameraPosition) {
+void BSPTreeSystem::MarkLeaves(World& world, const Vector3& cameraPosition, const Frustum* frustum) {
     visCount_++;
+    if (world.nodes.empty()) return;
 
-    // Find which leaf the camera is in
-    const BSPNode* cameraLeaf = FindLeafForPoint(world, cameraPosition);
-    if (!cameraLeaf || cameraLeaf->cluster < 0) {
-        // Camera not in a valid cluster, mark all nodes visible
-        std::function<void(BSPNode*)> markAllVisible = [&](BSPNode* node) {
-            if (!node) return;
-            node->visframe = visCount_;
-            if (!node->IsLeaf()) {
-                markAllVisible(node->children[0]);
-                markAllVisible(node->children[1]);
-            }
-        };
-        markAllVisible(world.root);
+    if (world.clusters.empty()) {
+        // No cluster data, mark all nodes visible
+        for (BSPNode& node : world.nodes) {
+            node.visframe = visCount_;
+        }
         return;
     }
 
-    int cameraCluster = cameraLeaf->cluster;
+    // Find which leaf the camera is in and get its PVS. Outside any cluster
+    // (inside solid) every cluster counts as potentially visible.
+    const BSPNode* cameraLeaf = FindLeafForPoint(world, cameraPosition);
+    const uint8_t* pvs = nullptr;
+    if (cameraLeaf && cameraLeaf->cluster >= 0) {
+        pvs = GetClusterPVS(world, cameraLeaf->cluster);
+    }
 
-    // Get PVS for camera cluster
-    const uint8_t* pvs = GetClusterPVS(world, cameraCluster);
-    if (!pvs) {
-        // No PVS data, mark all visible
-        std::function<void(BSPNode*)> markAllVisible = [&](BSPNode* node) {
-            if (!node) return;
-            node->visframe = visCount_;
-            if (!node->IsLeaf()) {
-                markAllVisible(node->children[0]);
-                markAllVisible(node->children[1]);
+    // Areas reachable from the camera through open portals. Inside a portal
+    // brush, both sides count.
+    bool areaCulling = false;
+    if (cameraLeaf && !world.areaPortals.empty()) {
+        if (cameraLeaf->contents == BSP_CONTENTS_EMPTY && cameraLeaf->area >= 0) {
+            FloodAreas(world, cameraLeaf->area, areaConnected_);
+            areaCulling = true;
+        } else if (cameraLeaf->contents == BSP_CONTENTS_AREAPORTAL) {
+            areaConnected_.assign(world.areas.size(), 0);
+            std::vector<uint8_t> reached;
+            for (int32_t area : world.areaPortals[cameraLeaf->area].areas) {
+                FloodAreas(world, area, reached);
+                for (size_t a = 0; a < reached.size(); ++a) areaConnected_[a] |= reached[a];
             }
-        };
-        markAllVisible(world.root);
-        return;
+            areaCulling = true;
+        }
     }
 
-    // Mark visible nodes (like Quake's R_MarkLeaves)
-    std::function<void(BSPNode*)> markVisibleNodes = [&](BSPNode* node) {
-        if (!node) return;
-        
-        // Check if this node is visible
-        if (node->IsLeaf()) {
-            // Check if leaf's cluster is visible
-            if (node->cluster >= 0 && node->cluster < world.numClusters) {
-                int byteIndex = node->cluster / 8;
-                int bitIndex = node->cluster % 8;
-                if (pvs[byteIndex] & (1 << bitIndex)) {
-                    // Mark path from this leaf to root
-                    BSPNode* current = node;
-                    while (current) {
-                        if (current->visframe == visCount_) break;
-                        current->visframe = visCount_;
-                        current = current->parent;
-                    }
-                }
-            }
-        } else {
-            // Recurse to children first
-            markVisibleNodes(node->children[0]);
-            markVisibleNodes(node->children[1]);
-
-            // If both children are marked, mark this node too
-            if ((node->children[0] && node->children[0]->visframe == visCount_) ||
-                (node->children[1] && node->children[1]->visframe == visCount_)) {
-                node->visframe = visCount_;
-            }
+    // Batch frustum test of all cluster bounds up front
+    const size_t clusterCount = world.clusters.size();
+    if (frustum) {
+        clusterInFrustum_.resize(clusterCount);
+        frustum->CullAABBs(world.clusterBounds.data(), clusterCount, clusterInFrustum_.data());
+    }
+
+    // Mark each surviving cluster's subtree (a contiguous node range) and the
+    // path up to the root, like Quake's R_MarkLeaves
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const BSPCluster& cluster = world.clusters[c];
+        if (cluster.surfaces.empty()) continue;
+        if (pvs && !(pvs[c >> 3] & (1 << (c & 7)))) continue;
+        if (areaCulling && cluster.area >= 0 && !areaConnected_[cluster.area]) continue;
+        if (frustum && !clusterInFrustum_[c]) continue;
+
+        BSPNode* nodes = world.nodes.data() + cluster.headNode;
+        for (int32_t i = 0; i < cluster.numNodes; ++i) {
+            nodes[i].visframe = visCount_;
         }
-    };
 
-    markVisibleNodes(world.root);
+        int32_t current = world.nodes[cluster.headNode].parent;
+        while (current >= 0) {
+            BSPNode& node = world.nodes[current];
+            if (node.visframe == visCount_) break;
+            node.visframe = visCount_;
+            current = node.parent;
+        }
+    }
 }
 
 // === RENDERING TRAVERSAL ===
 
-void BSPTreeSystem::TraverseForRendering(const World& world, const Camera3D& camera,
-                                       std::function<void(const Face& face)> faceCallback) {
-    if (!world.root) return;
+void BSPTreeSystem::TraverseForRendering(const World& world, const Frustum& frustum,
+                                       std::vector<const Face*>& outFaces) {
+    if (world.nodes.empty()) return;
 
-    Frustum frustum;
-    ExtractFrustumPlanes(frustum, camera);
+    // Explicit stack; depth is bounded by the compiler so a fixed array is enough.
+    // Each entry carries the frustum planes its parent wasn't fully inside.
+    struct StackEntry { int32_t node; uint32_t planeMask; };
+    StackEntry stack[BSP_MAX_DEPTH + 2];
+    int stackSize = 0;
+    stack[stackSize++] = {0, FRUSTUM_ALL_PLANES};
 
-    std::function<void(BSPNode*)> traverseNode = [&](BSPNode* node) {
-    if (!node) return;
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+        const BSPNode& node = world.nodes[entry.node];
 
         // PVS culling first
-        if (node->visframe != visCount_) return;
-
-        // TEMPORARILY DISABLE FRUSTUM CULLING FOR DEBUGGING
-        // Frustum culling - check against all 6 frustum planes
-        // bool isVisible = true;
-        // for (int i = 0; i < 6; ++i) {
-        //     int cullResult = BoxOnPlaneSide(node->mins, node->maxs, frustum.planes[i]);
-        //     if (cullResult == 2) { // Completely behind this plane
-        //         isVisible = false;
-        //         break;
-        //     }
-        // }
-        // if (!isVisible) return;
-
-    if (node->IsLeaf()) {
-            // Render all surfaces in this leaf
-            for (size_t surfaceIdx : node->surfaceIndices) {
-                if (surfaceIdx < world.surfaces.size()) {
-                    faceCallback(world.surfaces[surfaceIdx]);
-                }
+        if (node.visframe != visCount_) continue;
+
+        // Frustum culling against the remaining planes
+        uint32_t planeMask = entry.planeMask;
+        if (!frustum.TestAABB(node.mins, node.maxs, planeMask)) continue;
+
+        if (node.IsLeaf()) {
+            // Collect all surfaces in this leaf
+            const uint32_t* mark = world.markSurfaces.data() + node.firstSurface;
+            for (uint32_t i = 0; i < node.numSurfaces; ++i) {
+                outFaces.push_back(&world.surfaces[mark[i]]);
             }
-    } else {
-            // Recurse to children
-            traverseNode(node->children[0]);
-            traverseNode(node->children[1]);
+        } else {
+            // Back first so the front child is processed next (front-to-back order)
+            stack[stackSize++] = {node.children[1], planeMask};
+            stack[stackSize++] = {node.children[0], planeMask};
         }
-    };
+    }
+}
 
-    traverseNode(world.root);
+void BSPTreeSystem::GetVisibleClusters(const World& world, std::vector<uint8_t>& outVisible) const {
+    // Clusters are disjoint subtrees, so a cluster's head node is only marked
+    // when MarkLeaves kept that cluster
+    outVisible.assign(world.clusters.size(), 0);
+    for (size_t c = 0; c < world.clusters.size(); ++c) {
+        int32_t head = world.clusters[c].headNode;
+        if (head >= 0 && static_cast<size_t>(head) < world.nodes.size()) {
+            outVisible[c] = world.nodes[head].visframe == visCount_ ? 1 : 0;
+        }
+    }
 }
 
 // === UTILITY FUNCTIONS ===
 
 const BSPNode* BSPTreeSystem::FindLeafForPoint(const World& world, const Vector3& point) const {
-    BSPNode* node = world.root;
+    if (world.nodes.empty()) return nullptr;
 
-    while (node && !node->IsLeaf()) {
+    int32_t index = 0;
+    while (!world.nodes[index].IsLeaf()) {
         // Determine which side of the plane the point is on
-        // For now, use a simple heuristic since we don't store plane equations
-        // TODO: Store plane equations in nodes
-        float dist = 0.0f; // Would compute signed distance to plane
+        const BSPNode& node = world.nodes[index];
+        const BSPPlane& plane = world.planes[node.planeNum];
+        float dist = Vector3DotProduct(plane.normal, point) - plane.dist;
 
-        if (dist >= 0) {
-            node = node->children[0];
-        } else {
-            node = node->children[1];
-        }
+        index = dist >= 0 ? node.children[0] : node.children[1];
     }
 
-    return node;
+    return &world.nodes[index];
 }
 
-// === TEMPORARY LEGACY METHODS (for compatibility) ===
+// === TRACES ===
+
+namespace {
 
-float BSPTreeSystem::CastRay(const BSPTree& bspTree, const Vector3& rayOrigin, const Vector3& rayDirection, float maxDistance) const {
-    // TODO: Implement proper ray casting for legacy BSPTree
-    return maxDistance; // No hit
+// Slack in world units: how far a hit may sit outside the leaf span being
+// tested (surfaces lie on leaf boundaries) and how far outside a polygon edge
+// a hit still counts
+constexpr float TRACE_EPSILON = 0.001f;
+
+// Hits closer than this to either end of a line of sight test are ignored
+constexpr float LINE_OF_SIGHT_EPSILON = 0.01f;
+
+struct TraceSpan {
+    int32_t node;
+    float t0;
+    float t1;
+};
+
+// Segment (start + delta * t) against one convex surface, t within [tMin, tMax]
+bool TraceSurface(const Face& face, const Vector3& start, const Vector3& delta,
+                  float tMin, float tMax, float& outT) {
+    const size_t count = face.vertices.size();
+    if (count < 3) return false;
+
+    float denom = Vector3DotProduct(face.normal, delta);
+    if (std::fabs(denom) < 1e-8f) return false;
+    float t = Vector3DotProduct(face.normal, Vector3Subtract(face.vertices[0], start)) / denom;
+    if (t < tMin || t > tMax) return false;
+
+    // Inside when the point is on the same side of every edge. Either winding
+    // is accepted, the map doesn't guarantee one relative to the normal.
+    Vector3 p = Vector3Add(start, Vector3Scale(delta, t));
+    bool anyPositive = false, anyNegative = false;
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3& a = face.vertices[i];
+        const Vector3& b = face.vertices[(i + 1) % count];
+        Vector3 edge = Vector3Subtract(b, a);
+        float side = Vector3DotProduct(Vector3CrossProduct(edge, Vector3Subtract(p, a)), face.normal);
+        float slack = TRACE_EPSILON * Vector3Length(edge);
+        if (side > slack) anyPositive = true;
+        else if (side < -slack) anyNegative = true;
+        if (anyPositive && anyNegative) return false;
+    }
+
+    outT = t;
+    return true;
 }
 
-bool BSPTreeSystem::ContainsPoint(const BSPTree& bspTree, const Vector3& point) const {
-    // TODO: Implement proper point containment for legacy BSPTree
+// Front-to-back walk along the segment. Each stack entry is a node and the
+// part of the segment [t0, t1] inside it; the side holding the segment start
+// is visited first, so leaves come out in segment order. Returns at the first
+// leaf with a hit (the closest hit in it), or immediately when anyHit is set.
+// Hits outside [tLimit0, tLimit1] are ignored.
+bool TraceWorld(const World& world, const Vector3& start, const Vector3& end,
+                FaceFlags mask, FaceFlags ignore, bool anyHit,
+                float tLimit0, float tLimit1, float& outT, int32_t& outSurface) {
+    if (world.nodes.empty()) return false;
+
+    const Vector3 delta = Vector3Subtract(end, start);
+    const float length = Vector3Length(delta);
+    if (length < 1e-6f) return false;
+    const float tSlack = TRACE_EPSILON / length;
+
+    TraceSpan stack[BSP_MAX_DEPTH + 1];
+    int top = 0;
+    stack[top++] = {0, 0.0f, 1.0f};
+
+    while (top > 0) {
+        TraceSpan span = stack[--top];
+        const BSPNode* node = &world.nodes[span.node];
+
+        // Descend to a leaf, pushing far sides as the segment crosses planes
+        while (!node->IsLeaf()) {
+            const BSPPlane& plane = world.planes[node->planeNum];
+            float ds = Vector3DotProduct(plane.normal, start) - plane.dist;
+            float de = Vector3DotProduct(plane.normal, end) - plane.dist;
+            float d0 = ds + (de - ds) * span.t0;
+            float d1 = ds + (de - ds) * span.t1;
+
+            if (d0 >= 0.0f && d1 >= 0.0f) {
+                span.node = node->children[0];
+            } else if (d0 < 0.0f && d1 < 0.0f) {
+                span.node = node->children[1];
+            } else {
+                float tSplit = std::clamp(ds / (ds - de), span.t0, span.t1);
+                int nearSide = d0 >= 0.0f ? 0 : 1;
+                if (top < BSP_MAX_DEPTH + 1) {
+                    stack[top++] = {node->children[nearSide ^ 1], tSplit, span.t1};
+                }
+                span.node = node->children[nearSide];
+                span.t1 = tSplit;
+            }
+            node = &world.nodes[span.node];
+        }
+
+        const float tMin = std::max(span.t0 - tSlack, tLimit0);
+        const float tMax = std::min(span.t1 + tSlack, tLimit1);
+        if (tMin > tMax) continue;
+
+        bool found = false;
+        float bestT = tMax;
+        for (uint32_t i = 0; i < node->numSurfaces; ++i) {
+            uint32_t surfaceIndex = world.markSurfaces[node->firstSurface + i];
+            const Face& face = world.surfaces[surfaceIndex];
+            if (mask != FaceFlags::None && !HasFlag(face.flags, mask)) continue;
+            if (HasFlag(face.flags, ignore)) continue;
+
+            float t;
+            if (!TraceSurface(face, start, delta, tMin, bestT, t)) continue;
+            found = true;
+            bestT = t;
+            outSurface = static_cast<int32_t>(surfaceIndex);
+            if (anyHit) break;
+        }
+        if (found) {
+            outT = bestT;
+            return true;
+        }
+    }
     return false;
 }
 
-// === FRUSTUM CULLING IMPLEMENTATION ===
-
-void BSPTreeSystem::ExtractFrustumPlanes(Frustum& frustum, const Camera3D& camera) const {
-    // Based on Quake 3's R_SetupFrustum
-    float angle = camera.fovy * DEG2RAD * 0.5f;
-    float tang = tanf(angle);
-    float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
-
-    float nearHeight = tang * 0.1f; // Near plane distance (like raylib default)
-    float nearWidth = nearHeight * aspect;
-
-    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
-    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
-    Vector3 up = Vector3CrossProduct(right, forward);
-
-    Vector3 nearCenter = Vector3Add(camera.position, Vector3Scale(forward, 0.1f)); // Near plane at 0.1 units
-
-    // Left plane
-    Vector3 leftNormal = Vector3Normalize(Vector3Add(
-        Vector3Scale(forward, nearWidth),
-        Vector3Scale(right, -1.0f)
-    ));
-    frustum.planes[0].normal = leftNormal;
-    frustum.planes[0].dist = -Vector3DotProduct(leftNormal, Vector3Add(nearCenter, Vector3Scale(right, -nearWidth)));
-
-    // Right plane
-    Vector3 rightNormal = Vector3Normalize(Vector3Add(
-        Vector3Scale(forward, -nearWidth),
-        right
-    ));
-    frustum.planes[1].normal = rightNormal;
-    frustum.planes[1].dist = -Vector3DotProduct(rightNormal, Vector3Add(nearCenter, Vector3Scale(right, nearWidth)));
-
-    // Bottom plane
-    Vector3 bottomNormal = Vector3Normalize(Vector3Add(
-        Vector3Scale(forward, nearHeight),
-        Vector3Scale(up, -1.0f)
-    ));
-    frustum.planes[2].normal = bottomNormal;
-    frustum.planes[2].dist = -Vector3DotProduct(bottomNormal, Vector3Add(nearCenter, Vector3Scale(up, -nearHeight)));
-
-    // Top plane
-    Vector3 topNormal = Vector3Normalize(Vector3Add(
-        Vector3Scale(forward, -nearHeight),
-        up
-    ));
-    frustum.planes[3].normal = topNormal;
-    frustum.planes[3].dist = -Vector3DotProduct(topNormal, Vector3Add(nearCenter, Vector3Scale(up, nearHeight)));
-
-    // Near plane
-    frustum.planes[4].normal = forward;
-    frustum.planes[4].dist = -Vector3DotProduct(forward, nearCenter);
-
-    // Far plane
-    frustum.planes[5].normal = Vector3Scale(forward, -1.0f);
-    frustum.planes[5].dist = -Vector3DotProduct(Vector3Scale(forward, -1.0f),
-                                               Vector3Add(camera.position, Vector3Scale(forward, farClipDistance_)));
-
-    // Set signbits for optimization
-    for (int i = 0; i < 6; i++) {
-        SetPlaneSignbits(frustum.planes[i]);
-    }
-}
-
-void BSPTreeSystem::SetPlaneSignbits(FrustumPlane& plane) const {
-    // Based on Quake 3's BoxOnPlaneSide optimization
-    plane.signbits = 0;
-    if (plane.normal.x < 0) plane.signbits |= 1;
-    if (plane.normal.y < 0) plane.signbits |= 2;
-    if (plane.normal.z < 0) plane.signbits |= 4;
-
-    // Determine axial type
-    if (plane.normal.x == 1.0f || plane.normal.x == -1.0f) plane.type = 0; // X axis
-    else if (plane.normal.y == 1.0f || plane.normal.y == -1.0f) plane.type = 1; // Y axis
-    else if (plane.normal.z == 1.0f || plane.normal.z == -1.0f) plane.type = 2; // Z axis
-    else plane.type = 3; // Non-axial
-}
-
-int BSPTreeSystem::BoxOnPlaneSide(const Vector3& mins, const Vector3& maxs, const FrustumPlane& plane) const {
-    // Based on Quake 3's BoxOnPlaneSide function
-    float dist1, dist2;
-    int sides = 0;
-
-    // Fast axial cases
-    switch (plane.type) {
-        case 0: // Axial X
-            dist1 = plane.normal.x * mins.x + plane.dist;
-            dist2 = plane.normal.x * maxs.x + plane.dist;
-            break;
-        case 1: // Axial Y
-            dist1 = plane.normal.y * mins.y + plane.dist;
-            dist2 = plane.normal.y * maxs.y + plane.dist;
-            break;
-        case 2: // Axial Z
-            dist1 = plane.normal.z * mins.z + plane.dist;
-            dist2 = plane.normal.z * maxs.z + plane.dist;
-            break;
-        default: // General case
-            // Use the signbits to optimize
-            if (plane.signbits & 1) dist1 = plane.normal.x * maxs.x + plane.normal.y * mins.y + plane.normal.z * mins.z + plane.dist;
-            else dist1 = plane.normal.x * mins.x + plane.normal.y * mins.y + plane.normal.z * mins.z + plane.dist;
+// Swept box (center start + delta * t) against one convex surface by
+// separating axes: the surface normal, the box axes and every edge crossed
+// with every box axis. Each axis gives the span of t over which the
+// projections overlap; box and surface touch where all spans overlap. Returns
+// false if they never touch in (0, tMax]. outNormal is the axis of first
+// contact facing the box, outSpeed the approach speed along it.
+bool SweepBoxSurface(const Face& face, const Vector3& start, const Vector3& delta, const Vector3& halfExtents,
+                     float tMax, float& outEnter, float& outExit, Vector3& outNormal, float& outSpeed) {
+    const size_t count = face.vertices.size();
+    if (count < 3) return false;
+
+    float enter = -FLT_MAX, exit = FLT_MAX;
+    auto testAxis = [&](Vector3 axis) -> bool {
+        float lengthSq = Vector3DotProduct(axis, axis);
+        if (lengthSq < 1e-10f) return true; // Edge parallel to a box axis
+        axis = Vector3Scale(axis, 1.0f / sqrtf(lengthSq));
+
+        float radius = std::fabs(axis.x) * halfExtents.x + std::fabs(axis.y) * halfExtents.y +
+                       std::fabs(axis.z) * halfExtents.z;
+        float pMin = FLT_MAX, pMax = -FLT_MAX;
+        for (const Vector3& v : face.vertices) {
+            float d = Vector3DotProduct(axis, v);
+            pMin = std::min(pMin, d);
+            pMax = std::max(pMax, d);
+        }
 
-            if (plane.signbits & 2) dist2 = plane.normal.x * mins.x + plane.normal.y * maxs.y + plane.normal.z * mins.z + plane.dist;
-            else dist2 = plane.normal.x * mins.x + plane.normal.y * mins.y + plane.normal.z * mins.z + plane.dist;
+        // Overlapping while lo < speed * t < hi
+        float center = Vector3DotProduct(axis, start);
+        float speed = Vector3DotProduct(axis, delta);
+        float lo = pMin - radius - center;
+        float hi = pMax + radius - center;
+        if (std::fabs(speed) < 1e-9f) return lo < 0.0f && hi > 0.0f;
+
+        float tA = lo / speed, tB = hi / speed;
+        if (tA > tB) std::swap(tA, tB);
+        if (tA > enter) {
+            enter = tA;
+            outNormal = speed > 0.0f ? Vector3Negate(axis) : axis;
+            outSpeed = std::fabs(speed);
+        }
+        exit = std::min(exit, tB);
+        return enter < exit && enter <= tMax && exit > 0.0f;
+    };
 
-            if (plane.signbits & 4) dist2 += plane.normal.z * (maxs.z - mins.z);
-            else dist1 += plane.normal.z * (maxs.z - mins.z);
-            break;
+    // Normal first so it wins ties with a box axis (axial faces)
+    if (!testAxis(face.normal)) return false;
+    const Vector3 boxAxes[3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    for (const Vector3& axis : boxAxes) {
+        if (!testAxis(axis)) return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        Vector3 edge = Vector3Subtract(face.vertices[(i + 1) % count], face.vertices[i]);
+        for (const Vector3& axis : boxAxes) {
+            if (!testAxis(Vector3CrossProduct(edge, axis))) return false;
+        }
     }
 
-    if (dist1 >= 0) sides = 1;
-    if (dist2 < 0) sides |= 2;
+    outEnter = enter;
+    outExit = exit;
+    return true;
+}
 
-    return sides;
+// Part of [t0, t1] where a + b * t >= 0
+bool ClipSpan(float a, float b, float t0, float t1, float& out0, float& out1) {
+    out0 = t0;
+    out1 = t1;
+    if (std::fabs(b) < 1e-12f) return a >= 0.0f;
+    float t = -a / b;
+    if (b > 0.0f) out0 = std::max(t0, t);
+    else out1 = std::min(t1, t);
+    return out0 <= out1;
 }
 
-bool BSPTreeSystem::IsAABBVisibleInFrustum(const Vector3& mins, const Vector3& maxs, const Frustum& frustum) const {
-    // Test AABB against all 6 frustum planes
-    for (int i = 0; i < 6; ++i) {
-        int result = BoxOnPlaneSide(mins, maxs, frustum.planes[i]);
-        if (result == 2) { // Completely behind this plane
-            return false;
+// Earliest contact of a box trace so far
+struct BoxTraceState {
+    float bestEnter = 1.0f;
+    float bestSpeed = 0.0f;
+    Vector3 bestNormal{0, 0, 0};
+    int32_t bestSurface = -1;
+};
+
+// Sweeps the box against a list of surfaces, keeping the earliest contact in
+// state. Returns true when the box is stuck (allSolid, result filled in).
+bool SweepBoxSurfaces(const World& world, const uint32_t* surfaces, size_t count, const Vector3& start,
+                      const Vector3& delta, const Vector3& halfExtents, FaceFlags mask, FaceFlags ignore,
+                      BoxTraceState& state, BSPTraceResult& result) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t surfaceIndex = surfaces[i];
+        const Face& face = world.surfaces[surfaceIndex];
+        if (mask != FaceFlags::None && !HasFlag(face.flags, mask)) continue;
+        if (HasFlag(face.flags, ignore)) continue;
+
+        float enter, exit, speed = 0.0f;
+        Vector3 normal{0, 0, 0};
+        if (!SweepBoxSurface(face, start, delta, halfExtents, state.bestEnter, enter, exit, normal, speed)) continue;
+
+        if (enter < 0.0f) {
+            // Overlapping at the start: free to move off the surface, but
+            // stuck if the whole move stays overlapped
+            result.startSolid = true;
+            if (exit > 1.0f) {
+                result.hit = true;
+                result.allSolid = true;
+                result.fraction = 0.0f;
+                result.point = start;
+                result.surface = static_cast<int32_t>(surfaceIndex);
+                result.materialId = face.materialId;
+                return true;
+            }
+            continue;
+        }
+
+        if (state.bestSurface < 0 || enter < state.bestEnter) {
+            state.bestEnter = enter;
+            state.bestSpeed = speed;
+            state.bestNormal = normal;
+            state.bestSurface = static_cast<int32_t>(surfaceIndex);
         }
     }
-    return true; // AABB is visible (not completely behind any plane)
+    return false;
 }
 
-bool BSPTreeSystem::TestClusterVisibility(const World& world, int clusterA, int clusterB) const {
-    // For now, implement simple visibility: all clusters can see each other
-    // TODO: Implement proper PVS checking
+bool FinishBoxTrace(const World& world, const Vector3& start, const Vector3& delta, const BoxTraceState& state,
+                    BSPTraceResult& result) {
+    if (state.bestSurface < 0) return false;
+
+    // Back off along the contact normal, not the move, so the gap is the same
+    // however shallow the approach
+    result.hit = true;
+    result.fraction = state.bestSpeed > 0.0f ? std::max(0.0f, state.bestEnter - BSP_TRACE_SKIN / state.bestSpeed) : 0.0f;
+    result.point = Vector3Add(start, Vector3Scale(delta, result.fraction));
+    result.normal = state.bestNormal;
+    result.surface = state.bestSurface;
+    result.materialId = world.surfaces[state.bestSurface].materialId;
     return true;
 }
 
-bool BSPTreeSystem::TestLineOfSight(const World& world, const Vector3& start, const Vector3& end) const {
-    // TODO: Implement proper line-of-sight testing through BSP tree
-    // For now, always return true
+} // namespace
+
+bool BSPTreeSystem::TraceLine(const World& world, const Vector3& start, const Vector3& end,
+                              BSPTraceResult& result, FaceFlags mask, FaceFlags ignore) const {
+    result = BSPTraceResult{};
+
+    float t;
+    int32_t surface;
+    if (!TraceWorld(world, start, end, mask, ignore, false, 0.0f, 1.0f, t, surface)) {
+        result.point = end;
+        return false;
+    }
+
+    const Face& face = world.surfaces[surface];
+    Vector3 delta = Vector3Subtract(end, start);
+    result.hit = true;
+    result.fraction = t;
+    result.point = Vector3Add(start, Vector3Scale(delta, t));
+    result.normal = Vector3DotProduct(face.normal, delta) > 0.0f ? Vector3Negate(face.normal) : face.normal;
+    result.surface = surface;
+    result.materialId = face.materialId;
     return true;
 }
+
+bool BSPTreeSystem::TraceAnyHit(const World& world, const Vector3& start, const Vector3& end,
+                                FaceFlags mask, FaceFlags ignore) const {
+    float length = Vector3Distance(start, end);
+    if (length <= 2.0f * LINE_OF_SIGHT_EPSILON) return false;
+    float tEdge = LINE_OF_SIGHT_EPSILON / length;
+
+    float t;
+    int32_t surface;
+    return TraceWorld(world, start, end, mask, ignore, true, tEdge, 1.0f - tEdge, t, surface);
+}
+
+bool BSPTreeSystem::TraceBox(const World& world, const Vector3& start, const Vector3& end, const Vector3& halfExtents,
+                             BSPTraceResult& result, FaceFlags mask, FaceFlags ignore) const {
+    result = BSPTraceResult{};
+    result.point = end;
+    if (world.nodes.empty()) return false;
+
+    const Vector3 delta = Vector3Subtract(end, start);
+    BoxTraceState state;
+
+    // Each leaf is reached once, but spans overlap by the box size, so leaves
+    // don't come out strictly in order: keep the earliest hit and skip spans
+    // that start after it
+    TraceSpan stack[BSP_MAX_DEPTH + 2];
+    int top = 0;
+    stack[top++] = {0, 0.0f, 1.0f};
+
+    while (top > 0) {
+        TraceSpan span = stack[--top];
+        if (span.t0 > state.bestEnter) continue;
+        const BSPNode& node = world.nodes[span.node];
+
+        if (!node.IsLeaf()) {
+            // Positions whose box reaches the front half space (d >= -offset)
+            // and the back half space (d <= offset)
+            const BSPPlane& plane = world.planes[node.planeNum];
+            float offset = std::fabs(plane.normal.x) * halfExtents.x + std::fabs(plane.normal.y) * halfExtents.y +
+                           std::fabs(plane.normal.z) * halfExtents.z + TRACE_EPSILON;
+            float ds = Vector3DotProduct(plane.normal, start) - plane.dist;
+            float slope = Vector3DotProduct(plane.normal, end) - plane.dist - ds;
+
+            float f0, f1, b0, b1;
+            bool front = ClipSpan(ds + offset, slope, span.t0, span.t1, f0, f1);
+            bool back = ClipSpan(offset - ds, -slope, span.t0, span.t1, b0, b1);
+            bool frontFirst = ds + slope * span.t0 >= 0.0f;
+
+            // Far side first so the near side pops next
+            if (top + 2 > BSP_MAX_DEPTH + 2) continue;
+            if (frontFirst) {
+                if (back) stack[top++] = {node.children[1], b0, b1};
+                if (front) stack[top++] = {node.children[0], f0, f1};
+            } else {
+                if (front) stack[top++] = {node.children[0], f0, f1};
+                if (back) stack[top++] = {node.children[1], b0, b1};
+            }
+            continue;
+        }
+
+        if (SweepBoxSurfaces(world, &world.markSurfaces[node.firstSurface], node.numSurfaces, start, delta,
+                             halfExtents, mask, ignore, state, result)) {
+            return true;
+        }
+    }
+
+    return FinishBoxTrace(world, start, delta, state, result);
+}
+
+bool BSPTreeSystem::TraceBoxSurfaces(const World& world, const std::vector<uint32_t>& surfaces, const Vector3& start,
+                                     const Vector3& end, const Vector3& halfExtents, BSPTraceResult& result,
+                                     FaceFlags mask, FaceFlags ignore) const {
+    result = BSPTraceResult{};
+    result.point = end;
+
+    const Vector3 delta = Vector3Subtract(end, start);
+    BoxTraceState state;
+    if (SweepBoxSurfaces(world, surfaces.data(), surfaces.size(), start, delta, halfExtents, mask, ignore, state,
+                         result)) {
+        return true;
+    }
+    return FinishBoxTrace(world, start, delta, state, result);
+}
+
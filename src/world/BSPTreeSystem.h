@@ -14,23 +14,74 @@
 #include "BSPTree.h"
 #include "WorldGeometry.h" // For World struct
 #include "../math/AABB.h"
+#include "../math/Frustum.h"
 #include "../ecs/System.h"
 
 // Forward declarations
 struct BSPNode;
 
-// Frustum plane for culling (like Quake 3's cplane_s)
-struct FrustumPlane {
-    Vector3 normal;
-    float dist;
-    int type;        // For axial plane optimization
-    int signbits;    // For fast distance calculation
+// BSP compile scratch types (defined in BSPTreeSystem.cpp)
+struct BSPFragment;
+struct BSPBuildNode;
+struct BSPBuildContext;
+class BSPFragmentArena;
+
+// How BSPTreeSystem picks the splitting plane at each node
+enum class BSPSplitterMode {
+    FirstCandidate,   // First unused face plane (input-order dependent, for comparison)
+    CostDriven        // Score candidate planes and take the cheapest
+};
+
+// Tunable cost terms for BSPSplitterMode::CostDriven (lower cost wins)
+struct BSPSplitterWeights {
+    float splitWeight = 5.0f;      // Per face cut by the plane
+    float balanceWeight = 1.0f;    // Per face of |front - back| imbalance
+    float coplanarWeight = 2.0f;   // Bonus per face lying on the plane (consumed at this node)
+    float axialBonus = 5.0f;       // Bonus for axis-aligned planes (cheap tests, clean splits)
+    size_t sampleThreshold = 64;   // Above this many candidate planes, score a sample
+    size_t sampleCount = 32;       // Evenly strided sample size (deterministic)
 };
 
-// Complete frustum with 6 planes
-struct Frustum {
-    FrustumPlane planes[6]; // left, right, bottom, top, near, far
-    int numPlanes = 6;
+// Budgets for merging leaves into vis clusters. A subtree becomes one cluster
+// once it fits both budgets; subtrees split only by detail planes always merge.
+struct BSPClusterSettings {
+    size_t maxSurfaces = 48;        // Surfaces per cluster
+    float maxVolume = 2048.0f;      // Surface bounds volume per cluster (world units^3)
+};
+
+// Statistics from the last BSP compile
+struct BSPBuildStats {
+    size_t inputFaces = 0;
+    size_t nodeCount = 0;       // Internal nodes + leaves
+    size_t leafCount = 0;
+    size_t fragmentCount = 0;   // Surfaces after splitting
+    size_t splitCount = 0;      // Faces cut by a splitter
+    size_t mergedFaces = 0;     // Input faces removed by the coplanar merge
+    size_t tJunctionVertices = 0; // Vertices inserted into surface edges
+    size_t occluderCount = 0;   // Surfaces picked for occlusion culling
+    int maxDepth = 0;
+    unsigned int threadCount = 1;
+    double mergeMs = 0.0;       // Coplanar merge and T-junction fixing
+    double buildMs = 0.0;       // Tree build (splitting and node emission)
+    double areasMs = 0.0;       // Area flood and portal classification
+    double clustersMs = 0.0;    // Leaf clustering
+    double pvsMs = 0.0;         // PVS generation
+};
+
+// Gap a box trace leaves between the box and the surface it stopped at, so
+// the next trace from there doesn't start touching it (DIST_EPSILON)
+constexpr float BSP_TRACE_SKIN = 0.002f;
+
+// Result of a segment or swept box trace against the world surfaces (trace_t)
+struct BSPTraceResult {
+    bool hit = false;
+    bool startSolid = false;      // Box traces: the box overlaps a surface at the start
+    bool allSolid = false;        // Box traces: the box overlaps a surface for the whole move (fraction 0)
+    float fraction = 1.0f;        // Hit position along the segment (0 = start, 1 = end)
+    Vector3 point{0, 0, 0};       // Segment point at fraction (the box center for box traces)
+    Vector3 normal{0, 0, 0};      // Contact plane normal, facing the trace start
+    int32_t surface = -1;         // Index into world->surfaces
+    int materialId = -1;
 };
 
 
@@ -47,61 +98,142 @@ public:
     void Shutdown() override;
 
     // === QUAKE-STYLE WORLD LOADING ===
-    // Load and build world from parsed map data
-    std::unique_ptr<World> LoadWorld(const std::vector<Face>& faces);
+    // Load and build world from parsed map data. Area portal brushes split the
+    // world into areas that MarkLeaves can close off at runtime.
+    std::unique_ptr<World> LoadWorld(const std::vector<Face>& faces,
+                                     const std::vector<BSPAreaPortalBrush>& areaPortals = {});
 
     // === QUAKE-STYLE VISIBILITY SYSTEM ===
 
-    // Mark leaves visible from current camera position (R_MarkLeaves equivalent)
-    void MarkLeaves(World& world, const Vector3& cameraPosition);
+    // Mark leaves visible from current camera position (R_MarkLeaves equivalent).
+    // Works per cluster: PVS row first, then the areas reachable through open
+    // area portals, then (if given) a batch frustum test of cluster bounds, then
+    // the surviving clusters' subtrees and their ancestors are marked.
+    void MarkLeaves(World& world, const Vector3& cameraPosition, const Frustum* frustum = nullptr);
+
+    // Traverse world and collect visible surfaces (R_RecursiveWorldNode equivalent).
+    // Iterative over the flat node array with hierarchical frustum culling: planes
+    // a node is fully inside are dropped for its whole subtree. Appends to outFaces.
+    void TraverseForRendering(const World& world, const Frustum& frustum,
+                            std::vector<const Face*>& outFaces);
+
+    // Clusters marked by the last MarkLeaves (outVisible[c] != 0), for drawing
+    // the static batches' per-cluster index ranges
+    void GetVisibleClusters(const World& world, std::vector<uint8_t>& outVisible) const;
 
-    // Traverse world and render visible surfaces (R_RecursiveWorldNode equivalent)
-    void TraverseForRendering(const World& world, const Camera3D& camera,
-                            std::function<void(const Face& face)> faceCallback);
+    // === AREA PORTALS ===
+
+    // Open or close an area portal (doors). Returns false for an unknown portal.
+    bool SetAreaPortalOpen(World& world, int32_t portal, bool open);
+    int32_t FindAreaPortal(const World& world, const std::string& name) const;
+
+    // Flood from an area through open portals; outConnected[a] != 0 for every
+    // area reachable from startArea (including itself)
+    void FloodAreas(const World& world, int32_t startArea, std::vector<uint8_t>& outConnected) const;
 
     // === UTILITY FUNCTIONS ===
 
     // Find which leaf contains a point (R_PointInLeaf equivalent)
     const BSPNode* FindLeafForPoint(const World& world, const Vector3& point) const;
 
-    // TEMPORARY: Legacy methods for compatibility during transition
-    float CastRay(const BSPTree& bspTree, const Vector3& rayOrigin, const Vector3& rayDirection, float maxDistance = 1000.0f) const;
-    bool ContainsPoint(const BSPTree& bspTree, const Vector3& point) const;
+    // === TRACES ===
+
+    // Closest surface hit along the segment start -> end. Walks the tree front
+    // to back along the segment and stops at the first leaf with a hit, so cost
+    // grows with the leaves crossed rather than the surface count. Only
+    // surfaces with one of the mask flags count (None = every surface);
+    // surfaces with any of the ignore flags never do.
+    bool TraceLine(const World& world, const Vector3& start, const Vector3& end, BSPTraceResult& result,
+                   FaceFlags mask = FaceFlags::None, FaceFlags ignore = FaceFlags::None) const;
+
+    // True if any surface blocks the segment (line of sight). Hits touching
+    // either endpoint are ignored, so points lying on a surface still see out.
+    bool TraceAnyHit(const World& world, const Vector3& start, const Vector3& end,
+                     FaceFlags mask = FaceFlags::None, FaceFlags ignore = FaceFlags::None) const;
+
+    // Sweep an axis-aligned box (center start -> end) through the world
+    // (CM_BoxTrace). Node planes are pushed out by the box extents while
+    // descending, so only leaves the swept box can touch are tested. The box
+    // stops BSP_TRACE_SKIN short of the contact plane. A box that starts
+    // overlapping a surface may move off it; one that would stay overlapped
+    // for the whole move is allSolid and doesn't move.
+    bool TraceBox(const World& world, const Vector3& start, const Vector3& end, const Vector3& halfExtents,
+                  BSPTraceResult& result, FaceFlags mask = FaceFlags::None, FaceFlags ignore = FaceFlags::None) const;
+    // TraceBox against a given list of surfaces (indices into world.surfaces)
+    // instead of walking the tree, e.g. candidates gathered once for several
+    // traces in the same spot. Same contact rules as TraceBox.
+    bool TraceBoxSurfaces(const World& world, const std::vector<uint32_t>& surfaces, const Vector3& start,
+                          const Vector3& end, const Vector3& halfExtents, BSPTraceResult& result,
+                          FaceFlags mask = FaceFlags::None, FaceFlags ignore = FaceFlags::None) const;
+
+    // === BUILD SETTINGS ===
+
+    // Build front/back subtrees as parallel jobs (output is identical either way)
+    void SetParallelBuild(bool enabled) { parallelBuild_ = enabled; }
+    bool IsParallelBuild() const { return parallelBuild_; }
+    const BSPBuildStats& GetLastBuildStats() const { return lastBuildStats_; }
+
+    // Merge coplanar, same-surface faces before the build and fix T-junctions
+    // in the compiled surfaces (see FaceMerge)
+    void SetFaceMerging(bool enabled) { mergeFaces_ = enabled; }
+    bool IsFaceMerging() const { return mergeFaces_; }
+
+    void SetClusterSettings(const BSPClusterSettings& settings) { clusterSettings_ = settings; }
+    const BSPClusterSettings& GetClusterSettings() const { return clusterSettings_; }
+
+    void SetSplitterMode(BSPSplitterMode mode) { splitterMode_ = mode; }
+    BSPSplitterMode GetSplitterMode() const { return splitterMode_; }
+    void SetSplitterWeights(const BSPSplitterWeights& weights) { splitterWeights_ = weights; }
+    const BSPSplitterWeights& GetSplitterWeights() const { return splitterWeights_; }
+
+    // Comparison mode: build the same faces with every splitter mode and report
+    // depth, node count and fragment count for each. Doesn't touch any loaded world.
+    std::vector<std::pair<BSPSplitterMode, BSPBuildStats>> CompareSplitterModes(const std::vector<Face>& faces);
+    static const char* GetSplitterModeName(BSPSplitterMode mode);
 
 private:
     // === BSP CONSTRUCTION (Quake-style) ===
-    std::unique_ptr<BSPNode> BuildBSPTree(const std::vector<Face>& faces, std::vector<Face>& outSurfaces);
+    bool BuildBSPTree(const std::vector<Face>& faces, World& world);
+
+    // === OCCLUDERS ===
+    void SelectOccluders(World& world);
+
+    // === AREAS ===
+    void BuildAreas(World& world, const std::vector<BSPAreaPortalBrush>& portalBrushes);
 
     // === PVS GENERATION ===
     void BuildClustersFromLeaves(World& world);
+    int32_t ClusterSubtree(World& world, const std::vector<int32_t>& subtreeSize,
+                           const std::vector<uint32_t>& subtreeSurfaces,
+                           const std::vector<uint8_t>& structural,
+                           const std::vector<int32_t>& subtreeArea, int32_t nodeIndex);
+    int32_t MakeCluster(World& world, int32_t headNode, int32_t numNodes);
     void GeneratePVSData(World& world);
-    bool TestClusterVisibility(const World& world, int clusterA, int clusterB) const;
-    bool TestLineOfSight(const World& world, const Vector3& start, const Vector3& end) const;
-    bool IsAABBVisibleInFrustum(const Vector3& mins, const Vector3& maxs, const Frustum& frustum) const;
 
     // === VISIBILITY MARKING ===
     const uint8_t* GetClusterPVS(const World& world, int cluster) const;
 
     // === BSP TREE BUILDING HELPERS ===
-    std::unique_ptr<BSPNode> BuildBSPRecursive(const std::vector<size_t>& faceIndices,
-                                             const std::vector<Face>& allFaces,
-                                             int depth = 0);
-    size_t ChooseSplitterFace(const std::vector<size_t>& faceIndices,
-                            const std::vector<Face>& allFaces) const;
+    // Runs on job threads: must not touch mutable members or the Logger
+    std::unique_ptr<BSPBuildNode> BuildBSPRecursive(BSPBuildContext& ctx,
+                                                  std::vector<BSPFragment> fragments,
+                                                  int depth);
+    size_t ChooseSplitterFace(const BSPBuildContext& ctx,
+                            const std::vector<BSPFragment>& fragments) const;
+    int32_t EmitBuildNode(const BSPBuildContext& ctx, const BSPBuildNode& buildNode,
+                          World& world, int32_t parent);
 
     // === PLANE AND FRUSTUM UTILITIES ===
     struct Plane { Vector3 n; float d; };
-    Plane PlaneFromFace(const Face& face);
+    friend struct BSPBuildContext;
+    friend struct BSPBuildNode;
+    Plane PlaneFromFace(const Face& face) const;
     float SignedDistanceToPlane(const Plane& p, const Vector3& point) const;
-    int ClassifyFace(const Face& face, const Plane& plane) const;
-    void SplitFaceByPlane(const Face& face, const Plane& plane,
-                         bool& hasFront, Face& outFront,
-                         bool& hasBack, Face& outBack) const;
-
-    // === FRUSTUM CULLING ===
-    void ExtractFrustumPlanes(Frustum& frustum, const Camera3D& camera) const;
-    void SetPlaneSignbits(FrustumPlane& plane) const;
-    int BoxOnPlaneSide(const Vector3& mins, const Vector3& maxs, const FrustumPlane& plane) const;
+    int ClassifyFragment(const BSPFragment& fragment, const Plane& plane) const;
+    void SplitFragmentByPlane(BSPFragmentArena& arena, const BSPFragment& fragment,
+                              const Plane& plane,
+                              bool& hasFront, BSPFragment& outFront,
+                              bool& hasBack, BSPFragment& outBack) const;
 
     // === LEGACY METHODS (to be removed) ===
     // Old BSPTree-based methods for backward compatibility during transition
@@ -111,6 +243,15 @@ private:
     // Visibility frame counter (like Quake's visCount)
     int32_t visCount_ = 0;
 
-    // Far clip distance for frustum culling
-    float farClipDistance_ = 100.0f;
+    // BSP compile
+    bool parallelBuild_ = true;
+    bool mergeFaces_ = true;
+    BSPSplitterMode splitterMode_ = BSPSplitterMode::CostDriven;
+    BSPSplitterWeights splitterWeights_;
+    BSPBuildStats lastBuildStats_;
+    BSPClusterSettings clusterSettings_;
+
+    // Per-frame scratch for batch culling cluster bounds and area flooding
+    std::vector<uint8_t> clusterInFrustum_;
+    std::vector<uint8_t> areaConnected_;
 };
@@ -43,7 +43,9 @@ enum class FaceFlags : unsigned int {
     None     = 0,
     NoDraw   = 1 << 0,
     Invisible= 1 << 1,
-    Collidable = 1 << 2
+    Collidable = 1 << 2,
+    Detail   = 1 << 3,     // From a detail brush: splits late in the BSP, never separates clusters
+    AreaPortal = 1 << 4    // Area portal brush face: splits the BSP, never becomes a surface
 };
 
 inline FaceFlags operator|(FaceFlags a, FaceFlags b) {
@@ -53,11 +55,66 @@ inline bool HasFlag(FaceFlags a, FaceFlags b) {
     return (static_cast<unsigned int>(a) & static_cast<unsigned int>(b)) != 0;
 }
 
+// Stretch-to-fill UVs for a planar polygon: positions projected onto a
+// tangent frame (bitangent kept as close to world up as the plane allows) and
+// normalized to 0..1 over the polygon's extent. The renderer's default
+// texturing; the world build bakes it per authored face (Face::stretchUVs).
+inline void ComputeStretchUVs(const std::vector<Vector3>& vertices, const Vector3& faceNormal,
+                              std::vector<Vector2>& outUVs) {
+    outUVs.clear();
+    if (vertices.empty()) return;
+    Vector3 normal = Vector3Normalize(faceNormal);
+
+    // Prefer world up for the bitangent (keeps textures upright); world right
+    // when the face is horizontal
+    Vector3 planeUp = {0.0f, 1.0f, 0.0f};
+    planeUp = Vector3Subtract(planeUp, Vector3Scale(normal, Vector3DotProduct(planeUp, normal)));
+    if (Vector3DotProduct(planeUp, planeUp) < 1e-8f) {
+        planeUp = {1.0f, 0.0f, 0.0f};
+        planeUp = Vector3Subtract(planeUp, Vector3Scale(normal, Vector3DotProduct(planeUp, normal)));
+    }
+    Vector3 bitangent = Vector3Normalize(planeUp);
+    Vector3 tangent = Vector3Normalize(Vector3CrossProduct(bitangent, normal));
+
+    // Still degenerate (bad normal): fall back to the longest edge
+    if (Vector3DotProduct(tangent, tangent) < 1e-8f) {
+        float maxLenSq = -1.0f;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            Vector3 edge = Vector3Subtract(vertices[(i + 1) % vertices.size()], vertices[i]);
+            edge = Vector3Subtract(edge, Vector3Scale(normal, Vector3DotProduct(edge, normal)));
+            float lenSq = Vector3DotProduct(edge, edge);
+            if (lenSq > maxLenSq) {
+                maxLenSq = lenSq;
+                tangent = edge;
+            }
+        }
+        tangent = Vector3Normalize(tangent);
+        bitangent = Vector3Normalize(Vector3CrossProduct(normal, tangent));
+    }
+
+    float minU = FLT_MAX, maxU = -FLT_MAX, minV = FLT_MAX, maxV = -FLT_MAX;
+    for (const Vector3& v : vertices) {
+        float u = Vector3DotProduct(v, tangent), w = Vector3DotProduct(v, bitangent);
+        minU = std::min(minU, u);
+        maxU = std::max(maxU, u);
+        minV = std::min(minV, w);
+        maxV = std::max(maxV, w);
+    }
+    const float uRange = maxU - minU, vRange = maxV - minV;
+    outUVs.reserve(vertices.size());
+    for (const Vector3& v : vertices) {
+        float u = Vector3DotProduct(v, tangent), w = Vector3DotProduct(v, bitangent);
+        outUVs.push_back({uRange > 1e-5f ? (u - minU) / uRange : 0.5f, vRange > 1e-5f ? (w - minV) / vRange : 0.5f});
+    }
+}
+
 // A single planar face (typically a quad) with material + lightmap data
 struct Face {
     // Geometry
     std::vector<Vector3> vertices;   // Expect 3+ verts; rendered as triangles/quad
     std::vector<Vector2> uvs;        // UV coordinates for texture mapping (pre-calculated)
+    std::vector<Vector2> stretchUVs; // Stretch-to-fill UVs of the authored face, baked by the world build and
+                                     // interpolated through splits; empty: the renderer computes them per face
     Vector3 normal;                  // Cached normal
 
     // Material
@@ -98,7 +155,7 @@ struct Face {
 // A solid brush composed of multiple planar faces
 struct Brush {
     std::vector<Face> faces;
-    bool isDetail = false;           // Structural vs detail (for future vis/bsp tuning)
+    bool isDetail = false;           // Detail brushes don't separate vis clusters (faces get FaceFlags::Detail)
     BrushAABB bounds;                // Cached bounds for culling
 
     void RecalculateBounds() {
@@ -0,0 +1,394 @@
+#include "FaceMerge.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+constexpr float MERGE_POINT_EPSILON = 0.001f;   // Vertices closer than this are the same point
+constexpr float MERGE_NORMAL_QUANT = 1000.0f;   // Plane bucketing resolution (normal components)
+constexpr float MERGE_DIST_QUANT = 100.0f;      // Plane bucketing resolution (distance from origin)
+constexpr float MERGE_UV_EPSILON = 0.002f;      // UV error allowed when one mapping has to fit both faces
+constexpr float TJUNCTION_EPSILON = 0.001f;     // Max distance from an edge for a vertex to count as on it
+constexpr float TJUNCTION_CELL_SIZE = 4.0f;     // Vertex grid cell size for the edge queries
+
+bool SamePoint(const Vector3& a, const Vector3& b) {
+    Vector3 d = Vector3Subtract(a, b);
+    return Vector3DotProduct(d, d) < MERGE_POINT_EPSILON * MERGE_POINT_EPSILON;
+}
+
+// Newell normal: area-weighted, robust for polygons with collinear vertices
+Vector3 PolygonAreaNormal(const std::vector<Vector3>& v) {
+    Vector3 n{0, 0, 0};
+    for (size_t i = 0; i < v.size(); ++i) {
+        const Vector3& a = v[i];
+        const Vector3& b = v[(i + 1) % v.size()];
+        n.x += (a.y - b.y) * (a.z + b.z);
+        n.y += (a.z - b.z) * (a.x + b.x);
+        n.z += (a.x - b.x) * (a.y + b.y);
+    }
+    return n;
+}
+
+// Which way the vertex loop winds around face.normal (+1 / -1), 0 if degenerate
+int Winding(const Face& face) {
+    float d = Vector3DotProduct(PolygonAreaNormal(face.vertices), face.normal);
+    if (std::fabs(d) < 1e-8f) return 0;
+    return d > 0.0f ? 1 : -1;
+}
+
+bool Mergeable(const Face& face) {
+    return face.vertices.size() >= 3 && face.lightmapIndex < 0 &&
+           (face.uvs.empty() || face.uvs.size() == face.vertices.size()) &&
+           (face.stretchUVs.empty() || face.stretchUVs.size() == face.vertices.size());
+}
+
+// Faces only merge within a bucket: same plane (quantized) and same surface
+using MergeKey = std::tuple<int, uint64_t, uint32_t, int, unsigned int, int, int, int, int>;
+
+MergeKey MakeMergeKey(const Face& face) {
+    float dist = Vector3DotProduct(face.normal, face.vertices[0]);
+    uint32_t tint = (uint32_t(face.tint.r) << 24) | (uint32_t(face.tint.g) << 16) |
+                    (uint32_t(face.tint.b) << 8) | uint32_t(face.tint.a);
+    return MergeKey(face.materialId, face.materialEntityId, tint, static_cast<int>(face.renderMode),
+                    static_cast<unsigned int>(face.flags),
+                    static_cast<int>(std::lround(face.normal.x * MERGE_NORMAL_QUANT)),
+                    static_cast<int>(std::lround(face.normal.y * MERGE_NORMAL_QUANT)),
+                    static_cast<int>(std::lround(face.normal.z * MERGE_NORMAL_QUANT)),
+                    static_cast<int>(std::lround(dist * MERGE_DIST_QUANT)));
+}
+
+// True if a single affine map (plane position -> uv) reproduces every uv
+bool UVsAreAffine(const std::vector<Vector3>& vertices, const std::vector<Vector2>& uvs, const Vector3& normal) {
+    if (uvs.empty()) return true;
+
+    // In-plane basis
+    Vector3 axis = std::fabs(normal.x) < 0.9f ? Vector3{1, 0, 0} : Vector3{0, 1, 0};
+    Vector3 s = Vector3Normalize(Vector3CrossProduct(normal, axis));
+    Vector3 t = Vector3CrossProduct(normal, s);
+
+    // Fit through vertex 0 and the pair spanning the largest triangle
+    const size_t count = vertices.size();
+    size_t bestI = 1, bestJ = 2;
+    float bestArea = 0.0f;
+    for (size_t i = 1; i < count; ++i) {
+        for (size_t j = i + 1; j < count; ++j) {
+            Vector3 c = Vector3CrossProduct(Vector3Subtract(vertices[i], vertices[0]),
+                                            Vector3Subtract(vertices[j], vertices[0]));
+            float area = Vector3DotProduct(c, c);
+            if (area > bestArea) {
+                bestArea = area;
+                bestI = i;
+                bestJ = j;
+            }
+        }
+    }
+    if (bestArea < 1e-12f) return false;
+
+    float s0 = Vector3DotProduct(vertices[0], s), t0 = Vector3DotProduct(vertices[0], t);
+    float s1 = Vector3DotProduct(vertices[bestI], s) - s0, t1 = Vector3DotProduct(vertices[bestI], t) - t0;
+    float s2 = Vector3DotProduct(vertices[bestJ], s) - s0, t2 = Vector3DotProduct(vertices[bestJ], t) - t0;
+    float det = s1 * t2 - s2 * t1;
+    if (std::fabs(det) < 1e-12f) return false;
+
+    // uv = uv0 + A * (ds, dt) for each uv component
+    Vector2 du1 = Vector2Subtract(uvs[bestI], uvs[0]);
+    Vector2 du2 = Vector2Subtract(uvs[bestJ], uvs[0]);
+    float aU = (du1.x * t2 - du2.x * t1) / det, bU = (s1 * du2.x - s2 * du1.x) / det;
+    float aV = (du1.y * t2 - du2.y * t1) / det, bV = (s1 * du2.y - s2 * du1.y) / det;
+
+    for (size_t k = 0; k < count; ++k) {
+        float ds = Vector3DotProduct(vertices[k], s) - s0;
+        float dt = Vector3DotProduct(vertices[k], t) - t0;
+        float u = uvs[0].x + aU * ds + bU * dt;
+        float v = uvs[0].y + aV * ds + bV * dt;
+        if (std::fabs(u - uvs[k].x) > MERGE_UV_EPSILON || std::fabs(v - uvs[k].y) > MERGE_UV_EPSILON) return false;
+    }
+    return true;
+}
+
+// Drop vertices that sit on the straight line between their neighbours
+void RemoveCollinear(std::vector<Vector3>& vertices, std::vector<Vector2>& uvs, std::vector<Vector2>& stretchUVs) {
+    bool hasUVs = !uvs.empty();
+    bool hasStretchUVs = !stretchUVs.empty();
+    for (size_t i = 0; i < vertices.size() && vertices.size() > 3;) {
+        const Vector3& prev = vertices[(i + vertices.size() - 1) % vertices.size()];
+        const Vector3& next = vertices[(i + 1) % vertices.size()];
+        Vector3 e1 = Vector3Subtract(vertices[i], prev);
+        Vector3 e2 = Vector3Subtract(next, vertices[i]);
+        Vector3 c = Vector3CrossProduct(e1, e2);
+        float limit = MERGE_POINT_EPSILON * Vector3Length(e1) * Vector3Length(e2);
+        if (Vector3DotProduct(c, c) <= limit * limit && Vector3DotProduct(e1, e2) > 0.0f) {
+            vertices.erase(vertices.begin() + i);
+            if (hasUVs) uvs.erase(uvs.begin() + i);
+            if (hasStretchUVs) stretchUVs.erase(stretchUVs.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+// Both faces carry the same uvs at the ends of the shared edge
+bool EdgeUVsMatch(const std::vector<Vector2>& uvsA, size_t ia, const std::vector<Vector2>& uvsB, size_t ib) {
+    if (uvsA.empty()) return true;
+    const Vector2& uvA1 = uvsA[ia];
+    const Vector2& uvA2 = uvsA[(ia + 1) % uvsA.size()];
+    const Vector2& uvB2 = uvsB[ib];
+    const Vector2& uvB1 = uvsB[(ib + 1) % uvsB.size()];
+    return Vector2Distance(uvA1, uvB1) <= MERGE_UV_EPSILON && Vector2Distance(uvA2, uvB2) <= MERGE_UV_EPSILON;
+}
+
+// Join two faces across a shared edge. Fails unless the result is convex and
+// one uv mapping covers both faces, for the authored uvs and for the baked
+// stretch uvs alike.
+bool TryMerge(const Face& a, const Face& b, int winding, Face& out) {
+    const size_t na = a.vertices.size(), nb = b.vertices.size();
+    if (a.uvs.empty() != b.uvs.empty()) return false;
+    if (a.stretchUVs.empty() != b.stretchUVs.empty()) return false;
+
+    // Shared edge runs p1 -> p2 in a and p2 -> p1 in b
+    size_t ia = 0, ib = 0;
+    bool found = false;
+    for (size_t i = 0; i < na && !found; ++i) {
+        const Vector3& p1 = a.vertices[i];
+        const Vector3& p2 = a.vertices[(i + 1) % na];
+        for (size_t j = 0; j < nb; ++j) {
+            if (SamePoint(b.vertices[j], p2) && SamePoint(b.vertices[(j + 1) % nb], p1)) {
+                ia = i;
+                ib = j;
+                found = true;
+                break;
+            }
+        }
+    }
+    if (!found) return false;
+
+    if (!EdgeUVsMatch(a.uvs, ia, b.uvs, ib) || !EdgeUVsMatch(a.stretchUVs, ia, b.stretchUVs, ib)) return false;
+    const bool hasUVs = !a.uvs.empty();
+    const bool hasStretchUVs = !a.stretchUVs.empty();
+
+    // a from p2 all the way round to p1, then the rest of b
+    std::vector<Vector3> vertices;
+    std::vector<Vector2> uvs;
+    std::vector<Vector2> stretchUVs;
+    vertices.reserve(na + nb - 2);
+    for (size_t k = 0; k < na; ++k) {
+        size_t idx = (ia + 1 + k) % na;
+        vertices.push_back(a.vertices[idx]);
+        if (hasUVs) uvs.push_back(a.uvs[idx]);
+        if (hasStretchUVs) stretchUVs.push_back(a.stretchUVs[idx]);
+    }
+    for (size_t k = 2; k < nb; ++k) {
+        size_t idx = (ib + k) % nb;
+        vertices.push_back(b.vertices[idx]);
+        if (hasUVs) uvs.push_back(b.uvs[idx]);
+        if (hasStretchUVs) stretchUVs.push_back(b.stretchUVs[idx]);
+    }
+
+    RemoveCollinear(vertices, uvs, stretchUVs);
+    if (vertices.size() < 3) return false;
+
+    // Convex: every corner turns the same way as the original winding
+    Vector3 facing = Vector3Scale(a.normal, static_cast<float>(winding));
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const Vector3& prev = vertices[(i + vertices.size() - 1) % vertices.size()];
+        const Vector3& next = vertices[(i + 1) % vertices.size()];
+        Vector3 c = Vector3CrossProduct(Vector3Subtract(vertices[i], prev), Vector3Subtract(next, vertices[i]));
+        if (Vector3DotProduct(c, facing) <= 0.0f) return false;
+    }
+
+    if (!UVsAreAffine(vertices, uvs, a.normal)) return false;
+    if (!UVsAreAffine(vertices, stretchUVs, a.normal)) return false;
+
+    out = a;
+    out.vertices = std::move(vertices);
+    out.uvs = std::move(uvs);
+    out.stretchUVs = std::move(stretchUVs);
+    return true;
+}
+
+struct MergeBounds {
+    Vector3 min;
+    Vector3 max;
+
+    bool Touches(const MergeBounds& other) const {
+        return min.x <= other.max.x + MERGE_POINT_EPSILON && max.x >= other.min.x - MERGE_POINT_EPSILON &&
+               min.y <= other.max.y + MERGE_POINT_EPSILON && max.y >= other.min.y - MERGE_POINT_EPSILON &&
+               min.z <= other.max.z + MERGE_POINT_EPSILON && max.z >= other.min.z - MERGE_POINT_EPSILON;
+    }
+};
+
+MergeBounds BoundsOf(const Face& face) {
+    MergeBounds bounds{face.vertices[0], face.vertices[0]};
+    for (const Vector3& v : face.vertices) {
+        bounds.min = Vector3Min(bounds.min, v);
+        bounds.max = Vector3Max(bounds.max, v);
+    }
+    return bounds;
+}
+
+// Packed grid cell coordinates (21 bits per axis)
+int64_t CellKey(int x, int y, int z) {
+    return (static_cast<int64_t>(x & 0x1FFFFF) << 42) | (static_cast<int64_t>(y & 0x1FFFFF) << 21) |
+           static_cast<int64_t>(z & 0x1FFFFF);
+}
+
+int CellCoord(float value) {
+    return static_cast<int>(std::floor(value / TJUNCTION_CELL_SIZE));
+}
+
+} // namespace
+
+size_t FaceMerge::MergeCoplanarFaces(std::vector<Face>& faces) {
+    // Bucket mergeable faces; keys are ordered so the result is deterministic
+    std::map<MergeKey, std::vector<size_t>> buckets;
+    std::vector<int> windings(faces.size(), 0);
+    for (size_t i = 0; i < faces.size(); ++i) {
+        if (!Mergeable(faces[i])) continue;
+        windings[i] = Winding(faces[i]);
+        if (windings[i] == 0) continue;
+        buckets[MakeMergeKey(faces[i])].push_back(i);
+    }
+
+    std::vector<uint8_t> removed(faces.size(), 0);
+    size_t removedCount = 0;
+    Face merged;
+
+    for (auto& bucket : buckets) {
+        std::vector<size_t>& members = bucket.second;
+        if (members.size() < 2) continue;
+
+        std::vector<MergeBounds> bounds;
+        bounds.reserve(members.size());
+        for (size_t index : members) bounds.push_back(BoundsOf(faces[index]));
+
+        // Keep sweeping until nothing merges: each merge can open up new ones
+        bool mergedAny = true;
+        while (mergedAny) {
+            mergedAny = false;
+            for (size_t i = 0; i < members.size(); ++i) {
+                size_t fi = members[i];
+                if (removed[fi]) continue;
+                for (size_t j = i + 1; j < members.size(); ++j) {
+                    size_t fj = members[j];
+                    if (removed[fj] || windings[fi] != windings[fj]) continue;
+                    if (!bounds[i].Touches(bounds[j])) continue;
+                    if (!TryMerge(faces[fi], faces[fj], windings[fi], merged)) continue;
+
+                    faces[fi] = std::move(merged);
+                    bounds[i] = BoundsOf(faces[fi]);
+                    removed[fj] = 1;
+                    ++removedCount;
+                    mergedAny = true;
+                }
+            }
+        }
+    }
+
+    if (removedCount > 0) {
+        size_t write = 0;
+        for (size_t read = 0; read < faces.size(); ++read) {
+            if (removed[read]) continue;
+            if (write != read) faces[write] = std::move(faces[read]);
+            ++write;
+        }
+        faces.resize(write);
+    }
+    return removedCount;
+}
+
+size_t FaceMerge::FixTJunctions(std::vector<Face>& faces) {
+    // Every distinct vertex position, bucketed by grid cell
+    std::unordered_map<int64_t, std::vector<Vector3>> grid;
+    for (const Face& face : faces) {
+        for (const Vector3& v : face.vertices) {
+            auto& cell = grid[CellKey(CellCoord(v.x), CellCoord(v.y), CellCoord(v.z))];
+            bool known = false;
+            for (const Vector3& existing : cell) {
+                if (SamePoint(existing, v)) {
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) cell.push_back(v);
+        }
+    }
+
+    size_t inserted = 0;
+    std::vector<std::pair<float, Vector3>> onEdge;
+    std::vector<Vector3> vertices;
+    std::vector<Vector2> uvs;
+    std::vector<Vector2> stretchUVs;
+
+    for (Face& face : faces) {
+        const size_t count = face.vertices.size();
+        if (count < 3) continue;
+        const bool hasUVs = face.uvs.size() == count;
+        const bool hasStretchUVs = face.stretchUVs.size() == count;
+
+        vertices.clear();
+        uvs.clear();
+        stretchUVs.clear();
+        size_t added = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            const Vector3& a = face.vertices[i];
+            const Vector3& b = face.vertices[(i + 1) % count];
+            vertices.push_back(a);
+            if (hasUVs) uvs.push_back(face.uvs[i]);
+            if (hasStretchUVs) stretchUVs.push_back(face.stretchUVs[i]);
+
+            Vector3 edge = Vector3Subtract(b, a);
+            float lengthSq = Vector3DotProduct(edge, edge);
+            if (lengthSq < MERGE_POINT_EPSILON * MERGE_POINT_EPSILON) continue;
+            float tEpsilon = TJUNCTION_EPSILON / sqrtf(lengthSq);
+
+            // Vertices strictly inside the edge, in edge order
+            onEdge.clear();
+            Vector3 lo = Vector3Min(a, b), hi = Vector3Max(a, b);
+            int x0 = CellCoord(lo.x - TJUNCTION_EPSILON), x1 = CellCoord(hi.x + TJUNCTION_EPSILON);
+            int y0 = CellCoord(lo.y - TJUNCTION_EPSILON), y1 = CellCoord(hi.y + TJUNCTION_EPSILON);
+            int z0 = CellCoord(lo.z - TJUNCTION_EPSILON), z1 = CellCoord(hi.z + TJUNCTION_EPSILON);
+            for (int x = x0; x <= x1; ++x) {
+                for (int y = y0; y <= y1; ++y) {
+                    for (int z = z0; z <= z1; ++z) {
+                        auto it = grid.find(CellKey(x, y, z));
+                        if (it == grid.end()) continue;
+                        for (const Vector3& p : it->second) {
+                            float t = Vector3DotProduct(Vector3Subtract(p, a), edge) / lengthSq;
+                            if (t <= tEpsilon || t >= 1.0f - tEpsilon) continue;
+                            Vector3 closest = Vector3Add(a, Vector3Scale(edge, t));
+                            Vector3 offset = Vector3Subtract(p, closest);
+                            if (Vector3DotProduct(offset, offset) > TJUNCTION_EPSILON * TJUNCTION_EPSILON) continue;
+                            onEdge.emplace_back(t, p);
+                        }
+                    }
+                }
+            }
+            if (onEdge.empty()) continue;
+
+            std::sort(onEdge.begin(), onEdge.end(),
+                      [](const std::pair<float, Vector3>& l, const std::pair<float, Vector3>& r) { return l.first < r.first; });
+            for (const auto& hit : onEdge) {
+                if (SamePoint(vertices.back(), hit.second)) continue;
+                vertices.push_back(hit.second);
+                if (hasUVs) uvs.push_back(Vector2Lerp(face.uvs[i], face.uvs[(i + 1) % count], hit.first));
+                if (hasStretchUVs) {
+                    stretchUVs.push_back(Vector2Lerp(face.stretchUVs[i], face.stretchUVs[(i + 1) % count], hit.first));
+                }
+                ++added;
+            }
+        }
+
+        if (added > 0) {
+            face.vertices = vertices;
+            if (hasUVs) face.uvs = uvs;
+            if (hasStretchUVs) face.stretchUVs = stretchUVs;
+            inserted += added;
+        }
+    }
+    return inserted;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Brush.h"
+#include <cstddef>
+#include <vector>
+
+// World build passes that clean up authored faces (q3map's merge and tjunc
+// stages). Brushes and the YAML map emit walls as many small coplanar quads;
+// merging them before the BSP build means fewer fragments, splits, surfaces
+// and draws. T-junction fixing runs on the compiled surfaces afterwards.
+class FaceMerge {
+public:
+    // Merge faces that lie on the same plane, share an edge and have identical
+    // material, tint, render mode and flags into larger convex polygons. Faces
+    // only merge when one affine mapping fits both, for the authored UVs and
+    // for the baked stretch UVs, so texturing doesn't change in either render
+    // mode. Returns the number of faces removed.
+    static size_t MergeCoplanarFaces(std::vector<Face>& faces);
+
+    // Insert every vertex that lies inside another face's edge into that edge,
+    // so neighbouring polygons share vertices and rasterize without cracks.
+    // UVs and stretch UVs of inserted vertices are interpolated along the edge. Returns the
+    // number of vertices inserted.
+    static size_t FixTJunctions(std::vector<Face>& faces);
+};
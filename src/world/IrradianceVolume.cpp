@@ -0,0 +1,79 @@
+#include "IrradianceVolume.h"
+#include "WorldGeometry.h"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float SH_Y0 = 0.282095f;              // Constant band basis
+    constexpr float SH_Y1 = 0.488603f;              // Linear band basis (times x, y or z)
+    constexpr float SH_COSINE_L1 = 2.0f / 3.0f;     // Clamped cosine lobe, band 1, divided by pi
+}
+
+void IrradianceVolume::AddRadiance(BSPIrradianceProbe& probe, const Vector3& direction, const Vector3& radiance,
+                                   float weight) {
+    const float basis[4] = {SH_Y0, SH_Y1 * direction.x, SH_Y1 * direction.y, SH_Y1 * direction.z};
+    for (int i = 0; i < 4; ++i) {
+        probe.sh[i] = Vector3Add(probe.sh[i], Vector3Scale(radiance, basis[i] * weight));
+    }
+}
+
+void IrradianceVolume::ToAmbient(const BSPIrradianceProbe& probe, Vector3 outAmbient[4]) {
+    outAmbient[0] = Vector3Scale(probe.sh[0], SH_Y0);
+    for (int i = 1; i < 4; ++i) {
+        outAmbient[i] = Vector3Scale(probe.sh[i], SH_COSINE_L1 * SH_Y1);
+    }
+}
+
+Vector3 IrradianceVolume::EvaluateAmbient(const BSPIrradianceProbe& probe, const Vector3& normal) {
+    Vector3 a[4];
+    ToAmbient(probe, a);
+    Vector3 result = Vector3Add(a[0], Vector3Add(Vector3Scale(a[1], normal.x),
+                                                 Vector3Add(Vector3Scale(a[2], normal.y), Vector3Scale(a[3], normal.z))));
+    return Vector3Max(result, Vector3Zero());
+}
+
+bool IrradianceVolume::Sample(const World& world, const Vector3& position, BSPIrradianceProbe& outProbe) {
+    outProbe = {};
+    const BSPProbeGrid& grid = world.probeGrid;
+    if (grid.spacing <= 0.0f || world.probes.size() != grid.ProbeCount() || world.probes.empty()) return false;
+
+    // Clamped to the grid, so entities just outside still get the edge probes
+    const float local[3] = {
+        std::clamp((position.x - grid.origin.x) / grid.spacing, 0.0f, static_cast<float>(grid.countX - 1)),
+        std::clamp((position.y - grid.origin.y) / grid.spacing, 0.0f, static_cast<float>(grid.countY - 1)),
+        std::clamp((position.z - grid.origin.z) / grid.spacing, 0.0f, static_cast<float>(grid.countZ - 1))};
+    const uint32_t counts[3] = {grid.countX, grid.countY, grid.countZ};
+    uint32_t base[3];
+    float frac[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        base[axis] = std::min(static_cast<uint32_t>(local[axis]), counts[axis] > 1 ? counts[axis] - 2 : 0u);
+        frac[axis] = counts[axis] > 1 ? local[axis] - static_cast<float>(base[axis]) : 0.0f;
+    }
+
+    // Trilinear, with probes in solid dropped and the rest renormalized
+    float totalWeight = 0.0f;
+    for (uint32_t corner = 0; corner < 8; ++corner) {
+        uint32_t index[3];
+        float weight = 1.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            uint32_t step = (corner >> axis) & 1u;
+            index[axis] = std::min(base[axis] + step, counts[axis] - 1);
+            weight *= step ? frac[axis] : 1.0f - frac[axis];
+        }
+        const BSPIrradianceProbe& probe = world.probes[index[0] + grid.countX * (index[1] + grid.countY * index[2])];
+        weight *= probe.validity;
+        if (weight <= 0.0f) continue;
+        for (int i = 0; i < 4; ++i) {
+            outProbe.sh[i] = Vector3Add(outProbe.sh[i], Vector3Scale(probe.sh[i], weight));
+        }
+        totalWeight += weight;
+    }
+    if (totalWeight <= 0.0f) return false;
+
+    for (int i = 0; i < 4; ++i) {
+        outProbe.sh[i] = Vector3Scale(outProbe.sh[i], 1.0f / totalWeight);
+    }
+    outProbe.validity = 1.0f;
+    return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "raylib.h"
+#include "BSPTree.h"
+
+struct World;
+
+// Runtime side of the baked irradiance probes: trilinear lookup in the world's
+// probe grid and L1 spherical harmonics helpers shared with the baker.
+//
+// Ambient light uses the lightmap convention (the value multiplies albedo
+// directly), i.e. the cosine-weighted average of incoming radiance:
+//   ambient(n) = a[0] + a[1] * n.x + a[2] * n.y + a[3] * n.z
+// with a = ToAmbient(probe). Entities use this instead of runtime lights for
+// the indirect part of their lighting.
+class IrradianceVolume {
+public:
+    // Interpolated probe at position; skips probes inside solid and falls back
+    // to zero outside the grid or when nothing valid is nearby
+    static bool Sample(const World& world, const Vector3& position, BSPIrradianceProbe& outProbe);
+
+    // Project radiance arriving from direction (unit) with the given weight
+    static void AddRadiance(BSPIrradianceProbe& probe, const Vector3& direction, const Vector3& radiance, float weight);
+
+    // Cosine-convolved coefficients, see above
+    static void ToAmbient(const BSPIrradianceProbe& probe, Vector3 outAmbient[4]);
+    static Vector3 EvaluateAmbient(const BSPIrradianceProbe& probe, const Vector3& normal);
+};
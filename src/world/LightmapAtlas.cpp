@@ -0,0 +1,200 @@
+#include "LightmapAtlas.h"
+#include "WorldGeometry.h"
+#include "../utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace {
+
+// Skyline of one page: the top edge of everything placed so far, as runs of
+// constant height from left to right
+struct SkylinePage {
+    struct Segment { uint32_t x, y, width; };
+    std::vector<Segment> skyline;
+    uint32_t size = 0;
+    uint32_t usedHeight = 0;
+
+    explicit SkylinePage(uint32_t pageSize) : size(pageSize) {
+        skyline.push_back({0, 0, pageSize});
+    }
+
+    // Lowest y a width x height rectangle can sit at starting on segment index
+    bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& outY) const {
+        uint32_t x = skyline[index].x;
+        if (x + width > size) return false;
+        uint32_t y = 0, remaining = width;
+        for (size_t i = index; remaining > 0; ++i) {
+            if (i >= skyline.size()) return false;
+            y = std::max(y, skyline[i].y);
+            if (y + height > size) return false;
+            remaining -= std::min(remaining, skyline[i].width);
+        }
+        outY = y;
+        return true;
+    }
+
+    // Bottom-left: lowest top edge, then leftmost
+    bool Insert(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY) {
+        size_t bestIndex = skyline.size();
+        uint32_t bestTop = UINT32_MAX, bestY = 0;
+        for (size_t i = 0; i < skyline.size(); ++i) {
+            uint32_t y;
+            if (Fit(i, width, height, y) && y + height < bestTop) {
+                bestTop = y + height;
+                bestIndex = i;
+                bestY = y;
+            }
+        }
+        if (bestIndex == skyline.size()) return false;
+
+        outX = skyline[bestIndex].x;
+        outY = bestY;
+
+        // Raise the skyline under the new rectangle
+        Segment placed = {outX, bestY + height, width};
+        skyline.insert(skyline.begin() + bestIndex, placed);
+        for (size_t i = bestIndex + 1; i < skyline.size();) {
+            uint32_t placedEnd = placed.x + placed.width;
+            if (skyline[i].x >= placedEnd) break;
+            uint32_t overlap = placedEnd - skyline[i].x;
+            if (overlap >= skyline[i].width) {
+                skyline.erase(skyline.begin() + i);
+            } else {
+                skyline[i].x += overlap;
+                skyline[i].width -= overlap;
+                break;
+            }
+        }
+        for (size_t i = 0; i + 1 < skyline.size();) {
+            if (skyline[i].y == skyline[i + 1].y) {
+                skyline[i].width += skyline[i + 1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            } else {
+                ++i;
+            }
+        }
+        usedHeight = std::max(usedHeight, bestY + height);
+        return true;
+    }
+};
+
+struct Placement {
+    uint32_t page = 0;
+    uint32_t x = 0, y = 0;
+};
+
+uint32_t NextPowerOfTwo(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+} // namespace
+
+bool LightmapAtlas::Pack(World& world, const Settings& settings, Stats* outStats) {
+    auto startTime = std::chrono::steady_clock::now();
+    Stats stats;
+    stats.lightmaps = world.lightmaps.size();
+
+    const uint32_t padding = settings.padding;
+    const uint32_t pageSize = settings.pageSize;
+
+    // Tallest first packs a skyline tightest
+    std::vector<uint32_t> order(world.lightmaps.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const BSPLightmap& la = world.lightmaps[a];
+        const BSPLightmap& lb = world.lightmaps[b];
+        if (la.height != lb.height) return la.height > lb.height;
+        if (la.width != lb.width) return la.width > lb.width;
+        return a < b;
+    });
+
+    std::vector<SkylinePage> pages;
+    std::vector<Placement> placements(world.lightmaps.size());
+    for (uint32_t index : order) {
+        const BSPLightmap& lightmap = world.lightmaps[index];
+        uint32_t width = lightmap.width + 2 * padding, height = lightmap.height + 2 * padding;
+        if (width > pageSize || height > pageSize) {
+            LOG_ERROR("LightmapAtlas: " + std::to_string(lightmap.width) + "x" + std::to_string(lightmap.height) +
+                      " lightmap doesn't fit a " + std::to_string(pageSize) + " page");
+            return false;
+        }
+
+        Placement& placement = placements[index];
+        bool placed = false;
+        for (size_t p = 0; p < pages.size() && !placed; ++p) {
+            if (pages[p].Insert(width, height, placement.x, placement.y)) {
+                placement.page = static_cast<uint32_t>(p);
+                placed = true;
+            }
+        }
+        if (!placed) {
+            pages.emplace_back(pageSize);
+            pages.back().Insert(width, height, placement.x, placement.y);
+            placement.page = static_cast<uint32_t>(pages.size() - 1);
+        }
+    }
+
+    // Pages keep the full width; height is trimmed to what was used
+    std::vector<BSPLightmap> pageLightmaps(pages.size());
+    size_t texelCount = 0;
+    for (size_t p = 0; p < pages.size(); ++p) {
+        pageLightmaps[p].width = pageSize;
+        pageLightmaps[p].height = std::min(pageSize, NextPowerOfTwo(pages[p].usedHeight));
+        pageLightmaps[p].firstTexel = static_cast<uint32_t>(texelCount);
+        texelCount += static_cast<size_t>(pageLightmaps[p].width) * pageLightmaps[p].height;
+    }
+
+    // Copy each lightmap in, clamping reads so the padding repeats the edge
+    std::vector<Color> texels(texelCount, Color{0, 0, 0, 255});
+    std::vector<size_t> pageUsed(pages.size(), 0);
+    for (size_t i = 0; i < world.lightmaps.size(); ++i) {
+        const BSPLightmap& source = world.lightmaps[i];
+        const Placement& placement = placements[i];
+        const BSPLightmap& page = pageLightmaps[placement.page];
+        for (uint32_t y = 0; y < source.height + 2 * padding; ++y) {
+            uint32_t sy = static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(y) - padding, 0, source.height - 1));
+            for (uint32_t x = 0; x < source.width + 2 * padding; ++x) {
+                uint32_t sx = static_cast<uint32_t>(std::clamp<int64_t>(static_cast<int64_t>(x) - padding, 0, source.width - 1));
+                texels[page.firstTexel + (placement.y + y) * page.width + placement.x + x] =
+                    world.lightmapTexels[source.firstTexel + sy * source.width + sx];
+            }
+        }
+        pageUsed[placement.page] += static_cast<size_t>(source.width) * source.height;
+    }
+
+    for (Face& face : world.surfaces) {
+        if (face.lightmapIndex < 0 || face.lightmapIndex >= static_cast<int>(world.lightmaps.size())) continue;
+        const BSPLightmap& source = world.lightmaps[face.lightmapIndex];
+        const Placement& placement = placements[face.lightmapIndex];
+        const BSPLightmap& page = pageLightmaps[placement.page];
+
+        // uv in the lightmap -> texels -> uv in the page
+        float scaleX = static_cast<float>(source.width) / page.width;
+        float scaleY = static_cast<float>(source.height) / page.height;
+        face.lightmapUVScale = {face.lightmapUVScale.x * scaleX, face.lightmapUVScale.y * scaleY};
+        face.lightmapUVOffset = {face.lightmapUVOffset.x * scaleX + static_cast<float>(placement.x + padding) / page.width,
+                                 face.lightmapUVOffset.y * scaleY + static_cast<float>(placement.y + padding) / page.height};
+        face.lightmapIndex = static_cast<int>(placement.page);
+    }
+
+    world.lightmaps = std::move(pageLightmaps);
+    world.lightmapTexels = std::move(texels);
+
+    stats.pages = pages.size();
+    for (size_t p = 0; p < pages.size(); ++p) {
+        size_t area = static_cast<size_t>(world.lightmaps[p].width) * world.lightmaps[p].height;
+        stats.usedTexels += pageUsed[p];
+        stats.pageTexels += area;
+        stats.occupancy.push_back(area > 0 ? static_cast<float>(pageUsed[p]) / area : 0.0f);
+    }
+    stats.packMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    LOG_INFO("Lightmap atlas: " + std::to_string(stats.lightmaps) + " lightmaps -> " +
+             std::to_string(stats.pages) + " pages, " +
+             std::to_string(stats.pageTexels > 0 ? stats.usedTexels * 100 / stats.pageTexels : 0) + "% used");
+    if (outStats) *outStats = std::move(stats);
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct World;
+
+// Packs the baker's per-surface lightmaps into a few large pages (skyline
+// bottom-left), so the renderer binds one texture per page instead of one per
+// surface. Each rectangle gets a border of copied edge texels so bilinear
+// filtering never reads a neighbour. Face lightmapIndex / UV scale and offset
+// are rewritten to address the page.
+class LightmapAtlas {
+public:
+    static constexpr uint32_t DEFAULT_PAGE_SIZE = 1024;
+
+    struct Settings {
+        uint32_t pageSize = DEFAULT_PAGE_SIZE;  // Page width; height is trimmed to the used power of two
+        uint32_t padding = 1;                   // Dilated texels around each lightmap
+    };
+
+    struct Stats {
+        size_t lightmaps = 0;           // Input lightmaps
+        size_t pages = 0;
+        size_t usedTexels = 0;          // Lightmap texels, padding excluded
+        size_t pageTexels = 0;          // Total page area
+        std::vector<float> occupancy;   // Per page: used / page area
+        double packMs = 0.0;
+    };
+
+    // Replace world.lightmaps with atlas pages. Returns false (world untouched)
+    // if a lightmap doesn't fit a page.
+    static bool Pack(World& world, const Settings& settings, Stats* outStats = nullptr);
+};
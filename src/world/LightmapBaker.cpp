@@ -0,0 +1,472 @@
+#include "LightmapBaker.h"
+#include "BSPTreeSystem.h"
+#include "WorldGeometry.h"
+#include "IrradianceVolume.h"
+#include "../core/JobSystem.h"
+#include "../utils/Logger.h"
+#include "raymath.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    constexpr float LIGHT_INTENSITY_SCALE = 0.001f;  // Same scaling LightSystem applies to LightComponent::intensity
+    constexpr float LIGHT_ATTENUATION = 0.1f;        // Same falloff the lighting shader uses
+    constexpr float SAMPLE_OFFSET = 0.02f;           // Ray starts are lifted off the surface by this much
+    constexpr float SAMPLE_INSET = 0.01f;            // Edge texels are pulled this far into the polygon
+    constexpr float SUN_DISTANCE = 1.0e4f;           // Shadow ray length for directional lights
+
+    const FaceFlags TRACE_IGNORE = FaceFlags::NoDraw | FaceFlags::Invisible;
+
+    double MsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Small deterministic generator, so a bake doesn't depend on thread timing
+    uint32_t HashSeed(uint32_t a, uint32_t b, uint32_t c) {
+        uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u) * 0x85EBCA77u ^ (c + 0x165667B1u) * 0xC2B2AE3Du;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h ? h : 1u;
+    }
+
+    float NextFloat(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return (state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float SmoothStep(float edge0, float edge1, float x) {
+        if (edge1 <= edge0) return x >= edge1 ? 1.0f : 0.0f;
+        float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    // Closest point of a convex polygon (either winding) to p
+    Vector2 ClosestPointOnPolygon(const std::vector<Vector2>& polygon, Vector2 p) {
+        bool positive = false, negative = false;
+        for (size_t i = 0; i < polygon.size(); ++i) {
+            Vector2 a = polygon[i], b = polygon[(i + 1) % polygon.size()];
+            float cross = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+            positive |= cross > 0.0f;
+            negative |= cross < 0.0f;
+        }
+        if (!(positive && negative)) return p;
+
+        Vector2 best = polygon[0];
+        float bestDistSq = INFINITY;
+        for (size_t i = 0; i < polygon.size(); ++i) {
+            Vector2 a = polygon[i], b = polygon[(i + 1) % polygon.size()];
+            Vector2 ab = {b.x - a.x, b.y - a.y};
+            float lengthSq = ab.x * ab.x + ab.y * ab.y;
+            float t = lengthSq > 0.0f ? std::clamp(((p.x - a.x) * ab.x + (p.y - a.y) * ab.y) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            Vector2 q = {a.x + ab.x * t, a.y + ab.y * t};
+            float distSq = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+            if (distSq < bestDistSq) {
+                bestDistSq = distSq;
+                best = q;
+            }
+        }
+        return best;
+    }
+}
+
+LightmapBaker::LightmapBaker(const BSPTreeSystem& bspSystem)
+    : bspSystem_(bspSystem) {
+}
+
+void LightmapBaker::AddLight(const LightComponent& light, const Vector3& position, const Quaternion& rotation) {
+    if (!light.enabled) return;
+
+    BakeLight bake;
+    bake.type = light.type;
+    bake.position = position;
+    bake.direction = Vector3Normalize(Vector3RotateByQuaternion({0.0f, -1.0f, 0.0f}, rotation));
+    float scale = light.intensity * LIGHT_INTENSITY_SCALE / 255.0f;
+    bake.color = {light.color.r * scale, light.color.g * scale, light.color.b * scale};
+    bake.range = light.type == LightType::SPOT ? light.range : light.radius;
+    bake.cosInner = cosf(light.innerAngle * DEG2RAD);
+    bake.cosOuter = cosf(light.outerAngle * DEG2RAD);
+    bake.castShadows = light.castShadows;
+    lights_.push_back(bake);
+}
+
+// === SURFACE PROJECTION ===
+
+void LightmapBaker::SurfaceBasis(const Vector3& normal, Vector3& outTangent, Vector3& outBitangent) {
+    Vector3 n = Vector3Normalize(normal);
+    // Keep lightmaps upright on walls; floors and ceilings use world X instead
+    Vector3 reference = fabsf(n.y) < 0.999f ? Vector3{0.0f, 1.0f, 0.0f} : Vector3{1.0f, 0.0f, 0.0f};
+    outBitangent = Vector3Normalize(Vector3Subtract(reference, Vector3Scale(n, Vector3DotProduct(reference, n))));
+    outTangent = Vector3Normalize(Vector3CrossProduct(outBitangent, n));
+}
+
+Vector2 LightmapBaker::SurfacePlanar(const Face& face, const Vector3& point) {
+    Vector3 tangent, bitangent;
+    SurfaceBasis(face.normal, tangent, bitangent);
+    return {Vector3DotProduct(point, tangent), Vector3DotProduct(point, bitangent)};
+}
+
+bool LightmapBaker::IsLit(const Face& face) const {
+    if (face.vertices.size() < 3) return false;
+    if (HasFlag(face.flags, FaceFlags::NoDraw) || HasFlag(face.flags, FaceFlags::Invisible) ||
+        HasFlag(face.flags, FaceFlags::AreaPortal)) return false;
+    return face.renderMode != FaceRenderMode::Invisible && face.renderMode != FaceRenderMode::Wireframe;
+}
+
+void LightmapBaker::LayoutSurface(const Face& face, SurfaceLightmap& layout) const {
+    layout.normal = Vector3Normalize(face.normal);
+    SurfaceBasis(layout.normal, layout.tangent, layout.bitangent);
+    layout.dist = Vector3DotProduct(layout.normal, face.vertices[0]);
+
+    float maxU = -INFINITY, maxV = -INFINITY;
+    layout.minU = layout.minV = INFINITY;
+    for (const Vector3& v : face.vertices) {
+        float u = Vector3DotProduct(v, layout.tangent), w = Vector3DotProduct(v, layout.bitangent);
+        layout.minU = std::min(layout.minU, u);
+        layout.minV = std::min(layout.minV, w);
+        maxU = std::max(maxU, u);
+        maxV = std::max(maxV, w);
+    }
+
+    // Texel centers sit on the grid corners, so the edges are sampled exactly
+    float extent = std::max(maxU - layout.minU, maxV - layout.minV);
+    int maxSize = std::max(2, settings_.maxLightmapSize);
+    layout.luxel = std::max(settings_.luxelSize, extent / (maxSize - 1));
+    layout.width = static_cast<uint32_t>(std::ceil((maxU - layout.minU) / layout.luxel)) + 1;
+    layout.height = static_cast<uint32_t>(std::ceil((maxV - layout.minV) / layout.luxel)) + 1;
+
+    float reflectance = settings_.reflectance / 255.0f;
+    layout.albedo = {face.tint.r * reflectance, face.tint.g * reflectance, face.tint.b * reflectance};
+}
+
+Vector3 LightmapBaker::TexelPosition(const SurfaceLightmap& layout, const std::vector<Vector2>& polygon,
+                                     uint32_t x, uint32_t y) const {
+    Vector2 centroid = {0.0f, 0.0f};
+    for (const Vector2& p : polygon) {
+        centroid.x += p.x;
+        centroid.y += p.y;
+    }
+    centroid.x /= polygon.size();
+    centroid.y /= polygon.size();
+
+    // Texels hanging over the edge sample the nearest point of the face
+    // instead, or they'd sit inside the neighbouring wall and come out black
+    Vector2 p = ClosestPointOnPolygon(polygon, {layout.minU + x * layout.luxel, layout.minV + y * layout.luxel});
+    Vector2 toCentroid = {centroid.x - p.x, centroid.y - p.y};
+    float length = sqrtf(toCentroid.x * toCentroid.x + toCentroid.y * toCentroid.y);
+    if (length > SAMPLE_INSET) {
+        p.x += toCentroid.x / length * SAMPLE_INSET;
+        p.y += toCentroid.y / length * SAMPLE_INSET;
+    }
+
+    return Vector3Add(Vector3Add(Vector3Scale(layout.tangent, p.x), Vector3Scale(layout.bitangent, p.y)),
+                      Vector3Scale(layout.normal, layout.dist));
+}
+
+// === LIGHTING ===
+
+Vector3 LightmapBaker::DirectLight(const World& world, const Vector3& point, const Vector3& normal,
+                                   size_t& shadowRays) const {
+    Vector3 result = {0.0f, 0.0f, 0.0f};
+    Vector3 start = Vector3Add(point, Vector3Scale(normal, SAMPLE_OFFSET));
+
+    for (const BakeLight& light : lights_) {
+        Vector3 toLight;
+        float falloff = 1.0f;
+        Vector3 shadowEnd;
+
+        if (light.type == LightType::DIRECTIONAL) {
+            toLight = Vector3Negate(light.direction);
+            shadowEnd = Vector3Add(start, Vector3Scale(toLight, SUN_DISTANCE));
+        } else {
+            Vector3 delta = Vector3Subtract(light.position, point);
+            float distance = Vector3Length(delta);
+            if (distance < 1e-4f || distance > light.range) continue;
+            toLight = Vector3Scale(delta, 1.0f / distance);
+            falloff = 1.0f / (1.0f + LIGHT_ATTENUATION * distance * distance);
+            if (light.type == LightType::SPOT) {
+                falloff *= SmoothStep(light.cosOuter, light.cosInner,
+                                      Vector3DotProduct(Vector3Negate(toLight), light.direction));
+            }
+            shadowEnd = light.position;
+        }
+
+        float nDotL = Vector3DotProduct(normal, toLight);
+        if (nDotL <= 0.0f || falloff <= 0.0f) continue;
+
+        if (light.castShadows) {
+            shadowRays++;
+            if (bspSystem_.TraceAnyHit(world, start, shadowEnd, FaceFlags::None, TRACE_IGNORE)) continue;
+        }
+        result = Vector3Add(result, Vector3Scale(light.color, nDotL * falloff));
+    }
+    return result;
+}
+
+Vector3 LightmapBaker::GatherBounce(const World& world, const std::vector<int32_t>& surfaceLayouts,
+                                    const std::vector<Vector3>& previous, const SurfaceLightmap& layout,
+                                    const Vector3& point, uint32_t seed, size_t& rays) const {
+    Vector3 sum = {0.0f, 0.0f, 0.0f};
+    Vector3 start = Vector3Add(point, Vector3Scale(layout.normal, SAMPLE_OFFSET));
+    const int samples = std::max(1, settings_.bounceSamples);
+
+    for (int i = 0; i < samples; ++i) {
+        // Cosine weighted, so the plain average is the irradiance estimate
+        float r1 = NextFloat(seed), r2 = NextFloat(seed);
+        float phi = 2.0f * PI * r1, radius = sqrtf(r2);
+        Vector3 dir = Vector3Add(Vector3Add(Vector3Scale(layout.tangent, radius * cosf(phi)),
+                                            Vector3Scale(layout.bitangent, radius * sinf(phi))),
+                                 Vector3Scale(layout.normal, sqrtf(std::max(0.0f, 1.0f - r2))));
+
+        rays++;
+        BSPTraceResult hit;
+        Vector3 end = Vector3Add(start, Vector3Scale(dir, settings_.bounceDistance));
+        if (!bspSystem_.TraceLine(world, start, end, hit, FaceFlags::None, TRACE_IGNORE)) continue;
+        if (hit.surface < 0 || surfaceLayouts[hit.surface] < 0) continue;
+
+        const SurfaceLightmap& other = layouts_[surfaceLayouts[hit.surface]];
+        // Back of a surface: the ray left the playable space
+        if (Vector3DotProduct(dir, other.normal) >= 0.0f) continue;
+
+        float u = (Vector3DotProduct(hit.point, other.tangent) - other.minU) / other.luxel;
+        float v = (Vector3DotProduct(hit.point, other.bitangent) - other.minV) / other.luxel;
+        uint32_t x = static_cast<uint32_t>(std::clamp(static_cast<int>(lroundf(u)), 0, static_cast<int>(other.width) - 1));
+        uint32_t y = static_cast<uint32_t>(std::clamp(static_cast<int>(lroundf(v)), 0, static_cast<int>(other.height) - 1));
+        const Vector3& light = previous[other.firstTexel + y * other.width + x];
+        sum = Vector3Add(sum, Vector3Multiply(light, other.albedo));
+    }
+    return Vector3Scale(sum, 1.0f / samples);
+}
+
+// === BAKE ===
+
+bool LightmapBaker::Bake(World& world) {
+    auto startTime = std::chrono::steady_clock::now();
+    lastStats_ = Stats();
+    lastStats_.lights = lights_.size();
+
+    // Lay out one lightmap per lit surface
+    layouts_.clear();
+    std::vector<int32_t> surfaceLayouts(world.surfaces.size(), -1);
+    uint32_t texelCount = 0;
+    for (size_t i = 0; i < world.surfaces.size(); ++i) {
+        const Face& face = world.surfaces[i];
+        if (!IsLit(face)) continue;
+        SurfaceLightmap layout;
+        layout.surface = static_cast<int32_t>(i);
+        LayoutSurface(face, layout);
+        layout.firstTexel = texelCount;
+        texelCount += layout.width * layout.height;
+        surfaceLayouts[i] = static_cast<int32_t>(layouts_.size());
+        layouts_.push_back(layout);
+    }
+
+    // Sample positions once; every pass reuses them
+    std::vector<Vector3> positions(texelCount);
+    std::vector<Vector3> total(texelCount);
+    std::atomic<size_t> shadowRays{0};
+    JobSystem& jobs = JobSystem::GetInstance();
+    jobs.ParallelFor(layouts_.size(), 1, [&](size_t begin, size_t end) {
+        size_t rays = 0;
+        std::vector<Vector2> polygon;
+        for (size_t l = begin; l < end; ++l) {
+            const SurfaceLightmap& layout = layouts_[l];
+            const Face& face = world.surfaces[layout.surface];
+            polygon.clear();
+            for (const Vector3& v : face.vertices) {
+                polygon.push_back({Vector3DotProduct(v, layout.tangent), Vector3DotProduct(v, layout.bitangent)});
+            }
+            for (uint32_t y = 0; y < layout.height; ++y) {
+                for (uint32_t x = 0; x < layout.width; ++x) {
+                    uint32_t texel = layout.firstTexel + y * layout.width + x;
+                    positions[texel] = TexelPosition(layout, polygon, x, y);
+                    total[texel] = DirectLight(world, positions[texel], layout.normal, rays);
+                }
+            }
+        }
+        shadowRays += rays;
+    });
+    lastStats_.shadowRays = shadowRays.load();
+    lastStats_.directMs = MsSince(startTime);
+
+    // Each bounce gathers only the light added by the pass before it
+    auto bounceStart = std::chrono::steady_clock::now();
+    std::atomic<size_t> bounceRays{0};
+    std::vector<Vector3> previous = total;
+    std::vector<Vector3> next(texelCount);
+    for (int bounce = 0; bounce < settings_.bounces; ++bounce) {
+        jobs.ParallelFor(layouts_.size(), 1, [&](size_t begin, size_t end) {
+            size_t rays = 0;
+            for (size_t l = begin; l < end; ++l) {
+                const SurfaceLightmap& layout = layouts_[l];
+                for (uint32_t t = 0; t < layout.width * layout.height; ++t) {
+                    uint32_t texel = layout.firstTexel + t;
+                    next[texel] = GatherBounce(world, surfaceLayouts, previous, layout, positions[texel],
+                                               HashSeed(static_cast<uint32_t>(l), t, static_cast<uint32_t>(bounce)), rays);
+                }
+            }
+            bounceRays += rays;
+        });
+        for (uint32_t t = 0; t < texelCount; ++t) total[t] = Vector3Add(total[t], next[t]);
+        previous.swap(next);
+    }
+    lastStats_.bounceRays = bounceRays.load();
+    lastStats_.bounceMs = MsSince(bounceStart);
+
+    // Encode into the world
+    world.lightmaps.clear();
+    world.lightmapTexels.resize(texelCount);
+    for (uint32_t t = 0; t < texelCount; ++t) {
+        const float scale = 255.0f / LIGHTMAP_OVERBRIGHT;
+        Vector3 light = Vector3AddValue(total[t], settings_.ambient);
+        world.lightmapTexels[t] = {static_cast<unsigned char>(std::min(255.0f, light.x * scale + 0.5f)),
+                                   static_cast<unsigned char>(std::min(255.0f, light.y * scale + 0.5f)),
+                                   static_cast<unsigned char>(std::min(255.0f, light.z * scale + 0.5f)), 255};
+    }
+
+    for (Face& face : world.surfaces) face.lightmapIndex = -1;
+    for (const SurfaceLightmap& layout : layouts_) {
+        Face& face = world.surfaces[layout.surface];
+        face.lightmapIndex = static_cast<int>(world.lightmaps.size());
+        face.lightmapUVScale = {1.0f / (layout.luxel * layout.width), 1.0f / (layout.luxel * layout.height)};
+        face.lightmapUVOffset = {(0.5f - layout.minU / layout.luxel) / layout.width,
+                                 (0.5f - layout.minV / layout.luxel) / layout.height};
+
+        BSPLightmap lightmap;
+        lightmap.width = layout.width;
+        lightmap.height = layout.height;
+        lightmap.firstTexel = layout.firstTexel;
+        world.lightmaps.push_back(lightmap);
+    }
+    layouts_.clear();
+
+    lastStats_.lightmaps = world.lightmaps.size();
+    lastStats_.texels = texelCount;
+    LOG_INFO("Lightmaps baked: " + std::to_string(lastStats_.lightmaps) + " lightmaps, " +
+             std::to_string(texelCount) + " texels, " + std::to_string(lights_.size()) + " lights, " +
+             std::to_string(settings_.bounces) + " bounces, " +
+             std::to_string(lastStats_.directMs + lastStats_.bounceMs) + " ms");
+    return true;
+}
+
+// === PROBES ===
+
+BSPIrradianceProbe LightmapBaker::GatherProbe(const World& world, const Vector3& position,
+                                              const std::vector<Vector3>& directions, size_t& rays) const {
+    BSPIrradianceProbe probe = {};
+    const float weight = 4.0f * PI / directions.size();
+    const float reflectance = settings_.reflectance / 255.0f;
+    size_t backfaces = 0;
+
+    for (const Vector3& dir : directions) {
+        rays++;
+        BSPTraceResult hit;
+        Vector3 end = Vector3Add(position, Vector3Scale(dir, settings_.bounceDistance));
+        if (!bspSystem_.TraceLine(world, position, end, hit, FaceFlags::None, TRACE_IGNORE)) continue;
+        if (hit.surface < 0) continue;
+
+        const Face& face = world.surfaces[hit.surface];
+        if (Vector3DotProduct(dir, face.normal) >= 0.0f) {
+            backfaces++;
+            continue;
+        }
+        if (face.lightmapIndex < 0) continue;
+
+        // Light leaving the surface: its lightmap times its albedo, as in GatherBounce
+        const BSPLightmap& lightmap = world.lightmaps[face.lightmapIndex];
+        Vector2 planar = SurfacePlanar(face, hit.point);
+        float u = planar.x * face.lightmapUVScale.x + face.lightmapUVOffset.x;
+        float v = planar.y * face.lightmapUVScale.y + face.lightmapUVOffset.y;
+        uint32_t x = static_cast<uint32_t>(std::clamp(static_cast<int>(u * lightmap.width), 0, static_cast<int>(lightmap.width) - 1));
+        uint32_t y = static_cast<uint32_t>(std::clamp(static_cast<int>(v * lightmap.height), 0, static_cast<int>(lightmap.height) - 1));
+        const Color& texel = world.lightmapTexels[lightmap.firstTexel + y * lightmap.width + x];
+        const float decode = LIGHTMAP_OVERBRIGHT / 255.0f * reflectance;
+        Vector3 radiance = {texel.r * decode * face.tint.r, texel.g * decode * face.tint.g, texel.b * decode * face.tint.b};
+        IrradianceVolume::AddRadiance(probe, dir, radiance, weight);
+    }
+
+    // Mostly looking at the backs of faces: the probe is inside a wall
+    probe.validity = backfaces * 4 > directions.size() ? 0.0f : 1.0f;
+    if (probe.validity == 0.0f) {
+        for (Vector3& coefficient : probe.sh) coefficient = Vector3Zero();
+    }
+    return probe;
+}
+
+bool LightmapBaker::BakeProbes(World& world) {
+    auto startTime = std::chrono::steady_clock::now();
+    world.probeGrid = BSPProbeGrid();
+    world.probes.clear();
+    lastStats_.probes = lastStats_.validProbes = lastStats_.probeRays = 0;
+    if (settings_.probeSpacing <= 0.0f || world.lightmaps.empty()) return false;
+
+    // Grid over the drawn geometry
+    Vector3 minBounds = {INFINITY, INFINITY, INFINITY};
+    Vector3 maxBounds = {-INFINITY, -INFINITY, -INFINITY};
+    for (const Face& face : world.surfaces) {
+        if (!IsLit(face)) continue;
+        for (const Vector3& v : face.vertices) {
+            minBounds = Vector3Min(minBounds, v);
+            maxBounds = Vector3Max(maxBounds, v);
+        }
+    }
+    if (minBounds.x > maxBounds.x) return false;
+
+    Vector3 extent = Vector3Subtract(maxBounds, minBounds);
+    BSPProbeGrid grid;
+    grid.spacing = settings_.probeSpacing;
+    for (;;) {
+        grid.countX = static_cast<uint32_t>(extent.x / grid.spacing) + 1;
+        grid.countY = static_cast<uint32_t>(extent.y / grid.spacing) + 1;
+        grid.countZ = static_cast<uint32_t>(extent.z / grid.spacing) + 1;
+        if (grid.ProbeCount() <= std::max<size_t>(1, settings_.maxProbes)) break;
+        grid.spacing *= 1.25f;
+    }
+    // Centered, so the outermost probes sit the same distance inside each wall
+    grid.origin = {minBounds.x + (extent.x - (grid.countX - 1) * grid.spacing) * 0.5f,
+                   minBounds.y + (extent.y - (grid.countY - 1) * grid.spacing) * 0.5f,
+                   minBounds.z + (extent.z - (grid.countZ - 1) * grid.spacing) * 0.5f};
+
+    // Same Fibonacci sphere for every probe: even coverage, no noise between neighbours
+    const int samples = std::max(4, settings_.probeSamples);
+    std::vector<Vector3> directions(samples);
+    const float goldenAngle = PI * (3.0f - sqrtf(5.0f));
+    for (int i = 0; i < samples; ++i) {
+        float y = 1.0f - (i + 0.5f) * 2.0f / samples;
+        float radius = sqrtf(std::max(0.0f, 1.0f - y * y));
+        directions[i] = {radius * cosf(goldenAngle * i), y, radius * sinf(goldenAngle * i)};
+    }
+
+    std::vector<BSPIrradianceProbe> probes(grid.ProbeCount());
+    std::atomic<size_t> probeRays{0};
+    JobSystem::GetInstance().ParallelFor(probes.size(), 16, [&](size_t begin, size_t end) {
+        size_t rays = 0;
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t x = static_cast<uint32_t>(i % grid.countX);
+            uint32_t y = static_cast<uint32_t>((i / grid.countX) % grid.countY);
+            uint32_t z = static_cast<uint32_t>(i / (static_cast<size_t>(grid.countX) * grid.countY));
+            Vector3 position = Vector3Add(grid.origin, Vector3Scale({(float)x, (float)y, (float)z}, grid.spacing));
+            probes[i] = GatherProbe(world, position, directions, rays);
+        }
+        probeRays += rays;
+    });
+
+    world.probeGrid = grid;
+    world.probes = std::move(probes);
+    lastStats_.probes = world.probes.size();
+    for (const BSPIrradianceProbe& probe : world.probes) {
+        lastStats_.validProbes += probe.validity > 0.0f ? 1 : 0;
+    }
+    lastStats_.probeRays = probeRays.load();
+    lastStats_.probeMs = MsSince(startTime);
+
+    LOG_INFO("Irradiance probes baked: " + std::to_string(grid.countX) + "x" + std::to_string(grid.countY) + "x" +
+             std::to_string(grid.countZ) + " at " + std::to_string(grid.spacing) + " units, " +
+             std::to_string(lastStats_.validProbes) + " of " + std::to_string(lastStats_.probes) +
+             " outside solid, " + std::to_string(lastStats_.probeMs) + " ms");
+    return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "raylib.h"
+#include "../ecs/Components/LightComponent.h"
+#include "BSPTree.h"
+
+struct World;
+struct Face;
+class BSPTreeSystem;
+
+// Offline lightmap baker. Every drawn world surface gets a lightmap sampled
+// on a planar grid (one texel per luxelSize world units). Direct light comes
+// from the map's light entities with BSP shadow rays; optional bounces gather
+// the previous pass from the surfaces hit by cosine-weighted hemisphere rays.
+// Surfaces are baked in parallel on the job system.
+//
+// Results go into World::lightmaps / lightmapTexels (one lightmap per surface)
+// and each face's lightmapIndex / lightmapUVScale / lightmapUVOffset:
+//   uv = SurfacePlanar(face, point) * lightmapUVScale + lightmapUVOffset
+// gives normalized coordinates into the face's lightmap.
+//
+// BakeProbes then fills World::probeGrid / probes with irradiance probes for
+// dynamic entities, gathered from the baked lightmaps (see IrradianceVolume).
+class LightmapBaker {
+public:
+    struct Settings {
+        float luxelSize = 0.25f;        // World units per texel
+        int maxLightmapSize = 128;      // Larger surfaces get coarser luxels
+        int bounces = 1;                // Indirect passes (0 = direct only)
+        int bounceSamples = 32;         // Hemisphere rays per texel and bounce
+        float bounceDistance = 64.0f;   // Rays longer than this see nothing
+        float reflectance = 0.5f;       // Scales face tint to get bounce albedo
+        float ambient = 0.05f;          // Floor so unlit corners aren't pitch black
+        float probeSpacing = 2.0f;      // World units between irradiance probes
+        int probeSamples = 128;         // Sphere rays per probe
+        size_t maxProbes = 32768;       // Spacing grows until the grid fits
+    };
+
+    struct Stats {
+        size_t lights = 0;
+        size_t lightmaps = 0;
+        size_t texels = 0;
+        size_t shadowRays = 0;
+        size_t bounceRays = 0;
+        double directMs = 0.0;
+        double bounceMs = 0.0;
+        size_t probes = 0;
+        size_t validProbes = 0;
+        size_t probeRays = 0;
+        double probeMs = 0.0;
+    };
+
+    explicit LightmapBaker(const BSPTreeSystem& bspSystem);
+
+    void SetSettings(const Settings& settings) { settings_ = settings; }
+    const Settings& GetSettings() const { return settings_; }
+
+    // Lights point down (0, -1, 0) rotated by the entity rotation, the same
+    // default LightSystem uses at runtime
+    void AddLight(const LightComponent& light, const Vector3& position, const Quaternion& rotation);
+    void ClearLights() { lights_.clear(); }
+    size_t GetLightCount() const { return lights_.size(); }
+
+    // Replace the world's lightmaps with a fresh bake
+    bool Bake(World& world);
+    // Replace the world's probe grid; needs the lightmaps from Bake (packed
+    // into an atlas or not)
+    bool BakeProbes(World& world);
+
+    const Stats& GetLastStats() const { return lastStats_; }
+
+    // Orthonormal in-plane axes for a surface normal. Stable for a given
+    // normal, so the baker, the atlas packer and the renderer agree on the
+    // lightmap projection without storing it.
+    static void SurfaceBasis(const Vector3& normal, Vector3& outTangent, Vector3& outBitangent);
+    // Planar coordinates of a point on the face (world units along the basis)
+    static Vector2 SurfacePlanar(const Face& face, const Vector3& point);
+
+private:
+    struct BakeLight {
+        LightType type;
+        Vector3 position;
+        Vector3 direction;      // Where the light points (spot, directional)
+        Vector3 color;          // Linear, intensity applied
+        float range;
+        float cosInner, cosOuter;
+        bool castShadows;
+    };
+
+    // Per surface lightmap layout during the bake
+    struct SurfaceLightmap {
+        int32_t surface = -1;
+        uint32_t width = 0, height = 0;
+        uint32_t firstTexel = 0;
+        float minU = 0.0f, minV = 0.0f, luxel = 1.0f;
+        Vector3 tangent{1, 0, 0}, bitangent{0, 1, 0}, normal{0, 0, 1};
+        float dist = 0.0f;
+        Vector3 albedo{0, 0, 0};
+    };
+
+    bool IsLit(const Face& face) const;
+    void LayoutSurface(const Face& face, SurfaceLightmap& layout) const;
+    // World position of a texel; polygon is the face in planar coordinates
+    Vector3 TexelPosition(const SurfaceLightmap& layout, const std::vector<Vector2>& polygon,
+                          uint32_t x, uint32_t y) const;
+    Vector3 DirectLight(const World& world, const Vector3& point, const Vector3& normal, size_t& shadowRays) const;
+    Vector3 GatherBounce(const World& world, const std::vector<int32_t>& surfaceLayouts,
+                         const std::vector<Vector3>& previous, const SurfaceLightmap& layout,
+                         const Vector3& point, uint32_t seed, size_t& rays) const;
+    BSPIrradianceProbe GatherProbe(const World& world, const Vector3& position,
+                                   const std::vector<Vector3>& directions, size_t& rays) const;
+
+    const BSPTreeSystem& bspSystem_;
+    Settings settings_;
+    std::vector<BakeLight> lights_;
+    std::vector<SurfaceLightmap> layouts_;
+    Stats lastStats_;
+};
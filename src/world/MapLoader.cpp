@@ -81,6 +81,11 @@ bool MapLoader::ParseYamlMap(const std::string& content, MapData& mapData) {
         }
 
         // Parse world geometry (brushes)
+        if (skipWorldGeometry_) {
+            LOG_INFO("Skipping world block - compiled world comes from the cache");
+            LOG_INFO("YAML map parsed successfully. Entities: " + std::to_string(mapData.entities.size()));
+            return true;
+        }
         LOG_INFO("About to extract world block from content of length: " + std::to_string(content.length()));
         std::string worldBlock = ExtractYamlBlock(content, "world");
         LOG_INFO("World block extraction - length: " + std::to_string(worldBlock.length()));
@@ -317,6 +322,7 @@ bool MapLoader::ParseBrush(const std::string& brushYaml, MapData& mapData) {
     std::vector<std::string> faceItems = ExtractYamlList(facesBlock, "");
     LOG_DEBUG("Found " + std::to_string(faceItems.size()) + " faces in brush");
 
+    size_t firstFace = mapData.faces.size();
     for (const auto& faceItem : faceItems) {
         // Parse each face
         if (!ParseBrushFace(faceItem, mapData)) {
@@ -325,6 +331,29 @@ bool MapLoader::ParseBrush(const std::string& brushYaml, MapData& mapData) {
         }
     }
 
+    // Area portal brushes (doorways, shutters) never become world faces: they
+    // only split the BSP into areas that can be closed off at runtime
+    std::string portalName = ExtractYamlValue(brushYaml, "areaportal");
+    if (!portalName.empty() && portalName != "false") {
+        BSPAreaPortalBrush portal;
+        portal.name = portalName == "true" ? "portal_" + std::to_string(mapData.areaPortals.size()) : portalName;
+        portal.startOpen = ExtractYamlValue(brushYaml, "closed") != "true";
+        portal.faces.assign(mapData.faces.begin() + firstFace, mapData.faces.end());
+        mapData.faces.erase(mapData.faces.begin() + firstFace, mapData.faces.end());
+        LOG_DEBUG("ParseBrush: area portal '" + portal.name + "' with " + std::to_string(portal.faces.size()) + " faces");
+        mapData.areaPortals.push_back(std::move(portal));
+        return true;
+    }
+
+    // Detail brushes (props, trim, pillars) are tagged per face since brushes are
+    // flattened here; the BSP compiler keeps them out of the cluster structure
+    std::string detailStr = ExtractYamlValue(brushYaml, "detail");
+    if (detailStr == "true" || detailStr == "1") {
+        for (size_t i = firstFace; i < mapData.faces.size(); ++i) {
+            mapData.faces[i].flags = mapData.faces[i].flags | FaceFlags::Detail;
+        }
+    }
+
     return true;
 }
 
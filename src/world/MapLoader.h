@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Brush.h"
+#include "BSPTree.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -162,12 +163,18 @@ struct MapData {
     std::string name;
     std::vector<Face> faces;
     std::vector<Brush> brushes;
+    std::vector<BSPAreaPortalBrush> areaPortals;   // Brushes tagged `areaportal: <name>`
     std::vector<MaterialInfo> materials;
     std::vector<std::unique_ptr<EntityDefinition>> entities;
     Color skyColor;
     float floorHeight;
     float ceilingHeight;
 
+    // Source file and compiled world cache state (see WorldCache)
+    std::string sourcePath;
+    uint64_t sourceKey = 0;         // WorldCache::ComputeKey of sourcePath, 0 for generated maps
+    bool worldFromCache = false;    // World geometry was skipped; the compiled world comes from the cache
+
     MapData() : skyColor(SKYBLUE), floorHeight(0.0f), ceilingHeight(8.0f) {}
 };
 
@@ -185,7 +192,13 @@ public:
     // Returns: Raw MapData struct, empty if file not found or parsing failed
     MapData LoadMap(const std::string& mapPath);
 
+    // Skip the `world:` block (brushes/faces) on the next LoadMap calls. Used when
+    // a compiled world cache already holds the built geometry.
+    void SetSkipWorldGeometry(bool skip) { skipWorldGeometry_ = skip; }
+
 private:
+    bool skipWorldGeometry_ = false;
+
     // Parse a .map file format
     // content: File content as string
     // mapData: Output map data
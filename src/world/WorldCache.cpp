@@ -0,0 +1,730 @@
+#include "WorldCache.h"
+#include "../utils/Logger.h"
+#include "../utils/MappedFile.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+
+constexpr char WORLD_CACHE_MAGIC[4] = {'P', 'S', 'W', 'C'};
+constexpr size_t WORLD_CACHE_ALIGN = 16;    // Every section starts 16-byte aligned (BSPNode SIMD loads)
+
+// Section ids double as indices into the section table
+enum WorldCacheSection : uint32_t {
+    SECTION_INFO = 0,
+    SECTION_STRINGS,            // World and portal names, not null terminated
+    SECTION_NODES,
+    SECTION_PLANES,
+    SECTION_MARK_SURFACES,
+    SECTION_VIS_DATA,
+    SECTION_CLUSTER_BOUNDS,
+    SECTION_SURFACES,
+    SECTION_SURFACE_VERTICES,
+    SECTION_SURFACE_UVS,
+    SECTION_SURFACE_STRETCH_UVS,
+    SECTION_CLUSTERS,
+    SECTION_CLUSTER_LEAVES,
+    SECTION_CLUSTER_SURFACES,
+    SECTION_AREAS,
+    SECTION_AREA_PORTAL_REFS,
+    SECTION_AREA_PORTALS,
+    SECTION_PORTAL_AREAS,
+    SECTION_BATCHES,
+    SECTION_BATCH_POSITIONS,
+    SECTION_BATCH_NORMALS,
+    SECTION_BATCH_UVS,
+    SECTION_BATCH_STRETCH_UVS,
+    SECTION_BATCH_LIGHTMAP_UVS,
+    SECTION_BATCH_COLORS,
+    SECTION_BATCH_INDICES,
+    SECTION_BATCH_RANGES,
+    SECTION_OCCLUDERS,
+    SECTION_LIGHTMAPS,
+    SECTION_LIGHTMAP_TEXELS,
+    SECTION_PROBE_GRID,         // Zero or one BSPProbeGrid
+    SECTION_PROBES,
+    SECTION_COUNT
+};
+
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint64_t fileSize;          // Catches truncated writes
+    uint32_t sectionCount;
+    uint32_t nodeSize;          // sizeof(BSPNode), catches layout changes on other compilers
+    WorldCacheBuild build;
+};
+
+struct CacheSectionEntry {
+    uint64_t offset;
+    uint64_t count;
+    uint32_t elementSize;
+    uint32_t reserved;
+};
+
+// Flat records for the structs that own vectors; the vectors become ranges
+// into shared arrays of their own section.
+struct CacheInfo {
+    int32_t numClusters;
+    int32_t clusterBytes;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
+struct CacheSurface {
+    Vector3 normal;
+    int32_t materialId;
+    uint64_t materialEntityId;
+    Color tint;
+    int32_t renderMode;
+    int32_t lightmapIndex;
+    Vector2 lightmapUVScale;
+    Vector2 lightmapUVOffset;
+    uint32_t flags;
+    uint32_t firstVertex, numVertices;
+    uint32_t firstUV, numUVs;
+    uint32_t firstStretchUV, numStretchUVs;
+};
+
+struct CacheCluster {
+    AABB bounds;
+    int32_t id;
+    int32_t headNode, numNodes;
+    int32_t area;
+    uint32_t firstLeaf, numLeaves;
+    uint32_t firstSurface, numSurfaces;
+};
+
+struct CacheArea {
+    uint32_t firstPortal, numPortals;
+};
+
+struct CacheAreaPortal {
+    AABB bounds;
+    uint32_t nameOffset, nameLength;
+    uint32_t firstArea, numAreas;
+    uint32_t open;
+};
+
+struct CacheBatch {
+    int32_t materialId;
+    int32_t lightmapPage;
+    uint32_t firstVertex, numVertices;
+    uint32_t firstIndex, numIndices;
+    uint32_t firstRange, numRanges;
+};
+
+static_assert(std::is_trivially_copyable<BSPPlane>::value, "BSPPlane must be memcpy-able");
+static_assert(std::is_trivially_copyable<AABB>::value, "AABB must be memcpy-able");
+static_assert(std::is_trivially_copyable<WorldGeometry::BatchRange>::value, "BatchRange must be memcpy-able");
+static_assert(std::is_trivially_copyable<BSPProbeGrid>::value, "BSPProbeGrid must be memcpy-able");
+static_assert(std::is_trivially_copyable<BSPIrradianceProbe>::value, "BSPIrradianceProbe must be memcpy-able");
+
+size_t AlignUp(size_t value) {
+    return (value + WORLD_CACHE_ALIGN - 1) & ~(WORLD_CACHE_ALIGN - 1);
+}
+
+// Accumulates sections in memory, then lays them out and writes the file in one go
+class CacheWriter {
+public:
+    template <typename T>
+    void Add(WorldCacheSection section, const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "cache sections must be memcpy-able");
+        Payload& payload = payloads_[section];
+        payload.elementSize = sizeof(T);
+        payload.count = count;
+        payload.bytes.resize(count * sizeof(T));
+        if (count > 0) std::memcpy(payload.bytes.data(), data, count * sizeof(T));
+    }
+
+    template <typename T>
+    void Add(WorldCacheSection section, const std::vector<T>& data) {
+        Add(section, data.data(), data.size());
+    }
+
+    bool Write(const std::string& path, uint64_t key, const WorldCacheBuild& build) const {
+        CacheSectionEntry table[SECTION_COUNT] = {};
+        size_t offset = AlignUp(sizeof(CacheHeader) + sizeof(table));
+        for (uint32_t i = 0; i < SECTION_COUNT; ++i) {
+            table[i].offset = offset;
+            table[i].count = payloads_[i].count;
+            table[i].elementSize = payloads_[i].elementSize;
+            offset = AlignUp(offset + payloads_[i].bytes.size());
+        }
+
+        CacheHeader header = {};
+        std::memcpy(header.magic, WORLD_CACHE_MAGIC, sizeof(header.magic));
+        header.version = WORLD_CACHE_VERSION;
+        header.key = key;
+        header.fileSize = offset;
+        header.sectionCount = SECTION_COUNT;
+        header.nodeSize = sizeof(BSPNode);
+        header.build = build;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        static const char padding[WORLD_CACHE_ALIGN] = {};
+        size_t written = 0;
+        auto write = [&](const void* data, size_t size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written += size;
+        };
+        auto pad = [&]() { write(padding, AlignUp(written) - written); };
+
+        write(&header, sizeof(header));
+        write(table, sizeof(table));
+        pad();
+        for (uint32_t i = 0; i < SECTION_COUNT; ++i) {
+            write(payloads_[i].bytes.data(), payloads_[i].bytes.size());
+            pad();
+        }
+        return file.good();
+    }
+
+private:
+    struct Payload {
+        std::vector<uint8_t> bytes;
+        uint64_t count = 0;
+        uint32_t elementSize = 0;
+    };
+    Payload payloads_[SECTION_COUNT];
+};
+
+// Typed, bounds-checked views into a mapped cache file
+class CacheReader {
+public:
+    CacheReader(const uint8_t* data, size_t size, const CacheSectionEntry* table)
+        : data_(data), size_(size), table_(table) {}
+
+    template <typename T>
+    bool Get(WorldCacheSection section, const T*& out, size_t& count) const {
+        const CacheSectionEntry& entry = table_[section];
+        if (entry.elementSize != sizeof(T) || entry.offset % alignof(T) != 0) return false;
+        if (entry.offset > size_ || entry.count > (size_ - entry.offset) / sizeof(T)) return false;
+        out = reinterpret_cast<const T*>(data_ + entry.offset);
+        count = static_cast<size_t>(entry.count);
+        return true;
+    }
+
+    template <typename T>
+    bool Copy(WorldCacheSection section, std::vector<T>& out) const {
+        const T* data = nullptr;
+        size_t count = 0;
+        if (!Get(section, data, count)) return false;
+        out.assign(data, data + count);
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    const CacheSectionEntry* table_;
+};
+
+bool InRange(uint64_t first, uint64_t count, size_t size) {
+    return first <= size && count <= size - first;
+}
+
+// Reject files whose indices would walk off the arrays (bit rot, hand edits)
+bool ValidateWorld(const World& world) {
+    const size_t nodeCount = world.nodes.size();
+    for (const BSPNode& node : world.nodes) {
+        if (node.IsLeaf()) {
+            if (!InRange(node.firstSurface, node.numSurfaces, world.markSurfaces.size())) return false;
+            if (node.cluster < -1 || node.cluster >= world.numClusters) return false;
+        } else {
+            if (node.planeNum < 0 || static_cast<size_t>(node.planeNum) >= world.planes.size()) return false;
+            for (int32_t child : node.children) {
+                if (child < 0 || static_cast<size_t>(child) >= nodeCount) return false;
+            }
+        }
+    }
+    for (uint32_t surface : world.markSurfaces) {
+        if (surface >= world.surfaces.size()) return false;
+    }
+    for (uint32_t surface : world.occluders) {
+        if (surface >= world.surfaces.size()) return false;
+    }
+    for (const BSPLightmap& lightmap : world.lightmaps) {
+        uint64_t texels = static_cast<uint64_t>(lightmap.width) * lightmap.height;
+        if (!InRange(lightmap.firstTexel, texels, world.lightmapTexels.size())) return false;
+    }
+    for (const Face& face : world.surfaces) {
+        if (face.lightmapIndex < -1 || face.lightmapIndex >= static_cast<int>(world.lightmaps.size())) return false;
+    }
+    if (!world.probes.empty() && world.probes.size() != world.probeGrid.ProbeCount()) return false;
+    if (world.numClusters < 0 || static_cast<size_t>(world.numClusters) != world.clusters.size()) return false;
+    if (world.clusterBounds.size() != world.clusters.size()) return false;
+    // GetClusterPVS indexes rows of clusterBytes: a row must hold a bit per cluster
+    if (world.clusterBytes != (world.numClusters + 7) / 8) return false;
+    if (world.visData.size() != static_cast<size_t>(world.numClusters) * static_cast<size_t>(world.clusterBytes)) return false;
+    for (const BSPCluster& cluster : world.clusters) {
+        if (cluster.headNode < 0 || cluster.numNodes < 0 ||
+            !InRange(static_cast<uint64_t>(cluster.headNode), static_cast<uint64_t>(cluster.numNodes), nodeCount)) return false;
+        for (int32_t leaf : cluster.leafNodes) {
+            if (leaf < 0 || static_cast<size_t>(leaf) >= nodeCount) return false;
+        }
+        for (uint32_t surface : cluster.surfaces) {
+            if (surface >= world.surfaces.size()) return false;
+        }
+    }
+    for (const BSPArea& area : world.areas) {
+        for (int32_t portal : area.portals) {
+            if (portal < 0 || static_cast<size_t>(portal) >= world.areaPortals.size()) return false;
+        }
+    }
+    for (const BSPAreaPortal& portal : world.areaPortals) {
+        for (int32_t area : portal.areas) {
+            if (area < 0 || static_cast<size_t>(area) >= world.areas.size()) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t WorldCache::ComputeKey(const std::string& mapPath) {
+    MappedFile file;
+    if (!file.Open(mapPath)) return 0;
+
+    // FNV-1a, seeded with the compiler version so a version bump changes every key
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    const uint32_t version = WORLD_CACHE_VERSION;
+    mix(reinterpret_cast<const uint8_t*>(&version), sizeof(version));
+    mix(file.GetData(), file.GetSize());
+    return hash != 0 ? hash : 1;
+}
+
+std::string WorldCache::GetCachePath(const std::string& mapPath) {
+    return std::filesystem::path(mapPath).replace_extension(".wcache").string();
+}
+
+std::string WorldCache::GetRuntimeCachePath(const std::string& mapPath) {
+    return std::filesystem::path(mapPath).replace_extension(".runtime.wcache").string();
+}
+
+bool WorldCache::Save(const std::string& cachePath, uint64_t key, const WorldCacheBuild& build, const World& world,
+                      const std::vector<WorldGeometry::StaticBatch>& batches) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::string strings = world.name;
+    CacheInfo info = {world.numClusters, world.clusterBytes, 0, static_cast<uint32_t>(world.name.size())};
+
+    // Surfaces: vertex/uv vectors become ranges into two shared arrays
+    std::vector<CacheSurface> surfaces;
+    std::vector<Vector3> surfaceVertices;
+    std::vector<Vector2> surfaceUVs;
+    std::vector<Vector2> surfaceStretchUVs;
+    surfaces.reserve(world.surfaces.size());
+    for (const Face& face : world.surfaces) {
+        CacheSurface s = {};
+        s.normal = face.normal;
+        s.materialId = face.materialId;
+        s.materialEntityId = face.materialEntityId;
+        s.tint = face.tint;
+        s.renderMode = static_cast<int32_t>(face.renderMode);
+        s.lightmapIndex = face.lightmapIndex;
+        s.lightmapUVScale = face.lightmapUVScale;
+        s.lightmapUVOffset = face.lightmapUVOffset;
+        s.flags = static_cast<uint32_t>(face.flags);
+        s.firstVertex = static_cast<uint32_t>(surfaceVertices.size());
+        s.numVertices = static_cast<uint32_t>(face.vertices.size());
+        s.firstUV = static_cast<uint32_t>(surfaceUVs.size());
+        s.numUVs = static_cast<uint32_t>(face.uvs.size());
+        s.firstStretchUV = static_cast<uint32_t>(surfaceStretchUVs.size());
+        s.numStretchUVs = static_cast<uint32_t>(face.stretchUVs.size());
+        surfaceVertices.insert(surfaceVertices.end(), face.vertices.begin(), face.vertices.end());
+        surfaceUVs.insert(surfaceUVs.end(), face.uvs.begin(), face.uvs.end());
+        surfaceStretchUVs.insert(surfaceStretchUVs.end(), face.stretchUVs.begin(), face.stretchUVs.end());
+        surfaces.push_back(s);
+    }
+
+    std::vector<CacheCluster> clusters;
+    std::vector<int32_t> clusterLeaves;
+    std::vector<uint32_t> clusterSurfaces;
+    clusters.reserve(world.clusters.size());
+    for (const BSPCluster& cluster : world.clusters) {
+        CacheCluster c = {};
+        c.bounds = cluster.bounds;
+        c.id = cluster.id;
+        c.headNode = cluster.headNode;
+        c.numNodes = cluster.numNodes;
+        c.area = cluster.area;
+        c.firstLeaf = static_cast<uint32_t>(clusterLeaves.size());
+        c.numLeaves = static_cast<uint32_t>(cluster.leafNodes.size());
+        c.firstSurface = static_cast<uint32_t>(clusterSurfaces.size());
+        c.numSurfaces = static_cast<uint32_t>(cluster.surfaces.size());
+        clusterLeaves.insert(clusterLeaves.end(), cluster.leafNodes.begin(), cluster.leafNodes.end());
+        clusterSurfaces.insert(clusterSurfaces.end(), cluster.surfaces.begin(), cluster.surfaces.end());
+        clusters.push_back(c);
+    }
+
+    std::vector<CacheArea> areas;
+    std::vector<int32_t> areaPortalRefs;
+    for (const BSPArea& area : world.areas) {
+        areas.push_back({static_cast<uint32_t>(areaPortalRefs.size()), static_cast<uint32_t>(area.portals.size())});
+        areaPortalRefs.insert(areaPortalRefs.end(), area.portals.begin(), area.portals.end());
+    }
+
+    std::vector<CacheAreaPortal> portals;
+    std::vector<int32_t> portalAreas;
+    for (const BSPAreaPortal& portal : world.areaPortals) {
+        CacheAreaPortal p = {};
+        p.bounds = portal.bounds;
+        p.nameOffset = static_cast<uint32_t>(strings.size());
+        p.nameLength = static_cast<uint32_t>(portal.name.size());
+        p.firstArea = static_cast<uint32_t>(portalAreas.size());
+        p.numAreas = static_cast<uint32_t>(portal.areas.size());
+        p.open = portal.open ? 1u : 0u;
+        strings += portal.name;
+        portalAreas.insert(portalAreas.end(), portal.areas.begin(), portal.areas.end());
+        portals.push_back(p);
+    }
+
+    std::vector<CacheBatch> cacheBatches;
+    std::vector<Vector3> batchPositions, batchNormals;
+    std::vector<Vector2> batchUVs, batchStretchUVs, batchLightmapUVs;
+    std::vector<Color> batchColors;
+    std::vector<unsigned int> batchIndices;
+    std::vector<WorldGeometry::BatchRange> batchRanges;
+    for (const auto& batch : batches) {
+        // Streams are per-vertex; a batch missing one can't be stored as ranges
+        const size_t vertexCount = batch.positions.size();
+        if (batch.normals.size() != vertexCount || batch.uvs.size() != vertexCount ||
+            batch.stretchUVs.size() != vertexCount || batch.lightmapUVs.size() != vertexCount ||
+            batch.colors.size() != vertexCount) {
+            LOG_WARNING("WorldCache: batch for material " + std::to_string(batch.materialId) +
+                        " has mismatched vertex streams, not caching");
+            return false;
+        }
+        CacheBatch b = {};
+        b.materialId = batch.materialId;
+        b.lightmapPage = batch.lightmapPage;
+        b.firstVertex = static_cast<uint32_t>(batchPositions.size());
+        b.numVertices = static_cast<uint32_t>(batch.positions.size());
+        b.firstIndex = static_cast<uint32_t>(batchIndices.size());
+        b.numIndices = static_cast<uint32_t>(batch.indices.size());
+        b.firstRange = static_cast<uint32_t>(batchRanges.size());
+        b.numRanges = static_cast<uint32_t>(batch.clusterRanges.size());
+        batchPositions.insert(batchPositions.end(), batch.positions.begin(), batch.positions.end());
+        batchNormals.insert(batchNormals.end(), batch.normals.begin(), batch.normals.end());
+        batchUVs.insert(batchUVs.end(), batch.uvs.begin(), batch.uvs.end());
+        batchStretchUVs.insert(batchStretchUVs.end(), batch.stretchUVs.begin(), batch.stretchUVs.end());
+        batchLightmapUVs.insert(batchLightmapUVs.end(), batch.lightmapUVs.begin(), batch.lightmapUVs.end());
+        batchColors.insert(batchColors.end(), batch.colors.begin(), batch.colors.end());
+        batchIndices.insert(batchIndices.end(), batch.indices.begin(), batch.indices.end());
+        batchRanges.insert(batchRanges.end(), batch.clusterRanges.begin(), batch.clusterRanges.end());
+        cacheBatches.push_back(b);
+    }
+
+    CacheWriter writer;
+    writer.Add(SECTION_INFO, &info, 1);
+    writer.Add(SECTION_STRINGS, strings.data(), strings.size());
+    writer.Add(SECTION_NODES, world.nodes);
+    writer.Add(SECTION_PLANES, world.planes);
+    writer.Add(SECTION_MARK_SURFACES, world.markSurfaces);
+    writer.Add(SECTION_VIS_DATA, world.visData);
+    writer.Add(SECTION_CLUSTER_BOUNDS, world.clusterBounds);
+    writer.Add(SECTION_SURFACES, surfaces);
+    writer.Add(SECTION_SURFACE_VERTICES, surfaceVertices);
+    writer.Add(SECTION_SURFACE_UVS, surfaceUVs);
+    writer.Add(SECTION_SURFACE_STRETCH_UVS, surfaceStretchUVs);
+    writer.Add(SECTION_CLUSTERS, clusters);
+    writer.Add(SECTION_CLUSTER_LEAVES, clusterLeaves);
+    writer.Add(SECTION_CLUSTER_SURFACES, clusterSurfaces);
+    writer.Add(SECTION_AREAS, areas);
+    writer.Add(SECTION_AREA_PORTAL_REFS, areaPortalRefs);
+    writer.Add(SECTION_AREA_PORTALS, portals);
+    writer.Add(SECTION_PORTAL_AREAS, portalAreas);
+    writer.Add(SECTION_BATCHES, cacheBatches);
+    writer.Add(SECTION_BATCH_POSITIONS, batchPositions);
+    writer.Add(SECTION_BATCH_NORMALS, batchNormals);
+    writer.Add(SECTION_BATCH_UVS, batchUVs);
+    writer.Add(SECTION_BATCH_STRETCH_UVS, batchStretchUVs);
+    writer.Add(SECTION_BATCH_LIGHTMAP_UVS, batchLightmapUVs);
+    writer.Add(SECTION_BATCH_COLORS, batchColors);
+    writer.Add(SECTION_BATCH_INDICES, batchIndices);
+    writer.Add(SECTION_BATCH_RANGES, batchRanges);
+    writer.Add(SECTION_OCCLUDERS, world.occluders);
+    writer.Add(SECTION_LIGHTMAPS, world.lightmaps);
+    writer.Add(SECTION_LIGHTMAP_TEXELS, world.lightmapTexels);
+    writer.Add(SECTION_PROBE_GRID, &world.probeGrid, world.probes.empty() ? 0 : 1);
+    writer.Add(SECTION_PROBES, world.probes);
+
+    std::string tempPath = cachePath + ".tmp";
+    if (!writer.Write(tempPath, key, build)) {
+        LOG_WARNING("WorldCache: failed to write " + tempPath);
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        LOG_WARNING("WorldCache: failed to move cache into place at " + cachePath + ": " + ec.message());
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    float ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    LOG_INFO("WorldCache: wrote " + cachePath + " (" + std::to_string(world.nodes.size()) + " nodes, " +
+             std::to_string(world.surfaces.size()) + " surfaces, " + std::to_string(world.visData.size()) +
+             " PVS bytes) in " + std::to_string(ms) + " ms");
+    return true;
+}
+
+std::unique_ptr<World> WorldCache::Load(const std::string& cachePath, uint64_t key,
+                                        std::vector<WorldGeometry::StaticBatch>& outBatches,
+                                        WorldCacheBuild* outBuild) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    outBatches.clear();
+
+    MappedFile file;
+    if (!file.Open(cachePath)) {
+        LOG_DEBUG("WorldCache: no cache at " + cachePath);
+        return nullptr;
+    }
+
+    const uint8_t* data = file.GetData();
+    const size_t size = file.GetSize();
+    const size_t tableEnd = sizeof(CacheHeader) + sizeof(CacheSectionEntry) * SECTION_COUNT;
+    if (size < tableEnd) {
+        LOG_WARNING("WorldCache: " + cachePath + " is truncated, rebuilding");
+        return nullptr;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, WORLD_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != WORLD_CACHE_VERSION || header.sectionCount != SECTION_COUNT ||
+        header.nodeSize != sizeof(BSPNode)) {
+        LOG_INFO("WorldCache: " + cachePath + " was written by another compiler version, rebuilding");
+        return nullptr;
+    }
+    if (header.key != key) {
+        LOG_INFO("WorldCache: " + cachePath + " is stale (map changed), rebuilding");
+        return nullptr;
+    }
+    if (header.fileSize != size) {
+        LOG_WARNING("WorldCache: " + cachePath + " is truncated, rebuilding");
+        return nullptr;
+    }
+
+    CacheReader reader(data, size, reinterpret_cast<const CacheSectionEntry*>(data + sizeof(CacheHeader)));
+    auto world = std::make_unique<World>();
+    bool ok = true;
+
+    const CacheInfo* info = nullptr;
+    const char* strings = nullptr;
+    size_t count = 0, stringCount = 0;
+    ok = ok && reader.Get(SECTION_INFO, info, count) && count == 1;
+    ok = ok && reader.Get(SECTION_STRINGS, strings, stringCount);
+    if (ok) {
+        world->numClusters = info->numClusters;
+        world->clusterBytes = info->clusterBytes;
+        ok = InRange(info->nameOffset, info->nameLength, stringCount);
+        if (ok) world->name.assign(strings + info->nameOffset, info->nameLength);
+    }
+
+    // Plain arrays go straight from the mapping into the world
+    ok = ok && reader.Copy(SECTION_NODES, world->nodes);
+    ok = ok && reader.Copy(SECTION_PLANES, world->planes);
+    ok = ok && reader.Copy(SECTION_MARK_SURFACES, world->markSurfaces);
+    ok = ok && reader.Copy(SECTION_VIS_DATA, world->visData);
+    ok = ok && reader.Copy(SECTION_CLUSTER_BOUNDS, world->clusterBounds);
+    ok = ok && reader.Copy(SECTION_OCCLUDERS, world->occluders);
+    ok = ok && reader.Copy(SECTION_LIGHTMAPS, world->lightmaps);
+    ok = ok && reader.Copy(SECTION_LIGHTMAP_TEXELS, world->lightmapTexels);
+    ok = ok && reader.Copy(SECTION_PROBES, world->probes);
+
+    const BSPProbeGrid* probeGrid = nullptr;
+    size_t probeGridCount = 0;
+    ok = ok && reader.Get(SECTION_PROBE_GRID, probeGrid, probeGridCount) && probeGridCount <= 1;
+    if (ok && probeGridCount == 1) world->probeGrid = *probeGrid;
+
+    const CacheSurface* surfaces = nullptr;
+    const Vector3* vertices = nullptr;
+    const Vector2* uvs = nullptr;
+    const Vector2* stretchUVs = nullptr;
+    size_t surfaceCount = 0, vertexCount = 0, uvCount = 0, stretchUVCount = 0;
+    ok = ok && reader.Get(SECTION_SURFACES, surfaces, surfaceCount);
+    ok = ok && reader.Get(SECTION_SURFACE_VERTICES, vertices, vertexCount);
+    ok = ok && reader.Get(SECTION_SURFACE_UVS, uvs, uvCount);
+    ok = ok && reader.Get(SECTION_SURFACE_STRETCH_UVS, stretchUVs, stretchUVCount);
+    if (ok) {
+        world->surfaces.resize(surfaceCount);
+        for (size_t i = 0; i < surfaceCount && ok; ++i) {
+            const CacheSurface& s = surfaces[i];
+            if (!InRange(s.firstVertex, s.numVertices, vertexCount) || !InRange(s.firstUV, s.numUVs, uvCount) ||
+                !InRange(s.firstStretchUV, s.numStretchUVs, stretchUVCount)) {
+                ok = false;
+                break;
+            }
+            Face& face = world->surfaces[i];
+            face.vertices.assign(vertices + s.firstVertex, vertices + s.firstVertex + s.numVertices);
+            face.uvs.assign(uvs + s.firstUV, uvs + s.firstUV + s.numUVs);
+            face.stretchUVs.assign(stretchUVs + s.firstStretchUV, stretchUVs + s.firstStretchUV + s.numStretchUVs);
+            face.normal = s.normal;
+            face.materialId = s.materialId;
+            face.materialEntityId = s.materialEntityId;
+            face.tint = s.tint;
+            face.renderMode = static_cast<FaceRenderMode>(s.renderMode);
+            face.lightmapIndex = s.lightmapIndex;
+            face.lightmapUVScale = s.lightmapUVScale;
+            face.lightmapUVOffset = s.lightmapUVOffset;
+            face.flags = static_cast<FaceFlags>(s.flags);
+        }
+    }
+
+    const CacheCluster* clusters = nullptr;
+    const int32_t* leaves = nullptr;
+    const uint32_t* clusterSurfaces = nullptr;
+    size_t clusterCount = 0, leafCount = 0, clusterSurfaceCount = 0;
+    ok = ok && reader.Get(SECTION_CLUSTERS, clusters, clusterCount);
+    ok = ok && reader.Get(SECTION_CLUSTER_LEAVES, leaves, leafCount);
+    ok = ok && reader.Get(SECTION_CLUSTER_SURFACES, clusterSurfaces, clusterSurfaceCount);
+    if (ok) {
+        world->clusters.resize(clusterCount);
+        for (size_t i = 0; i < clusterCount; ++i) {
+            const CacheCluster& c = clusters[i];
+            if (!InRange(c.firstLeaf, c.numLeaves, leafCount) ||
+                !InRange(c.firstSurface, c.numSurfaces, clusterSurfaceCount)) {
+                ok = false;
+                break;
+            }
+            BSPCluster& cluster = world->clusters[i];
+            cluster.id = c.id;
+            cluster.bounds = c.bounds;
+            cluster.headNode = c.headNode;
+            cluster.numNodes = c.numNodes;
+            cluster.area = c.area;
+            cluster.leafNodes.assign(leaves + c.firstLeaf, leaves + c.firstLeaf + c.numLeaves);
+            cluster.surfaces.assign(clusterSurfaces + c.firstSurface, clusterSurfaces + c.firstSurface + c.numSurfaces);
+        }
+    }
+
+    const CacheArea* areas = nullptr;
+    const int32_t* portalRefs = nullptr;
+    size_t areaCount = 0, portalRefCount = 0;
+    ok = ok && reader.Get(SECTION_AREAS, areas, areaCount);
+    ok = ok && reader.Get(SECTION_AREA_PORTAL_REFS, portalRefs, portalRefCount);
+    if (ok) {
+        world->areas.resize(areaCount);
+        for (size_t i = 0; i < areaCount; ++i) {
+            if (!InRange(areas[i].firstPortal, areas[i].numPortals, portalRefCount)) {
+                ok = false;
+                break;
+            }
+            world->areas[i].portals.assign(portalRefs + areas[i].firstPortal,
+                                           portalRefs + areas[i].firstPortal + areas[i].numPortals);
+        }
+    }
+
+    const CacheAreaPortal* portals = nullptr;
+    const int32_t* portalAreas = nullptr;
+    size_t portalCount = 0, portalAreaCount = 0;
+    ok = ok && reader.Get(SECTION_AREA_PORTALS, portals, portalCount);
+    ok = ok && reader.Get(SECTION_PORTAL_AREAS, portalAreas, portalAreaCount);
+    if (ok) {
+        world->areaPortals.resize(portalCount);
+        for (size_t i = 0; i < portalCount; ++i) {
+            const CacheAreaPortal& p = portals[i];
+            if (!InRange(p.nameOffset, p.nameLength, stringCount) || !InRange(p.firstArea, p.numAreas, portalAreaCount)) {
+                ok = false;
+                break;
+            }
+            BSPAreaPortal& portal = world->areaPortals[i];
+            portal.name.assign(strings + p.nameOffset, p.nameLength);
+            portal.bounds = p.bounds;
+            portal.areas.assign(portalAreas + p.firstArea, portalAreas + p.firstArea + p.numAreas);
+            portal.open = p.open != 0;
+        }
+    }
+
+    const CacheBatch* batches = nullptr;
+    const Vector3* positions = nullptr;
+    const Vector3* normals = nullptr;
+    const Vector2* batchUVs = nullptr;
+    const Vector2* batchStretchUVs = nullptr;
+    const Vector2* batchLightmapUVs = nullptr;
+    const Color* colors = nullptr;
+    const unsigned int* indices = nullptr;
+    const WorldGeometry::BatchRange* ranges = nullptr;
+    size_t batchCount = 0, positionCount = 0, normalCount = 0, batchUVCount = 0, batchStretchUVCount = 0,
+           batchLightmapUVCount = 0, colorCount = 0, indexCount = 0, rangeCount = 0;
+    ok = ok && reader.Get(SECTION_BATCHES, batches, batchCount);
+    ok = ok && reader.Get(SECTION_BATCH_POSITIONS, positions, positionCount);
+    ok = ok && reader.Get(SECTION_BATCH_NORMALS, normals, normalCount);
+    ok = ok && reader.Get(SECTION_BATCH_UVS, batchUVs, batchUVCount);
+    ok = ok && reader.Get(SECTION_BATCH_STRETCH_UVS, batchStretchUVs, batchStretchUVCount);
+    ok = ok && reader.Get(SECTION_BATCH_LIGHTMAP_UVS, batchLightmapUVs, batchLightmapUVCount);
+    ok = ok && reader.Get(SECTION_BATCH_COLORS, colors, colorCount);
+    ok = ok && reader.Get(SECTION_BATCH_INDICES, indices, indexCount);
+    ok = ok && reader.Get(SECTION_BATCH_RANGES, ranges, rangeCount);
+    ok = ok && normalCount == positionCount && batchUVCount == positionCount && batchStretchUVCount == positionCount &&
+         batchLightmapUVCount == positionCount && colorCount == positionCount;
+    if (ok) {
+        outBatches.resize(batchCount);
+        for (size_t i = 0; i < batchCount; ++i) {
+            const CacheBatch& b = batches[i];
+            if (!InRange(b.firstVertex, b.numVertices, positionCount) || !InRange(b.firstIndex, b.numIndices, indexCount) ||
+                !InRange(b.firstRange, b.numRanges, rangeCount) || b.lightmapPage < -1 ||
+                b.lightmapPage >= static_cast<int32_t>(world->lightmaps.size())) {
+                ok = false;
+                break;
+            }
+            auto& batch = outBatches[i];
+            batch.materialId = b.materialId;
+            batch.lightmapPage = b.lightmapPage;
+            batch.positions.assign(positions + b.firstVertex, positions + b.firstVertex + b.numVertices);
+            batch.normals.assign(normals + b.firstVertex, normals + b.firstVertex + b.numVertices);
+            batch.uvs.assign(batchUVs + b.firstVertex, batchUVs + b.firstVertex + b.numVertices);
+            batch.stretchUVs.assign(batchStretchUVs + b.firstVertex, batchStretchUVs + b.firstVertex + b.numVertices);
+            batch.lightmapUVs.assign(batchLightmapUVs + b.firstVertex,
+                                     batchLightmapUVs + b.firstVertex + b.numVertices);
+            batch.colors.assign(colors + b.firstVertex, colors + b.firstVertex + b.numVertices);
+            batch.indices.assign(indices + b.firstIndex, indices + b.firstIndex + b.numIndices);
+            batch.clusterRanges.assign(ranges + b.firstRange, ranges + b.firstRange + b.numRanges);
+            for (const auto& range : batch.clusterRanges) {
+                if (!InRange(range.firstIndex, range.indexCount, b.numIndices) ||
+                    range.cluster >= world->numClusters) {
+                    ok = false;
+                }
+            }
+            for (unsigned int index : batch.indices) {
+                if (index >= b.numVertices) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!ok || !ValidateWorld(*world)) {
+        LOG_WARNING("WorldCache: " + cachePath + " is corrupt, rebuilding");
+        outBatches.clear();
+        return nullptr;
+    }
+
+    if (outBuild) *outBuild = header.build;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    float ms = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    LOG_INFO("WorldCache: loaded " + cachePath + " (" + std::to_string(world->nodes.size()) + " nodes, " +
+             std::to_string(world->surfaces.size()) + " surfaces, " + std::to_string(world->numClusters) +
+             " clusters, " + (header.build.lit ? "lit" : "unlit") + ") in " + std::to_string(ms) + " ms");
+    return world;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "WorldGeometry.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bump whenever the BSP compiler's output changes (splitter choice, clustering,
+// PVS, area building) or any serialized struct changes layout. Old caches then
+// miss and get rebuilt instead of loading stale worlds.
+constexpr uint32_t WORLD_CACHE_VERSION = 13;
+
+// How a cache was compiled, stored in its header. Only paintsplash_mapc bakes
+// lightmaps and probes; a compile at load time is unlit.
+struct WorldCacheBuild {
+    uint32_t lit = 0;             // Lightmaps baked
+    uint32_t mergedFaces = 1;     // Coplanar merge and T-junction fixing ran
+    int32_t bounces = 0;          // Indirect light bounces (lit only)
+    float luxelSize = 0.0f;       // Lightmap texel size (lit only)
+    float probeSpacing = 0.0f;    // 0: no irradiance probes
+};
+
+// Compiled world cache: the output of BSPTreeSystem::LoadWorld (nodes, planes,
+// surfaces, clusters, PVS, areas), baked lightmaps and irradiance probes, and
+// the static batches, stored next to the .map it was compiled from. The file
+// is a header, a section table and 16-byte aligned arrays, so loading is a
+// memory map, a bounds check per section and one copy per array - no parsing.
+class WorldCache {
+public:
+    // Cache key for a map file: hash of its bytes mixed with WORLD_CACHE_VERSION.
+    // Returns 0 when the file can't be read (0 is never a valid key).
+    static uint64_t ComputeKey(const std::string& mapPath);
+
+    // "<map path without extension>.wcache": written by paintsplash_mapc, and
+    // the first place the game looks
+    static std::string GetCachePath(const std::string& mapPath);
+    // "<map path without extension>.runtime.wcache": the game's own unlit
+    // compile, used only while the mapc cache is missing or stale. Kept apart
+    // so a load-time compile never replaces the baked cache (or makes it look
+    // up to date to the build).
+    static std::string GetRuntimeCachePath(const std::string& mapPath);
+
+    // Write the compiled world. Written to a temp file and renamed into place so
+    // a crash mid-write never leaves a truncated cache behind.
+    static bool Save(const std::string& cachePath, uint64_t key, const WorldCacheBuild& build, const World& world,
+                     const std::vector<WorldGeometry::StaticBatch>& batches);
+
+    // Map the cache and rebuild the world from it. Returns nullptr on any
+    // mismatch (missing file, wrong key/version/layout, truncated or corrupt data).
+    // outBuild, if given, receives how the cache was compiled.
+    static std::unique_ptr<World> Load(const std::string& cachePath, uint64_t key,
+                                       std::vector<WorldGeometry::StaticBatch>& outBatches,
+                                       WorldCacheBuild* outBuild = nullptr);
+};
@@ -1,6 +1,13 @@
 #include "WorldGeometry.h"
+#include "WorldMesh.h"
+#include "LightmapBaker.h"
 #include "../utils/Logger.h"
 #include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
 #include <unordered_map>
 #include <cfloat>
 #include "../rendering/Skybox.h"
@@ -131,6 +138,7 @@ void WorldGeometry::Clear() {
     materialIdMap.clear();
     brushes.clear();
     faces.clear();
+    areaPortalBrushes.clear();
     levelName = "Untitled Level";
     levelBoundsMin = {0.0f, 0.0f, 0.0f};
     levelBoundsMax = {0.0f, 0.0f, 0.0f};
@@ -208,10 +216,9 @@ void WorldGeometry::BuildBSPFromFaces(const std::vector<Face>& inFaces) {
         }
     }
 
-    // Note: BSP tree is now built externally and set via SetBSPTree()
-    BuildBatchesFromFaces(faces);
-    size_t triCount = 0; for (const auto& b : batches) triCount += b.indices.size()/3;
-    LOG_INFO("WorldGeometry: built " + std::to_string(batches.size()) + " batches, ~" + std::to_string(triCount) + " tris");
+    // Note: BSP tree is now built externally and set via SetBSPTree().
+    // Static batches are built from the compiled surfaces (BuildBatchesFromWorld)
+    // so their index ranges follow the vis clusters.
     if (bspTree) {
         LOG_INFO("WorldGeometry: BSP tree has " + std::to_string(bspTree->GetClusterCount()) + " clusters");
     }
@@ -221,7 +228,10 @@ void WorldGeometry::BuildBSPFromBrushes(const std::vector<Brush>& inBrushes) {
     brushes = inBrushes;
     std::vector<Face> flat;
     for (const auto& b : brushes) {
-        for (const auto& f : b.faces) flat.push_back(f);
+        for (const auto& f : b.faces) {
+            flat.push_back(f);
+            if (b.isDetail) flat.back().flags = flat.back().flags | FaceFlags::Detail;
+        }
     }
     faces = flat;
 
@@ -232,10 +242,9 @@ void WorldGeometry::BuildBSPFromBrushes(const std::vector<Brush>& inBrushes) {
         }
     }
 
-    // Note: BSP tree is now built externally and set via SetBSPTree()
-    BuildBatchesFromFaces(faces);
-    size_t triCount = 0; for (const auto& b : batches) triCount += b.indices.size()/3;
-    LOG_INFO("WorldGeometry: built " + std::to_string(batches.size()) + " batches from brushes, ~" + std::to_string(triCount) + " tris");
+    // Note: BSP tree is now built externally and set via SetBSPTree().
+    // Static batches are built from the compiled surfaces (BuildBatchesFromWorld)
+    // so their index ranges follow the vis clusters.
     if (bspTree) {
         LOG_INFO("WorldGeometry: BSP tree has " + std::to_string(bspTree->GetClusterCount()) + " clusters");
     }
@@ -380,91 +389,287 @@ void WorldGeometry::ClearBatches() {
 
 
 
-void WorldGeometry::BuildBatchesFromFaces(const std::vector<Face>& inFaces) {
-    // Build renderable geometry batches from BSP faces
-    //
-    // This function converts BSP face data into optimized render batches with proper UV coordinates.
-    // Key features:
-    // - Groups faces by material for efficient rendering
-    // - Triangulates polygons (quads -> 2 triangles, n-gons -> triangle fan)
-    // - Calculates UV coordinates using tangent space projection for consistent texture orientation
-    // - Handles both horizontal (floor/ceiling) and vertical (wall) faces appropriately
+namespace {
 
-    // Reset existing batches
-    ClearBatches();
+// Vertices weld when they match after quantizing, so copies that differ only
+// by float noise from BSP splitting still share one entry
+constexpr float WELD_POSITION_SCALE = 1024.0f;
+constexpr float WELD_UV_SCALE = 4096.0f;
+constexpr float WELD_NORMAL_SCALE = 4096.0f;
+
+struct BatchVertexKey {
+    int32_t values[13];  // position, normal, uv, stretch uv, lightmap uv, color
+
+    bool operator==(const BatchVertexKey& other) const {
+        return std::equal(std::begin(values), std::end(values), std::begin(other.values));
+    }
+};
+
+struct BatchVertexKeyHash {
+    size_t operator()(const BatchVertexKey& key) const {
+        uint64_t h = 1469598103934665603ull;
+        for (int32_t value : key.values) {
+            h ^= static_cast<uint32_t>(value);
+            h *= 1099511628211ull;
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+BatchVertexKey MakeBatchVertexKey(const Vector3& position, const Vector3& normal, const Vector2& uv,
+                                  const Vector2& stretchUV, const Vector2& lightmapUV, Color color) {
+    auto q = [](float value, float scale) { return static_cast<int32_t>(std::lround(value * scale)); };
+    BatchVertexKey key = {{
+        q(position.x, WELD_POSITION_SCALE), q(position.y, WELD_POSITION_SCALE), q(position.z, WELD_POSITION_SCALE),
+        q(normal.x, WELD_NORMAL_SCALE), q(normal.y, WELD_NORMAL_SCALE), q(normal.z, WELD_NORMAL_SCALE),
+        q(uv.x, WELD_UV_SCALE), q(uv.y, WELD_UV_SCALE),
+        q(stretchUV.x, WELD_UV_SCALE), q(stretchUV.y, WELD_UV_SCALE),
+        q(lightmapUV.x, WELD_UV_SCALE), q(lightmapUV.y, WELD_UV_SCALE),
+        static_cast<int32_t>((uint32_t(color.r) << 24) | (uint32_t(color.g) << 16) | (uint32_t(color.b) << 8) |
+                             uint32_t(color.a)),
+    }};
+    return key;
+}
 
-    // Group faces by materialId
-    std::unordered_map<unsigned int, size_t> batchIndexByMaterial;
-    for (const auto& f : inFaces) {
-        if (batchIndexByMaterial.find(f.materialId) == batchIndexByMaterial.end()) {
+struct PendingTriangle {
+    int32_t cluster;
+    unsigned int corners[3];
+};
+
+} // namespace
+
+void WorldGeometry::BuildBatchesFromFaces(const std::vector<Face>& inFaces, const std::vector<int32_t>& faceClusters) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    ClearBatches();
+    lastBatchStats_ = BatchBuildStats();
+
+    // Weld each face's corners into its material and lightmap page's batch
+    // and collect the triangles; the index buffers are written once they can
+    // be ordered
+    std::unordered_map<uint64_t, size_t> batchIndexByKey;
+    std::vector<std::unordered_map<BatchVertexKey, unsigned int, BatchVertexKeyHash>> welds;
+    std::vector<std::vector<PendingTriangle>> pending;
+    std::vector<uint32_t> corners;
+    std::vector<unsigned int> faceVertices;
+    std::vector<Vector2> computedStretchUVs;
+
+    for (size_t i = 0; i < inFaces.size(); ++i) {
+        const Face& f = inFaces[i];
+        if (HasFlag(f.flags, FaceFlags::NoDraw) || f.vertices.size() < 3) continue;
+
+        corners.clear();
+        if (!WorldMesh::TriangulatePolygon(f.vertices, corners) || corners.empty()) continue;
+
+        const int lightmapPage = f.lightmapIndex >= 0 ? f.lightmapIndex : -1;
+        const uint64_t batchKey = (static_cast<uint64_t>(static_cast<uint32_t>(f.materialId)) << 32) |
+                                  static_cast<uint32_t>(lightmapPage);
+        auto found = batchIndexByKey.find(batchKey);
+        size_t bi;
+        if (found == batchIndexByKey.end()) {
             StaticBatch batch;
             batch.materialId = f.materialId;
+            batch.lightmapPage = lightmapPage;
             batches.push_back(std::move(batch));
-            batchIndexByMaterial[f.materialId] = batches.size() - 1;
+            welds.emplace_back();
+            pending.emplace_back();
+            bi = batches.size() - 1;
+            batchIndexByKey[batchKey] = bi;
+        } else {
+            bi = found->second;
         }
-        size_t bi = batchIndexByMaterial[f.materialId];
-        auto& batch = batches[bi];
-
-        // Handle polygons - prefer quads, triangulate if necessary
-        const auto& v = f.vertices;
-        if (v.size() == 4) {
-            // Handle as quad
-            unsigned int base = (unsigned int)batch.positions.size();
-
-            // Add the 4 vertices
-            for (size_t i = 0; i < 4; i++) {
-                batch.positions.push_back(v[i]);
-            }
-
-            // Calculate UVs
-            Vector3 edge1 = Vector3Subtract(v[1], v[0]);
-            Vector3 edge2 = Vector3Subtract(v[2], v[1]);
-            Vector3 faceNormal = Vector3Normalize(Vector3CrossProduct(edge1, edge2));
-            bool isHorizontal = fabsf(faceNormal.y) > 0.9f;
-
-            Vector3 minVert = v[0];
-            Vector3 maxVert = v[0];
-            for (const auto& vertex : v) {
-                minVert = Vector3Min(minVert, vertex);
-                maxVert = Vector3Max(maxVert, vertex);
+        StaticBatch& batch = batches[bi];
+
+        // Same uv choice as Renderer::RenderFace: stretch UVs baked by the
+        // world build, and standing in for authored UVs a face doesn't have
+        const bool bakedStretchUVs = f.stretchUVs.size() == f.vertices.size();
+        if (!bakedStretchUVs) ComputeStretchUVs(f.vertices, f.normal, computedStretchUVs);
+        const std::vector<Vector2>& stretchUVs = bakedStretchUVs ? f.stretchUVs : computedStretchUVs;
+        const bool authoredUVs = f.uvs.size() == f.vertices.size();
+
+        // Colors - store face tint, material handling done in renderer
+        faceVertices.clear();
+        for (size_t k = 0; k < f.vertices.size(); ++k) {
+            const Vector2& uv = authoredUVs ? f.uvs[k] : stretchUVs[k];
+            Vector2 lightmapUV = {0.0f, 0.0f};
+            if (lightmapPage >= 0) {
+                Vector2 planar = LightmapBaker::SurfacePlanar(f, f.vertices[k]);
+                lightmapUV = {planar.x * f.lightmapUVScale.x + f.lightmapUVOffset.x,
+                              planar.y * f.lightmapUVScale.y + f.lightmapUVOffset.y};
             }
-
-            // Use pre-calculated UVs from the face
-            for (size_t i = 0; i < 4; i++) {
-                batch.uvs.push_back(f.uvs[i]);
+            auto inserted = welds[bi].emplace(
+                MakeBatchVertexKey(f.vertices[k], f.normal, uv, stretchUVs[k], lightmapUV, f.tint),
+                static_cast<unsigned int>(batch.positions.size()));
+            if (inserted.second) {
+                batch.positions.push_back(f.vertices[k]);
+                batch.normals.push_back(f.normal);
+                batch.uvs.push_back(uv);
+                batch.stretchUVs.push_back(stretchUVs[k]);
+                batch.lightmapUVs.push_back(lightmapUV);
+                batch.colors.push_back(f.tint);
             }
+            faceVertices.push_back(inserted.first->second);
+        }
 
-            // Colors - store face tint, material handling done in renderer
-            Color finalColor = f.tint;
-            LOG_INFO("BATCH COLOR (quad): materialId=" + std::to_string(f.materialId) + " using face tint (" +
-                     std::to_string(f.tint.r) + "," + std::to_string(f.tint.g) + "," + std::to_string(f.tint.b) + ")");
+        int32_t cluster = i < faceClusters.size() ? faceClusters[i] : -1;
+        for (size_t c = 0; c + 2 < corners.size(); c += 3) {
+            pending[bi].push_back({cluster, {faceVertices[corners[c]], faceVertices[corners[c + 1]],
+                                             faceVertices[corners[c + 2]]}});
+        }
+        lastBatchStats_.faces++;
+        lastBatchStats_.cornerVertices += f.vertices.size();
+    }
 
-            for (int i = 0; i < 4; i++) {
-                batch.colors.push_back(finalColor);
+    float missesBefore = 0.0f, missesAfter = 0.0f;
+    std::vector<unsigned int> localIndex;
+    std::vector<unsigned int> rangeVertices;
+    std::vector<Vector3> localPositions;
+
+    for (size_t bi = 0; bi < batches.size(); ++bi) {
+        StaticBatch& batch = batches[bi];
+        std::vector<PendingTriangle>& triangles = pending[bi];
+        const size_t vertexCount = batch.positions.size();
+
+        // Face order, for the before/after comparison
+        batch.indices.reserve(triangles.size() * 3);
+        for (const PendingTriangle& t : triangles) batch.indices.insert(batch.indices.end(), t.corners, t.corners + 3);
+        missesBefore += WorldMesh::AverageCacheMissRatio(batch.indices.data(), batch.indices.size(), vertexCount) *
+                        static_cast<float>(triangles.size());
+
+        // One contiguous range per cluster so visible clusters draw as runs
+        std::stable_sort(triangles.begin(), triangles.end(),
+                         [](const PendingTriangle& a, const PendingTriangle& b) { return a.cluster < b.cluster; });
+        batch.indices.clear();
+        for (const PendingTriangle& t : triangles) batch.indices.insert(batch.indices.end(), t.corners, t.corners + 3);
+
+        // Cache and overdraw ordering stay within each range. The optimizers
+        // get range-local vertex numbers so their work doesn't scale with the
+        // whole batch.
+        localIndex.assign(vertexCount, UINT_MAX);
+        for (size_t start = 0; start < triangles.size();) {
+            size_t end = start;
+            while (end < triangles.size() && triangles[end].cluster == triangles[start].cluster) ++end;
+
+            BatchRange range;
+            range.cluster = triangles[start].cluster;
+            range.firstIndex = static_cast<uint32_t>(start * 3);
+            range.indexCount = static_cast<uint32_t>((end - start) * 3);
+
+            unsigned int* indices = batch.indices.data() + range.firstIndex;
+            rangeVertices.clear();
+            localPositions.clear();
+            for (uint32_t k = 0; k < range.indexCount; ++k) {
+                unsigned int& index = indices[k];
+                if (localIndex[index] == UINT_MAX) {
+                    localIndex[index] = static_cast<unsigned int>(rangeVertices.size());
+                    rangeVertices.push_back(index);
+                    localPositions.push_back(batch.positions[index]);
+                }
+                index = localIndex[index];
             }
-        } else if (v.size() == 3) {
-            // Handle triangle natively - no conversion to quad
-            unsigned int base = (unsigned int)batch.positions.size();
+            WorldMesh::OptimizeVertexCache(indices, range.indexCount, rangeVertices.size());
+            WorldMesh::OptimizeOverdraw(indices, range.indexCount, localPositions.data(), localPositions.size());
+            for (uint32_t k = 0; k < range.indexCount; ++k) indices[k] = rangeVertices[indices[k]];
+            for (unsigned int vertex : rangeVertices) localIndex[vertex] = UINT_MAX;
 
-            // Add the 3 vertices exactly as they are
-            for (size_t i = 0; i < 3; i++) {
-                batch.positions.push_back(v[i]);
-            }
+            batch.clusterRanges.push_back(range);
+            start = end;
+        }
 
-            // Use pre-calculated UVs from the face (exactly 3 UVs for 3 vertices)
-            for (size_t i = 0; i < 3; i++) {
-                batch.uvs.push_back(f.uvs[i]);
+        // Renumber vertices in first-use order so fetches stream through memory
+        std::vector<unsigned int> remap(vertexCount, UINT_MAX);
+        std::vector<Vector3> positions, normals;
+        std::vector<Vector2> uvs, stretchUVs, lightmapUVs;
+        std::vector<Color> colors;
+        positions.reserve(vertexCount);
+        normals.reserve(vertexCount);
+        uvs.reserve(vertexCount);
+        stretchUVs.reserve(vertexCount);
+        lightmapUVs.reserve(vertexCount);
+        colors.reserve(vertexCount);
+        for (unsigned int& index : batch.indices) {
+            if (remap[index] == UINT_MAX) {
+                remap[index] = static_cast<unsigned int>(positions.size());
+                positions.push_back(batch.positions[index]);
+                normals.push_back(batch.normals[index]);
+                uvs.push_back(batch.uvs[index]);
+                stretchUVs.push_back(batch.stretchUVs[index]);
+                lightmapUVs.push_back(batch.lightmapUVs[index]);
+                colors.push_back(batch.colors[index]);
             }
+            index = remap[index];
+        }
+        batch.positions = std::move(positions);
+        batch.normals = std::move(normals);
+        batch.uvs = std::move(uvs);
+        batch.stretchUVs = std::move(stretchUVs);
+        batch.lightmapUVs = std::move(lightmapUVs);
+        batch.colors = std::move(colors);
+
+        missesAfter += WorldMesh::AverageCacheMissRatio(batch.indices.data(), batch.indices.size(),
+                                                        batch.positions.size()) *
+                       static_cast<float>(triangles.size());
+
+        lastBatchStats_.vertices += batch.positions.size();
+        lastBatchStats_.triangles += triangles.size();
+        lastBatchStats_.ranges += batch.clusterRanges.size();
+        lastBatchStats_.bytes += batch.positions.size() * (2 * sizeof(Vector3) + 3 * sizeof(Vector2) + sizeof(Color)) +
+                                 batch.indices.size() * sizeof(unsigned int) +
+                                 batch.clusterRanges.size() * sizeof(BatchRange);
+    }
 
-            // Colors - unified material handling will be done in renderer
-            Color finalColor = f.tint;
-            LOG_INFO("BATCH COLOR (triangle): materialId=" + std::to_string(f.materialId) + " using face tint (" +
-                     std::to_string(f.tint.r) + "," + std::to_string(f.tint.g) + "," + std::to_string(f.tint.b) + ")");
+    if (lastBatchStats_.triangles > 0) {
+        lastBatchStats_.acmrBefore = missesBefore / static_cast<float>(lastBatchStats_.triangles);
+        lastBatchStats_.acmrAfter = missesAfter / static_cast<float>(lastBatchStats_.triangles);
+    }
+    lastBatchStats_.buildMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+
+    char acmr[64];
+    std::snprintf(acmr, sizeof(acmr), "%.3f -> %.3f", lastBatchStats_.acmrBefore, lastBatchStats_.acmrAfter);
+    LOG_INFO("WorldGeometry: built " + std::to_string(batches.size()) + " batches from " +
+             std::to_string(lastBatchStats_.faces) + " faces: " + std::to_string(lastBatchStats_.vertices) +
+             " vertices (" + std::to_string(lastBatchStats_.cornerVertices) + " before welding), " +
+             std::to_string(lastBatchStats_.triangles) + " triangles, " + std::to_string(lastBatchStats_.ranges) +
+             " cluster ranges, " + std::to_string(lastBatchStats_.bytes / 1024) + " KB, ACMR " + acmr + ", " +
+             std::to_string(lastBatchStats_.buildMs) + " ms");
+}
+
+void WorldGeometry::BuildBatchesFromWorld(const World& world) {
+    // A surface on a plane between two clusters is listed by both; drawing it
+    // with either one's range would drop it when only the other is visible,
+    // so it goes in the always drawn range
+    constexpr int32_t UNASSIGNED = -2;
+    std::vector<int32_t> surfaceClusters(world.surfaces.size(), UNASSIGNED);
+    for (size_t c = 0; c < world.clusters.size(); ++c) {
+        for (uint32_t surface : world.clusters[c].surfaces) {
+            if (surface >= surfaceClusters.size()) continue;
+            int32_t& cluster = surfaceClusters[surface];
+            cluster = (cluster == UNASSIGNED || cluster == static_cast<int32_t>(c)) ? static_cast<int32_t>(c) : -1;
+        }
+    }
+    for (int32_t& cluster : surfaceClusters) {
+        if (cluster == UNASSIGNED) cluster = -1;
+    }
+    BuildBatchesFromFaces(world.surfaces, surfaceClusters);
+}
 
-            // Add exactly 3 colors for 3 vertices
-            for (int i = 0; i < 3; i++) {
-                batch.colors.push_back(finalColor);
+void WorldGeometry::CollectVisibleRanges(const std::vector<BatchRange>& clusterRanges,
+                                         const std::vector<uint8_t>& clusterVisible,
+                                         std::vector<BatchRange>& outRanges) {
+    const size_t firstOut = outRanges.size();
+    for (const BatchRange& range : clusterRanges) {
+        bool visible = range.cluster < 0 ||
+                       (static_cast<size_t>(range.cluster) < clusterVisible.size() && clusterVisible[range.cluster]);
+        if (!visible) continue;
+
+        if (outRanges.size() > firstOut) {
+            BatchRange& last = outRanges.back();
+            if (last.firstIndex + last.indexCount == range.firstIndex) {
+                last.indexCount += range.indexCount;
+                continue;
             }
         }
+        outRanges.push_back(range);
     }
 }
@@ -13,13 +13,25 @@
 struct World {
     std::string name;
     std::vector<Face> surfaces;           // All faces in the world
-    std::vector<std::unique_ptr<BSPNode>> nodes; // BSP tree (owned pointers)
+    std::vector<BSPNode> nodes;           // Flat BSP tree, nodes[0] is the root
+    std::vector<BSPPlane> planes;         // Node splitting planes
+    std::vector<uint32_t> markSurfaces;   // Leaf surface lists (indices into surfaces)
+    std::vector<BSPCluster> clusters;     // Leaf clusters, one PVS row each
+    std::vector<AABB> clusterBounds;      // clusters[i].bounds, contiguous for batch frustum culling
     std::vector<uint8_t> visData;         // PVS data (byte array)
+    std::vector<BSPArea> areas;           // Leaf areas, connected through areaPortals
+    std::vector<BSPAreaPortal> areaPortals;
+    std::vector<uint32_t> occluders;      // Large opaque surfaces for occlusion culling, largest first
+    std::vector<BSPLightmap> lightmaps;   // Indexed by Face::lightmapIndex
+    std::vector<Color> lightmapTexels;
+    BSPProbeGrid probeGrid;
+    std::vector<BSPIrradianceProbe> probes;   // probeGrid.ProbeCount() entries, or none
     int numClusters;
     int clusterBytes;
-    BSPNode* root;                        // Root of BSP tree
 
-    World() : numClusters(0), clusterBytes(0), root(nullptr) {}
+    World() : numClusters(0), clusterBytes(0) {}
+
+    const BSPNode* GetRoot() const { return nodes.empty() ? nullptr : &nodes[0]; }
 };
 
 // WorldMaterial definition for static world geometry (avoiding raylib's Material conflict)
@@ -60,18 +72,42 @@ public:
     // Core static data containers
     std::unique_ptr<BSPTree> bspTree;           // LEGACY: For physics queries and culling (to be removed)
     std::unique_ptr<World> world;               // NEW: Quake-style world with BSP tree and PVS
+    // Run of a batch's index buffer holding one vis cluster's triangles
+    struct BatchRange {
+        int32_t cluster;                 // -1: surfaces outside any cluster
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
     struct StaticBatch {
         int materialId;
-        std::vector<Vector3> positions;  // per-vertex positions (triangulated)
-        std::vector<Vector2> uvs;        // per-vertex uvs
+        int lightmapPage = -1;           // Atlas page modulating the batch (-1: lit by the shader)
+        std::vector<Vector3> positions;  // per-vertex positions (welded, in first-use order)
+        std::vector<Vector3> normals;    // per-vertex face normals
+        std::vector<Vector2> uvs;        // per-vertex uvs (stretch UVs where the face has none)
+        std::vector<Vector2> stretchUVs; // per-vertex stretch-to-fill uvs
+        std::vector<Vector2> lightmapUVs; // per-vertex atlas page uvs (zero without a lightmap)
         std::vector<Color> colors;       // per-vertex colors (from face tint)
         std::vector<unsigned int> indices; // triangle indices into positions
+        std::vector<BatchRange> clusterRanges; // Sorted by cluster, together cover indices
+    };
+    // Statistics from the last batch build
+    struct BatchBuildStats {
+        size_t faces = 0;                // Faces batched (NoDraw faces are skipped)
+        size_t cornerVertices = 0;       // Vertices before welding (one per face corner)
+        size_t vertices = 0;             // Vertices after welding
+        size_t triangles = 0;
+        size_t ranges = 0;
+        size_t bytes = 0;                // Vertex streams + indices
+        float acmrBefore = 0.0f;         // Average cache miss ratio in face order
+        float acmrAfter = 0.0f;          // ... after vertex cache and overdraw ordering
+        double buildMs = 0.0;
     };
     std::vector<StaticBatch> batches;           // Pre-batched meshes for efficient rendering
     std::unordered_map<int, uint32_t> materialIdMap; // Map surface ID to MaterialSystem ID
     // Brush-based geometry (new pipeline)
     std::vector<Brush> brushes;
     std::vector<Face> faces; // flattened faces for BSP build
+    std::vector<BSPAreaPortalBrush> areaPortalBrushes; // Door/opening portals for the BSP build
 
     // Skybox system
     std::unique_ptr<class Skybox> skybox;
@@ -136,9 +172,23 @@ private:
     // Internal helper methods
     void CalculateBounds();
     void ClearBatches();
+
+    BatchBuildStats lastBatchStats_;
 public:
-    // Build GPU batches by material from faces
-    void BuildBatchesFromFaces(const std::vector<Face>& inFaces);
+    // Build GPU batches by material and lightmap page from faces: polygons
+    // are ear-clipped, identical vertices welded per batch and each batch's
+    // index buffer is ordered by cluster (faceClusters[i], -1 if not given),
+    // then for the vertex cache and overdraw within each cluster range
+    void BuildBatchesFromFaces(const std::vector<Face>& inFaces, const std::vector<int32_t>& faceClusters = {});
+    // Same for the compiled world's surfaces, ranged by their vis clusters.
+    // Call after the lightmap atlas is packed, the batches carry page uvs.
+    void BuildBatchesFromWorld(const World& world);
+    const BatchBuildStats& GetLastBatchStats() const { return lastBatchStats_; }
+
+    // Append the ranges whose cluster is visible (clusterVisible[c] != 0;
+    // cluster -1 always is), merging neighbours into single draws
+    static void CollectVisibleRanges(const std::vector<BatchRange>& clusterRanges,
+                                     const std::vector<uint8_t>& clusterVisible, std::vector<BatchRange>& outRanges);
 
     // Calculate UV coordinates for a face (called during world building)
     void CalculateFaceUVs(Face& face);
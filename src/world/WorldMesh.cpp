@@ -0,0 +1,357 @@
+#include "WorldMesh.h"
+#include "raymath.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Distance (world units) under which a vertex counts as lying on a line
+constexpr float TRIANGULATE_EPSILON = 0.002f;
+
+// Forsyth's scoring parameters
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+struct Point2 { float x, y; };
+
+float Cross2(const Point2& o, const Point2& a, const Point2& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+float Length2(const Point2& a, const Point2& b) {
+    return sqrtf((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+}
+
+// Signed distance of p from the directed line a->b, positive on the inside
+// of a polygon with the given orientation
+float SideOfLine(const Point2& a, const Point2& b, const Point2& p, float orient) {
+    float length = Length2(a, b);
+    if (length < 1e-12f) return 0.0f;
+    return orient * Cross2(a, b, p) / length;
+}
+
+float VertexScore(int cachePosition, uint32_t liveTriangles) {
+    if (liveTriangles == 0) return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The triangle just emitted: don't favour reusing it right away
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            const float scale = 1.0f / static_cast<float>(WorldMesh::CACHE_SIZE - 3);
+            score = powf(1.0f - static_cast<float>(cachePosition - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+    // Finish off vertices with few triangles left so they leave the cache for good
+    score += VALENCE_BOOST_SCALE * powf(static_cast<float>(liveTriangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace
+
+bool WorldMesh::TriangulatePolygon(const std::vector<Vector3>& vertices, std::vector<uint32_t>& outCorners) {
+    const size_t count = vertices.size();
+    if (count < 3) return false;
+
+    // Newell normal, so a stale face normal can't pick a bad projection
+    Vector3 normal{0, 0, 0};
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3& a = vertices[i];
+        const Vector3& b = vertices[(i + 1) % count];
+        normal.x += (a.y - b.y) * (a.z + b.z);
+        normal.y += (a.z - b.z) * (a.x + b.x);
+        normal.z += (a.x - b.x) * (a.y + b.y);
+    }
+
+    // Project onto the plane's dominant axis
+    float ax = fabsf(normal.x), ay = fabsf(normal.y), az = fabsf(normal.z);
+    std::vector<Point2> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Vector3& v = vertices[i];
+        if (ax >= ay && ax >= az) points[i] = {v.y, v.z};
+        else if (ay >= az) points[i] = {v.z, v.x};
+        else points[i] = {v.x, v.y};
+    }
+
+    float area = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const Point2& a = points[i];
+        const Point2& b = points[(i + 1) % count];
+        area += a.x * b.y - b.x * a.y;
+    }
+    if (fabsf(area) < 1e-8f) return false;
+    const float orient = area > 0.0f ? 1.0f : -1.0f;
+
+    if (count == 3) {
+        outCorners.insert(outCorners.end(), {0u, 1u, 2u});
+        return true;
+    }
+
+    std::vector<uint32_t> remaining(count);
+    for (size_t i = 0; i < count; ++i) remaining[i] = static_cast<uint32_t>(i);
+
+    while (remaining.size() > 3) {
+        const size_t n = remaining.size();
+        size_t bestEar = n;
+        float bestQuality = 0.0f;
+
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t p = remaining[(i + n - 1) % n], c = remaining[i], q = remaining[(i + 1) % n];
+            const Point2& pp = points[p];
+            const Point2& pc = points[c];
+            const Point2& pq = points[q];
+
+            // Convex corner with real area (collinear vertices are never clipped)
+            if (SideOfLine(pp, pq, pc, -orient) <= TRIANGULATE_EPSILON) continue;
+
+            // No other vertex inside or on the ear, otherwise it would leave
+            // a vertex off the triangle edges (a crack at T-junctions)
+            bool blocked = false;
+            for (size_t k = 0; k < n && !blocked; ++k) {
+                uint32_t other = remaining[k];
+                if (other == p || other == c || other == q) continue;
+                const Point2& po = points[other];
+                if (Length2(po, pp) < TRIANGULATE_EPSILON || Length2(po, pc) < TRIANGULATE_EPSILON ||
+                    Length2(po, pq) < TRIANGULATE_EPSILON) {
+                    continue;
+                }
+                blocked = SideOfLine(pp, pc, po, orient) >= -TRIANGULATE_EPSILON &&
+                          SideOfLine(pc, pq, po, orient) >= -TRIANGULATE_EPSILON &&
+                          SideOfLine(pq, pp, po, orient) >= -TRIANGULATE_EPSILON;
+            }
+            if (blocked) continue;
+
+            // Prefer well shaped ears: area over squared edge lengths
+            float a = Length2(pp, pc), b = Length2(pc, pq), e = Length2(pq, pp);
+            float quality = orient * Cross2(pp, pc, pq) / (a * a + b * b + e * e);
+            if (quality > bestQuality) {
+                bestQuality = quality;
+                bestEar = i;
+            }
+        }
+
+        if (bestEar == n) break;
+        outCorners.push_back(remaining[(bestEar + n - 1) % n]);
+        outCorners.push_back(remaining[bestEar]);
+        outCorners.push_back(remaining[(bestEar + 1) % n]);
+        remaining.erase(remaining.begin() + bestEar);
+    }
+
+    // Whatever is left (the last triangle, or a sliver the ear search gave up
+    // on) is fanned, skipping zero-area triangles
+    for (size_t i = 1; i + 1 < remaining.size(); ++i) {
+        const Point2& a = points[remaining[0]];
+        const Point2& b = points[remaining[i]];
+        const Point2& c = points[remaining[i + 1]];
+        if (orient * Cross2(a, b, c) <= 0.0f) continue;
+        outCorners.push_back(remaining[0]);
+        outCorners.push_back(remaining[i]);
+        outCorners.push_back(remaining[i + 1]);
+    }
+    return true;
+}
+
+void WorldMesh::OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || vertexCount == 0) return;
+
+    // Vertex -> live triangles adjacency
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) liveTriangles[indices[i]]++;
+    std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) adjacencyStart[v + 1] = adjacencyStart[v] + liveTriangles[v];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursor(adjacencyStart.begin(), adjacencyStart.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) adjacency[cursor[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) vertexScore[v] = VertexScore(-1, liveTriangles[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    int64_t best = -1;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* tri = indices + t * 3;
+        triangleScore[t] = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+        if (triangleScore[t] > bestScore) {
+            bestScore = triangleScore[t];
+            best = static_cast<int64_t>(t);
+        }
+    }
+
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+    uint32_t cache[CACHE_SIZE + 3];
+    uint32_t nextCache[CACHE_SIZE + 3];
+    size_t cacheCount = 0;
+    size_t scan = 0;
+
+    while (output.size() < triangleCount * 3) {
+        // Nothing in the cache has triangles left: take the next unemitted one
+        if (best < 0) {
+            while (emitted[scan]) ++scan;
+            best = static_cast<int64_t>(scan);
+        }
+
+        const unsigned int* tri = indices + best * 3;
+        output.insert(output.end(), tri, tri + 3);
+        emitted[best] = 1;
+
+        size_t nextCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            // Drop the triangle from the vertex's live list
+            uint32_t* list = adjacency.data() + adjacencyStart[v];
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                if (list[j] == static_cast<uint32_t>(best)) {
+                    list[j] = list[liveTriangles[v] - 1];
+                    liveTriangles[v]--;
+                    break;
+                }
+            }
+            if (std::find(nextCache, nextCache + nextCount, v) == nextCache + nextCount) {
+                nextCache[nextCount++] = v;
+            }
+        }
+
+        // LRU: the triangle's vertices move to the front
+        for (size_t i = 0; i < cacheCount; ++i) {
+            uint32_t v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) nextCache[nextCount++] = v;
+        }
+
+        // Rescore everything that moved or fell out, then the triangles using them
+        for (size_t i = 0; i < nextCount; ++i) {
+            uint32_t v = nextCache[i];
+            cachePosition[v] = i < CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = VertexScore(cachePosition[v], liveTriangles[v]);
+        }
+
+        best = -1;
+        bestScore = -1.0f;
+        for (size_t i = 0; i < nextCount; ++i) {
+            uint32_t v = nextCache[i];
+            const uint32_t* list = adjacency.data() + adjacencyStart[v];
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                uint32_t t = list[j];
+                const unsigned int* other = indices + static_cast<size_t>(t) * 3;
+                triangleScore[t] = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(nextCount, CACHE_SIZE);
+        std::copy(nextCache, nextCache + cacheCount, cache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void WorldMesh::OptimizeOverdraw(unsigned int* indices, size_t indexCount, const Vector3* positions,
+                                 size_t vertexCount, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2 || vertexCount == 0) return;
+
+    // Split where all three vertices miss the cache: reordering whole runs
+    // then costs (almost) nothing in cache efficiency
+    std::vector<size_t> runStart;
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    uint32_t timestamp = static_cast<uint32_t>(MEASURE_CACHE_SIZE) + 1;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        int misses = 0;
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = indices[t * 3 + k];
+            if (timestamp - stamp[v] > MEASURE_CACHE_SIZE) {
+                stamp[v] = timestamp++;
+                ++misses;
+            }
+        }
+        if (t == 0 || misses == 3) runStart.push_back(t);
+    }
+    if (runStart.size() < 2) return;
+    runStart.push_back(triangleCount);
+
+    // Area weighted centroid and normal per run and for the whole range
+    const size_t runCount = runStart.size() - 1;
+    std::vector<Vector3> runCentroid(runCount), runNormal(runCount);
+    Vector3 meshCentroid{0, 0, 0};
+    float meshArea = 0.0f;
+    for (size_t r = 0; r < runCount; ++r) {
+        Vector3 centroid{0, 0, 0}, normal{0, 0, 0};
+        float runArea = 0.0f;
+        for (size_t t = runStart[r]; t < runStart[r + 1]; ++t) {
+            const Vector3& a = positions[indices[t * 3 + 0]];
+            const Vector3& b = positions[indices[t * 3 + 1]];
+            const Vector3& c = positions[indices[t * 3 + 2]];
+            Vector3 cross = Vector3CrossProduct(Vector3Subtract(b, a), Vector3Subtract(c, a));
+            float area = Vector3Length(cross);
+            Vector3 center = Vector3Scale(Vector3Add(Vector3Add(a, b), c), 1.0f / 3.0f);
+            centroid = Vector3Add(centroid, Vector3Scale(center, area));
+            normal = Vector3Add(normal, cross);
+            runArea += area;
+        }
+        meshCentroid = Vector3Add(meshCentroid, centroid);
+        meshArea += runArea;
+        runCentroid[r] = runArea > 0.0f ? Vector3Scale(centroid, 1.0f / runArea) : centroid;
+        runNormal[r] = normal;
+    }
+    if (meshArea <= 0.0f) return;
+    meshCentroid = Vector3Scale(meshCentroid, 1.0f / meshArea);
+
+    // Occlusion potential: runs far out along their own normal are likely to
+    // hide the rest, so they go first
+    std::vector<float> sortKey(runCount, 0.0f);
+    for (size_t r = 0; r < runCount; ++r) {
+        float length = Vector3Length(runNormal[r]);
+        if (length <= 0.0f) continue;
+        sortKey[r] = Vector3DotProduct(Vector3Subtract(runCentroid[r], meshCentroid),
+                                       Vector3Scale(runNormal[r], 1.0f / length));
+    }
+    std::vector<uint32_t> order(runCount);
+    for (size_t r = 0; r < runCount; ++r) order[r] = static_cast<uint32_t>(r);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> sorted;
+    sorted.reserve(triangleCount * 3);
+    for (uint32_t r : order) {
+        sorted.insert(sorted.end(), indices + runStart[r] * 3, indices + runStart[r + 1] * 3);
+    }
+
+    float before = AverageCacheMissRatio(indices, triangleCount * 3, vertexCount);
+    float after = AverageCacheMissRatio(sorted.data(), sorted.size(), vertexCount);
+    if (after <= before * threshold) {
+        std::copy(sorted.begin(), sorted.end(), indices);
+    }
+}
+
+float WorldMesh::AverageCacheMissRatio(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                       size_t cacheSize) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || vertexCount == 0) return 0.0f;
+
+    // FIFO cache: a vertex is resident while fewer than cacheSize misses
+    // happened since it was loaded
+    std::vector<uint32_t> stamp(vertexCount, 0);
+    uint32_t timestamp = static_cast<uint32_t>(cacheSize) + 1;
+    size_t misses = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        uint32_t v = indices[i];
+        if (timestamp - stamp[v] > cacheSize) {
+            stamp[v] = timestamp++;
+            ++misses;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Index buffer helpers for the static world batches: polygon triangulation,
+// post-transform vertex cache ordering (Forsyth), view-independent overdraw
+// ordering (Sander et al. / meshoptimizer) and cache miss measurement.
+class WorldMesh {
+public:
+    // Vertex cache size the ordering optimizes for
+    static constexpr size_t CACHE_SIZE = 32;
+    // FIFO cache size used when measuring ACMR (a typical post-transform cache)
+    static constexpr size_t MEASURE_CACHE_SIZE = 16;
+
+    // Ear-clip a planar polygon into triangles (corner indices into vertices,
+    // three per triangle, same winding as the polygon). Unlike a fan it never
+    // emits zero-area triangles for collinear vertices such as T-junction
+    // fixes. Returns false if the polygon is degenerate.
+    static bool TriangulatePolygon(const std::vector<Vector3>& vertices, std::vector<uint32_t>& outCorners);
+
+    // Reorder the triangles of indices[0..indexCount) so vertices are reused
+    // while they are still in the post-transform cache
+    static void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+    // Reorder runs of triangles (split where the cache restarts) so outward
+    // facing ones come first, which cuts overdraw from most viewpoints. Keeps
+    // the result only if ACMR stays within threshold of the input ordering.
+    static void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const Vector3* positions,
+                                 size_t vertexCount, float threshold = 1.05f);
+
+    // Average cache miss ratio: transformed vertices per triangle (0.5 - 3.0)
+    static float AverageCacheMissRatio(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+                                       size_t cacheSize = MEASURE_CACHE_SIZE);
+};
@@ -0,0 +1,394 @@
+// paintsplash_mapc - offline map compiler
+//
+// Runs the same world compile the game runs at load time (parse, material
+// fallback, BSP, areas, clusters, PVS, static batches), bakes lightmaps and
+// irradiance probes from the map's light entities, packs the lightmaps into
+// atlas pages and writes the result as a compiled world cache. By default the
+// cache goes next to the .map, where WorldSystem::LoadMap picks it up and skips
+// the compile entirely.
+//
+// Usage: paintsplash_mapc [-threads N] [-nomerge] [-nolight] [-bounces N] [-luxel S] [-probes S]
+//                         [-verbose] [-o output.wcache] input.map
+
+#include "world/MapLoader.h"
+#include "world/BSPTreeSystem.h"
+#include "world/WorldCache.h"
+#include "world/WorldGeometry.h"
+#include "world/LightmapBaker.h"
+#include "world/LightmapAtlas.h"
+#include "core/JobSystem.h"
+#include "utils/Logger.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct MapcOptions {
+    std::string inputPath;
+    std::string outputPath;
+    unsigned int threads = 0;   // 0 = hardware_concurrency
+    bool noMerge = false;
+    bool noLight = false;
+    int bounces = 1;
+    float luxelSize = 0.25f;
+    float probeSpacing = 2.0f;  // 0 = no irradiance probes
+    bool verbose = false;
+};
+
+struct MapcStage {
+    const char* name;
+    double ms;
+};
+
+// Validation findings. Warnings still produce output; errors fail the compile.
+struct MapcReport {
+    std::vector<std::string> warnings;
+    std::vector<std::string> errors;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double MsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void PrintUsage() {
+    std::printf("Usage: paintsplash_mapc [options] input.map\n"
+                "  -o <file>      Output path (default: input path with .wcache extension)\n"
+                "  -threads <n>   Worker threads including the main thread (default: all cores)\n"
+                "  -nomerge       Keep authored faces as they are (no coplanar merge or T-junction fixing)\n"
+                "  -nolight       Skip the lightmap bake\n"
+                "  -bounces <n>   Indirect light bounces (default: 1, 0 = direct light only)\n"
+                "  -luxel <size>  Lightmap texel size in world units (default: 0.25)\n"
+                "  -probes <size> Irradiance probe spacing in world units (default: 2, 0 = no probes)\n"
+                "  -verbose       Show engine log output\n");
+}
+
+bool ParseArgs(int argc, char** argv, MapcOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            options.outputPath = argv[++i];
+        } else if (arg == "-threads" && i + 1 < argc) {
+            int threads = std::atoi(argv[++i]);
+            if (threads < 1) {
+                std::fprintf(stderr, "mapc: -threads expects a positive count\n");
+                return false;
+            }
+            options.threads = static_cast<unsigned int>(threads);
+        } else if (arg == "-nomerge") {
+            options.noMerge = true;
+        } else if (arg == "-nolight") {
+            options.noLight = true;
+        } else if (arg == "-bounces" && i + 1 < argc) {
+            options.bounces = std::atoi(argv[++i]);
+            if (options.bounces < 0) {
+                std::fprintf(stderr, "mapc: -bounces expects zero or more\n");
+                return false;
+            }
+        } else if (arg == "-luxel" && i + 1 < argc) {
+            options.luxelSize = static_cast<float>(std::atof(argv[++i]));
+            if (options.luxelSize <= 0.0f) {
+                std::fprintf(stderr, "mapc: -luxel expects a positive size\n");
+                return false;
+            }
+        } else if (arg == "-probes" && i + 1 < argc) {
+            options.probeSpacing = static_cast<float>(std::atof(argv[++i]));
+            if (options.probeSpacing < 0.0f) {
+                std::fprintf(stderr, "mapc: -probes expects zero or a positive spacing\n");
+                return false;
+            }
+        } else if (arg == "-verbose") {
+            options.verbose = true;
+        } else if (arg == "-h" || arg == "-help" || arg == "--help") {
+            return false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "mapc: unknown option %s\n", arg.c_str());
+            return false;
+        } else if (options.inputPath.empty()) {
+            options.inputPath = arg;
+        } else {
+            std::fprintf(stderr, "mapc: more than one input map given\n");
+            return false;
+        }
+    }
+    return !options.inputPath.empty();
+}
+
+// Same checks and fixes WorldSystem::BuildWorldGeometry applies before the
+// build, so the compiled surfaces match what a runtime compile would produce
+void ValidateFaces(MapData& mapData, MapcReport& report) {
+    std::unordered_set<int> materialIds;
+    for (const auto& material : mapData.materials) {
+        materialIds.insert(material.id);
+    }
+
+    size_t unknownMaterials = 0, degenerate = 0, badUVs = 0;
+    for (Face& face : mapData.faces) {
+        if (materialIds.find(face.materialId) == materialIds.end()) {
+            face.materialId = 0;
+            ++unknownMaterials;
+        }
+        if (face.vertices.size() < 3 || std::fabs(Vector3Length(face.normal) - 1.0f) > 0.01f) {
+            ++degenerate;
+        }
+        if (face.uvs.size() != face.vertices.size()) {
+            ++badUVs;
+        }
+    }
+
+    if (mapData.materials.empty()) {
+        report.warnings.push_back("map defines no materials");
+    }
+    if (unknownMaterials > 0) {
+        report.warnings.push_back(std::to_string(unknownMaterials) + " faces reference unknown materials (using material 0)");
+    }
+    if (degenerate > 0) {
+        report.warnings.push_back(std::to_string(degenerate) + " degenerate faces (fewer than 3 vertices or no normal)");
+    }
+    if (badUVs > 0) {
+        report.warnings.push_back(std::to_string(badUVs) + " faces whose UV count doesn't match their vertex count");
+    }
+    for (const auto& portal : mapData.areaPortals) {
+        if (portal.faces.empty()) {
+            report.warnings.push_back("area portal '" + portal.name + "' has no faces");
+        }
+    }
+}
+
+void ValidateWorld(const World& world, MapcReport& report) {
+    size_t emptyLeaves = 0, unclustered = 0;
+    for (const BSPNode& node : world.nodes) {
+        if (!node.IsLeaf() || node.contents != BSP_CONTENTS_EMPTY) continue;
+        ++emptyLeaves;
+        if (node.cluster < 0) ++unclustered;
+    }
+    if (emptyLeaves == 0) {
+        report.errors.push_back("no empty leaves: the world has no open space");
+    }
+    if (unclustered > 0) {
+        report.warnings.push_back(std::to_string(unclustered) + " empty leaves not assigned to a cluster");
+    }
+
+    for (const BSPAreaPortal& portal : world.areaPortals) {
+        if (portal.areas.size() < 2) {
+            report.warnings.push_back("area portal '" + portal.name + "' touches " +
+                                      std::to_string(portal.areas.size()) +
+                                      " area(s); the areas around it are not sealed");
+        }
+    }
+}
+
+// Average share of clusters each cluster's PVS row marks visible
+double AveragePVSVisibility(const World& world) {
+    if (world.numClusters <= 0 || world.visData.empty()) return 1.0;
+    size_t visible = 0;
+    for (int a = 0; a < world.numClusters; ++a) {
+        const uint8_t* row = &world.visData[static_cast<size_t>(a) * world.clusterBytes];
+        for (int b = 0; b < world.numClusters; ++b) {
+            if (row[b >> 3] & (1 << (b & 7))) ++visible;
+        }
+    }
+    return static_cast<double>(visible) / (static_cast<double>(world.numClusters) * world.numClusters);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MapcOptions options;
+    if (!ParseArgs(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+    if (options.outputPath.empty()) {
+        options.outputPath = WorldCache::GetCachePath(options.inputPath);
+    }
+
+    // The engine logs every step at INFO; the tool prints its own summary
+    Logger::SetLogLevel(options.verbose ? LogLevel::INFO : LogLevel::WARNING);
+
+    // The calling thread also runs jobs, so N threads means N - 1 workers.
+    // With one thread the pool is never started and every job runs inline.
+    JobSystem& jobs = JobSystem::GetInstance();
+    if (options.threads != 1) {
+        jobs.Initialize(options.threads > 0 ? options.threads - 1 : 0);
+    }
+
+    std::vector<MapcStage> stages;
+    MapcReport report;
+    auto totalStart = Clock::now();
+
+    // === Parse ===
+    auto stageStart = Clock::now();
+    uint64_t key = WorldCache::ComputeKey(options.inputPath);
+    MapLoader loader;
+    MapData mapData = loader.LoadMap(options.inputPath);
+    stages.push_back({"parse", MsSince(stageStart)});
+    if (key == 0 || mapData.faces.empty()) {
+        std::fprintf(stderr, "mapc: %s: no world geometry (missing file or parse error)\n", options.inputPath.c_str());
+        jobs.Shutdown();
+        return 1;
+    }
+
+    // === Validate input ===
+    stageStart = Clock::now();
+    ValidateFaces(mapData, report);
+    stages.push_back({"validate", MsSince(stageStart)});
+
+    // === BSP, areas, clusters, PVS ===
+    BSPTreeSystem bsp;
+    bsp.SetFaceMerging(!options.noMerge);
+    std::unique_ptr<World> world = bsp.LoadWorld(mapData.faces, mapData.areaPortals);
+    if (!world) {
+        std::fprintf(stderr, "mapc: %s: BSP compile failed\n", options.inputPath.c_str());
+        jobs.Shutdown();
+        return 1;
+    }
+    const BSPBuildStats& stats = bsp.GetLastBuildStats();
+    stages.push_back({"merge", stats.mergeMs});
+    stages.push_back({"bsp", stats.buildMs});
+    stages.push_back({"areas", stats.areasMs});
+    stages.push_back({"clusters", stats.clustersMs});
+    stages.push_back({"pvs", stats.pvsMs});
+    ValidateWorld(*world, report);
+    // Authored maps always have some coplanar neighbours; merging none of
+    // them means something upstream stopped their UVs from lining up
+    if (!options.noMerge && mapData.faces.size() > 1 && stats.mergedFaces == 0) {
+        report.warnings.push_back("face merging removed no faces; adjacent coplanar faces have mismatched UVs");
+    }
+
+    // === Lightmaps ===
+    LightmapBaker baker(bsp);
+    LightmapAtlas::Stats atlasStats;
+    if (!options.noLight) {
+        LightmapBaker::Settings lightSettings;
+        lightSettings.bounces = options.bounces;
+        lightSettings.luxelSize = options.luxelSize;
+        lightSettings.probeSpacing = options.probeSpacing;
+        baker.SetSettings(lightSettings);
+        for (const auto& entity : mapData.entities) {
+            if (entity->type == GameObjectType::LIGHT_POINT || entity->type == GameObjectType::LIGHT_SPOT ||
+                entity->type == GameObjectType::LIGHT_DIRECTIONAL) {
+                baker.AddLight(entity->light, entity->position, entity->rotation);
+            }
+        }
+        if (baker.GetLightCount() == 0) {
+            report.warnings.push_back("no enabled light entities; lightmaps only hold the ambient floor");
+        }
+        baker.Bake(*world);
+        stages.push_back({"light", baker.GetLastStats().directMs});
+        stages.push_back({"bounce", baker.GetLastStats().bounceMs});
+
+        // Probes read the lightmaps, so they come after the bake
+        if (options.probeSpacing > 0.0f) {
+            baker.BakeProbes(*world);
+            stages.push_back({"probes", baker.GetLastStats().probeMs});
+        }
+
+        if (!LightmapAtlas::Pack(*world, LightmapAtlas::Settings{}, &atlasStats)) {
+            report.errors.push_back("lightmap atlas packing failed");
+        }
+        stages.push_back({"atlas", atlasStats.packMs});
+    }
+
+    // === Static batches ===
+    stageStart = Clock::now();
+    WorldGeometry geometry;
+    geometry.BuildBatchesFromWorld(*world);
+    const WorldGeometry::BatchBuildStats& batchStats = geometry.GetLastBatchStats();
+    size_t surfaceTriangles = 0;
+    for (const Face& surface : world->surfaces) {
+        if (surface.vertices.size() >= 3) surfaceTriangles += surface.vertices.size() - 2;
+    }
+    stages.push_back({"batches", MsSince(stageStart)});
+
+    // === Write ===
+    bool written = false;
+    if (report.errors.empty()) {
+        stageStart = Clock::now();
+        WorldCacheBuild build;
+        build.lit = options.noLight ? 0 : 1;
+        build.mergedFaces = options.noMerge ? 0 : 1;
+        if (!options.noLight) {
+            build.bounces = options.bounces;
+            build.luxelSize = options.luxelSize;
+            build.probeSpacing = options.probeSpacing;
+        }
+        written = WorldCache::Save(options.outputPath, key, build, *world, geometry.GetBatches());
+        stages.push_back({"write", MsSince(stageStart)});
+        if (!written) {
+            report.errors.push_back("failed to write " + options.outputPath);
+        } else if (options.outputPath == WorldCache::GetCachePath(options.inputPath)) {
+            // The game's stand-in compile is superseded now
+            std::error_code ec;
+            std::filesystem::remove(WorldCache::GetRuntimeCachePath(options.inputPath), ec);
+        }
+    }
+    double totalMs = MsSince(totalStart);
+
+    // === Report ===
+    std::printf("%s -> %s\n", options.inputPath.c_str(), written ? options.outputPath.c_str() : "(not written)");
+    std::printf("  threads     %u\n", stats.threadCount);
+    std::printf("  input       %zu faces, %zu area portals, %zu materials, %zu entities\n",
+                mapData.faces.size(), mapData.areaPortals.size(), mapData.materials.size(), mapData.entities.size());
+    std::printf("  merge       %zu faces removed, %zu T-junction vertices inserted%s\n",
+                stats.mergedFaces, stats.tJunctionVertices, options.noMerge ? " (disabled)" : "");
+    std::printf("  bsp         %zu nodes, %zu leaves, depth %d, %zu splits, %zu surfaces\n",
+                stats.nodeCount, stats.leafCount, stats.maxDepth, stats.splitCount, world->surfaces.size());
+    std::printf("  collision   %zu surface triangles\n", surfaceTriangles);
+    std::printf("  occluders   %zu surfaces\n", stats.occluderCount);
+    if (options.noLight) {
+        std::printf("  light       (disabled)\n");
+    } else {
+        const LightmapBaker::Stats& lightStats = baker.GetLastStats();
+        std::printf("  light       %zu lights, %zu lightmaps, %zu texels (%.1f KB), %d bounces\n",
+                    lightStats.lights, lightStats.lightmaps, lightStats.texels,
+                    lightStats.texels * sizeof(Color) / 1024.0, options.bounces);
+        std::printf("              %zu shadow rays, %zu bounce rays\n", lightStats.shadowRays, lightStats.bounceRays);
+        if (lightStats.probes > 0) {
+            const BSPProbeGrid& grid = world->probeGrid;
+            std::printf("  probes      %ux%ux%u at %.2f units, %zu of %zu outside solid, %zu rays\n",
+                        grid.countX, grid.countY, grid.countZ, grid.spacing, lightStats.validProbes,
+                        lightStats.probes, lightStats.probeRays);
+        } else {
+            std::printf("  probes      (disabled)\n");
+        }
+        std::printf("  atlas       %zu pages, %zu of %zu texels used (%.1f%%)",
+                    atlasStats.pages, atlasStats.usedTexels, atlasStats.pageTexels,
+                    atlasStats.pageTexels > 0 ? 100.0 * atlasStats.usedTexels / atlasStats.pageTexels : 0.0);
+        for (size_t p = 0; p < atlasStats.occupancy.size(); ++p) {
+            std::printf("%s%.0f%%", p == 0 ? " [" : " ", atlasStats.occupancy[p] * 100.0);
+        }
+        std::printf("%s\n", atlasStats.occupancy.empty() ? "" : "]");
+    }
+    std::printf("  vis         %d clusters, %zu areas, %zu PVS bytes, %.1f%% visible on average\n",
+                world->numClusters, world->areas.size(), world->visData.size(), AveragePVSVisibility(*world) * 100.0);
+    std::printf("  batches     %zu by material and lightmap page, %zu vertices (%zu before welding)\n",
+                geometry.GetBatches().size(), batchStats.vertices, batchStats.cornerVertices);
+    std::printf("              %zu triangles, %zu cluster ranges\n", batchStats.triangles, batchStats.ranges);
+    std::printf("              %.1f KB, ACMR %.3f -> %.3f\n", batchStats.bytes / 1024.0, batchStats.acmrBefore,
+                batchStats.acmrAfter);
+
+    std::printf("  timings\n");
+    for (const MapcStage& stage : stages) {
+        std::printf("    %-10s %9.2f ms\n", stage.name, stage.ms);
+    }
+    std::printf("    %-10s %9.2f ms\n", "total", totalMs);
+
+    for (const std::string& warning : report.warnings) {
+        std::printf("  warning: %s\n", warning.c_str());
+    }
+    for (const std::string& error : report.errors) {
+        std::printf("  error: %s\n", error.c_str());
+    }
+    std::printf("  %zu warning(s), %zu error(s)\n", report.warnings.size(), report.errors.size());
+
+    jobs.Shutdown();
+    return report.errors.empty() ? 0 : 1;
+}